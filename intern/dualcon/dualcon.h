@@ -62,6 +62,12 @@ typedef void (*DualConAddVert)(void *output, const float co[3]);
 /* callback for adding a new quad to the output */
 typedef void (*DualConAddQuad)(void *output, const int vert_indices[4]);
 
+/* function run for each index of a parallel range */
+typedef void (*DualConParallelFunc)(void *userdata, int index);
+/* callback for running func(userdata, i) for each i in [0, tot), possibly
+ * in parallel; returns once all of them are done */
+typedef void (*DualConParallelRange)(int tot, void *userdata, DualConParallelFunc func);
+
 typedef enum {
 	DUALCON_FLOOD_FILL = 1,
 } DualConFlags;
@@ -84,12 +90,19 @@ typedef enum {
  * add_quad callbacks will then be called for each new vertex and
  * quad, and the callback should add the new mesh elements to the
  * structure.
+ *
+ * The optional parallel_range callback lets the caller provide a
+ * threading implementation; when non-NULL, scan conversion and
+ * contouring are split over the eight octants of the root node. The
+ * output is the same as with a NULL callback, in the same order.
  */
 void *dualcon(const DualConInput *input_mesh,
               /* callbacks for output */
               DualConAllocOutput alloc_output,
               DualConAddVert add_vert,
               DualConAddQuad add_quad,
+              /* optional callback for multithreading, may be NULL */
+              DualConParallelRange parallel_range,
 
               /* flags and settings to control the remeshing
                * algorithm */
@@ -71,7 +71,7 @@ class MemoryAllocator : public VirtualMemoryAllocator
 private:
 
 /// Constants
-int HEAP_UNIT, HEAP_MASK;
+int heapbase, HEAP_UNIT, HEAP_MASK;
 
 /// Data array
 UCHAR **data;
@@ -124,12 +124,13 @@ void allocateStackBlock( )
 
 public:
 /**
- * Constructor
+ * Constructor, objects are allocated in blocks of (1 << base) objects
  */
-MemoryAllocator( )
+MemoryAllocator(int base = HEAP_BASE)
 {
-	HEAP_UNIT = 1 << HEAP_BASE;
-	HEAP_MASK = (1 << HEAP_BASE) - 1;
+	heapbase = base;
+	HEAP_UNIT = 1 << heapbase;
+	HEAP_MASK = (1 << heapbase) - 1;
 
 	data = ( UCHAR ** )malloc(sizeof(UCHAR *) );
 	data[0] = ( UCHAR * )malloc(HEAP_UNIT * N);
@@ -177,7 +178,7 @@ void *allocate( )
 
 	// printf("Allocating %d\n", header[ allocated ]) ;
 	available--;
-	return (void *)stack[available >> HEAP_BASE][available & HEAP_MASK];
+	return (void *)stack[available >> heapbase][available & HEAP_MASK];
 }
 
 /**
@@ -191,7 +192,7 @@ void deallocate(void *obj)
 	}
 
 	// printf("De-allocating %d\n", ( obj - data ) / N ) ;
-	stack[available >> HEAP_BASE][available & HEAP_MASK] = (UCHAR *)obj;
+	stack[available >> heapbase][available & HEAP_MASK] = (UCHAR *)obj;
 	available++;
 	// printf("%d %d\n", allocated, header[ allocated ]) ;
 }
@@ -171,6 +171,7 @@ void *dualcon(const DualConInput *input_mesh,
               DualConAllocOutput alloc_output,
               DualConAddVert add_vert,
               DualConAddQuad add_quad,
+              DualConParallelRange parallel_range,
 
               DualConFlags flags,
               DualConMode mode,
@@ -180,7 +181,7 @@ void *dualcon(const DualConInput *input_mesh,
               int depth)
 {
 	DualConInputReader r(input_mesh, scale);
-	Octree o(&r, alloc_output, add_vert, add_quad,
+	Octree o(&r, alloc_output, add_vert, add_quad, parallel_range,
 	         flags, mode, depth, threshold, hermite_num);
 	o.scanConvert();
 	return o.getOutputMesh();
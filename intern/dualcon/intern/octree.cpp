@@ -46,10 +46,18 @@
 #define dc_printf(...) do {} while (0)
 #endif
 
+/* allocators of the octant tasks start smaller than the main ones,
+   as each only holds part of the tree */
+#define OCTANT_HEAP_BASE 12
+
+/* number of calls made by cellProcContour() on an internal node */
+#define CELL_PROC_CONTOUR_CALLS 26
+
 Octree::Octree(ModelReader *mr,
                DualConAllocOutput alloc_output_func,
                DualConAddVert add_vert_func,
                DualConAddQuad add_quad_func,
+               DualConParallelRange parallel_range_func,
                DualConFlags flags, DualConMode dualcon_mode, int depth,
                float threshold, float sharpness)
 	: use_flood_fill(flags & DUALCON_FLOOD_FILL),
@@ -74,13 +82,15 @@ Octree::Octree(ModelReader *mr,
 	mode(dualcon_mode),
 	alloc_output(alloc_output_func),
 	add_vert(add_vert_func),
-	add_quad(add_quad_func)
+	add_quad(add_quad_func),
+	parallel_range(parallel_range_func)
 {
 	thresh = threshold;
 	reader = mr;
 	dimen = 1 << GRID_DIMENSION;
 	range = reader->getBoundingBox(origin);
 	nodeCount = nodeSpace = 0;
+	octant_mem = NULL;
 	maxDepth = depth;
 	mindimen = (dimen >> maxDepth);
 	minshift = (GRID_DIMENSION - maxDepth);
@@ -206,32 +216,51 @@ void Octree::scanConvert()
 
 void Octree::initMemory()
 {
-	leafalloc[0] = new MemoryAllocator<sizeof(LeafNode)>();
-	leafalloc[1] = new MemoryAllocator<sizeof(LeafNode) + sizeof(float) *EDGE_FLOATS>();
-	leafalloc[2] = new MemoryAllocator<sizeof(LeafNode) + sizeof(float) *EDGE_FLOATS * 2>();
-	leafalloc[3] = new MemoryAllocator<sizeof(LeafNode) + sizeof(float) *EDGE_FLOATS * 3>();
+	initNodeAllocators(mem, HEAP_BASE);
+}
 
-	alloc[0] = new MemoryAllocator<sizeof(InternalNode)>();
-	alloc[1] = new MemoryAllocator<sizeof(InternalNode) + sizeof(Node *)>();
-	alloc[2] = new MemoryAllocator<sizeof(InternalNode) + sizeof(Node *) * 2>();
-	alloc[3] = new MemoryAllocator<sizeof(InternalNode) + sizeof(Node *) * 3>();
-	alloc[4] = new MemoryAllocator<sizeof(InternalNode) + sizeof(Node *) * 4>();
-	alloc[5] = new MemoryAllocator<sizeof(InternalNode) + sizeof(Node *) * 5>();
-	alloc[6] = new MemoryAllocator<sizeof(InternalNode) + sizeof(Node *) * 6>();
-	alloc[7] = new MemoryAllocator<sizeof(InternalNode) + sizeof(Node *) * 7>();
-	alloc[8] = new MemoryAllocator<sizeof(InternalNode) + sizeof(Node *) * 8>();
+void Octree::initNodeAllocators(NodeAllocators& m, int heapbase)
+{
+	m.leafalloc[0] = new MemoryAllocator<sizeof(LeafNode)>(heapbase);
+	m.leafalloc[1] = new MemoryAllocator<sizeof(LeafNode) + sizeof(float) *EDGE_FLOATS>(heapbase);
+	m.leafalloc[2] = new MemoryAllocator<sizeof(LeafNode) + sizeof(float) *EDGE_FLOATS * 2>(heapbase);
+	m.leafalloc[3] = new MemoryAllocator<sizeof(LeafNode) + sizeof(float) *EDGE_FLOATS * 3>(heapbase);
+
+	m.alloc[0] = new MemoryAllocator<sizeof(InternalNode)>(heapbase);
+	m.alloc[1] = new MemoryAllocator<sizeof(InternalNode) + sizeof(Node *)>(heapbase);
+	m.alloc[2] = new MemoryAllocator<sizeof(InternalNode) + sizeof(Node *) * 2>(heapbase);
+	m.alloc[3] = new MemoryAllocator<sizeof(InternalNode) + sizeof(Node *) * 3>(heapbase);
+	m.alloc[4] = new MemoryAllocator<sizeof(InternalNode) + sizeof(Node *) * 4>(heapbase);
+	m.alloc[5] = new MemoryAllocator<sizeof(InternalNode) + sizeof(Node *) * 5>(heapbase);
+	m.alloc[6] = new MemoryAllocator<sizeof(InternalNode) + sizeof(Node *) * 6>(heapbase);
+	m.alloc[7] = new MemoryAllocator<sizeof(InternalNode) + sizeof(Node *) * 7>(heapbase);
+	m.alloc[8] = new MemoryAllocator<sizeof(InternalNode) + sizeof(Node *) * 8>(heapbase);
 }
 
 void Octree::freeMemory()
+{
+	freeNodeAllocators(mem);
+
+	/* nodes from the octant allocators may have been moved to the
+	   main allocators' free lists, so these go last */
+	if (octant_mem) {
+		for (int i = 0; i < 8; i++) {
+			freeNodeAllocators(octant_mem[i]);
+		}
+		delete [] octant_mem;
+	}
+}
+
+void Octree::freeNodeAllocators(NodeAllocators& m)
 {
 	for (int i = 0; i < 9; i++) {
-		alloc[i]->destroy();
-		delete alloc[i];
+		m.alloc[i]->destroy();
+		delete m.alloc[i];
 	}
 
 	for (int i = 0; i < 4; i++) {
-		leafalloc[i]->destroy();
-		delete leafalloc[i];
+		m.leafalloc[i]->destroy();
+		delete m.leafalloc[i];
 	}
 }
 
@@ -240,17 +269,17 @@ void Octree::printMemUsage()
 	int totalbytes = 0;
 	dc_printf("********* Internal nodes: \n");
 	for (int i = 0; i < 9; i++) {
-		alloc[i]->printInfo();
+		mem.alloc[i]->printInfo();
 
-		totalbytes += alloc[i]->getAll() * alloc[i]->getBytes();
+		totalbytes += mem.alloc[i]->getAll() * mem.alloc[i]->getBytes();
 	}
 	dc_printf("********* Leaf nodes: \n");
 	int totalLeafs = 0;
 	for (int i = 0; i < 4; i++) {
-		leafalloc[i]->printInfo();
+		mem.leafalloc[i]->printInfo();
 
-		totalbytes += leafalloc[i]->getAll() * leafalloc[i]->getBytes();
-		totalLeafs += leafalloc[i]->getAllocated();
+		totalbytes += mem.leafalloc[i]->getAll() * mem.leafalloc[i]->getBytes();
+		totalLeafs += mem.leafalloc[i]->getAllocated();
 	}
 
 	dc_printf("Total allocated bytes on disk: %d \n", totalbytes);
@@ -275,6 +304,11 @@ void Octree::addAllTriangles()
 
 	srand(0);
 
+	if (parallel_range && maxDepth >= 2) {
+		addAllTrianglesParallel();
+		return;
+	}
+
 	while ((trian = reader->getNextTriangle()) != NULL) {
 		// Drop triangles
 		{
@@ -324,30 +358,131 @@ void Octree::addAllTriangles()
 /* Prepare a triangle for insertion into the octree; call the other
    addTriangle() to (recursively) build the octree */
 void Octree::addTriangle(Triangle *trian, int triind)
+{
+	/* Generate projections */
+	int64_t cube[2][3] = {{0, 0, 0}, {dimen, dimen, dimen}};
+	int64_t trig[3][3];
+	projectTriangle(trian, trig);
+
+	/* Add triangle to the octree */
+	int64_t errorvec = (int64_t)(0);
+	CubeTriangleIsect *proj = new CubeTriangleIsect(cube, trig, errorvec, triind);
+	root = (Node *)addTriangle(mem, &root->internal, proj, maxDepth);
+
+	delete proj->inherit;
+	delete proj;
+}
+
+/* Project the triangle's coordinates into the grid */
+void Octree::projectTriangle(Triangle *trian, int64_t trig[3][3])
 {
 	int i, j;
 
-	/* Project the triangle's coordinates into the grid */
 	for (i = 0; i < 3; i++) {
 		for (j = 0; j < 3; j++)
 			trian->vt[i][j] = dimen * (trian->vt[i][j] - origin[j]) / range;
 	}
 
-	/* Generate projections */
-	int64_t cube[2][3] = {{0, 0, 0}, {dimen, dimen, dimen}};
-	int64_t trig[3][3];
 	for (i = 0; i < 3; i++) {
 		for (j = 0; j < 3; j++)
 			trig[i][j] = (int64_t)(trian->vt[i][j]);
 	}
+}
 
-	/* Add triangle to the octree */
-	int64_t errorvec = (int64_t)(0);
-	CubeTriangleIsect *proj = new CubeTriangleIsect(cube, trig, errorvec, triind);
-	root = (Node *)addTriangle(&root->internal, proj, maxDepth);
+/* Build the subtrees of the root's octants in parallel, then attach
+   them to the root. Each octant sees the triangles in the same order
+   as addAllTriangles() would add them, so the tree is the same as the
+   one built serially. */
+void Octree::addAllTrianglesParallel()
+{
+	Triangle *trian;
+	int i;
 
-	delete proj->inherit;
-	delete proj;
+	/* Read and project all triangles up front, the octant tasks
+	   each go over the whole list */
+	scan_trigs = (int64_t (*)[3][3])malloc(sizeof(*scan_trigs) * reader->getNumTriangles());
+	scan_numtrigs = 0;
+
+	while ((trian = reader->getNextTriangle()) != NULL) {
+		projectTriangle(trian, scan_trigs[scan_numtrigs]);
+		delete trian;
+
+		scan_numtrigs++;
+	}
+
+	octant_mem = new NodeAllocators[8];
+	for (i = 0; i < 8; i++) {
+		initNodeAllocators(octant_mem[i], OCTANT_HEAP_BASE);
+		scan_octants[i] = createInternal(octant_mem[i], 0);
+		scan_octant_used[i] = 0;
+	}
+
+	parallel_range(8, this, addOctantTrianglesFunc);
+
+	/* The root is still empty here, add the octants in order */
+	int count = 0;
+	for (i = 0; i < 8; i++) {
+		if (scan_octant_used[i]) {
+			root = (Node *)addInternalChild(&root->internal, i, count, scan_octants[i]);
+			count++;
+		}
+		else {
+			removeInternal(octant_mem[i], 0, scan_octants[i]);
+		}
+	}
+
+	free(scan_trigs);
+	scan_trigs = NULL;
+}
+
+void Octree::addOctantTrianglesFunc(void *userdata, int octant)
+{
+	((Octree *)userdata)->addOctantTriangles(octant);
+}
+
+void Octree::addOctantTriangles(int octant)
+{
+	NodeAllocators& m = octant_mem[octant];
+	InternalNode *node = scan_octants[octant];
+	int64_t cube[2][3] = {{0, 0, 0}, {dimen, dimen, dimen}};
+	const int64_t mid = dimen >> 1;
+	int off[3] = {vertmap[octant][0], vertmap[octant][1], vertmap[octant][2]};
+
+	for (int t = 0; t < scan_numtrigs; t++) {
+		int64_t (*trig)[3] = scan_trigs[t];
+		int j;
+
+		/* Skip triangles outside of the octant's bounding box before
+		   computing their projections, same test as getBoxMask() */
+		for (j = 0; j < 3; j++) {
+			if (off[j]) {
+				if (trig[0][j] <= mid && trig[1][j] <= mid && trig[2][j] <= mid)
+					break;
+			}
+			else {
+				if (trig[0][j] > mid && trig[1][j] > mid && trig[2][j] > mid)
+					break;
+			}
+		}
+		if (j != 3)
+			continue;
+
+		CubeTriangleIsect proj(cube, trig, (int64_t)0, t);
+
+		if (proj.getBoxMask() & (1 << octant)) {
+			CubeTriangleIsect subp(&proj);
+			subp.shift(off);
+
+			if (subp.isIntersecting()) {
+				node = addTriangle(m, node, &subp, maxDepth - 1);
+				scan_octant_used[octant] = 1;
+			}
+		}
+
+		delete proj.inherit;
+	}
+
+	scan_octants[octant] = node;
 }
 
 #if 0
@@ -358,7 +493,7 @@ static void print_depth(int height, int maxDepth)
 }
 #endif
 
-InternalNode *Octree::addTriangle(InternalNode *node, CubeTriangleIsect *p, int height)
+InternalNode *Octree::addTriangle(NodeAllocators& m, InternalNode *node, CubeTriangleIsect *p, int height)
 {
 	int i;
 	const int vertdiff[8][3] = {
@@ -391,16 +526,16 @@ InternalNode *Octree::addTriangle(InternalNode *node, CubeTriangleIsect *p, int
 			if (subp->isIntersecting()) {
 				if (!node->has_child(i)) {
 					if (height == 1)
-						node = addLeafChild(node, i, count, createLeaf(0));
+						node = addLeafChild(m, node, i, count, createLeaf(m, 0));
 					else
-						node = addInternalChild(node, i, count, createInternal(0));
+						node = addInternalChild(m, node, i, count, createInternal(m, 0));
 				}
 				Node *chd = node->get_child(count);
 
 				if (node->is_child_leaf(i))
-					node->set_child(count, (Node *)updateCell(&chd->leaf, subp));
+					node->set_child(count, (Node *)updateCell(m, &chd->leaf, subp));
 				else
-					node->set_child(count, (Node *)addTriangle(&chd->internal, subp, height - 1));
+					node->set_child(count, (Node *)addTriangle(m, &chd->internal, subp, height - 1));
 			}
 		}
 
@@ -413,7 +548,7 @@ InternalNode *Octree::addTriangle(InternalNode *node, CubeTriangleIsect *p, int
 	return node;
 }
 
-LeafNode *Octree::updateCell(LeafNode *node, CubeTriangleIsect *p)
+LeafNode *Octree::updateCell(NodeAllocators& m, LeafNode *node, CubeTriangleIsect *p)
 {
 	int i;
 
@@ -445,7 +580,7 @@ LeafNode *Octree::updateCell(LeafNode *node, CubeTriangleIsect *p)
 
 	if (newc > oldc) {
 		// New offsets added, update this node
-		node = updateEdgeOffsetsNormals(node, oldc, newc, offs, a, b, c);
+		node = updateEdgeOffsetsNormals(m, node, oldc, newc, offs, a, b, c);
 	}
 
 	return node;
@@ -2064,7 +2199,10 @@ void Octree::writeOut()
 	actualQuads = 0;
 
 	generateMinimizer(root, st, dimen, maxDepth, offset);
-	cellProcContour(root, 0, maxDepth);
+	if (parallel_range)
+		cellProcContourParallel();
+	else
+		cellProcContour(root, 0, maxDepth, NULL);
 	dc_printf("Vertices written: %d Quads written: %d \n", offset, actualQuads);
 }
 
@@ -2317,7 +2455,22 @@ void Octree::generateMinimizer(Node *node, int st[3], int len, int height, int&
 	}
 }
 
-void Octree::processEdgeWrite(Node *node[4], int /*depth*/[4], int /*maxdep*/, int dir)
+static void quad_buffer_add(QuadBuffer *quads, const int ind[4])
+{
+	if (quads->totquad == quads->allocquad) {
+		quads->allocquad = quads->allocquad ? quads->allocquad * 2 : 256;
+		quads->indices = (int *)realloc(quads->indices, sizeof(int) * 4 * quads->allocquad);
+	}
+
+	int *dst = quads->indices + quads->totquad * 4;
+	dst[0] = ind[0];
+	dst[1] = ind[1];
+	dst[2] = ind[2];
+	dst[3] = ind[3];
+	quads->totquad++;
+}
+
+void Octree::processEdgeWrite(Node *node[4], int /*depth*/[4], int /*maxdep*/, int dir, QuadBuffer *quads)
 {
 	//int color = 0;
 
@@ -2369,7 +2522,10 @@ void Octree::processEdgeWrite(Node *node[4], int /*depth*/[4], int /*maxdep*/, i
 						ind[3] = getMinimizerIndex((LeafNode *)(node[2]));
 					}
 
-					add_quad(output_mesh, ind);
+					if (quads)
+						quad_buffer_add(quads, ind);
+					else
+						add_quad(output_mesh, ind);
 				}
 			}
 			return;
@@ -2381,13 +2537,13 @@ void Octree::processEdgeWrite(Node *node[4], int /*depth*/[4], int /*maxdep*/, i
 }
 
 
-void Octree::edgeProcContour(Node *node[4], int leaf[4], int depth[4], int maxdep, int dir)
+void Octree::edgeProcContour(Node *node[4], int leaf[4], int depth[4], int maxdep, int dir, QuadBuffer *quads)
 {
 	if (!(node[0] && node[1] && node[2] && node[3])) {
 		return;
 	}
 	if (leaf[0] && leaf[1] && leaf[2] && leaf[3]) {
-		processEdgeWrite(node, depth, maxdep, dir);
+		processEdgeWrite(node, depth, maxdep, dir, quads);
 	}
 	else {
 		int i, j;
@@ -2423,13 +2579,13 @@ void Octree::edgeProcContour(Node *node[4], int leaf[4], int depth[4], int maxde
 				}
 			}
 
-			edgeProcContour(ne, le, de, maxdep - 1, edgeProcEdgeMask[dir][i][4]);
+			edgeProcContour(ne, le, de, maxdep - 1, edgeProcEdgeMask[dir][i][4], quads);
 		}
 
 	}
 }
 
-void Octree::faceProcContour(Node *node[2], int leaf[2], int depth[2], int maxdep, int dir)
+void Octree::faceProcContour(Node *node[2], int leaf[2], int depth[2], int maxdep, int dir, QuadBuffer *quads)
 {
 	if (!(node[0] && node[1])) {
 		return;
@@ -2465,7 +2621,7 @@ void Octree::faceProcContour(Node *node[2], int leaf[2], int depth[2], int maxde
 					df[j] = depth[j] - 1;
 				}
 			}
-			faceProcContour(nf, lf, df, maxdep - 1, faceProcFaceMask[dir][i][2]);
+			faceProcContour(nf, lf, df, maxdep - 1, faceProcFaceMask[dir][i][2], quads);
 		}
 
 		// 4 edge calls
@@ -2492,13 +2648,13 @@ void Octree::faceProcContour(Node *node[2], int leaf[2], int depth[2], int maxde
 				}
 			}
 
-			edgeProcContour(ne, le, de, maxdep - 1, faceProcEdgeMask[dir][i][5]);
+			edgeProcContour(ne, le, de, maxdep - 1, faceProcEdgeMask[dir][i][5], quads);
 		}
 	}
 }
 
 
-void Octree::cellProcContour(Node *node, int leaf, int depth)
+void Octree::cellProcContour(Node *node, int leaf, int depth, QuadBuffer *quads)
 {
 	if (node == NULL) {
 		return;
@@ -2514,43 +2670,79 @@ void Octree::cellProcContour(Node *node, int leaf, int depth)
 			         node->internal.get_child(node->internal.get_child_count(i)) : NULL;
 		}
 
-		// 8 Cell calls
-		for (i = 0; i < 8; i++) {
-			cellProcContour(chd[i], node->internal.is_child_leaf(i), depth - 1);
+		for (i = 0; i < CELL_PROC_CONTOUR_CALLS; i++) {
+			cellProcContourCall(node, chd, depth, i, quads);
 		}
+	}
 
-		// 12 face calls
-		Node *nf[2];
-		int lf[2];
-		int df[2] = {depth - 1, depth - 1};
-		for (i = 0; i < 12; i++) {
-			int c[2] = {cellProcFaceMask[i][0], cellProcFaceMask[i][1]};
-
-			lf[0] = node->internal.is_child_leaf(c[0]);
-			lf[1] = node->internal.is_child_leaf(c[1]);
-
-			nf[0] = chd[c[0]];
-			nf[1] = chd[c[1]];
+}
 
-			faceProcContour(nf, lf, df, depth - 1, cellProcFaceMask[i][2]);
-		}
+/* Calls made by cellProcContour() on an internal node, in order: 8 cell
+   calls, 12 face calls then 6 edge calls */
+void Octree::cellProcContourCall(Node *node, Node *chd[8], int depth, int call, QuadBuffer *quads)
+{
+	if (call < 8) {
+		cellProcContour(chd[call], node->internal.is_child_leaf(call), depth - 1, quads);
+	}
+	else if (call < 20) {
+		const int i = call - 8;
+		int c[2] = {cellProcFaceMask[i][0], cellProcFaceMask[i][1]};
+		Node *nf[2] = {chd[c[0]], chd[c[1]]};
+		int lf[2] = {node->internal.is_child_leaf(c[0]), node->internal.is_child_leaf(c[1])};
+		int df[2] = {depth - 1, depth - 1};
 
-		// 6 edge calls
+		faceProcContour(nf, lf, df, depth - 1, cellProcFaceMask[i][2], quads);
+	}
+	else {
+		const int i = call - 20;
+		int c[4] = {cellProcEdgeMask[i][0], cellProcEdgeMask[i][1], cellProcEdgeMask[i][2], cellProcEdgeMask[i][3]};
 		Node *ne[4];
 		int le[4];
 		int de[4] = {depth - 1, depth - 1, depth - 1, depth - 1};
-		for (i = 0; i < 6; i++) {
-			int c[4] = {cellProcEdgeMask[i][0], cellProcEdgeMask[i][1], cellProcEdgeMask[i][2], cellProcEdgeMask[i][3]};
 
-			for (int j = 0; j < 4; j++) {
-				le[j] = node->internal.is_child_leaf(c[j]);
-				ne[j] = chd[c[j]];
-			}
+		for (int j = 0; j < 4; j++) {
+			le[j] = node->internal.is_child_leaf(c[j]);
+			ne[j] = chd[c[j]];
+		}
 
-			edgeProcContour(ne, le, de, depth - 1, cellProcEdgeMask[i][4]);
+		edgeProcContour(ne, le, de, depth - 1, cellProcEdgeMask[i][4], quads);
+	}
+}
+
+/* Each call made on the root collects its quads in its own buffer, the
+   buffers are then output in the order cellProcContour() uses. */
+void Octree::cellProcContourParallel()
+{
+	int i;
+
+	for (i = 0; i < 8; i++) {
+		contour_chd[i] = root->internal.has_child(i) ?
+		                 root->internal.get_child(root->internal.get_child_count(i)) : NULL;
+	}
+
+	contour_quads = (QuadBuffer *)calloc(CELL_PROC_CONTOUR_CALLS, sizeof(QuadBuffer));
+
+	parallel_range(CELL_PROC_CONTOUR_CALLS, this, cellProcContourRootFunc);
+
+	for (i = 0; i < CELL_PROC_CONTOUR_CALLS; i++) {
+		QuadBuffer *quads = &contour_quads[i];
+
+		for (int j = 0; j < quads->totquad; j++) {
+			add_quad(output_mesh, quads->indices + j * 4);
 		}
+		free(quads->indices);
 	}
 
+	free(contour_quads);
+	contour_quads = NULL;
+}
+
+void Octree::cellProcContourRootFunc(void *userdata, int call)
+{
+	Octree *octree = (Octree *)userdata;
+
+	octree->cellProcContourCall(octree->root, octree->contour_chd, octree->maxDepth, call,
+	                            &octree->contour_quads[call]);
 }
 
 void Octree::processEdgeParity(LeafNode *node[4], int /*depth*/[4], int /*maxdep*/, int dir)
@@ -222,6 +222,24 @@ struct PathList {
 	PathList *next;
 };
 
+/**
+ * Memory allocators for internal nodes (by number of children) and
+ * leaf nodes (by number of stored edge intersections)
+ */
+struct NodeAllocators {
+	VirtualMemoryAllocator *alloc[9];
+	VirtualMemoryAllocator *leafalloc[4];
+};
+
+/**
+ * Growable array of quads, used to collect the output of a contouring
+ * task before it is passed on to the add_quad callback
+ */
+struct QuadBuffer {
+	int *indices;
+	int totquad;
+	int allocquad;
+};
 
 /**
  * Class for building and processing an octree
@@ -232,8 +250,11 @@ class Octree
 	/* Public members */
 
 	/// Memory allocators
-	VirtualMemoryAllocator *alloc[9];
-	VirtualMemoryAllocator *leafalloc[4];
+	NodeAllocators mem;
+
+	/// Memory allocators used by the tasks scan converting the root's
+	/// octants in parallel, freed along with the main ones
+	NodeAllocators *octant_mem;
 
 	/// Root node
 	Node *root;
@@ -285,6 +306,7 @@ class Octree
 		   DualConAllocOutput alloc_output_func,
 		   DualConAddVert add_vert_func,
 		   DualConAddQuad add_quad_func,
+		   DualConParallelRange parallel_range_func,
 		   DualConFlags flags, DualConMode mode, int depth,
 		   float threshold, float hermite_num);
 
@@ -309,11 +331,13 @@ class Octree
 	 * Initialize memory allocators
 	 */
 	void initMemory();
+	void initNodeAllocators(NodeAllocators& m, int heapbase);
 
 	/**
 	 * Release memory
 	 */
 	void freeMemory();
+	void freeNodeAllocators(NodeAllocators& m);
 
 	/**
 	 * Print memory usage
@@ -337,12 +361,27 @@ class Octree
 	 */
 	void addAllTriangles();
 	void addTriangle(Triangle *trian, int triind);
-	InternalNode *addTriangle(InternalNode *node, CubeTriangleIsect *p, int height);
+	InternalNode *addTriangle(NodeAllocators& m, InternalNode *node, CubeTriangleIsect *p, int height);
+	void projectTriangle(Triangle *trian, int64_t trig[3][3]);
+
+	/**
+	 * Scan convert the triangles into each octant of the root node
+	 * in parallel, each octant using its own memory allocators
+	 */
+	void addAllTrianglesParallel();
+	void addOctantTriangles(int octant);
+	static void addOctantTrianglesFunc(void *userdata, int octant);
+
+	/// Projected triangles and octant subtrees of addAllTrianglesParallel()
+	int64_t (*scan_trigs)[3][3];
+	int scan_numtrigs;
+	InternalNode *scan_octants[8];
+	int scan_octant_used[8];
 
 	/**
 	 * Method to update minimizer in a cell: update edge intersections instead
 	 */
-	LeafNode *updateCell(LeafNode *node, CubeTriangleIsect *p);
+	LeafNode *updateCell(NodeAllocators& m, LeafNode *node, CubeTriangleIsect *p);
 
 	/* Routines to detect and patch holes */
 	int numRings;
@@ -427,16 +466,29 @@ class Octree
 	/**
 	 * Traversal functions to generate polygon model
 	 * op: 0 for counting, 1 for writing OBJ, 2 for writing OFF, 3 for writing PLY
+	 * quads: if non-NULL, quads are appended to it instead of passed to add_quad
 	 */
-	void cellProcContour(Node *node, int leaf, int depth);
-	void faceProcContour(Node * node[2], int leaf[2], int depth[2], int maxdep, int dir);
-	void edgeProcContour(Node * node[4], int leaf[4], int depth[4], int maxdep, int dir);
-	void processEdgeWrite(Node * node[4], int depths[4], int maxdep, int dir);
+	void cellProcContour(Node *node, int leaf, int depth, QuadBuffer *quads);
+	void cellProcContourCall(Node *node, Node *chd[8], int depth, int call, QuadBuffer *quads);
+	void faceProcContour(Node * node[2], int leaf[2], int depth[2], int maxdep, int dir, QuadBuffer *quads);
+	void edgeProcContour(Node * node[4], int leaf[4], int depth[4], int maxdep, int dir, QuadBuffer *quads);
+	void processEdgeWrite(Node * node[4], int depths[4], int maxdep, int dir, QuadBuffer *quads);
+
+	/**
+	 * Contour the calls made by cellProcContour() on the root node in
+	 * parallel, then output their quads in the serial order
+	 */
+	void cellProcContourParallel();
+	static void cellProcContourRootFunc(void *userdata, int call);
+
+	Node *contour_chd[8];
+	QuadBuffer *contour_quads;
 
 	/* output callbacks/data */
 	DualConAllocOutput alloc_output;
 	DualConAddVert add_vert;
 	DualConAddQuad add_quad;
+	DualConParallelRange parallel_range;
 	void *output_mesh;
 
  private:
@@ -1143,17 +1195,17 @@ class Octree
 
 
 	/// Update method
-	LeafNode *updateEdgeOffsetsNormals(LeafNode *leaf, int oldlen, int newlen, float offs[3], float a[3], float b[3], float c[3])
+	LeafNode *updateEdgeOffsetsNormals(NodeAllocators& m, LeafNode *leaf, int oldlen, int newlen, float offs[3], float a[3], float b[3], float c[3])
 	{
 		// First, create a new leaf node
-		LeafNode *nleaf = createLeaf(newlen);
+		LeafNode *nleaf = createLeaf(m, newlen);
 		*nleaf = *leaf;
 
 		// Next, fill in the offsets
 		setEdgeOffsetsNormals(nleaf, offs, a, b, c, newlen);
 
 		// Finally, delete the old leaf
-		removeLeaf(oldlen, leaf);
+		removeLeaf(m, oldlen, leaf);
 
 		return nleaf;
 	}
@@ -1307,19 +1359,24 @@ class Octree
 	}
 
 	/// Allocate a node
-	InternalNode *createInternal(int length)
+	InternalNode *createInternal(NodeAllocators& m, int length)
 	{
-		InternalNode *inode = (InternalNode *)alloc[length]->allocate();
+		InternalNode *inode = (InternalNode *)m.alloc[length]->allocate();
 		inode->has_child_bitfield = 0;
 		inode->child_is_leaf_bitfield = 0;
 		return inode;
 	}
 
-	LeafNode *createLeaf(int length)
+	InternalNode *createInternal(int length)
+	{
+		return createInternal(mem, length);
+	}
+
+	LeafNode *createLeaf(NodeAllocators& m, int length)
 	{
 		assert(length <= 3);
 
-		LeafNode *lnode = (LeafNode *)leafalloc[length]->allocate();
+		LeafNode *lnode = (LeafNode *)m.leafalloc[length]->allocate();
 		lnode->edge_parity = 0;
 		lnode->primary_edge_intersections = 0;
 		lnode->signs = 0;
@@ -1327,23 +1384,38 @@ class Octree
 		return lnode;
 	}
 
+	LeafNode *createLeaf(int length)
+	{
+		return createLeaf(mem, length);
+	}
+
+	void removeInternal(NodeAllocators& m, int num, InternalNode *node)
+	{
+		m.alloc[num]->deallocate(node);
+	}
+
 	void removeInternal(int num, InternalNode *node)
 	{
-		alloc[num]->deallocate(node);
+		removeInternal(mem, num, node);
 	}
 
-	void removeLeaf(int num, LeafNode *leaf)
+	void removeLeaf(NodeAllocators& m, int num, LeafNode *leaf)
 	{
 		assert(num >= 0 && num <= 3);
-		leafalloc[num]->deallocate(leaf);
+		m.leafalloc[num]->deallocate(leaf);
+	}
+
+	void removeLeaf(int num, LeafNode *leaf)
+	{
+		removeLeaf(mem, num, leaf);
 	}
 
 	/// Add a leaf (by creating a new par node with the leaf added)
-	InternalNode *addLeafChild(InternalNode *par, int index, int count,
+	InternalNode *addLeafChild(NodeAllocators& m, InternalNode *par, int index, int count,
 							   LeafNode *leaf)
 	{
 		int num = par->get_num_children() + 1;
-		InternalNode *npar = createInternal(num);
+		InternalNode *npar = createInternal(m, num);
 		*npar = *par;
 
 		if (num == 1) {
@@ -1360,15 +1432,21 @@ class Octree
 			}
 		}
 
-		removeInternal(num - 1, par);
+		removeInternal(m, num - 1, par);
 		return npar;
 	}
 
-	InternalNode *addInternalChild(InternalNode *par, int index, int count,
+	InternalNode *addLeafChild(InternalNode *par, int index, int count,
+							   LeafNode *leaf)
+	{
+		return addLeafChild(mem, par, index, count, leaf);
+	}
+
+	InternalNode *addInternalChild(NodeAllocators& m, InternalNode *par, int index, int count,
 								   InternalNode *node)
 	{
 		int num = par->get_num_children() + 1;
-		InternalNode *npar = createInternal(num);
+		InternalNode *npar = createInternal(m, num);
 		*npar = *par;
 
 		if (num == 1) {
@@ -1385,10 +1463,16 @@ class Octree
 			}
 		}
 
-		removeInternal(num - 1, par);
+		removeInternal(m, num - 1, par);
 		return npar;
 	}
 
+	InternalNode *addInternalChild(InternalNode *par, int index, int count,
+								   InternalNode *node)
+	{
+		return addInternalChild(mem, par, index, count, node);
+	}
+
 #ifdef WITH_CXX_GUARDEDALLOC
 	MEM_CXX_CLASS_ALLOC_FUNCS("DUALCON:Octree")
 #endif
@@ -45,6 +45,10 @@ class DATA_PT_modifiers(ModifierButtonsPanel, Panel):
                 # match enum type to our functions, avoids a lookup table.
                 getattr(self, md.type)(box, ob, md)
 
+                if ob.type == 'MESH':
+                    box.separator()
+                    box.prop(md, "use_cache_result")
+
     # the mt.type enum is (ab)used for a lookup on function names
     # ...to avoid lengthy if statements
     # so each type must have a function here.
@@ -326,6 +330,9 @@ class DATA_PT_modifiers(ModifierButtonsPanel, Panel):
             row = col.split(percentage=0.75)
             row.prop(md, "use_symmetry")
             row.prop(md, "symmetry_axis", text="")
+            row = col.row()
+            row.active = not md.use_symmetry
+            row.prop(md, "use_collapse_partition")
 
         elif decimate_type == 'UNSUBDIV':
             layout.prop(md, "iterations")
@@ -166,7 +166,11 @@ IFACEMETHODIMP CBlendThumb::GetThumbnail(UINT cx, HBITMAP *phbmp, WTS_ALPHATYPE
 		// Do the inflation
 		int err;
 		err = inflateInit2(&stream,16); // 16 means "gzip"...nice!
-		err = inflate(&stream, Z_FINISH);		
+		// Files are saved as a sequence of gzip members, inflate them one after the other.
+		while ((err = inflate(&stream, Z_FINISH)) == Z_STREAM_END && stream.avail_in > 0 && stream.avail_out > 0) {
+			if (inflateReset(&stream) != Z_OK)
+				break;
+		}
 		err = inflateEnd(&stream);
 				
 		// Replace the IStream, which is read-only
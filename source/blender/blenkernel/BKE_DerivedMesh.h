@@ -621,6 +621,7 @@ void DM_free_loop_data(struct DerivedMesh *dm, int index, int count);
 void DM_free_poly_data(struct DerivedMesh *dm, int index, int count);
 
 /*sets up mpolys for a DM based on face iterators in source*/
+void DM_DupPolys_ex(DerivedMesh *source, DerivedMesh *target, const int alloctype);
 void DM_DupPolys(DerivedMesh *source, DerivedMesh *target);
 
 void DM_ensure_normals(DerivedMesh *dm);
@@ -735,6 +736,8 @@ DerivedMesh *editbmesh_get_derived_cage_and_final(
 
 DerivedMesh *object_get_derived_final(struct Object *ob, const bool for_render);
 
+void DM_modifier_cache_free(struct Object *ob);
+
 float (*editbmesh_get_vertex_cos(struct BMEditMesh *em, int *r_numVerts))[3];
 bool editbmesh_modifier_is_enabled(struct Scene *scene, struct ModifierData *md, DerivedMesh *dm);
 void makeDerivedMesh(
@@ -37,6 +37,8 @@ struct Path;
 struct Object;
 struct Scene;
 struct ListBase;
+struct DupliObject;
+struct ParticleSystem;
 struct bAnimVizSettings;
 struct bMotionPath;
 struct bPoseChannel;
@@ -84,4 +86,45 @@ DupliApplyData *duplilist_apply(struct Object *ob, struct Scene *scene, struct L
 void duplilist_restore(struct ListBase *duplilist, DupliApplyData *apply_data);
 void duplilist_free_apply_data(DupliApplyData *apply_data);
 
+/* Dupli instance table, the compact alternative to the DupliObject list */
+
+typedef struct DupliInstance {
+	struct Object *ob;
+	struct ParticleSystem *particle_system;  /* particle this dupli was generated from */
+	float mat[4][3];  /* DupliObject.mat without its last row, which is always (0, 0, 0, 1) */
+	float orco[3], uv[2];
+	unsigned int random_id;
+	int persistent_id[8];  /* MAX_DUPLI_RECUR */
+	short type;  /* from Object.transflag */
+	char no_draw, animated;
+} DupliInstance;
+
+typedef struct DupliTable {
+	DupliInstance *instances;
+	int totinstance, maxinstance;
+
+	/* what the instances were generated for, to know when a cached table is still valid */
+	struct Scene *scene;
+	struct Object *obedit;
+	unsigned int lay;
+	int eval_mode;
+	float ctime;
+	unsigned int update_id;
+} DupliTable;
+
+#define DUPLI_TABLE_ITER(inst, table) \
+	for ((inst) = (table)->instances; (inst) != (table)->instances + (table)->totinstance; (inst)++)
+
+struct DupliTable *object_dupli_table_ex(struct EvaluationContext *eval_ctx, struct Scene *sce, struct Object *ob, bool update);
+struct DupliTable *object_dupli_table_cached(struct EvaluationContext *eval_ctx, struct Scene *sce, struct Object *ob);
+void free_object_dupli_table(struct DupliTable *table);
+void object_dupli_cache_free(struct Object *ob);
+void object_dupli_cache_tag_update(void);
+
+void dupli_instance_mat_get(const DupliInstance *inst, float r_mat[4][4]);
+void dupli_instance_to_dupli_object(const DupliInstance *inst, struct DupliObject *r_dob);
+
+DupliApplyData *dupli_table_apply(struct Object *ob, struct Scene *scene, const DupliTable *table);
+void dupli_table_restore(const DupliTable *table, DupliApplyData *apply_data);
+
 #endif
@@ -78,6 +78,9 @@ DerivedMesh *CDDM_from_curve_displist(struct Object *ob, struct ListBase *dispba
  * custom element data.
  */
 struct DerivedMesh *CDDM_copy(struct DerivedMesh *dm);
+/* Same as CDDM_copy, but mesh layers are shared with dm until duplicated for writing,
+ * see CD_SHARE. */
+struct DerivedMesh *CDDM_copy_shared(struct DerivedMesh *dm);
 struct DerivedMesh *CDDM_copy_from_tessface(struct DerivedMesh *dm);
 struct DerivedMesh *CDDM_copy_with_tessface(struct DerivedMesh *dm);
 
@@ -73,6 +73,9 @@ extern const CustomDataMask CD_MASK_EVERYTHING;
 #define CD_REFERENCE 3  /* use data pointers, set layer flag NOFREE */
 #define CD_DUPLICATE 4  /* do a full copy of all layers, only allowed if source
                          * has same number of elements */
+#define CD_SHARE     5  /* share the data of mesh layers until duplicated for writing
+                         * (like referenced layers), only allowed if source has same
+                         * number of elements */
 
 #define CD_TYPE_AS_MASK(_type) (CustomDataMask)((CustomDataMask)1 << (CustomDataMask)(_type))
 
@@ -342,6 +345,7 @@ void CustomData_set_layer_stencil_index(struct CustomData *data, int type, int n
 /* adds flag to the layer flags */
 void CustomData_set_layer_flag(struct CustomData *data, int type, int flag);
 
+void CustomData_bmesh_alloc_block(struct CustomData *data, void **block);
 void CustomData_bmesh_set_default(struct CustomData *data, void **block);
 void CustomData_bmesh_free_block(struct CustomData *data, void **block);
 void CustomData_bmesh_free_block_data(struct CustomData *data, void *block);
@@ -76,6 +76,8 @@ static CCGVert *_vert_new(CCGVertHDL vHDL, CCGSubSurf *ss)
 	v->numEdges = v->numFaces = 0;
 	v->flags = 0;
 
+	ccgSubSurf__stencils_free(ss);
+
 	userData = ccgSubSurf_getVertUserData(ss, v);
 	memset(userData, 0, ss->meshIFC.vertUserSize);
 	if (ss->useAgeCounts) *((int *) &userData[ss->vertUserAgeOffset]) = ss->currentAge;
@@ -127,6 +129,8 @@ static CCGEdge *_vert_findEdgeTo(const CCGVert *v, const CCGVert *vQ)
 }
 static void _vert_free(CCGVert *v, CCGSubSurf *ss)
 {
+	ccgSubSurf__stencils_free(ss);
+
 	if (v->edges) {
 		CCGSUBSURF_free(ss, v->edges);
 	}
@@ -159,6 +163,8 @@ static CCGEdge *_edge_new(CCGEdgeHDL eHDL, CCGVert *v0, CCGVert *v1, float creas
 	_vert_addEdge(v0, e, ss);
 	_vert_addEdge(v1, e, ss);
 
+	ccgSubSurf__stencils_free(ss);
+
 	userData = ccgSubSurf_getEdgeUserData(ss, e);
 	memset(userData, 0, ss->meshIFC.edgeUserSize);
 	if (ss->useAgeCounts) *((int *) &userData[ss->edgeUserAgeOffset]) = ss->currentAge;
@@ -193,6 +199,8 @@ static void *_edge_getCoVert(CCGEdge *e, CCGVert *v, int lvl, int x, int dataSiz
 
 static void _edge_free(CCGEdge *e, CCGSubSurf *ss)
 {
+	ccgSubSurf__stencils_free(ss);
+
 	if (e->faces) {
 		CCGSUBSURF_free(ss, e->faces);
 	}
@@ -233,6 +241,8 @@ static CCGFace *_face_new(CCGFaceHDL fHDL, CCGVert **verts, CCGEdge **edges, int
 		_edge_addFace(edges[i], f, ss);
 	}
 
+	ccgSubSurf__stencils_free(ss);
+
 	userData = ccgSubSurf_getFaceUserData(ss, f);
 	memset(userData, 0, ss->meshIFC.faceUserSize);
 	if (ss->useAgeCounts) *((int *) &userData[ss->faceUserAgeOffset]) = ss->currentAge;
@@ -241,6 +251,8 @@ static CCGFace *_face_new(CCGFaceHDL fHDL, CCGVert **verts, CCGEdge **edges, int
 }
 static void _face_free(CCGFace *f, CCGSubSurf *ss)
 {
+	ccgSubSurf__stencils_free(ss);
+
 	CCGSUBSURF_free(ss, f);
 }
 static void _face_unlinkMarkAndFree(CCGFace *f, CCGSubSurf *ss)
@@ -304,6 +316,9 @@ CCGSubSurf *ccgSubSurf_new(CCGMeshIFC *ifc, int subdivLevels, CCGAllocatorIFC *a
 		ss->tempVerts = NULL;
 		ss->tempEdges = NULL;
 
+		ss->stencils = NULL;
+		ss->numStableSyncs = 0;
+
 #ifdef WITH_OPENSUBDIV
 		ss->osd_evaluator = NULL;
 		ss->osd_mesh = NULL;
@@ -362,6 +377,8 @@ void ccgSubSurf_free(CCGSubSurf *ss)
 	ccg_ehash_free(ss->eMap, (EHEntryFreeFP) _edge_free, ss);
 	ccg_ehash_free(ss->vMap, (EHEntryFreeFP) _vert_free, ss);
 
+	ccgSubSurf__stencils_free(ss);
+
 	CCGSUBSURF_free(ss, ss);
 
 	if (allocatorIFC.release) {
@@ -411,6 +428,7 @@ CCGError ccgSubSurf_setSubdivisionLevels(CCGSubSurf *ss, int subdivisionLevels)
 		ss->vMap = ccg_ehash_new(0, &ss->allocatorIFC, ss->allocator);
 		ss->eMap = ccg_ehash_new(0, &ss->allocatorIFC, ss->allocator);
 		ss->fMap = ccg_ehash_new(0, &ss->allocatorIFC, ss->allocator);
+		ccgSubSurf__stencils_free(ss);
 	}
 
 	return eCCGError_None;
@@ -1248,6 +1266,12 @@ int ccgSubSurf_getSimpleSubdiv(const CCGSubSurf *ss)
 	return ss->meshIFC.simpleSubdiv;
 }
 
+/* Whether the precomputed weights of CCGSubSurf_stencil.c are built for the current topology. */
+int ccgSubSurf_hasStencilTable(const CCGSubSurf *ss)
+{
+	return ss->stencils != NULL;
+}
+
 /* Vert accessors */
 
 CCGVertHDL ccgSubSurf_getVertVertHandle(CCGVert *v)
@@ -125,6 +125,7 @@ int			ccgSubSurf_getEdgeLevelSize			(const CCGSubSurf *ss, int level);
 int			ccgSubSurf_getGridSize				(const CCGSubSurf *ss);
 int			ccgSubSurf_getGridLevelSize			(const CCGSubSurf *ss, int level);
 int			ccgSubSurf_getSimpleSubdiv			(const CCGSubSurf *ss);
+int			ccgSubSurf_hasStencilTable			(const CCGSubSurf *ss);
 
 CCGVert*	ccgSubSurf_getVert					(CCGSubSurf *ss, CCGVertHDL v);
 CCGVertHDL	ccgSubSurf_getVertVertHandle		(CCGVert *v);
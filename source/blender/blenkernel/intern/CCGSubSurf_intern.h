@@ -166,6 +166,8 @@ typedef enum {
 #endif
 } SyncState;
 
+typedef struct CCGStencilTable CCGStencilTable;
+
 struct CCGSubSurf {
 	EHash *vMap;   /* map of CCGVertHDL -> Vert */
 	EHash *eMap;   /* map of CCGEdgeHDL -> Edge */
@@ -207,6 +209,12 @@ struct CCGSubSurf {
 	CCGVert **tempVerts;
 	CCGEdge **tempEdges;
 
+	/* Precomputed subdivision weights, valid as long as the topology
+	 * does not change. Only built once the topology survived a sync.
+	 */
+	CCGStencilTable *stencils;
+	int numStableSyncs;
+
 #ifdef WITH_OPENSUBDIV
 	/* Skip grids means no CCG geometry is created and subsurf is possible
 	 * to be completely done on GPU.
@@ -296,6 +304,13 @@ void ccgSubSurf__effectedFaceNeighbours(CCGSubSurf *ss,
 
 void ccgSubSurf__sync_legacy(CCGSubSurf *ss);
 
+/* * CCGSubSurf_stencil.c * */
+
+CCGStencilTable *ccgSubSurf__stencils_ensure(CCGSubSurf *ss);
+void ccgSubSurf__stencils_free(CCGSubSurf *ss);
+void ccgSubSurf__stencils_evalFaceCenters(CCGSubSurf *ss, const CCGStencilTable *stencils);
+void ccgSubSurf__stencils_evalLevel(CCGSubSurf *ss, const CCGStencilTable *stencils, int curLvl);
+
 /* * CCGSubSurf_opensubdiv.c * */
 
 void ccgSubSurf__sync_opensubdiv(CCGSubSurf *ss);
@@ -624,34 +624,19 @@ static void ccgSubSurf__calcSubdivLevel_verts_copydata_cb(void *userdata, int pt
 	}
 }
 
-static void ccgSubSurf__calcSubdivLevel(
+/* Exterior edge and vertex points, the same weights are used by CCGSubSurf_stencil.c */
+static void ccgSubSurf__calcSubdivLevel_exterior(
         CCGSubSurf *ss,
-        CCGVert **effectedV, CCGEdge **effectedE, CCGFace **effectedF,
-        const int numEffectedV, const int numEffectedE, const int numEffectedF, const int curLvl)
+        CCGVert **effectedV, CCGEdge **effectedE,
+        const int numEffectedV, const int numEffectedE, const int curLvl)
 {
 	const int subdivLevels = ss->subdivLevels;
 	const int nextLvl = curLvl + 1;
-	int edgeSize = ccg_edgesize(curLvl);
-	int ptrIdx, i;
+	const int edgeSize = ccg_edgesize(curLvl);
+	int ptrIdx;
 	const int vertDataSize = ss->meshIFC.vertDataSize;
 	float *q = ss->q, *r = ss->r;
 
-	CCGSubSurfCalcSubdivData data = {
-	    .ss = ss,
-	    .effectedV = effectedV,
-	    .effectedE = effectedE,
-	    .effectedF = effectedF,
-	    .numEffectedV = numEffectedV,
-	    .numEffectedE = numEffectedE,
-	    .numEffectedF = numEffectedF,
-	    .curLvl = curLvl
-	};
-
-	BLI_task_parallel_range(0, numEffectedF,
-	                        &data,
-	                        ccgSubSurf__calcSubdivLevel_interior_faces_edges_midpoints_cb,
-	                        numEffectedF * edgeSize * edgeSize * 4 >= CCG_OMP_LIMIT);
-
 	/* exterior edge midpoints
 	 * - old exterior edge points
 	 * - new interior face midpoints
@@ -924,6 +909,42 @@ static void ccgSubSurf__calcSubdivLevel(
 			}
 		}
 	}
+}
+
+static void ccgSubSurf__calcSubdivLevel(
+        CCGSubSurf *ss, const CCGStencilTable *stencils,
+        CCGVert **effectedV, CCGEdge **effectedE, CCGFace **effectedF,
+        const int numEffectedV, const int numEffectedE, const int numEffectedF, const int curLvl)
+{
+	const int nextLvl = curLvl + 1;
+	int edgeSize = ccg_edgesize(curLvl);
+	int i;
+	const int vertDataSize = ss->meshIFC.vertDataSize;
+
+	CCGSubSurfCalcSubdivData data = {
+	    .ss = ss,
+	    .effectedV = effectedV,
+	    .effectedE = effectedE,
+	    .effectedF = effectedF,
+	    .numEffectedV = numEffectedV,
+	    .numEffectedE = numEffectedE,
+	    .numEffectedF = numEffectedF,
+	    .curLvl = curLvl
+	};
+
+	BLI_task_parallel_range(0, numEffectedF,
+	                        &data,
+	                        ccgSubSurf__calcSubdivLevel_interior_faces_edges_midpoints_cb,
+	                        numEffectedF * edgeSize * edgeSize * 4 >= CCG_OMP_LIMIT);
+
+	if (stencils) {
+		ccgSubSurf__stencils_evalLevel(ss, stencils, curLvl);
+	}
+	else {
+		ccgSubSurf__calcSubdivLevel_exterior(ss,
+		                                     effectedV, effectedE,
+		                                     numEffectedV, numEffectedE, curLvl);
+	}
 
 	BLI_task_parallel_range(0, numEffectedF,
 	                        &data,
@@ -946,50 +967,19 @@ static void ccgSubSurf__calcSubdivLevel(
 	                        numEffectedF * edgeSize * edgeSize * 4 >= CCG_OMP_LIMIT);
 }
 
-void ccgSubSurf__sync_legacy(CCGSubSurf *ss)
+/* Face centers, edge and vertex points of the first level,
+ * the same weights are used by CCGSubSurf_stencil.c */
+static void ccgSubSurf__calcFirstLevel(
+        CCGSubSurf *ss,
+        CCGVert **effectedV, CCGEdge **effectedE, CCGFace **effectedF,
+        const int numEffectedV, const int numEffectedE, const int numEffectedF)
 {
-	CCGVert **effectedV;
-	CCGEdge **effectedE;
-	CCGFace **effectedF;
-	int numEffectedV, numEffectedE, numEffectedF;
-	int subdivLevels = ss->subdivLevels;
-	int vertDataSize = ss->meshIFC.vertDataSize;
-	int i, j, ptrIdx, S;
-	int curLvl, nextLvl;
+	const int vertDataSize = ss->meshIFC.vertDataSize;
+	const int curLvl = 0;
+	const int nextLvl = curLvl + 1;
+	int i, ptrIdx;
 	void *q = ss->q, *r = ss->r;
 
-	effectedV = MEM_mallocN(sizeof(*effectedV) * ss->vMap->numEntries, "CCGSubsurf effectedV");
-	effectedE = MEM_mallocN(sizeof(*effectedE) * ss->eMap->numEntries, "CCGSubsurf effectedE");
-	effectedF = MEM_mallocN(sizeof(*effectedF) * ss->fMap->numEntries, "CCGSubsurf effectedF");
-	numEffectedV = numEffectedE = numEffectedF = 0;
-	for (i = 0; i < ss->vMap->curSize; i++) {
-		CCGVert *v = (CCGVert *) ss->vMap->buckets[i];
-		for (; v; v = v->next) {
-			if (v->flags & Vert_eEffected) {
-				effectedV[numEffectedV++] = v;
-
-				for (j = 0; j < v->numEdges; j++) {
-					CCGEdge *e = v->edges[j];
-					if (!(e->flags & Edge_eEffected)) {
-						effectedE[numEffectedE++] = e;
-						e->flags |= Edge_eEffected;
-					}
-				}
-
-				for (j = 0; j < v->numFaces; j++) {
-					CCGFace *f = v->faces[j];
-					if (!(f->flags & Face_eEffected)) {
-						effectedF[numEffectedF++] = f;
-						f->flags |= Face_eEffected;
-					}
-				}
-			}
-		}
-	}
-
-	curLvl = 0;
-	nextLvl = curLvl + 1;
-
 	for (ptrIdx = 0; ptrIdx < numEffectedF; ptrIdx++) {
 		CCGFace *f = effectedF[ptrIdx];
 		void *co = FACE_getCenterData(f);
@@ -1161,6 +1151,78 @@ void ccgSubSurf__sync_legacy(CCGSubSurf *ss)
 
 		/* vert flags cleared later */
 	}
+}
+
+void ccgSubSurf__sync_legacy(CCGSubSurf *ss)
+{
+	CCGVert **effectedV;
+	CCGEdge **effectedE;
+	CCGFace **effectedF;
+	int numEffectedV, numEffectedE, numEffectedF;
+	int subdivLevels = ss->subdivLevels;
+	int vertDataSize = ss->meshIFC.vertDataSize;
+	int i, j, ptrIdx, S;
+	int curLvl, nextLvl;
+	bool has_seams = false;
+	CCGStencilTable *stencils = NULL;
+
+	effectedV = MEM_mallocN(sizeof(*effectedV) * ss->vMap->numEntries, "CCGSubsurf effectedV");
+	effectedE = MEM_mallocN(sizeof(*effectedE) * ss->eMap->numEntries, "CCGSubsurf effectedE");
+	effectedF = MEM_mallocN(sizeof(*effectedF) * ss->fMap->numEntries, "CCGSubsurf effectedF");
+	numEffectedV = numEffectedE = numEffectedF = 0;
+	for (i = 0; i < ss->vMap->curSize; i++) {
+		CCGVert *v = (CCGVert *) ss->vMap->buckets[i];
+		for (; v; v = v->next) {
+			if (v->flags & Vert_eSeam) {
+				has_seams = true;
+			}
+			if (v->flags & Vert_eEffected) {
+				effectedV[numEffectedV++] = v;
+
+				for (j = 0; j < v->numEdges; j++) {
+					CCGEdge *e = v->edges[j];
+					if (!(e->flags & Edge_eEffected)) {
+						effectedE[numEffectedE++] = e;
+						e->flags |= Edge_eEffected;
+					}
+				}
+
+				for (j = 0; j < v->numFaces; j++) {
+					CCGFace *f = v->faces[j];
+					if (!(f->flags & Face_eEffected)) {
+						effectedF[numEffectedF++] = f;
+						f->flags |= Face_eEffected;
+					}
+				}
+			}
+		}
+	}
+
+	/* Deforming meshes update all vertices on every sync, use precomputed
+	 * weights once the topology did not change since the previous sync. */
+	if (numEffectedV != 0 && numEffectedV == ss->vMap->numEntries &&
+	    ss->numStableSyncs > 0 && !has_seams)
+	{
+		stencils = ccgSubSurf__stencils_ensure(ss);
+	}
+
+	curLvl = 0;
+	nextLvl = curLvl + 1;
+
+	if (stencils) {
+		ccgSubSurf__stencils_evalFaceCenters(ss, stencils);
+		ccgSubSurf__stencils_evalLevel(ss, stencils, curLvl);
+
+		for (ptrIdx = 0; ptrIdx < numEffectedF; ptrIdx++) {
+			CCGFace *f = effectedF[ptrIdx];
+			f->flags = 0;
+		}
+	}
+	else {
+		ccgSubSurf__calcFirstLevel(ss,
+		                           effectedV, effectedE, effectedF,
+		                           numEffectedV, numEffectedE, numEffectedF);
+	}
 
 	if (ss->useAgeCounts) {
 		for (i = 0; i < numEffectedV; i++) {
@@ -1204,7 +1266,7 @@ void ccgSubSurf__sync_legacy(CCGSubSurf *ss)
 	}
 
 	for (curLvl = 1; curLvl < subdivLevels; curLvl++)
-		ccgSubSurf__calcSubdivLevel(ss,
+		ccgSubSurf__calcSubdivLevel(ss, stencils,
 		                            effectedV, effectedE, effectedF,
 		                            numEffectedV, numEffectedE, numEffectedF, curLvl);
 
@@ -1226,6 +1288,8 @@ void ccgSubSurf__sync_legacy(CCGSubSurf *ss)
 	MEM_freeN(effectedE);
 	MEM_freeN(effectedV);
 
+	ss->numStableSyncs++;
+
 #ifdef DUMP_RESULT_GRIDS
 	ccgSubSurf__dumpCoords(ss);
 #endif
@@ -1278,7 +1342,7 @@ CCGError ccgSubSurf_updateLevels(CCGSubSurf *ss, int lvl, CCGFace **effectedF, i
 	                                   &effectedV, &numEffectedV, &effectedE, &numEffectedE);
 
 	for (curLvl = lvl; curLvl < subdivLevels; curLvl++) {
-		ccgSubSurf__calcSubdivLevel(ss,
+		ccgSubSurf__calcSubdivLevel(ss, NULL,
 		                            effectedV, effectedE, effectedF,
 		                            numEffectedV, numEffectedE, numEffectedF, curLvl);
 	}
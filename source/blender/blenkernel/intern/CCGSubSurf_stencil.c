@@ -0,0 +1,656 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file blender/blenkernel/intern/CCGSubSurf_stencil.c
+ *  \ingroup bke
+ *
+ * Stencil tables for the legacy CCG evaluation.
+ *
+ * The face center, exterior edge and vertex points of every level are weighted
+ * sums of points of the previous level, with weights which only depend on the
+ * topology and edge creases. When the topology stays the same between syncs
+ * (deforming meshes) these weights are computed once and every following sync
+ * evaluates them as a sparse matrix-vector product over the CCG level data,
+ * in parallel, instead of walking the elements with the per-element rules.
+ *
+ * The rows of a table write exactly the data the legacy code writes, so all
+ * levels stay valid for partial syncs falling back to the legacy code.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "MEM_guardedalloc.h"
+#include "BLI_sys_types.h" // for intptr_t support
+
+#include "BLI_utildefines.h" /* for BLI_assert */
+#include "BLI_math.h"
+#include "BLI_task.h"
+
+#include "CCGSubSurf.h"
+#include "CCGSubSurf_intern.h"
+
+/* Rows evaluated by a single task. */
+#define STENCIL_ROWS_PER_TASK 1024
+
+/* dst = sum(weights[i] * src[i]) for the entries rowStart[row] .. rowStart[row + 1] */
+typedef struct CCGStencilRows {
+	float **dst;
+	int *rowStart;
+	const float **src;
+	float *weights;
+	int numRows, numEntries;
+	int allocRows, allocEntries;
+} CCGStencilRows;
+
+struct CCGStencilTable {
+	/* Face centers from the base vertices. */
+	CCGStencilRows faceCenters;
+	/* Exterior edge and vertex points of level + 1. */
+	CCGStencilRows levels[CCGSUBSURF_LEVEL_MAX];
+};
+
+/* Linear combination of CCG data, used while building the rows. */
+typedef struct StencilExpr {
+	const float **src;
+	float *weights;
+	int num, alloc;
+} StencilExpr;
+
+/* ** Topology helpers, same as in CCGSubSurf_legacy.c ** */
+
+static int _edge_isBoundary(const CCGEdge *e)
+{
+	return e->numFaces < 2;
+}
+
+static int _vert_isBoundary(const CCGVert *v)
+{
+	int i;
+	for (i = 0; i < v->numEdges; i++)
+		if (_edge_isBoundary(v->edges[i]))
+			return 1;
+	return 0;
+}
+
+static CCGVert *_edge_getOtherVert(CCGEdge *e, CCGVert *vQ)
+{
+	if (vQ == e->v0) {
+		return e->v1;
+	}
+	else {
+		return e->v0;
+	}
+}
+
+static void *_edge_getCoVert(CCGEdge *e, CCGVert *v, int lvl, int x, int dataSize)
+{
+	int levelBase = ccg_edgebase(lvl);
+	if (v == e->v0) {
+		return &EDGE_getLevelData(e)[dataSize * (levelBase + x)];
+	}
+	else {
+		return &EDGE_getLevelData(e)[dataSize * (levelBase + (1 << lvl) - x)];
+	}
+}
+
+static float EDGE_getSharpness(CCGEdge *e, int lvl)
+{
+	if (!lvl)
+		return e->crease;
+	else if (!e->crease)
+		return 0.0f;
+	else if (e->crease - lvl < 0.0f)
+		return 0.0f;
+	else
+		return e->crease - lvl;
+}
+
+/* ** Expressions ** */
+
+static void expr_init(StencilExpr *expr)
+{
+	expr->alloc = 16;
+	expr->num = 0;
+	expr->src = MEM_mallocN(sizeof(*expr->src) * (size_t)expr->alloc, "CCGStencil expr src");
+	expr->weights = MEM_mallocN(sizeof(*expr->weights) * (size_t)expr->alloc, "CCGStencil expr weights");
+}
+
+static void expr_free(StencilExpr *expr)
+{
+	MEM_freeN(expr->src);
+	MEM_freeN(expr->weights);
+}
+
+static void expr_zero(StencilExpr *expr)
+{
+	expr->num = 0;
+}
+
+/* expr += co * weight */
+static void expr_add_co(StencilExpr *expr, const void *co, float weight)
+{
+	int i;
+
+	for (i = 0; i < expr->num; i++) {
+		if (expr->src[i] == co) {
+			expr->weights[i] += weight;
+			return;
+		}
+	}
+
+	if (expr->num == expr->alloc) {
+		expr->alloc *= 2;
+		expr->src = MEM_reallocN(expr->src, sizeof(*expr->src) * (size_t)expr->alloc);
+		expr->weights = MEM_reallocN(expr->weights, sizeof(*expr->weights) * (size_t)expr->alloc);
+	}
+	expr->src[expr->num] = co;
+	expr->weights[expr->num] = weight;
+	expr->num++;
+}
+
+/* expr += other * weight */
+static void expr_add(StencilExpr *expr, const StencilExpr *other, float weight)
+{
+	int i;
+	for (i = 0; i < other->num; i++) {
+		expr_add_co(expr, other->src[i], other->weights[i] * weight);
+	}
+}
+
+static void expr_copy(StencilExpr *expr, const StencilExpr *other)
+{
+	expr_zero(expr);
+	expr_add(expr, other, 1.0f);
+}
+
+static void expr_mul(StencilExpr *expr, float f)
+{
+	int i;
+	for (i = 0; i < expr->num; i++) {
+		expr->weights[i] *= f;
+	}
+}
+
+/* ** Rows ** */
+
+static void rows_append(CCGStencilRows *rows, void *dst, const StencilExpr *expr)
+{
+	int i;
+
+	if (rows->numRows == rows->allocRows) {
+		rows->allocRows = max_ii(rows->allocRows * 2, 256);
+		rows->dst = MEM_reallocN(rows->dst, sizeof(*rows->dst) * (size_t)rows->allocRows);
+		rows->rowStart = MEM_reallocN(rows->rowStart, sizeof(*rows->rowStart) * (size_t)(rows->allocRows + 1));
+	}
+	if (rows->numEntries + expr->num > rows->allocEntries) {
+		rows->allocEntries = max_ii(rows->allocEntries * 2, rows->numEntries + expr->num);
+		rows->src = MEM_reallocN(rows->src, sizeof(*rows->src) * (size_t)rows->allocEntries);
+		rows->weights = MEM_reallocN(rows->weights, sizeof(*rows->weights) * (size_t)rows->allocEntries);
+	}
+
+	rows->dst[rows->numRows] = dst;
+	rows->rowStart[rows->numRows] = rows->numEntries;
+	for (i = 0; i < expr->num; i++) {
+		/* sharpness blending can cancel out terms */
+		if (expr->weights[i] != 0.0f) {
+			rows->src[rows->numEntries] = expr->src[i];
+			rows->weights[rows->numEntries] = expr->weights[i];
+			rows->numEntries++;
+		}
+	}
+	rows->numRows++;
+	rows->rowStart[rows->numRows] = rows->numEntries;
+}
+
+static void rows_free(CCGStencilRows *rows)
+{
+	MEM_SAFE_FREE(rows->dst);
+	MEM_SAFE_FREE(rows->rowStart);
+	MEM_SAFE_FREE(rows->src);
+	MEM_SAFE_FREE(rows->weights);
+	memset(rows, 0, sizeof(*rows));
+}
+
+/* ** Building ** */
+
+typedef struct StencilBuildData {
+	CCGSubSurf *ss;
+	StencilExpr co, q, r, sharp;
+} StencilBuildData;
+
+/* Same as the face center loop of ccgSubSurf__sync_legacy(). */
+static void stencils_build_face_centers(StencilBuildData *bd, CCGStencilRows *rows)
+{
+	CCGSubSurf *ss = bd->ss;
+	const int vertDataSize = ss->meshIFC.vertDataSize;
+	int i, j;
+
+	for (i = 0; i < ss->fMap->curSize; i++) {
+		CCGFace *f = (CCGFace *) ss->fMap->buckets[i];
+		for (; f; f = f->next) {
+			expr_zero(&bd->co);
+			for (j = 0; j < f->numVerts; j++) {
+				expr_add_co(&bd->co, VERT_getCo(FACE_getVerts(f)[j], 0), 1.0f);
+			}
+			expr_mul(&bd->co, 1.0f / f->numVerts);
+			rows_append(rows, FACE_getCenterData(f), &bd->co);
+		}
+	}
+}
+
+/* Exterior edge midpoints, same as ccgSubSurf__sync_legacy() for level 0
+ * and ccgSubSurf__calcSubdivLevel_exterior() for the other levels. */
+static void stencils_build_edge_midpoints(StencilBuildData *bd, CCGStencilRows *rows, CCGEdge *e, int curLvl)
+{
+	CCGSubSurf *ss = bd->ss;
+	const int subdivLevels = ss->subdivLevels;
+	const int vertDataSize = ss->meshIFC.vertDataSize;
+	const int nextLvl = curLvl + 1;
+	const int edgeSize = ccg_edgesize(curLvl);
+	const float sharpness = EDGE_getSharpness(e, curLvl);
+	const bool is_sharp = (curLvl == 0) ? (sharpness >= 1.0f) : (sharpness > 1.0f);
+	int x, j;
+
+	for (x = 0; x < edgeSize - 1; x++) {
+		int fx = x * 2 + 1;
+		const float *co0 = EDGE_getCo(e, curLvl, x + 0);
+		const float *co1 = EDGE_getCo(e, curLvl, x + 1);
+
+		if (curLvl == 0) {
+			co0 = VERT_getCo(e->v0, curLvl);
+			co1 = VERT_getCo(e->v1, curLvl);
+		}
+
+		expr_zero(&bd->co);
+
+		if (_edge_isBoundary(e) || is_sharp) {
+			expr_add_co(&bd->co, co0, 1.0f);
+			expr_add_co(&bd->co, co1, 1.0f);
+			expr_mul(&bd->co, 0.5f);
+		}
+		else {
+			int numFaces = 0;
+
+			expr_zero(&bd->q);
+			expr_add_co(&bd->q, co0, 1.0f);
+			expr_add_co(&bd->q, co1, 1.0f);
+			for (j = 0; j < e->numFaces; j++) {
+				CCGFace *f = e->faces[j];
+				if (curLvl == 0) {
+					expr_add_co(&bd->q, FACE_getCenterData(f), 1.0f);
+				}
+				else {
+					const int f_ed_idx = ccg_face_getEdgeIndex(f, e);
+					expr_add_co(&bd->q, ccg_face_getIFCoEdge(f, e, f_ed_idx, nextLvl, fx, 1, subdivLevels, vertDataSize), 1.0f);
+				}
+				numFaces++;
+			}
+			expr_mul(&bd->q, 1.0f / (2.0f + numFaces));
+
+			expr_zero(&bd->r);
+			expr_add_co(&bd->r, co0, 1.0f);
+			expr_add_co(&bd->r, co1, 1.0f);
+			expr_mul(&bd->r, 0.5f);
+
+			/* co = q + (r - q) * sharpness */
+			expr_copy(&bd->co, &bd->q);
+			expr_add(&bd->co, &bd->r, sharpness);
+			expr_add(&bd->co, &bd->q, -sharpness);
+		}
+
+		rows_append(rows, EDGE_getCo(e, nextLvl, fx), &bd->co);
+	}
+}
+
+/* Exterior edge interior shift, same as ccgSubSurf__calcSubdivLevel_exterior(). */
+static void stencils_build_edge_shift(StencilBuildData *bd, CCGStencilRows *rows, CCGEdge *e, int curLvl)
+{
+	CCGSubSurf *ss = bd->ss;
+	const int subdivLevels = ss->subdivLevels;
+	const int vertDataSize = ss->meshIFC.vertDataSize;
+	const int nextLvl = curLvl + 1;
+	const int edgeSize = ccg_edgesize(curLvl);
+	const float sharpness = EDGE_getSharpness(e, curLvl);
+	const float avgSharpness = min_ff(sharpness, 1.0f);
+	int x, j;
+
+	for (x = 1; x < edgeSize - 1; x++) {
+		int fx = x * 2;
+		const float *co = EDGE_getCo(e, curLvl, x);
+		const float *co_prev = EDGE_getCo(e, curLvl, x - 1);
+		const float *co_next = EDGE_getCo(e, curLvl, x + 1);
+
+		expr_zero(&bd->co);
+
+		if (_edge_isBoundary(e)) {
+			/* nCo = co * 0.75 + (prev + next) * 0.5 * 0.25 */
+			expr_add_co(&bd->co, co, 0.75f);
+			expr_add_co(&bd->co, co_prev, 0.5f * 0.25f);
+			expr_add_co(&bd->co, co_next, 0.5f * 0.25f);
+		}
+		else {
+			int numFaces = 0;
+
+			expr_zero(&bd->q);
+			expr_zero(&bd->r);
+			expr_add_co(&bd->r, co_prev, 1.0f);
+			expr_add_co(&bd->r, co_next, 1.0f);
+			for (j = 0; j < e->numFaces; j++) {
+				CCGFace *f = e->faces[j];
+				int f_ed_idx = ccg_face_getEdgeIndex(f, e);
+				expr_add_co(&bd->q, ccg_face_getIFCoEdge(f, e, f_ed_idx, nextLvl, fx - 1, 1, subdivLevels, vertDataSize), 1.0f);
+				expr_add_co(&bd->q, ccg_face_getIFCoEdge(f, e, f_ed_idx, nextLvl, fx + 1, 1, subdivLevels, vertDataSize), 1.0f);
+
+				expr_add_co(&bd->r, ccg_face_getIFCoEdge(f, e, f_ed_idx, curLvl, x, 1, subdivLevels, vertDataSize), 1.0f);
+				numFaces++;
+			}
+			expr_mul(&bd->q, 1.0f / (numFaces * 2.0f));
+			expr_mul(&bd->r, 1.0f / (2.0f + numFaces));
+
+			expr_add_co(&bd->co, co, (float) numFaces);
+			expr_add(&bd->co, &bd->q, 1.0f);
+			expr_add(&bd->co, &bd->r, 1.0f);
+			expr_mul(&bd->co, 1.0f / (2 + numFaces));
+
+			if (sharpness != 0.0f) {
+				/* nCo = nCo + ((co * 6 + prev + next) / 8 - nCo) * avgSharpness */
+				expr_zero(&bd->sharp);
+				expr_add_co(&bd->sharp, co, 6.0f);
+				expr_add_co(&bd->sharp, co_prev, 1.0f);
+				expr_add_co(&bd->sharp, co_next, 1.0f);
+				expr_mul(&bd->sharp, 1 / 8.0f);
+
+				expr_mul(&bd->co, 1.0f - avgSharpness);
+				expr_add(&bd->co, &bd->sharp, avgSharpness);
+			}
+		}
+
+		rows_append(rows, EDGE_getCo(e, nextLvl, fx), &bd->co);
+	}
+}
+
+/* Vertex points, same as ccgSubSurf__sync_legacy() for level 0
+ * and ccgSubSurf__calcSubdivLevel_exterior() for the other levels.
+ * Seams are not supported, tables are not used for meshes with seams. */
+static void stencils_build_vert(StencilBuildData *bd, CCGStencilRows *rows, CCGVert *v, int curLvl)
+{
+	CCGSubSurf *ss = bd->ss;
+	const int subdivLevels = ss->subdivLevels;
+	const int vertDataSize = ss->meshIFC.vertDataSize;
+	const int nextLvl = curLvl + 1;
+	const float *co = VERT_getCo(v, curLvl);
+	int sharpCount = 0, allSharp = 1;
+	float avgSharpness = 0.0;
+	int j;
+
+	BLI_assert((v->flags & Vert_eSeam) == 0);
+
+#define VERT_EDGE_CO(e) \
+	((curLvl == 0) ? \
+	 (const float *)VERT_getCo(_edge_getOtherVert(e, v), curLvl) : \
+	 (const float *)_edge_getCoVert(e, v, curLvl, 1, vertDataSize))
+
+	for (j = 0; j < v->numEdges; j++) {
+		CCGEdge *e = v->edges[j];
+		float sharpness = EDGE_getSharpness(e, curLvl);
+
+		if (sharpness != 0.0f) {
+			sharpCount++;
+			avgSharpness += sharpness;
+		}
+		else {
+			allSharp = 0;
+		}
+	}
+
+	if (sharpCount) {
+		avgSharpness /= sharpCount;
+		if (avgSharpness > 1.0f) {
+			avgSharpness = 1.0f;
+		}
+	}
+
+	expr_zero(&bd->co);
+
+	if (!v->numEdges || ss->meshIFC.simpleSubdiv) {
+		expr_add_co(&bd->co, co, 1.0f);
+	}
+	else if (_vert_isBoundary(v)) {
+		int numBoundary = 0;
+
+		expr_zero(&bd->r);
+		for (j = 0; j < v->numEdges; j++) {
+			CCGEdge *e = v->edges[j];
+			if (_edge_isBoundary(e)) {
+				expr_add_co(&bd->r, VERT_EDGE_CO(e), 1.0f);
+				numBoundary++;
+			}
+		}
+		expr_add_co(&bd->co, co, 0.75f);
+		expr_add(&bd->co, &bd->r, 0.25f / numBoundary);
+	}
+	else {
+		const int cornerIdx = (1 + (1 << (curLvl))) - 2;
+		int numEdges = 0, numFaces = 0;
+
+		expr_zero(&bd->q);
+		for (j = 0; j < v->numFaces; j++) {
+			CCGFace *f = v->faces[j];
+			if (curLvl == 0) {
+				expr_add_co(&bd->q, FACE_getCenterData(f), 1.0f);
+			}
+			else {
+				expr_add_co(&bd->q, FACE_getIFCo(f, nextLvl, ccg_face_getVertIndex(f, v), cornerIdx, cornerIdx), 1.0f);
+			}
+			numFaces++;
+		}
+		expr_mul(&bd->q, 1.0f / numFaces);
+		expr_zero(&bd->r);
+		for (j = 0; j < v->numEdges; j++) {
+			CCGEdge *e = v->edges[j];
+			expr_add_co(&bd->r, VERT_EDGE_CO(e), 1.0f);
+			numEdges++;
+		}
+		expr_mul(&bd->r, 1.0f / numEdges);
+
+		expr_add_co(&bd->co, co, numEdges - 2.0f);
+		expr_add(&bd->co, &bd->q, 1.0f);
+		expr_add(&bd->co, &bd->r, 1.0f);
+		expr_mul(&bd->co, 1.0f / numEdges);
+	}
+
+	if (sharpCount > 1 && (curLvl == 0 || v->numFaces)) {
+		expr_zero(&bd->q);
+
+		for (j = 0; j < v->numEdges; j++) {
+			CCGEdge *e = v->edges[j];
+			float sharpness = EDGE_getSharpness(e, curLvl);
+
+			if (sharpness != 0.0f) {
+				expr_add_co(&bd->q, VERT_EDGE_CO(e), 1.0f);
+			}
+		}
+
+		expr_mul(&bd->q, (float) 1 / sharpCount);
+
+		if (sharpCount != 2 || allSharp) {
+			/* q = q + (co - q) * avgSharpness */
+			expr_mul(&bd->q, 1.0f - avgSharpness);
+			expr_add_co(&bd->q, co, avgSharpness);
+		}
+
+		/* r = co * 0.75 + q * 0.25 */
+		expr_zero(&bd->r);
+		expr_add_co(&bd->r, co, 0.75f);
+		expr_add(&bd->r, &bd->q, 0.25f);
+
+		/* nCo = nCo + (r - nCo) * avgSharpness */
+		expr_mul(&bd->co, 1.0f - avgSharpness);
+		expr_add(&bd->co, &bd->r, avgSharpness);
+	}
+
+#undef VERT_EDGE_CO
+
+	rows_append(rows, VERT_getCo(v, nextLvl), &bd->co);
+}
+
+static void stencils_build_level(StencilBuildData *bd, CCGStencilRows *rows, int curLvl)
+{
+	CCGSubSurf *ss = bd->ss;
+	int i;
+
+	for (i = 0; i < ss->eMap->curSize; i++) {
+		CCGEdge *e = (CCGEdge *) ss->eMap->buckets[i];
+		for (; e; e = e->next) {
+			stencils_build_edge_midpoints(bd, rows, e, curLvl);
+			if (curLvl != 0) {
+				stencils_build_edge_shift(bd, rows, e, curLvl);
+			}
+		}
+	}
+
+	for (i = 0; i < ss->vMap->curSize; i++) {
+		CCGVert *v = (CCGVert *) ss->vMap->buckets[i];
+		for (; v; v = v->next) {
+			stencils_build_vert(bd, rows, v, curLvl);
+		}
+	}
+}
+
+static CCGStencilTable *stencils_build(CCGSubSurf *ss)
+{
+	CCGStencilTable *stencils = MEM_callocN(sizeof(*stencils), "CCGStencilTable");
+	StencilBuildData bd;
+	int curLvl;
+
+	bd.ss = ss;
+	expr_init(&bd.co);
+	expr_init(&bd.q);
+	expr_init(&bd.r);
+	expr_init(&bd.sharp);
+
+	stencils_build_face_centers(&bd, &stencils->faceCenters);
+	for (curLvl = 0; curLvl < ss->subdivLevels; curLvl++) {
+		stencils_build_level(&bd, &stencils->levels[curLvl], curLvl);
+	}
+
+	expr_free(&bd.co);
+	expr_free(&bd.q);
+	expr_free(&bd.r);
+	expr_free(&bd.sharp);
+
+	return stencils;
+}
+
+/* ** Evaluation ** */
+
+typedef struct StencilEvalData {
+	const CCGStencilRows *rows;
+	int numLayers;
+} StencilEvalData;
+
+static void stencils_eval_cb(void *userdata, int taskIdx)
+{
+	const StencilEvalData *data = userdata;
+	const CCGStencilRows *rows = data->rows;
+	const int numLayers = data->numLayers;
+	const int rowEnd = min_ii((taskIdx + 1) * STENCIL_ROWS_PER_TASK, rows->numRows);
+	int row, i, k;
+
+	if (numLayers == 3) {
+		for (row = taskIdx * STENCIL_ROWS_PER_TASK; row < rowEnd; row++) {
+			const int end = rows->rowStart[row + 1];
+			float co[3] = {0.0f, 0.0f, 0.0f};
+
+			for (i = rows->rowStart[row]; i < end; i++) {
+				madd_v3_v3fl(co, rows->src[i], rows->weights[i]);
+			}
+			copy_v3_v3(rows->dst[row], co);
+		}
+	}
+	else {
+		float *co = alloca(sizeof(float) * (size_t)numLayers);
+
+		for (row = taskIdx * STENCIL_ROWS_PER_TASK; row < rowEnd; row++) {
+			const int end = rows->rowStart[row + 1];
+
+			memset(co, 0, sizeof(float) * (size_t)numLayers);
+			for (i = rows->rowStart[row]; i < end; i++) {
+				for (k = 0; k < numLayers; k++) {
+					co[k] += rows->src[i][k] * rows->weights[i];
+				}
+			}
+			memcpy(rows->dst[row], co, sizeof(float) * (size_t)numLayers);
+		}
+	}
+}
+
+static void stencils_eval(CCGSubSurf *ss, const CCGStencilRows *rows)
+{
+	StencilEvalData data = {
+	    .rows = rows,
+	    .numLayers = ss->meshIFC.numLayers,
+	};
+	const int numTasks = (rows->numRows + STENCIL_ROWS_PER_TASK - 1) / STENCIL_ROWS_PER_TASK;
+
+	BLI_task_parallel_range(0, numTasks,
+	                        &data,
+	                        stencils_eval_cb,
+	                        rows->numEntries * 4 >= CCG_OMP_LIMIT);
+}
+
+/* ** Public API ** */
+
+/* Returns the stencil table for the current topology, building it when needed. */
+CCGStencilTable *ccgSubSurf__stencils_ensure(CCGSubSurf *ss)
+{
+	if (ss->stencils == NULL) {
+		ss->stencils = stencils_build(ss);
+	}
+	return ss->stencils;
+}
+
+/* Free the stencil table, called whenever the topology changes. */
+void ccgSubSurf__stencils_free(CCGSubSurf *ss)
+{
+	if (ss->stencils) {
+		int curLvl;
+
+		rows_free(&ss->stencils->faceCenters);
+		for (curLvl = 0; curLvl < CCGSUBSURF_LEVEL_MAX; curLvl++) {
+			rows_free(&ss->stencils->levels[curLvl]);
+		}
+		MEM_freeN(ss->stencils);
+		ss->stencils = NULL;
+	}
+	ss->numStableSyncs = 0;
+}
+
+void ccgSubSurf__stencils_evalFaceCenters(CCGSubSurf *ss, const CCGStencilTable *stencils)
+{
+	stencils_eval(ss, &stencils->faceCenters);
+}
+
+/* Exterior edge and vertex points of curLvl + 1. */
+void ccgSubSurf__stencils_evalLevel(CCGSubSurf *ss, const CCGStencilTable *stencils, int curLvl)
+{
+	stencils_eval(ss, &stencils->levels[curLvl]);
+}
@@ -42,14 +42,18 @@
 #include "DNA_meshdata_types.h"
 #include "DNA_object_types.h"
 #include "DNA_scene_types.h"
+#include "DNA_genfile.h"
+#include "DNA_sdna_types.h"
 
 #include "BLI_array.h"
 #include "BLI_blenlib.h"
 #include "BLI_bitmap.h"
+#include "BLI_hash_mm2a.h"
 #include "BLI_math.h"
 #include "BLI_utildefines.h"
 #include "BLI_linklist.h"
 #include "BLI_task.h"
+#include "BLI_threads.h"
 
 #include "BKE_cdderivedmesh.h"
 #include "BKE_colorband.h"
@@ -436,13 +440,13 @@ int DM_release(DerivedMesh *dm)
 	}
 }
 
-void DM_DupPolys(DerivedMesh *source, DerivedMesh *target)
+void DM_DupPolys_ex(DerivedMesh *source, DerivedMesh *target, const int alloctype)
 {
 	CustomData_free(&target->loopData, source->numLoopData);
 	CustomData_free(&target->polyData, source->numPolyData);
 
-	CustomData_copy(&source->loopData, &target->loopData, CD_MASK_DERIVEDMESH, CD_DUPLICATE, source->numLoopData);
-	CustomData_copy(&source->polyData, &target->polyData, CD_MASK_DERIVEDMESH, CD_DUPLICATE, source->numPolyData);
+	CustomData_copy(&source->loopData, &target->loopData, CD_MASK_DERIVEDMESH, alloctype, source->numLoopData);
+	CustomData_copy(&source->polyData, &target->polyData, CD_MASK_DERIVEDMESH, alloctype, source->numPolyData);
 
 	target->numLoopData = source->numLoopData;
 	target->numPolyData = source->numPolyData;
@@ -458,6 +462,11 @@ void DM_DupPolys(DerivedMesh *source, DerivedMesh *target)
 	}
 }
 
+void DM_DupPolys(DerivedMesh *source, DerivedMesh *target)
+{
+	DM_DupPolys_ex(source, target, CD_DUPLICATE);
+}
+
 void DM_ensure_normals(DerivedMesh *dm)
 {
 	if (dm->dirty & DM_DIRTY_NORMALS) {
@@ -1745,6 +1754,399 @@ static void dm_ensure_display_normals(DerivedMesh *dm)
 	}
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Modifier Stack Cache
+ *
+ * Results of the modifiers flagged with #eModifierMode_CacheResult are kept in #Object.modifier_cache,
+ * keyed by a hash of the input mesh and of the settings of all the modifiers applied up to them.
+ * When something after such a modifier changes, #mesh_calc_modifiers resumes from its result.
+ *
+ * Only modifiers whose result depends on nothing else than their settings and their input mesh
+ * can be part of a cached stack, see #modifier_cache_supported.
+ * \{ */
+
+/* Memory used by the results cached in all objects. */
+#define MODIFIER_CACHE_MEMORY_MAX ((size_t)512 * 1024 * 1024)
+
+typedef struct ModifierCacheEntry {
+	struct ModifierCacheEntry *next, *prev;
+	/* In #modifier_cache_lru, data is the entry. */
+	LinkData lru_link;
+	struct ModifierStackCache *cache;
+	ModifierData *md;
+	uint64_t key;
+	DerivedMesh *dm;
+	size_t mem_size;
+} ModifierCacheEntry;
+
+typedef struct ModifierStackCache {
+	ListBase entries;
+} ModifierStackCache;
+
+/* Objects are evaluated in parallel, all the caches and the globals below are accessed with the lock held. */
+static ThreadMutex modifier_cache_lock = BLI_MUTEX_INITIALIZER;
+/* Entries of all the objects, least recently used first. */
+static ListBase modifier_cache_lru = {NULL, NULL};
+static size_t modifier_cache_mem_size = 0;
+
+/* Two 32 bits hashes with different seeds, collisions would silently give a wrong mesh. */
+static uint64_t modifier_cache_hash(uint64_t key, const void *data, const size_t len)
+{
+	const uint32_t h1 = BLI_hash_mm2(data, len, (uint32_t)key);
+	const uint32_t h2 = BLI_hash_mm2(data, len, (uint32_t)(key >> 32) ^ 0x9747b28cu);
+
+	return ((uint64_t)h1 << 32) | h2;
+}
+
+static uint64_t modifier_cache_hash_customdata(uint64_t key, const CustomData *data, const int totelem)
+{
+	int i;
+
+	for (i = 0; i < data->totlayer; i++) {
+		CustomDataLayer layer = data->layers[i];
+
+		/* Hash the layer settings and names, not the pointers. */
+		layer.data = NULL;
+		layer.shared = NULL;
+		layer.offset = 0;
+		key = modifier_cache_hash(key, &layer, sizeof(layer));
+		key = modifier_cache_hash(key, &totelem, sizeof(totelem));
+
+		if (data->layers[i].data == NULL) {
+			continue;
+		}
+
+		if (layer.type == CD_MDEFORMVERT) {
+			/* Weights are allocated per vertex. */
+			const MDeformVert *dvert = data->layers[i].data;
+			int j;
+
+			for (j = 0; j < totelem; j++, dvert++) {
+				key = modifier_cache_hash(key, &dvert->totweight, sizeof(dvert->totweight));
+				if (dvert->dw) {
+					key = modifier_cache_hash(key, dvert->dw, sizeof(*dvert->dw) * (size_t)dvert->totweight);
+				}
+			}
+		}
+		else {
+			key = modifier_cache_hash(
+			        key, data->layers[i].data, (size_t)CustomData_sizeof(layer.type) * (size_t)totelem);
+		}
+	}
+
+	return key;
+}
+
+/**
+ * Key of the mesh given to the first modifier of the stack, with the parameters of the evaluation.
+ */
+static uint64_t modifier_cache_key_input(
+        Scene *scene, Object *ob, float (*deformedVerts)[3], const int numVerts,
+        const CustomDataMask dataMask, const int required_mode, const bool need_mapping,
+        const ModifierApplyFlag app_flags)
+{
+	Mesh *me = ob->data;
+	const int params[] = {
+	    required_mode, need_mapping, (int)app_flags, ob->totcol,
+	    me->flag, me->cd_flag, (scene->r.mode & R_SIMPLIFY),
+	    scene->r.simplify_subsurf, scene->r.simplify_subsurf_render};
+	bDeformGroup *dg;
+	uint64_t key = 0;
+
+	key = modifier_cache_hash(key, params, sizeof(params));
+	key = modifier_cache_hash(key, &dataMask, sizeof(dataMask));
+	key = modifier_cache_hash(key, &me->smoothresh, sizeof(me->smoothresh));
+
+	/* Modifiers refer to vertex groups by name. */
+	for (dg = ob->defbase.first; dg; dg = dg->next) {
+		key = modifier_cache_hash(key, dg->name, strlen(dg->name));
+	}
+
+	key = modifier_cache_hash_customdata(key, &me->vdata, me->totvert);
+	key = modifier_cache_hash_customdata(key, &me->edata, me->totedge);
+	key = modifier_cache_hash_customdata(key, &me->ldata, me->totloop);
+	key = modifier_cache_hash_customdata(key, &me->pdata, me->totpoly);
+
+	if (deformedVerts) {
+		key = modifier_cache_hash(key, deformedVerts, sizeof(*deformedVerts) * (size_t)numVerts);
+	}
+
+	return key;
+}
+
+/**
+ * Chain the settings of a modifier to the key of its input, skipping all pointers
+ * (runtime data of the modifier, or datablocks which are not allowed, see #modifier_cache_supported).
+ */
+static uint64_t modifier_cache_key_modifier(
+        uint64_t key, const SDNA *sdna, ModifierData *md, const ModifierTypeInfo *mti,
+        const CustomDataMask mask, const CustomDataMask nextmask)
+{
+	const int params[] = {md->type, md->mode & ~(eModifierMode_Expanded | eModifierMode_CacheResult)};
+	const int struct_nr = DNA_struct_find_nr(sdna, mti->structName);
+	const short *sp;
+	int offset = 0;
+	int i, members_len;
+
+	key = modifier_cache_hash(key, params, sizeof(params));
+	key = modifier_cache_hash(key, &mask, sizeof(mask));
+	key = modifier_cache_hash(key, &nextmask, sizeof(nextmask));
+
+	BLI_assert(struct_nr != -1);
+	sp = sdna->structs[struct_nr];
+	members_len = sp[1];
+
+	for (i = 0, sp += 2; i < members_len; i++, sp += 2) {
+		const char *name = sdna->names[sp[1]];
+		const bool is_pointer = ELEM(name[0], '*', '(');
+		const int len = (is_pointer ? sdna->pointerlen : sdna->typelens[sp[0]]) * DNA_elem_array_size(name);
+
+		/* The first member is the ModifierData, already handled. */
+		if (!is_pointer && i != 0) {
+			key = modifier_cache_hash(key, (const char *)md + offset, (size_t)len);
+		}
+		offset += len;
+	}
+
+	return key;
+}
+
+static void modifier_cache_id_link_cb(void *userData, Object *UNUSED(ob), ID **idpoin, int UNUSED(cb_flag))
+{
+	if (*idpoin) {
+		*((bool *)userData) = true;
+	}
+}
+
+/**
+ * Modifiers which may be part of a cached stack.
+ *
+ * Their result must only depend on their settings and their input mesh, so all modifiers using
+ * other datablocks (objects, textures...), time, point caches or bound data are excluded.
+ */
+static bool modifier_cache_supported(Object *ob, ModifierData *md, const ModifierTypeInfo *mti)
+{
+	bool has_id_link = false;
+
+	switch ((ModifierType)md->type) {
+		case eModifierType_Subsurf:
+		case eModifierType_Mirror:
+		case eModifierType_Decimate:
+		case eModifierType_Boolean:
+		case eModifierType_Array:
+		case eModifierType_EdgeSplit:
+		case eModifierType_Displace:
+		case eModifierType_Smooth:
+		case eModifierType_Cast:
+		case eModifierType_Bevel:
+		case eModifierType_Mask:
+		case eModifierType_SimpleDeform:
+		case eModifierType_Solidify:
+		case eModifierType_Screw:
+		case eModifierType_Remesh:
+		case eModifierType_Skin:
+		case eModifierType_LaplacianSmooth:
+		case eModifierType_Triangulate:
+		case eModifierType_UVWarp:
+		case eModifierType_Wireframe:
+		case eModifierType_NormalEdit:
+			break;
+		default:
+			return false;
+	}
+
+	if (mti->dependsOnTime && mti->dependsOnTime(md)) {
+		return false;
+	}
+
+	if (mti->foreachIDLink) {
+		mti->foreachIDLink(md, ob, modifier_cache_id_link_cb, &has_id_link);
+	}
+	else if (mti->foreachObjectLink) {
+		mti->foreachObjectLink(md, ob, (ObjectWalkFunc)modifier_cache_id_link_cb, &has_id_link);
+	}
+
+	return !has_id_link;
+}
+
+/**
+ * Whether the modifier stack from \a md has results to cache, frees the cache when not.
+ */
+static bool modifier_cache_is_used(Object *ob, ModifierData *md, CDMaskLink *datamasks)
+{
+	CDMaskLink *curr;
+
+	if (ob->particlesystem.first || DNA_sdna_current_get() == NULL) {
+		return false;
+	}
+
+	for (; md; md = md->next) {
+		if (md->mode & eModifierMode_CacheResult) {
+			break;
+		}
+	}
+
+	if (md == NULL) {
+		DM_modifier_cache_free(ob);
+		return false;
+	}
+
+	/* Orco meshes are computed along, by the same modifiers. */
+	for (curr = datamasks; curr; curr = curr->next) {
+		if (curr->mask & (CD_MASK_ORCO | CD_MASK_CLOTH_ORCO)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static size_t modifier_cache_customdata_mem_size(const CustomData *data, const int totelem)
+{
+	size_t mem_size = 0;
+	int i;
+
+	for (i = 0; i < data->totlayer; i++) {
+		mem_size += (size_t)CustomData_sizeof(data->layers[i].type) * (size_t)totelem;
+	}
+
+	return mem_size;
+}
+
+static void modifier_cache_entry_free(ModifierCacheEntry *entry)
+{
+	modifier_cache_mem_size -= entry->mem_size;
+	entry->dm->needsFree = 1;
+	entry->dm->release(entry->dm);
+	BLI_remlink(&modifier_cache_lru, &entry->lru_link);
+	BLI_freelinkN(&entry->cache->entries, entry);
+}
+
+static ModifierCacheEntry *modifier_cache_find_locked(Object *ob, ModifierData *md, const uint64_t key)
+{
+	ModifierStackCache *cache = ob->modifier_cache;
+	ModifierCacheEntry *entry;
+
+	if (cache == NULL) {
+		return NULL;
+	}
+
+	for (entry = cache->entries.first; entry; entry = entry->next) {
+		if (entry->md == md && entry->key == key) {
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+static bool modifier_cache_has(Object *ob, ModifierData *md, const uint64_t key)
+{
+	bool found;
+
+	BLI_mutex_lock(&modifier_cache_lock);
+	found = (modifier_cache_find_locked(ob, md, key) != NULL);
+	BLI_mutex_unlock(&modifier_cache_lock);
+
+	return found;
+}
+
+/**
+ * Return a copy of the cached result, or NULL when it was evicted meanwhile by another object.
+ */
+static DerivedMesh *modifier_cache_get(Object *ob, ModifierData *md, const uint64_t key)
+{
+	ModifierCacheEntry *entry;
+	DerivedMesh *dm = NULL;
+
+	BLI_mutex_lock(&modifier_cache_lock);
+	if ((entry = modifier_cache_find_locked(ob, md, key))) {
+		/* Most recently used. */
+		BLI_remlink(&modifier_cache_lru, &entry->lru_link);
+		BLI_addtail(&modifier_cache_lru, &entry->lru_link);
+		dm = CDDM_copy_shared(entry->dm);
+	}
+	BLI_mutex_unlock(&modifier_cache_lock);
+
+	return dm;
+}
+
+static void modifier_cache_store(Object *ob, ModifierData *md, const uint64_t key, DerivedMesh *dm)
+{
+	ModifierStackCache *cache;
+	ModifierCacheEntry *entry, *entry_next;
+	size_t mem_size;
+
+	/* Other types (subsurf's CCGDM...) would lose their optimized drawing when copied. */
+	if (dm->type != DM_TYPE_CDDM) {
+		return;
+	}
+
+	mem_size = (modifier_cache_customdata_mem_size(&dm->vertData, dm->numVertData) +
+	            modifier_cache_customdata_mem_size(&dm->edgeData, dm->numEdgeData) +
+	            modifier_cache_customdata_mem_size(&dm->loopData, dm->numLoopData) +
+	            modifier_cache_customdata_mem_size(&dm->polyData, dm->numPolyData));
+
+	if (mem_size > MODIFIER_CACHE_MEMORY_MAX) {
+		return;
+	}
+
+	BLI_mutex_lock(&modifier_cache_lock);
+
+	cache = ob->modifier_cache;
+	if (cache == NULL) {
+		cache = ob->modifier_cache = MEM_callocN(sizeof(*cache), __func__);
+	}
+
+	/* Only keep the latest result of each modifier. */
+	for (entry = cache->entries.first; entry; entry = entry_next) {
+		entry_next = entry->next;
+		if (entry->md == md) {
+			modifier_cache_entry_free(entry);
+		}
+	}
+
+	/* Evict the least recently used results, of any object. */
+	while (modifier_cache_mem_size + mem_size > MODIFIER_CACHE_MEMORY_MAX) {
+		LinkData *link = modifier_cache_lru.first;
+		modifier_cache_entry_free(link->data);
+	}
+
+	entry = MEM_mallocN(sizeof(*entry), __func__);
+	entry->lru_link.data = entry;
+	entry->cache = cache;
+	entry->md = md;
+	entry->key = key;
+	entry->dm = CDDM_copy_shared(dm);
+	entry->mem_size = mem_size;
+	BLI_addtail(&cache->entries, entry);
+	BLI_addtail(&modifier_cache_lru, &entry->lru_link);
+	modifier_cache_mem_size += mem_size;
+
+	BLI_mutex_unlock(&modifier_cache_lock);
+}
+
+/**
+ * Free the cached modifier results of the object.
+ */
+void DM_modifier_cache_free(Object *ob)
+{
+	ModifierStackCache *cache = ob->modifier_cache;
+
+	if (cache) {
+		BLI_mutex_lock(&modifier_cache_lock);
+		while (cache->entries.first) {
+			modifier_cache_entry_free(cache->entries.first);
+		}
+		BLI_mutex_unlock(&modifier_cache_lock);
+
+		MEM_freeN(cache);
+		ob->modifier_cache = NULL;
+	}
+}
+
+/** \} */
+
 /**
  * new value for useDeform -1  (hack for the gameengine):
  *
@@ -1792,6 +2194,10 @@ static void mesh_calc_modifiers(
 	const bool do_loop_normals = (me->flag & ME_AUTOSMOOTH) != 0;
 	const float loop_normals_split_angle = me->smoothresh;
 
+	const SDNA *sdna = DNA_sdna_current_get();
+	bool use_modifier_cache;
+	uint64_t cache_key = 0;
+
 	VirtualModifierData virtualModifierData;
 
 	ModifierApplyFlag app_flags = useRenderParams ? MOD_APPLY_RENDER : 0;
@@ -1906,6 +2312,72 @@ static void mesh_calc_modifiers(
 	orcodm = NULL;
 	clothorcodm = NULL;
 
+	/* Resume from the last cached result still valid, if any. */
+	use_modifier_cache = (useDeform >= 0 && index == -1 && inputVertexCos == NULL &&
+	                      !sculpt_mode && previewmd == NULL && !do_init_wmcol && !build_shapekey_layers &&
+	                      (dataMask & (CD_MASK_ORCO | CD_MASK_CLOTH_ORCO)) == 0 &&
+	                      modifier_cache_is_used(ob, md, datamasks));
+
+	if (use_modifier_cache) {
+		ModifierData *cache_hit_md = NULL;
+		CDMaskLink *cache_hit_curr = NULL;
+		uint64_t cache_hit_key = 0;
+		ModifierData *md_iter;
+		CDMaskLink *curr_iter = curr;
+		const uint64_t input_key = modifier_cache_key_input(
+		        scene, ob, deformedVerts, numVerts, dataMask, required_mode, need_mapping, app_flags);
+
+		cache_key = input_key;
+
+		/* Same skipping rules as the loop below. */
+		for (md_iter = md; md_iter; md_iter = md_iter->next, curr_iter = curr_iter->next) {
+			const ModifierTypeInfo *mti = modifierType_getInfo(md_iter->type);
+
+			md_iter->scene = scene;
+
+			if (!modifier_isEnabled(scene, md_iter, required_mode)) {
+				continue;
+			}
+
+			if (mti->type == eModifierTypeType_OnlyDeform && !useDeform) {
+				continue;
+			}
+
+			if (need_mapping && !modifier_supportsMapping(md_iter)) {
+				continue;
+			}
+
+			if (!modifier_cache_supported(ob, md_iter, mti)) {
+				break;
+			}
+
+			cache_key = modifier_cache_key_modifier(
+			        cache_key, sdna, md_iter, mti, curr_iter->mask, curr_iter->next ? curr_iter->next->mask : dataMask);
+
+			if ((mti->type != eModifierTypeType_OnlyDeform) && (md_iter->mode & eModifierMode_CacheResult)) {
+				if (modifier_cache_has(ob, md_iter, cache_key)) {
+					cache_hit_md = md_iter;
+					cache_hit_curr = curr_iter;
+					cache_hit_key = cache_key;
+				}
+			}
+		}
+
+		if (cache_hit_md && (dm = modifier_cache_get(ob, cache_hit_md, cache_hit_key))) {
+			md = cache_hit_md->next;
+			curr = cache_hit_curr->next;
+			cache_key = cache_hit_key;
+
+			if (deformedVerts) {
+				MEM_freeN(deformedVerts);
+				deformedVerts = NULL;
+			}
+		}
+		else {
+			cache_key = input_key;
+		}
+	}
+
 	for (; md; md = md->next, curr = curr->next) {
 		const ModifierTypeInfo *mti = modifierType_getInfo(md->type);
 
@@ -1964,6 +2436,16 @@ static void mesh_calc_modifiers(
 			continue;
 		}
 
+		if (use_modifier_cache) {
+			if (modifier_cache_supported(ob, md, mti)) {
+				cache_key = modifier_cache_key_modifier(
+				        cache_key, sdna, md, mti, curr->mask, curr->next ? curr->next->mask : dataMask);
+			}
+			else {
+				use_modifier_cache = false;
+			}
+		}
+
 		/* add an orco layer if needed by this modifier */
 		if (mti->requiredDataMask)
 			mask = mti->requiredDataMask(ob, md);
@@ -2019,7 +2501,7 @@ static void mesh_calc_modifiers(
 			/* apply vertex coordinates or build a DerivedMesh as necessary */
 			if (dm) {
 				if (deformedVerts) {
-					DerivedMesh *tdm = CDDM_copy(dm);
+					DerivedMesh *tdm = CDDM_copy_shared(dm);
 					dm->release(dm);
 					dm = tdm;
 
@@ -2148,6 +2630,10 @@ static void mesh_calc_modifiers(
 			}
 
 			dm->deformedOnly = false;
+
+			if (use_modifier_cache && (md->mode & eModifierMode_CacheResult)) {
+				modifier_cache_store(ob, md, cache_key, dm);
+			}
 		}
 
 		isPrevDeform = (mti->type == eModifierTypeType_OnlyDeform);
@@ -2169,7 +2655,7 @@ static void mesh_calc_modifiers(
 	 * DerivedMesh then we need to build one.
 	 */
 	if (dm && deformedVerts) {
-		finaldm = CDDM_copy(dm);
+		finaldm = CDDM_copy_shared(dm);
 
 		dm->release(dm);
 
@@ -2406,7 +2892,7 @@ static void editbmesh_calc_modifiers(
 			/* apply vertex coordinates or build a DerivedMesh as necessary */
 			if (dm) {
 				if (deformedVerts) {
-					DerivedMesh *tdm = CDDM_copy(dm);
+					DerivedMesh *tdm = CDDM_copy_shared(dm);
 					if (!(r_cage && dm == *r_cage)) {
 						dm->release(dm);
 					}
@@ -2520,7 +3006,7 @@ static void editbmesh_calc_modifiers(
 	 * then we need to build one.
 	 */
 	if (dm && deformedVerts) {
-		*r_final = CDDM_copy(dm);
+		*r_final = CDDM_copy_shared(dm);
 
 		if (!(r_cage && dm == *r_cage)) {
 			dm->release(dm);
@@ -3507,7 +3993,7 @@ void DM_calc_loop_tangents(
 					dm->tangent_mask |= 1 << (uv_ind - uv_start);
 				}
 
-				mesh2tangent->tangent = dm->loopData.layers[index].data;
+				mesh2tangent->tangent = CustomData_get_layer_n(&dm->loopData, CD_TANGENT, n);
 				BLI_task_pool_push(task_pool, DM_calc_loop_tangents_thread, mesh2tangent, false, TASK_PRIORITY_LOW);
 			}
 
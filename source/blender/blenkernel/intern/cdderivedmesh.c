@@ -2397,7 +2397,8 @@ DerivedMesh *CDDM_from_editbmesh(BMEditMesh *em, const bool use_mdisps, const bo
 
 static DerivedMesh *cddm_copy_ex(DerivedMesh *source,
                                  const bool need_tessface_data,
-                                 const bool faces_from_tessfaces)
+                                 const bool faces_from_tessfaces,
+                                 const bool share_layers)
 {
 	const bool copy_tessface_data = (faces_from_tessfaces || need_tessface_data);
 	CDDerivedMesh *cddm = cdDM_create("CDDM_copy cddm");
@@ -2418,9 +2419,20 @@ static DerivedMesh *cddm_copy_ex(DerivedMesh *source,
 		source->getTessFaceDataArray(source, CD_ORIGINDEX);
 	}
 
-	/* this initializes dm, and copies all non mvert/medge/mface layers */
-	DM_from_template(dm, source, DM_TYPE_CDDM, numVerts, numEdges, numTessFaces,
-	                 numLoops, numPolys);
+	if (share_layers) {
+		/* this initializes dm, and shares the mesh layers with source,
+		 * they're only duplicated once written to */
+		DM_init(dm, DM_TYPE_CDDM, numVerts, numEdges, numTessFaces, numLoops, numPolys);
+		CustomData_copy(&source->vertData, &dm->vertData, CD_MASK_DERIVEDMESH, CD_SHARE, numVerts);
+		CustomData_copy(&source->edgeData, &dm->edgeData, CD_MASK_DERIVEDMESH, CD_SHARE, numEdges);
+		CustomData_copy(&source->faceData, &dm->faceData, CD_MASK_DERIVEDMESH,
+		                copy_tessface_data ? CD_SHARE : CD_CALLOC, numTessFaces);
+	}
+	else {
+		/* this initializes dm, and copies all non mvert/medge/mface layers */
+		DM_from_template(dm, source, DM_TYPE_CDDM, numVerts, numEdges, numTessFaces,
+		                 numLoops, numPolys);
+	}
 	dm->deformedOnly = source->deformedOnly;
 	dm->cd_flag = source->cd_flag;
 	dm->dirty = source->dirty;
@@ -2432,10 +2444,12 @@ static DerivedMesh *cddm_copy_ex(DerivedMesh *source,
 		dm->dirty |= DM_DIRTY_TESS_CDLAYERS;
 	}
 
-	CustomData_copy_data(&source->vertData, &dm->vertData, 0, 0, numVerts);
-	CustomData_copy_data(&source->edgeData, &dm->edgeData, 0, 0, numEdges);
-	if (copy_tessface_data) {
-		CustomData_copy_data(&source->faceData, &dm->faceData, 0, 0, numTessFaces);
+	if (!share_layers) {
+		CustomData_copy_data(&source->vertData, &dm->vertData, 0, 0, numVerts);
+		CustomData_copy_data(&source->edgeData, &dm->edgeData, 0, 0, numEdges);
+		if (copy_tessface_data) {
+			CustomData_copy_data(&source->faceData, &dm->faceData, 0, 0, numTessFaces);
+		}
 	}
 
 	/* now add mvert/medge/mface layers */
@@ -2451,7 +2465,7 @@ static DerivedMesh *cddm_copy_ex(DerivedMesh *source,
 	}
 
 	if (!faces_from_tessfaces) {
-		DM_DupPolys(source, dm);
+		DM_DupPolys_ex(source, dm, share_layers ? CD_SHARE : CD_DUPLICATE);
 	}
 	else {
 		CDDM_tessfaces_to_faces(dm);
@@ -2465,17 +2479,22 @@ static DerivedMesh *cddm_copy_ex(DerivedMesh *source,
 
 DerivedMesh *CDDM_copy(DerivedMesh *source)
 {
-	return cddm_copy_ex(source, false, false);
+	return cddm_copy_ex(source, false, false, false);
+}
+
+DerivedMesh *CDDM_copy_shared(DerivedMesh *source)
+{
+	return cddm_copy_ex(source, false, false, true);
 }
 
 DerivedMesh *CDDM_copy_from_tessface(DerivedMesh *source)
 {
-	return cddm_copy_ex(source, false, true);
+	return cddm_copy_ex(source, false, true, false);
 }
 
 DerivedMesh *CDDM_copy_with_tessface(DerivedMesh *source)
 {
-	return cddm_copy_ex(source, true, false);
+	return cddm_copy_ex(source, true, false, false);
 }
 
 /* note, the CD_ORIGINDEX layers are all 0, so if there is a direct
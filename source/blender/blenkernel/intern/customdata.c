@@ -60,6 +60,8 @@
 
 #include "bmesh.h"
 
+#include "atomic_ops.h"
+
 /* only for customdata_data_transfer_interp_normal_normals */
 #include "data_transfer_intern.h"
 
@@ -1404,6 +1406,130 @@ void customData_mask_layers__print(CustomDataMask mask)
 	}
 }
 
+/********************* Shared layers *********************/
+
+/* Layers copied with CD_SHARE point to the data of their source layer, the data is only
+ * duplicated once one of them is written to, so layers a modifier doesn't touch aren't
+ * copied along the modifier stack (copy-on-write).
+ *
+ * Like referenced layers, shared layers must be made writable with
+ * CustomData_duplicate_referenced_layer* (or be written through the element writers
+ * like CustomData_copy_data and CustomData_interp), the plain accessors only read.
+ * Only layer types a Mesh can store are shared, those are the ones modifiers already
+ * expect to be referenced, and not the main element arrays DerivedMesh caches. */
+
+typedef struct CustomDataLayerShared {
+	uint32_t users;  /* number of layers using the data */
+	int totelem;     /* number of elements when the data was shared */
+} CustomDataLayerShared;
+
+static void *customData_duplicate_data(const LayerTypeInfo *typeInfo, const void *data, const int totelem)
+{
+	/* MEM_dupallocN won't work in case of complex layers, like e.g.
+	 * CD_MDEFORMVERT, which has pointers to allocated data...
+	 * So in case a custom copy function is defined, use it!
+	 */
+	if (typeInfo->copy) {
+		void *dst_data = MEM_mallocN((size_t)totelem * typeInfo->size, "CD duplicate ref layer");
+		typeInfo->copy(data, dst_data, totelem);
+		return dst_data;
+	}
+	else {
+		return MEM_dupallocN(data);
+	}
+}
+
+static void customData_free_data(const LayerTypeInfo *typeInfo, void *data, const int totelem)
+{
+	if (typeInfo->free)
+		typeInfo->free(data, totelem, typeInfo->size);
+
+	MEM_freeN(data);
+}
+
+static void customData_layer_share(CustomDataLayer *layer, CustomDataLayer *newlayer, const int totelem)
+{
+	if (layer->shared == NULL) {
+		CustomDataLayerShared *shared = MEM_mallocN(sizeof(*shared), __func__);
+
+		shared->users = 1;
+		shared->totelem = totelem;
+
+		/* The same source may be copied from several threads. */
+		if (atomic_cas_ptr((void **)&layer->shared, NULL, shared) != NULL) {
+			MEM_freeN(shared);
+		}
+	}
+
+	BLI_assert(layer->shared->totelem == totelem);
+
+	atomic_add_and_fetch_uint32(&layer->shared->users, 1);
+	newlayer->data = layer->data;
+	newlayer->shared = layer->shared;
+}
+
+static bool customData_layer_is_shareable(const CustomDataLayer *layer)
+{
+	const CustomDataMask mask = CD_MASK_MESH &
+	        ~(CD_MASK_MVERT | CD_MASK_MEDGE | CD_MASK_MFACE | CD_MASK_MLOOP | CD_MASK_MPOLY);
+
+	return layer->data && !(layer->flag & CD_FLAG_NOFREE) && (mask & CD_TYPE_AS_MASK(layer->type));
+}
+
+/**
+ * Give the layer its own data before it's written to, only copied if other layers still use it.
+ *
+ * \note Only call this on write paths, from the thread owning \a layer. Other copies may be
+ * made unique concurrently, so the data is duplicated before our user is released.
+ */
+static void customData_layer_ensure_unique(CustomDataLayer *layer)
+{
+	CustomDataLayerShared *shared = layer->shared;
+
+	if (shared == NULL) {
+		return;
+	}
+
+	layer->shared = NULL;
+
+	/* Last user: no other layer points to the data anymore, and a new copy can only be
+	 * shared from this layer, which isn't done while it's written to. */
+	if (atomic_add_and_fetch_uint32(&shared->users, 0) != 1) {
+		const LayerTypeInfo *typeInfo = layerType_getInfo(layer->type);
+		void *data = layer->data;
+
+		/* Copy before releasing, the last other user could free it otherwise. */
+		layer->data = customData_duplicate_data(typeInfo, data, shared->totelem);
+
+		if (atomic_sub_and_fetch_uint32(&shared->users, 1) != 0) {
+			return;
+		}
+
+		customData_free_data(typeInfo, data, shared->totelem);
+	}
+
+	MEM_freeN(shared);
+}
+
+/**
+ * Stop using the shared data without touching it, when the layer was its last user
+ * the data is left to the caller.
+ */
+static void customData_layer_release_shared(CustomDataLayer *layer)
+{
+	CustomDataLayerShared *shared = layer->shared;
+
+	if (shared == NULL) {
+		return;
+	}
+
+	layer->shared = NULL;
+
+	if (atomic_sub_and_fetch_uint32(&shared->users, 1) == 0) {
+		MEM_freeN(shared);
+	}
+}
+
 /********************* CustomData functions *********************/
 static void customData_update_offsets(CustomData *data);
 
@@ -1471,6 +1597,11 @@ bool CustomData_merge(const struct CustomData *source, struct CustomData *dest,
 		else if ((maxnumber != -1) && (number >= maxnumber)) continue;
 		else if (CustomData_get_layer_named(dest, type, layer->name)) continue;
 
+		if (alloctype == CD_ASSIGN) {
+			/* The new layer takes ownership, other copies can't see its changes. */
+			customData_layer_ensure_unique(layer);
+		}
+
 		switch (alloctype) {
 			case CD_ASSIGN:
 			case CD_REFERENCE:
@@ -1485,6 +1616,19 @@ bool CustomData_merge(const struct CustomData *source, struct CustomData *dest,
 		if ((alloctype == CD_ASSIGN) && (flag & CD_FLAG_NOFREE)) {
 			newlayer = customData_add_layer__internal(dest, type, CD_REFERENCE, data, totelem, layer->name);
 		}
+		else if (alloctype == CD_SHARE) {
+			if (customData_layer_is_shareable(layer)) {
+				newlayer = customData_add_layer__internal(dest, type, CD_ASSIGN, NULL, totelem, layer->name);
+				if (newlayer && newlayer->data == NULL) {
+					customData_layer_share(layer, newlayer, totelem);
+				}
+			}
+			else {
+				/* Referenced data may change or be freed by its owner, and other layers
+				 * may be written through the plain accessors. */
+				newlayer = customData_add_layer__internal(dest, type, CD_DUPLICATE, layer->data, totelem, layer->name);
+			}
+		}
 		else {
 			newlayer = customData_add_layer__internal(dest, type, alloctype, data, totelem, layer->name);
 		}
@@ -1515,6 +1659,7 @@ void CustomData_realloc(CustomData *data, int totelem)
 		if (layer->flag & CD_FLAG_NOFREE) {
 			continue;
 		}
+		customData_layer_ensure_unique(layer);
 		typeInfo = layerType_getInfo(layer->type);
 		layer->data = MEM_reallocN(layer->data, (size_t)totelem * typeInfo->size);
 	}
@@ -1535,14 +1680,24 @@ static void customData_free_layer__internal(CustomDataLayer *layer, int totelem)
 {
 	const LayerTypeInfo *typeInfo;
 
+	if (layer->shared) {
+		CustomDataLayerShared *shared = layer->shared;
+
+		layer->shared = NULL;
+
+		/* Still used by other copies. */
+		if (atomic_sub_and_fetch_uint32(&shared->users, 1) != 0) {
+			return;
+		}
+
+		totelem = shared->totelem;
+		MEM_freeN(shared);
+	}
+
 	if (!(layer->flag & CD_FLAG_NOFREE) && layer->data) {
 		typeInfo = layerType_getInfo(layer->type);
 
-		if (typeInfo->free)
-			typeInfo->free(layer->data, totelem, typeInfo->size);
-
-		if (layer->data)
-			MEM_freeN(layer->data);
+		customData_free_data(typeInfo, layer->data, totelem);
 	}
 }
 
@@ -1883,6 +2038,7 @@ static CustomDataLayer *customData_add_layer__internal(CustomData *data, int typ
 	data->layers[index].type = type;
 	data->layers[index].flag = flag;
 	data->layers[index].data = newlayerdata;
+	data->layers[index].shared = NULL;
 
 	if (name || (name = DATA_(typeInfo->defaultname))) {
 		BLI_strncpy(data->layers[index].name, name, sizeof(data->layers[index].name));
@@ -2041,23 +2197,12 @@ static void *customData_duplicate_referenced_layer_index(CustomData *data, const
 	layer = &data->layers[layer_index];
 
 	if (layer->flag & CD_FLAG_NOFREE) {
-		/* MEM_dupallocN won't work in case of complex layers, like e.g.
-		 * CD_MDEFORMVERT, which has pointers to allocated data...
-		 * So in case a custom copy function is defined, use it!
-		 */
-		const LayerTypeInfo *typeInfo = layerType_getInfo(layer->type);
-
-		if (typeInfo->copy) {
-			void *dst_data = MEM_mallocN((size_t)totelem * typeInfo->size, "CD duplicate ref layer");
-			typeInfo->copy(layer->data, dst_data, totelem);
-			layer->data = dst_data;
-		}
-		else {
-			layer->data = MEM_dupallocN(layer->data);
-		}
-
+		layer->data = customData_duplicate_data(layerType_getInfo(layer->type), layer->data, totelem);
 		layer->flag &= ~CD_FLAG_NOFREE;
 	}
+	else {
+		customData_layer_ensure_unique(layer);
+	}
 
 	return layer->data;
 }
@@ -2104,7 +2249,7 @@ bool CustomData_is_referenced_layer(struct CustomData *data, int type)
 
 	layer = &data->layers[layer_index];
 
-	return (layer->flag & CD_FLAG_NOFREE) != 0;
+	return (layer->flag & CD_FLAG_NOFREE) != 0 || layer->shared != NULL;
 }
 
 void CustomData_free_temporary(CustomData *data, int totelem)
@@ -2167,7 +2312,10 @@ static void CustomData_copy_data_layer(
 	const LayerTypeInfo *typeInfo;
 
 	const void *src_data = source->layers[src_i].data;
-	void *dst_data = dest->layers[dst_i].data;
+	void *dst_data;
+
+	customData_layer_ensure_unique(&dest->layers[dst_i]);
+	dst_data = dest->layers[dst_i].data;
 
 	typeInfo = layerType_getInfo(source->layers[src_i].type);
 
@@ -2256,6 +2404,8 @@ void CustomData_free_elem(CustomData *data, int index, int count)
 			if (typeInfo->free) {
 				size_t offset = (size_t)index * typeInfo->size;
 
+				customData_layer_ensure_unique(&data->layers[i]);
+
 				typeInfo->free(POINTER_OFFSET(data->layers[i].data, offset), count, typeInfo->size);
 			}
 		}
@@ -2299,6 +2449,8 @@ void CustomData_interp(const CustomData *source, CustomData *dest,
 		if (dest->layers[dest_i].type == source->layers[src_i].type) {
 			void *src_data = source->layers[src_i].data;
 
+			customData_layer_ensure_unique(&dest->layers[dest_i]);
+
 			for (j = 0; j < count; ++j) {
 				sources[j] = POINTER_OFFSET(src_data, (size_t)src_indices[j] * typeInfo->size);
 			}
@@ -2335,6 +2487,8 @@ void CustomData_swap_corners(struct CustomData *data, int index, const int *corn
 		if (typeInfo->swap) {
 			const size_t offset = (size_t)index * typeInfo->size;
 
+			customData_layer_ensure_unique(&data->layers[i]);
+
 			typeInfo->swap(POINTER_OFFSET(data->layers[i].data, offset), corner_indices);
 		}
 	}
@@ -2359,6 +2513,9 @@ void CustomData_swap(struct CustomData *data, const int index_a, const int index
 		const size_t offset_b = size * index_b;
 
 		void *buff = size <= sizeof(buff_static) ? buff_static : MEM_mallocN(size, __func__);
+
+		customData_layer_ensure_unique(&data->layers[i]);
+
 		memcpy(buff, POINTER_OFFSET(data->layers[i].data, offset_a), size);
 		memcpy(POINTER_OFFSET(data->layers[i].data, offset_a), POINTER_OFFSET(data->layers[i].data, offset_b), size);
 		memcpy(POINTER_OFFSET(data->layers[i].data, offset_b), buff, size);
@@ -2471,6 +2628,9 @@ void *CustomData_set_layer(const CustomData *data, int type, void *ptr)
 
 	if (layer_index == -1) return NULL;
 
+	/* The replaced data is left to the caller as for other layers, unless other layers
+	 * still share it. */
+	customData_layer_release_shared(&data->layers[layer_index]);
 	data->layers[layer_index].data = ptr;
 
 	return ptr;
@@ -2482,6 +2642,9 @@ void *CustomData_set_layer_n(const struct CustomData *data, int type, int n, voi
 	int layer_index = CustomData_get_layer_index_n(data, type, n);
 	if (layer_index == -1) return NULL;
 
+	/* The replaced data is left to the caller as for other layers, unless other layers
+	 * still share it. */
+	customData_layer_release_shared(&data->layers[layer_index]);
 	data->layers[layer_index].data = ptr;
 
 	return ptr;
@@ -2489,10 +2652,14 @@ void *CustomData_set_layer_n(const struct CustomData *data, int type, int n, voi
 
 void CustomData_set(const CustomData *data, int index, int type, const void *source)
 {
-	void *dest = CustomData_get(data, index, type);
+	const int layer_index = CustomData_get_active_layer_index(data, type);
 	const LayerTypeInfo *typeInfo = layerType_getInfo(type);
+	void *dest;
 
-	if (!dest) return;
+	if (layer_index == -1) return;
+
+	customData_layer_ensure_unique(&data->layers[layer_index]);
+	dest = CustomData_get(data, index, type);
 
 	if (typeInfo->copy)
 		typeInfo->copy(source, dest, 1);
@@ -2830,7 +2997,12 @@ void CustomData_bmesh_free_block_data(CustomData *data, void *block)
 		memset(block, 0, data->totsize);
 }
 
-static void CustomData_bmesh_alloc_block(CustomData *data, void **block)
+/**
+ * Allocate a (non-initialized) block from the pool of \a data, freeing the previous one if any.
+ *
+ * Allocating blocks up-front allows to fill them from several threads afterwards.
+ */
+void CustomData_bmesh_alloc_block(CustomData *data, void **block)
 {
 
 	if (*block)
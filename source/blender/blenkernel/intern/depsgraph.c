@@ -1716,6 +1716,8 @@ static void dag_scene_build(Main *bmain, Scene *sce)
 /* clear all dependency graphs */
 void DAG_relations_tag_update(Main *bmain)
 {
+	object_dupli_cache_tag_update();
+
 	if (DEG_depsgraph_use_legacy()) {
 		Scene *sce;
 		for (sce = bmain->scene.first; sce; sce = sce->id.next) {
@@ -2507,6 +2509,8 @@ void DAG_on_visible_update(Main *bmain, const bool do_time)
 	ListBase listbase;
 	DagSceneLayer *dsl;
 
+	object_dupli_cache_tag_update();
+
 	if (!DEG_depsgraph_use_legacy()) {
 		/* Inform new dependnecy graphs about visibility changes. */
 		DEG_on_visible_update(bmain, do_time);
@@ -2966,6 +2970,8 @@ void DAG_ids_clear_recalc(Main *bmain)
 
 void DAG_id_tag_update_ex(Main *bmain, ID *id, short flag)
 {
+	object_dupli_cache_tag_update();
+
 	if (!DEG_depsgraph_use_legacy()) {
 		DEG_id_tag_update_ex(bmain, id, flag);
 		return;
@@ -3053,6 +3059,8 @@ void DAG_id_tag_update(ID *id, short flag)
 
 void DAG_id_type_tag(Main *bmain, short idtype)
 {
+	object_dupli_cache_tag_update();
+
 	if (idtype == ID_NT) {
 		/* stupid workaround so parent datablocks of nested nodetree get looped
 		 * over when we loop over tagged datablock types */
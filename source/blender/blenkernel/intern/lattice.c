@@ -40,6 +40,7 @@
 #include "BLI_listbase.h"
 #include "BLI_bitmap.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
 
 #include "DNA_mesh_types.h"
 #include "DNA_meshdata_types.h"
@@ -705,6 +706,48 @@ static bool calc_curve_deform(Scene *scene, Object *par, float co[3],
 	return false;
 }
 
+typedef struct CurveDeformUserdata {
+	Scene *scene;
+	Object *cuOb;
+	CurveDeform *cd;
+	float (*vertexCos)[3];
+	const MDeformVert *dvert;
+	int defgrp_index;
+	short defaxis;
+	/* coordinates were already moved into 'cd->curvespace' by the bounds pass */
+	bool in_curvespace;
+} CurveDeformUserdata;
+
+static void curve_deform_vert_task(void *userdata, const int index)
+{
+	const CurveDeformUserdata *data = userdata;
+	CurveDeform *cd = data->cd;
+	float *co = data->vertexCos[index];
+
+	if (data->dvert) {
+		const float weight = defvert_find_weight(&data->dvert[index], data->defgrp_index);
+
+		if (weight > 0.0f) {
+			float vec[3];
+
+			if (!data->in_curvespace) {
+				mul_m4_v3(cd->curvespace, co);
+			}
+			copy_v3_v3(vec, co);
+			calc_curve_deform(data->scene, data->cuOb, vec, data->defaxis, cd, NULL);
+			interp_v3_v3v3(co, co, vec, weight);
+			mul_m4_v3(cd->objectspace, co);
+		}
+	}
+	else {
+		if (!data->in_curvespace) {
+			mul_m4_v3(cd->curvespace, co);
+		}
+		calc_curve_deform(data->scene, data->cuOb, co, data->defaxis, cd, NULL);
+		mul_m4_v3(cd->objectspace, co);
+	}
+}
+
 void curve_deform_verts(
         Scene *scene, Object *cuOb, Object *target, DerivedMesh *dm, float (*vertexCos)[3],
         int numVerts, const char *vgroup, short defaxis)
@@ -712,6 +755,7 @@ void curve_deform_verts(
 	Curve *cu;
 	int a;
 	CurveDeform cd;
+	CurveDeformUserdata data;
 	MDeformVert *dvert = NULL;
 	int defgrp_index = -1;
 	const bool is_neg_axis = (defaxis > 2);
@@ -721,6 +765,13 @@ void curve_deform_verts(
 
 	cu = cuOb->data;
 
+	/* calc_curve_deform() would do this from the threads below */
+#ifdef CYCLIC_DEPENDENCY_WORKAROUND
+	if (cuOb->curve_cache == NULL) {
+		BKE_displist_make_curveTypes(scene, cuOb, false);
+	}
+#endif
+
 	init_curve_deform(cuOb, target, &cd);
 
 	/* dummy bounds, keep if CU_DEFORM_BOUNDS_OFF is set */
@@ -754,26 +805,21 @@ void curve_deform_verts(
 		}
 	}
 
-	if (dvert) {
-		MDeformVert *dvert_iter;
-		float vec[3];
+	data.scene = scene;
+	data.cuOb = cuOb;
+	data.cd = &cd;
+	data.vertexCos = vertexCos;
+	data.dvert = dvert;
+	data.defgrp_index = defgrp_index;
+	data.defaxis = defaxis;
+	data.in_curvespace = false;
 
-		if (cu->flag & CU_DEFORM_BOUNDS_OFF) {
-			for (a = 0, dvert_iter = dvert; a < numVerts; a++, dvert_iter++) {
-				const float weight = defvert_find_weight(dvert_iter, defgrp_index);
+	if ((cu->flag & CU_DEFORM_BOUNDS_OFF) == 0) {
+		/* set mesh min/max bounds, the reduction stays serial */
+		INIT_MINMAX(cd.dmin, cd.dmax);
 
-				if (weight > 0.0f) {
-					mul_m4_v3(cd.curvespace, vertexCos[a]);
-					copy_v3_v3(vec, vertexCos[a]);
-					calc_curve_deform(scene, cuOb, vec, defaxis, &cd, NULL);
-					interp_v3_v3v3(vertexCos[a], vertexCos[a], vec, weight);
-					mul_m4_v3(cd.objectspace, vertexCos[a]);
-				}
-			}
-		}
-		else {
-			/* set mesh min/max bounds */
-			INIT_MINMAX(cd.dmin, cd.dmax);
+		if (dvert) {
+			MDeformVert *dvert_iter;
 
 			for (a = 0, dvert_iter = dvert; a < numVerts; a++, dvert_iter++) {
 				if (defvert_find_weight(dvert_iter, defgrp_index) > 0.0f) {
@@ -781,44 +827,19 @@ void curve_deform_verts(
 					minmax_v3v3_v3(cd.dmin, cd.dmax, vertexCos[a]);
 				}
 			}
-
-			for (a = 0, dvert_iter = dvert; a < numVerts; a++, dvert_iter++) {
-				const float weight = defvert_find_weight(dvert_iter, defgrp_index);
-
-				if (weight > 0.0f) {
-					/* already in 'cd.curvespace', prev for loop */
-					copy_v3_v3(vec, vertexCos[a]);
-					calc_curve_deform(scene, cuOb, vec, defaxis, &cd, NULL);
-					interp_v3_v3v3(vertexCos[a], vertexCos[a], vec, weight);
-					mul_m4_v3(cd.objectspace, vertexCos[a]);
-				}
-			}
-		}
-	}
-	else {
-		if (cu->flag & CU_DEFORM_BOUNDS_OFF) {
-			for (a = 0; a < numVerts; a++) {
-				mul_m4_v3(cd.curvespace, vertexCos[a]);
-				calc_curve_deform(scene, cuOb, vertexCos[a], defaxis, &cd, NULL);
-				mul_m4_v3(cd.objectspace, vertexCos[a]);
-			}
 		}
 		else {
-			/* set mesh min max bounds */
-			INIT_MINMAX(cd.dmin, cd.dmax);
-				
 			for (a = 0; a < numVerts; a++) {
 				mul_m4_v3(cd.curvespace, vertexCos[a]);
 				minmax_v3v3_v3(cd.dmin, cd.dmax, vertexCos[a]);
 			}
-	
-			for (a = 0; a < numVerts; a++) {
-				/* already in 'cd.curvespace', prev for loop */
-				calc_curve_deform(scene, cuOb, vertexCos[a], defaxis, &cd, NULL);
-				mul_m4_v3(cd.objectspace, vertexCos[a]);
-			}
 		}
+
+		data.in_curvespace = true;
 	}
+
+	/* the path is only read from here on, each vertex is independent */
+	BLI_task_parallel_range(0, numVerts, &data, curve_deform_vert_task, numVerts > 1000);
 }
 
 /* input vec and orco = local coord in armature space */
@@ -856,12 +877,35 @@ void curve_deform_vector(Scene *scene, Object *cuOb, Object *target,
 
 }
 
+typedef struct LatticeDeformUserdata {
+	LatticeDeformData *lattice_deform_data;
+	float (*vertexCos)[3];
+	const MDeformVert *dvert;
+	int defgrp_index;
+	float fac;
+} LatticeDeformUserdata;
+
+static void lattice_deform_vert_task(void *userdata, const int index)
+{
+	const LatticeDeformUserdata *data = userdata;
+
+	if (data->dvert != NULL) {
+		const float weight = defvert_find_weight(&data->dvert[index], data->defgrp_index);
+
+		if (weight > 0.0f)
+			calc_latt_deform(data->lattice_deform_data, data->vertexCos[index], weight * data->fac);
+	}
+	else {
+		calc_latt_deform(data->lattice_deform_data, data->vertexCos[index], data->fac);
+	}
+}
+
 void lattice_deform_verts(Object *laOb, Object *target, DerivedMesh *dm,
                           float (*vertexCos)[3], int numVerts, const char *vgroup, float fac)
 {
 	LatticeDeformData *lattice_deform_data;
-	int a;
-	bool use_vgroups;
+	MDeformVert *dvert = NULL;
+	int defgrp_index = -1;
 
 	if (laOb->type != OB_LATTICE)
 		return;
@@ -875,40 +919,34 @@ void lattice_deform_verts(Object *laOb, Object *target, DerivedMesh *dm,
 	if (target && target->type == OB_MESH) {
 		/* if there's derived data without deformverts, don't use vgroups */
 		if (dm) {
-			use_vgroups = (dm->getVertDataArray(dm, CD_MDEFORMVERT) != NULL);
+			dvert = dm->getVertDataArray(dm, CD_MDEFORMVERT);
 		}
 		else {
-			Mesh *me = target->data;
-			use_vgroups = (me->dvert != NULL);
+			dvert = ((Mesh *)target->data)->dvert;
 		}
 	}
+
+	if (vgroup && vgroup[0] && dvert) {
+		defgrp_index = defgroup_name_index(target, vgroup);
+	}
 	else {
-		use_vgroups = false;
+		dvert = NULL;
 	}
-	
-	if (vgroup && vgroup[0] && use_vgroups) {
-		Mesh *me = target->data;
-		const int defgrp_index = defgroup_name_index(target, vgroup);
-		float weight;
 
-		if (defgrp_index >= 0 && (me->dvert || dm)) {
-			MDeformVert *dvert = me->dvert;
-			
-			for (a = 0; a < numVerts; a++, dvert++) {
-				if (dm) dvert = dm->getVertData(dm, a, CD_MDEFORMVERT);
-
-				weight = defvert_find_weight(dvert, defgrp_index);
+	/* a missing vertex group leaves everything in place */
+	if (dvert == NULL || defgrp_index != -1) {
+		LatticeDeformUserdata data = {
+		    .lattice_deform_data = lattice_deform_data,
+		    .vertexCos = vertexCos,
+		    .dvert = dvert,
+		    .defgrp_index = defgrp_index,
+		    .fac = fac,
+		};
 
-				if (weight > 0.0f)
-					calc_latt_deform(lattice_deform_data, vertexCos[a], weight * fac);
-			}
-		}
-	}
-	else {
-		for (a = 0; a < numVerts; a++) {
-			calc_latt_deform(lattice_deform_data, vertexCos[a], fac);
-		}
+		/* calc_latt_deform() only reads the lattice, each vertex is independent */
+		BLI_task_parallel_range(0, numVerts, &data, lattice_deform_vert_task, numVerts > 1000);
 	}
+
 	end_latt_deform(lattice_deform_data);
 }
 
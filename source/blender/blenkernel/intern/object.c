@@ -412,6 +412,8 @@ void BKE_object_free(Object *ob)
 	BKE_animdata_free((ID *)ob, false);
 
 	BKE_object_free_modifiers(ob);
+	DM_modifier_cache_free(ob);
+	object_dupli_cache_free(ob);
 
 	MEM_SAFE_FREE(ob->mat);
 	MEM_SAFE_FREE(ob->matbits);
@@ -1184,6 +1186,8 @@ void BKE_object_copy_data(Main *UNUSED(bmain), Object *ob_dst, const Object *ob_
 	
 	/* Do not copy runtime curve data. */
 	ob_dst->curve_cache = NULL;
+	ob_dst->modifier_cache = NULL;
+	ob_dst->dupli_table = NULL;
 
 	/* Do not copy object's preview (mostly due to the fact renderers create temp copy of objects). */
 	if ((flag & LIB_ID_COPY_NO_PREVIEW) == 0 && false) {  /* XXX TODO temp hack */
@@ -32,11 +32,13 @@
 #include <limits.h>
 #include <stdlib.h>
 #include <stddef.h>
+#include <string.h>
 
 #include "MEM_guardedalloc.h"
 
 #include "BLI_listbase.h"
 #include "BLI_string_utf8.h"
+#include "BLI_threads.h"
 
 #include "BLI_math.h"
 #include "BLI_rand.h"
@@ -62,6 +64,7 @@
 #include "BKE_editmesh.h"
 #include "BKE_anim.h"
 
+#include "atomic_ops.h"
 
 #include "BLI_strict_flags.h"
 #include "BLI_hash.h"
@@ -84,8 +87,8 @@ typedef struct DupliContext {
 
 	const struct DupliGenerator *gen;
 
-	/* result containers */
-	ListBase *duplilist; /* legacy doubly-linked list */
+	/* result container */
+	DupliTable *table;
 } DupliContext;
 
 typedef struct DupliGenerator {
@@ -115,7 +118,7 @@ static void init_context(DupliContext *r_ctx, EvaluationContext *eval_ctx, Scene
 
 	r_ctx->gen = get_dupli_generator(r_ctx);
 
-	r_ctx->duplilist = NULL;
+	r_ctx->table = NULL;
 }
 
 /* create sub-context for recursive duplis */
@@ -141,64 +144,74 @@ static void copy_dupli_context(DupliContext *r_ctx, const DupliContext *ctx, Obj
 /* generate a dupli instance
  * mat is transform of the object relative to current context (including object obmat)
  */
-static DupliObject *make_dupli(const DupliContext *ctx,
-                               Object *ob, float mat[4][4], int index,
-                               bool animated, bool hide)
+static DupliInstance *make_dupli(const DupliContext *ctx,
+                                 Object *ob, float mat[4][4], int index,
+                                 bool animated, bool hide)
 {
-	DupliObject *dob;
+	DupliTable *table = ctx->table;
+	DupliInstance *inst;
+	float inst_mat[4][4];
 	int i;
 
-	/* add a DupliObject instance to the result container */
-	if (ctx->duplilist) {
-		dob = MEM_callocN(sizeof(DupliObject), "dupli object");
-		BLI_addtail(ctx->duplilist, dob);
+	/* add an instance to the result container */
+	if (table) {
+		if (table->totinstance == table->maxinstance) {
+			table->maxinstance = max_ii(table->maxinstance * 2, 32);
+			table->instances = MEM_reallocN(table->instances, sizeof(DupliInstance) * (size_t)table->maxinstance);
+		}
+		inst = &table->instances[table->totinstance++];
+		memset(inst, 0, sizeof(*inst));
 	}
 	else {
 		return NULL;
 	}
 
-	dob->ob = ob;
-	mul_m4_m4m4(dob->mat, (float (*)[4])ctx->space_mat, mat);
-	dob->type = ctx->gen->type;
-	dob->animated = animated || ctx->animated; /* object itself or some parent is animated */
+	inst->ob = ob;
+	mul_m4_m4m4(inst_mat, (float (*)[4])ctx->space_mat, mat);
+	for (i = 0; i < 4; i++)
+		copy_v3_v3(inst->mat[i], inst_mat[i]);
+	inst->type = ctx->gen->type;
+	inst->animated = animated || ctx->animated; /* object itself or some parent is animated */
 
 	/* set persistent id, which is an array with a persistent index for each level
 	 * (particle number, vertex number, ..). by comparing this we can find the same
 	 * dupli object between frames, which is needed for motion blur. last level
 	 * goes first in the array. */
-	dob->persistent_id[0] = index;
+	inst->persistent_id[0] = index;
 	for (i = 1; i < ctx->level + 1; i++)
-		dob->persistent_id[i] = ctx->persistent_id[ctx->level - i];
+		inst->persistent_id[i] = ctx->persistent_id[ctx->level - i];
 	/* fill rest of values with INT_MAX which index will never have as value */
 	for (; i < MAX_DUPLI_RECUR; i++)
-		dob->persistent_id[i] = INT_MAX;
+		inst->persistent_id[i] = INT_MAX;
 
 	if (hide)
-		dob->no_draw = true;
+		inst->no_draw = true;
 	/* metaballs never draw in duplis, they are instead merged into one by the basis
 	 * mball outside of the group. this does mean that if that mball is not in the
 	 * scene, they will not show up at all, limitation that should be solved once. */
 	if (ob->type == OB_MBALL)
-		dob->no_draw = true;
+		inst->no_draw = true;
 
 	/* random number */
 	/* the logic here is designed to match Cycles */
-	dob->random_id = BLI_hash_string(dob->ob->id.name + 2);
+	inst->random_id = BLI_hash_string(inst->ob->id.name + 2);
 
-	if (dob->persistent_id[0] != INT_MAX) {
+	if (inst->persistent_id[0] != INT_MAX) {
+		/* hash the zeroed second half of DupliObject.persistent_id too */
 		for (i = 0; i < MAX_DUPLI_RECUR * 2; i++) {
-			dob->random_id = BLI_hash_int_2d(dob->random_id, (unsigned int)dob->persistent_id[i]);
+			const int id = (i < MAX_DUPLI_RECUR) ? inst->persistent_id[i] : 0;
+			inst->random_id = BLI_hash_int_2d(inst->random_id, (unsigned int)id);
 		}
 	}
 	else {
-		dob->random_id = BLI_hash_int_2d(dob->random_id, 0);
+		inst->random_id = BLI_hash_int_2d(inst->random_id, 0);
 	}
 
 	if (ctx->object != ob) {
-		dob->random_id ^= BLI_hash_int(BLI_hash_string(ctx->object->id.name + 2));
+		inst->random_id ^= BLI_hash_int(BLI_hash_string(ctx->object->id.name + 2));
 	}
 
-	return dob;
+	return inst;
 }
 
 /* recursive dupli objects
@@ -471,7 +484,7 @@ static void vertex_dupli__mapFunc(void *userData, int index, const float co[3],
 {
 	const VertexDupliData *vdd = userData;
 	Object *inst_ob = vdd->inst_ob;
-	DupliObject *dob;
+	DupliInstance *inst;
 	float obmat[4][4], space_mat[4][4];
 
 	/* obmat is transform to vertex */
@@ -486,10 +499,10 @@ static void vertex_dupli__mapFunc(void *userData, int index, const float co[3],
 	 */
 	mul_m4_m4m4(space_mat, obmat, inst_ob->imat);
 
-	dob = make_dupli(vdd->ctx, vdd->inst_ob, obmat, index, false, false);
+	inst = make_dupli(vdd->ctx, vdd->inst_ob, obmat, index, false, false);
 
 	if (vdd->orco)
-		copy_v3_v3(dob->orco, vdd->orco[index]);
+		copy_v3_v3(inst->orco, vdd->orco[index]);
 
 	/* recursion */
 	make_recursive_duplis(vdd->ctx, vdd->inst_ob, space_mat, index, false);
@@ -741,7 +754,7 @@ static void make_child_duplis_faces(const DupliContext *ctx, void *userdata, Obj
 	int a, totface = fdd->totface;
 	bool use_texcoords = ELEM(ctx->eval_ctx->mode, DAG_EVAL_RENDER, DAG_EVAL_PREVIEW);
 	float child_imat[4][4];
-	DupliObject *dob;
+	DupliInstance *inst;
 
 	invert_m4_m4(inst_ob->imat, inst_ob->obmat);
 	/* relative transform from parent to child space */
@@ -777,21 +790,21 @@ static void make_child_duplis_faces(const DupliContext *ctx, void *userdata, Obj
 		 */
 		mul_m4_m4m4(space_mat, obmat, inst_ob->imat);
 
-		dob = make_dupli(ctx, inst_ob, obmat, a, false, false);
+		inst = make_dupli(ctx, inst_ob, obmat, a, false, false);
 		if (use_texcoords) {
 			float w = 1.0f / (float)mp->totloop;
 
 			if (orco) {
 				int j;
 				for (j = 0; j < mp->totloop; j++) {
-					madd_v3_v3fl(dob->orco, orco[loopstart[j].v], w);
+					madd_v3_v3fl(inst->orco, orco[loopstart[j].v], w);
 				}
 			}
 
 			if (mloopuv) {
 				int j;
 				for (j = 0; j < mp->totloop; j++) {
-					madd_v2_v2fl(dob->uv, mloopuv[mp->loopstart + j].uv, w);
+					madd_v2_v2fl(inst->uv, mloopuv[mp->loopstart + j].uv, w);
 				}
 			}
 		}
@@ -862,7 +875,7 @@ static void make_duplis_particle_system(const DupliContext *ctx, ParticleSystem
 
 	GroupObject *go;
 	Object *ob = NULL, **oblist = NULL, obcopy, *obcopylist = NULL;
-	DupliObject *dob;
+	DupliInstance *inst;
 	ParticleDupliWeight *dw;
 	ParticleSettings *part;
 	ParticleData *pa;
@@ -1073,10 +1086,10 @@ static void make_duplis_particle_system(const DupliContext *ctx, ParticleSystem
 					/* individual particle transform */
 					mul_m4_m4m4(mat, pamat, tmat);
 
-					dob = make_dupli(ctx, go->ob, mat, a, false, false);
-					dob->particle_system = psys;
+					inst = make_dupli(ctx, go->ob, mat, a, false, false);
+					inst->particle_system = psys;
 					if (use_texcoords)
-						psys_get_dupli_texture(psys, part, sim.psmd, pa, cpa, dob->uv, dob->orco);
+						psys_get_dupli_texture(psys, part, sim.psmd, pa, cpa, inst->uv, inst->orco);
 				}
 			}
 			else {
@@ -1122,14 +1135,14 @@ static void make_duplis_particle_system(const DupliContext *ctx, ParticleSystem
 				if (part->draw & PART_DRAW_GLOBAL_OB)
 					add_v3_v3v3(mat[3], mat[3], vec);
 
-				dob = make_dupli(ctx, ob, mat, a, false, false);
-				dob->particle_system = psys;
+				inst = make_dupli(ctx, ob, mat, a, false, false);
+				inst->particle_system = psys;
 				if (use_texcoords)
-					psys_get_dupli_texture(psys, part, sim.psmd, pa, cpa, dob->uv, dob->orco);
+					psys_get_dupli_texture(psys, part, sim.psmd, pa, cpa, inst->uv, inst->orco);
 				/* XXX blender internal needs this to be set to dupligroup to render
 				 * groups correctly, but we don't want this hack for cycles */
 				if (dupli_type_hack && ctx->group)
-					dob->type = OB_DUPLIGROUP;
+					inst->type = OB_DUPLIGROUP;
 			}
 		}
 
@@ -1214,19 +1227,125 @@ static const DupliGenerator *get_dupli_generator(const DupliContext *ctx)
 }
 
 
-/* ---- ListBase dupli container implementation ---- */
+/* ---- Dupli table container implementation ---- */
 
-/* Returns a list of DupliObject */
-ListBase *object_duplilist_ex(EvaluationContext *eval_ctx, Scene *scene, Object *ob, bool update)
+/* bumped on every depsgraph tag, cached tables generated before are outdated */
+static unsigned int dupli_cache_update_id = 0;
+
+/* Returns a new table with all dupli instances of ob, free with free_object_dupli_table */
+DupliTable *object_dupli_table_ex(EvaluationContext *eval_ctx, Scene *scene, Object *ob, bool update)
 {
-	ListBase *duplilist = MEM_callocN(sizeof(ListBase), "duplilist");
+	DupliTable *table = MEM_callocN(sizeof(DupliTable), "DupliTable");
 	DupliContext ctx;
+
+	/* read before generating, so tags sent meanwhile invalidate the result */
+	table->update_id = atomic_add_and_fetch_uint32(&dupli_cache_update_id, 0);
+	table->scene = scene;
+	table->obedit = scene->obedit;
+	table->lay = scene->lay;
+	table->eval_mode = eval_ctx->mode;
+	table->ctime = BKE_scene_frame_get(scene);
+
 	init_context(&ctx, eval_ctx, scene, ob, NULL, update);
 	if (ctx.gen) {
-		ctx.duplilist = duplilist;
+		ctx.table = table;
 		ctx.gen->make_duplis(&ctx);
 	}
 
+	return table;
+}
+
+static bool dupli_table_is_valid(const DupliTable *table, const EvaluationContext *eval_ctx, const Scene *scene)
+{
+	return (table->update_id == atomic_add_and_fetch_uint32(&dupli_cache_update_id, 0) &&
+	        table->scene == scene &&
+	        table->obedit == scene->obedit &&
+	        table->lay == scene->lay &&
+	        table->eval_mode == eval_ctx->mode &&
+	        table->ctime == BKE_scene_frame_get(scene));
+}
+
+/* Returns the dupli instances of ob, kept in the object until the next depsgraph tag or frame change.
+ * The table is owned by the object, only use this from the main thread (viewport drawing). */
+DupliTable *object_dupli_table_cached(EvaluationContext *eval_ctx, Scene *scene, Object *ob)
+{
+	BLI_assert(BLI_thread_is_main());
+
+	if (ob->dupli_table) {
+		if (dupli_table_is_valid(ob->dupli_table, eval_ctx, scene)) {
+			return ob->dupli_table;
+		}
+		free_object_dupli_table(ob->dupli_table);
+	}
+
+	ob->dupli_table = object_dupli_table_ex(eval_ctx, scene, ob, true);
+	return ob->dupli_table;
+}
+
+void free_object_dupli_table(DupliTable *table)
+{
+	MEM_SAFE_FREE(table->instances);
+	MEM_freeN(table);
+}
+
+void object_dupli_cache_free(Object *ob)
+{
+	if (ob->dupli_table) {
+		free_object_dupli_table(ob->dupli_table);
+		ob->dupli_table = NULL;
+	}
+}
+
+/* outdates all cached dupli tables, called when tagging the depsgraph */
+void object_dupli_cache_tag_update(void)
+{
+	atomic_add_and_fetch_uint32(&dupli_cache_update_id, 1);
+}
+
+void dupli_instance_mat_get(const DupliInstance *inst, float r_mat[4][4])
+{
+	int i;
+
+	for (i = 0; i < 4; i++) {
+		copy_v3_v3(r_mat[i], inst->mat[i]);
+		r_mat[i][3] = 0.0f;
+	}
+	r_mat[3][3] = 1.0f;
+}
+
+/* fill in a DupliObject for code which still needs one, the list links are left as they are */
+void dupli_instance_to_dupli_object(const DupliInstance *inst, DupliObject *r_dob)
+{
+	r_dob->ob = inst->ob;
+	dupli_instance_mat_get(inst, r_dob->mat);
+	copy_v3_v3(r_dob->orco, inst->orco);
+	copy_v2_v2(r_dob->uv, inst->uv);
+	r_dob->type = inst->type;
+	r_dob->no_draw = inst->no_draw;
+	r_dob->animated = inst->animated;
+	memcpy(r_dob->persistent_id, inst->persistent_id, sizeof(inst->persistent_id));
+	memset(r_dob->persistent_id + MAX_DUPLI_RECUR, 0, sizeof(r_dob->persistent_id) - sizeof(inst->persistent_id));
+	r_dob->particle_system = inst->particle_system;
+	r_dob->random_id = inst->random_id;
+}
+
+/* ---- ListBase dupli container implementation ---- */
+
+/* Returns a list of DupliObject */
+ListBase *object_duplilist_ex(EvaluationContext *eval_ctx, Scene *scene, Object *ob, bool update)
+{
+	ListBase *duplilist = MEM_callocN(sizeof(ListBase), "duplilist");
+	DupliTable *table = object_dupli_table_ex(eval_ctx, scene, ob, update);
+	DupliInstance *inst;
+
+	DUPLI_TABLE_ITER (inst, table) {
+		DupliObject *dob = MEM_callocN(sizeof(DupliObject), "dupli object");
+		dupli_instance_to_dupli_object(inst, dob);
+		BLI_addtail(duplilist, dob);
+	}
+
+	free_object_dupli_table(table);
+
 	return duplilist;
 }
 
@@ -1328,3 +1447,52 @@ void duplilist_free_apply_data(DupliApplyData *apply_data)
 	MEM_freeN(apply_data->extra);
 	MEM_freeN(apply_data);
 }
+
+DupliApplyData *dupli_table_apply(Object *ob, Scene *scene, const DupliTable *table)
+{
+	DupliApplyData *apply_data = NULL;
+	const int num_objects = table->totinstance;
+
+	if (num_objects > 0) {
+		const DupliInstance *inst;
+		int i;
+		apply_data = MEM_mallocN(sizeof(DupliApplyData), "DupliObject apply data");
+		apply_data->num_objects = num_objects;
+		apply_data->extra = MEM_mallocN(sizeof(DupliExtraData) * (size_t) num_objects,
+		                                "DupliObject apply extra data");
+
+		DUPLI_TABLE_ITER (inst, table) {
+			/* make sure derivedmesh is calculated once, before drawing */
+			if (scene && !(inst->ob->transflag & OB_DUPLICALCDERIVED) && inst->ob->type == OB_MESH) {
+				mesh_get_derived_final(scene, inst->ob, scene->customdata_mask);
+				inst->ob->transflag |= OB_DUPLICALCDERIVED;
+			}
+		}
+
+		i = 0;
+		DUPLI_TABLE_ITER (inst, table) {
+			/* copy obmat from duplis */
+			copy_m4_m4(apply_data->extra[i].obmat, inst->ob->obmat);
+			dupli_instance_mat_get(inst, inst->ob->obmat);
+
+			/* copy layers from the main duplicator object */
+			apply_data->extra[i].lay = inst->ob->lay;
+			inst->ob->lay = ob->lay;
+			i++;
+		}
+	}
+	return apply_data;
+}
+
+void dupli_table_restore(const DupliTable *table, DupliApplyData *apply_data)
+{
+	int i;
+	/* Restore object matrices, in reverse order as for duplilist_restore. */
+	for (i = apply_data->num_objects - 1; i >= 0; i--) {
+		const DupliInstance *inst = &table->instances[i];
+		copy_m4_m4(inst->ob->obmat, apply_data->extra[i].obmat);
+		inst->ob->transflag &= ~OB_DUPLICALCDERIVED;
+
+		inst->ob->lay = apply_data->extra[i].lay;
+	}
+}
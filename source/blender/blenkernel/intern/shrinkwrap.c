@@ -42,6 +42,8 @@
 #include "DNA_meshdata_types.h"
 #include "DNA_mesh_types.h"
 
+#include "MEM_guardedalloc.h"
+
 #include "BLI_math.h"
 #include "BLI_utildefines.h"
 #include "BLI_task.h"
@@ -67,6 +69,17 @@
 /* Util macros */
 #define OUT_OF_MEMORY() ((void)printf("Shrinkwrap: Out of memory\n"))
 
+/*
+ * Nearest point queries of all vertices, as one batch
+ *
+ * Vertices are converted to tree coordinates in parallel, the ones with a zero weight
+ * get a zero search distance so the batch skips them.
+ */
+typedef struct ShrinkwrapNearestBatch {
+	float (*co)[3];
+	BVHTreeNearest *nearest;
+} ShrinkwrapNearestBatch;
+
 typedef struct ShrinkwrapCalcCBData {
 	ShrinkwrapCalcData *calc;
 
@@ -79,59 +92,89 @@ typedef struct ShrinkwrapCalcCBData {
 
 	float *proj_axis;
 	SpaceTransform *local2aux;
+
+	ShrinkwrapNearestBatch *batch;
 } ShrinkwrapCalcCBData;
 
-/*
- * Shrinkwrap to the nearest vertex
- *
- * it builds a kdtree of vertexs we can attach to and then
- * for each vertex performs a nearest vertex search on the tree
- */
-static void shrinkwrap_calc_nearest_vertex_cb_ex(
-        void *userdata, void *userdata_chunk, const int i, const int UNUSED(threadid))
+static float shrinkwrap_vert_weight(const ShrinkwrapCalcData *calc, const int i)
 {
-	ShrinkwrapCalcCBData *data = userdata;
+	const float weight = defvert_array_find_weight_safe(calc->dvert, i, calc->vgroup);
 
-	ShrinkwrapCalcData *calc = data->calc;
-	BVHTreeFromMesh *treeData = data->treeData;
-	BVHTreeNearest *nearest = userdata_chunk;
+	return calc->invert_vgroup ? 1.0f - weight : weight;
+}
 
-	float *co = calc->vertexCos[i];
-	float tmp_co[3];
-	float weight = defvert_array_find_weight_safe(calc->dvert, i, calc->vgroup);
+static void shrinkwrap_nearest_batch_init_cb(void *userdata, const int i)
+{
+	ShrinkwrapCalcCBData *data = userdata;
+	ShrinkwrapCalcData *calc = data->calc;
+	ShrinkwrapNearestBatch *batch = data->batch;
 
-	if (calc->invert_vgroup) {
-		weight = 1.0f - weight;
-	}
+	batch->nearest[i].index = -1;
 
-	if (weight == 0.0f) {
+	if (shrinkwrap_vert_weight(calc, i) == 0.0f) {
+		batch->nearest[i].dist_sq = 0.0f;
+		zero_v3(batch->co[i]);
 		return;
 	}
 
+	batch->nearest[i].dist_sq = FLT_MAX;
+
 	/* Convert the vertex to tree coordinates */
 	if (calc->vert) {
-		copy_v3_v3(tmp_co, calc->vert[i].co);
+		copy_v3_v3(batch->co[i], calc->vert[i].co);
 	}
 	else {
-		copy_v3_v3(tmp_co, co);
+		copy_v3_v3(batch->co[i], calc->vertexCos[i]);
 	}
-	BLI_space_transform_apply(&calc->local2target, tmp_co);
+	BLI_space_transform_apply(&calc->local2target, batch->co[i]);
+}
+
+static void shrinkwrap_nearest_batch_find(
+        ShrinkwrapCalcData *calc, BVHTreeFromMesh *treeData, ShrinkwrapNearestBatch *batch)
+{
+	const size_t numVerts = (size_t)calc->numVerts;
+
+	batch->co = MEM_mallocN(sizeof(*batch->co) * numVerts, __func__);
+	batch->nearest = MEM_mallocN(sizeof(*batch->nearest) * numVerts, __func__);
+
+	ShrinkwrapCalcCBData data = {.calc = calc, .batch = batch};
+	BLI_task_parallel_range(
+	        0, calc->numVerts, &data, shrinkwrap_nearest_batch_init_cb,
+	        calc->numVerts > BKE_MESH_OMP_LIMIT);
+
+	/* Searches start from the previous hit of the same thread, see BLI_bvhtree_find_nearest_batch. */
+	BLI_bvhtree_find_nearest_batch(
+	        treeData->tree, (const float (*)[3])batch->co, calc->numVerts, batch->nearest,
+	        treeData->nearest_callback, treeData);
+}
+
+static void shrinkwrap_nearest_batch_free(ShrinkwrapNearestBatch *batch)
+{
+	MEM_freeN(batch->co);
+	MEM_freeN(batch->nearest);
+}
 
-	/* Use local proximity heuristics (to reduce the nearest search)
-	 *
-	 * If we already had an hit before.. we assume this vertex is going to have a close hit to that other vertex
-	 * so we can initiate the "nearest.dist" with the expected value to that last hit.
-	 * This will lead in pruning of the search tree. */
-	if (nearest->index != -1)
-		nearest->dist_sq = len_squared_v3v3(tmp_co, nearest->co);
-	else
-		nearest->dist_sq = FLT_MAX;
+/*
+ * Shrinkwrap to the nearest vertex
+ *
+ * it builds a kdtree of vertexs we can attach to and then
+ * for each vertex performs a nearest vertex search on the tree
+ */
+static void shrinkwrap_calc_nearest_vertex_cb(void *userdata, const int i)
+{
+	ShrinkwrapCalcCBData *data = userdata;
 
-	BLI_bvhtree_find_nearest(treeData->tree, tmp_co, nearest, treeData->nearest_callback, treeData);
+	ShrinkwrapCalcData *calc = data->calc;
+	const BVHTreeNearest *nearest = &data->batch->nearest[i];
 
+	float *co = calc->vertexCos[i];
+	float tmp_co[3];
+	float weight;
 
-	/* Found the nearest vertex */
+	/* Found the nearest vertex, vertices with a zero weight are never searched */
 	if (nearest->index != -1) {
+		weight = shrinkwrap_vert_weight(calc, i);
+
 		/* Adjusting the vertex weight,
 		 * so that after interpolating it keeps a certain distance from the nearest position */
 		if (nearest->dist_sq > FLT_EPSILON) {
@@ -150,7 +193,7 @@ static void shrinkwrap_calc_nearest_vertex_cb_ex(
 static void shrinkwrap_calc_nearest_vertex(ShrinkwrapCalcData *calc)
 {
 	BVHTreeFromMesh treeData = NULL_BVHTreeFromMesh;
-	BVHTreeNearest nearest  = NULL_BVHTreeNearest;
+	ShrinkwrapNearestBatch batch;
 
 	if (calc->target != NULL && calc->target->getNumVerts(calc->target) == 0) {
 		return;
@@ -161,16 +204,15 @@ static void shrinkwrap_calc_nearest_vertex(ShrinkwrapCalcData *calc)
 		OUT_OF_MEMORY();
 		return;
 	}
-	
-	/* Setup nearest */
-	nearest.index = -1;
-	nearest.dist_sq = FLT_MAX;
 
-	ShrinkwrapCalcCBData data = {.calc = calc, .treeData = &treeData};
-	BLI_task_parallel_range_ex(
-	            0, calc->numVerts, &data, &nearest, sizeof(nearest), shrinkwrap_calc_nearest_vertex_cb_ex,
-	            calc->numVerts > BKE_MESH_OMP_LIMIT, false);
+	shrinkwrap_nearest_batch_find(calc, &treeData, &batch);
 
+	ShrinkwrapCalcCBData data = {.calc = calc, .batch = &batch};
+	BLI_task_parallel_range(
+	        0, calc->numVerts, &data, shrinkwrap_calc_nearest_vertex_cb,
+	        calc->numVerts > BKE_MESH_OMP_LIMIT);
+
+	shrinkwrap_nearest_batch_free(&batch);
 	free_bvhtree_from_mesh(&treeData);
 }
 
@@ -494,49 +536,17 @@ static void shrinkwrap_calc_normal_projection(ShrinkwrapCalcData *calc, bool for
  * it builds a BVHTree from the target mesh and then performs a
  * NN matches for each vertex
  */
-static void shrinkwrap_calc_nearest_surface_point_cb_ex(
-        void *userdata, void *userdata_chunk, const int i, const int UNUSED(threadid))
+static void shrinkwrap_calc_nearest_surface_point_cb(void *userdata, const int i)
 {
 	ShrinkwrapCalcCBData *data = userdata;
 
 	ShrinkwrapCalcData *calc = data->calc;
-	BVHTreeFromMesh *treeData = data->treeData;
-	BVHTreeNearest *nearest = userdata_chunk;
+	const BVHTreeNearest *nearest = &data->batch->nearest[i];
 
 	float *co = calc->vertexCos[i];
-	float tmp_co[3];
-	float weight = defvert_array_find_weight_safe(calc->dvert, i, calc->vgroup);
+	float *tmp_co = data->batch->co[i];
 
-	if (calc->invert_vgroup) {
-		weight = 1.0f - weight;
-	}
-
-	if (weight == 0.0f) {
-		return;
-	}
-
-	/* Convert the vertex to tree coordinates */
-	if (calc->vert) {
-		copy_v3_v3(tmp_co, calc->vert[i].co);
-	}
-	else {
-		copy_v3_v3(tmp_co, co);
-	}
-	BLI_space_transform_apply(&calc->local2target, tmp_co);
-
-	/* Use local proximity heuristics (to reduce the nearest search)
-	 *
-	 * If we already had an hit before.. we assume this vertex is going to have a close hit to that other vertex
-	 * so we can initiate the "nearest.dist" with the expected value to that last hit.
-	 * This will lead in pruning of the search tree. */
-	if (nearest->index != -1)
-		nearest->dist_sq = len_squared_v3v3(tmp_co, nearest->co);
-	else
-		nearest->dist_sq = FLT_MAX;
-
-	BLI_bvhtree_find_nearest(treeData->tree, tmp_co, nearest, treeData->nearest_callback, treeData);
-
-	/* Found the nearest vertex */
+	/* Found the nearest vertex, vertices with a zero weight are never searched */
 	if (nearest->index != -1) {
 		if (calc->smd->shrinkOpts & MOD_SHRINKWRAP_KEEP_ABOVE_SURFACE) {
 			/* Make the vertex stay on the front side of the face */
@@ -557,14 +567,14 @@ static void shrinkwrap_calc_nearest_surface_point_cb_ex(
 
 		/* Convert the coordinates back to mesh coordinates */
 		BLI_space_transform_invert(&calc->local2target, tmp_co);
-		interp_v3_v3v3(co, co, tmp_co, weight);  /* linear interpolation */
+		interp_v3_v3v3(co, co, tmp_co, shrinkwrap_vert_weight(calc, i));  /* linear interpolation */
 	}
 }
 
 static void shrinkwrap_calc_nearest_surface_point(ShrinkwrapCalcData *calc)
 {
 	BVHTreeFromMesh treeData = NULL_BVHTreeFromMesh;
-	BVHTreeNearest nearest  = NULL_BVHTreeNearest;
+	ShrinkwrapNearestBatch batch;
 
 	if (calc->target->getNumPolys(calc->target) == 0) {
 		return;
@@ -577,16 +587,15 @@ static void shrinkwrap_calc_nearest_surface_point(ShrinkwrapCalcData *calc)
 		return;
 	}
 
-	/* Setup nearest */
-	nearest.index = -1;
-	nearest.dist_sq = FLT_MAX;
+	/* Find the nearest surface points */
+	shrinkwrap_nearest_batch_find(calc, &treeData, &batch);
 
-	/* Find the nearest vertex */
-	ShrinkwrapCalcCBData data = {.calc = calc, .treeData = &treeData};
-	BLI_task_parallel_range_ex(
-	            0, calc->numVerts, &data, &nearest, sizeof(nearest), shrinkwrap_calc_nearest_surface_point_cb_ex,
-	            calc->numVerts > BKE_MESH_OMP_LIMIT, false);
+	ShrinkwrapCalcCBData data = {.calc = calc, .batch = &batch};
+	BLI_task_parallel_range(
+	        0, calc->numVerts, &data, shrinkwrap_calc_nearest_surface_point_cb,
+	        calc->numVerts > BKE_MESH_OMP_LIMIT);
 
+	shrinkwrap_nearest_batch_free(&batch);
 	free_bvhtree_from_mesh(&treeData);
 }
 
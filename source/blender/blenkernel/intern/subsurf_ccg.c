@@ -212,6 +212,21 @@ static CCGSubSurf *_getSubSurf(CCGSubSurf *prevSS, int subdivLevels,
 	return ccgSS;
 }
 
+/* Whether \a ss was created by #_getSubSurf with the same \a flags, so it can be synced again. */
+static bool subsurf_cache_is_compatible(CCGSubSurf *ss, CCGFlags flags)
+{
+	CCGKey key;
+	int useAging;
+
+	ccgSubSurf_getUseAgeCounts(ss, &useAging, NULL, NULL, NULL);
+	CCG_key_top_level(&key, ss);
+
+	return ((useAging != 0) == ((flags & CCG_USE_AGING) != 0) &&
+	        (ccgSubSurf_getSimpleSubdiv(ss) != 0) == ((flags & CCG_SIMPLE_SUBDIV) != 0) &&
+	        (key.has_normals != 0) == ((flags & CCG_CALC_NORMALS) != 0) &&
+	        (key.has_mask != 0) == ((flags & CCG_ALLOC_MASK) != 0));
+}
+
 static int getEdgeIndex(CCGSubSurf *ss, CCGEdge *e, int x, int edgeSize)
 {
 	CCGVert *v0 = ccgSubSurf_getEdgeVert0(e);
@@ -5145,9 +5160,17 @@ struct DerivedMesh *subsurf_make_derived_from_derived(
 			                           useSubsurfUv, dm, false);
 		}
 		else {
-			CCGFlags ccg_flags = useSimple | CCG_USE_ARENA | CCG_CALC_NORMALS;
+			CCGFlags ccg_flags = useSimple | CCG_CALC_NORMALS;
 			CCGSubSurf *prevSS = NULL;
 
+			if (flags & SUBSURF_ALLOC_PAINT_MASK)
+				ccg_flags |= CCG_ALLOC_MASK;
+
+			/* The final result is cached and synced again on the next evaluation,
+			 * the arena would keep growing with the hashes re-allocated by every sync. */
+			if (!(flags & SUBSURF_IS_FINAL_CALC))
+				ccg_flags |= CCG_USE_ARENA;
+
 			if (smd->mCache && (flags & SUBSURF_IS_FINAL_CALC)) {
 #ifdef WITH_OPENSUBDIV
 				/* With OpenSubdiv enabled we always tries to re-use previos
@@ -5164,16 +5187,18 @@ struct DerivedMesh *subsurf_make_derived_from_derived(
 				}
 				else
 #endif
-				{
+				/* Re-use the previous subsurf while its data layout matches, syncing
+				 * a deformed mesh with the same topology then evaluates the cached
+				 * stencil tables instead of building everything again. */
+				if (subsurf_cache_is_compatible(smd->mCache, ccg_flags)) {
+					prevSS = smd->mCache;
+				}
+				else {
 					ccgSubSurf_free(smd->mCache);
 					smd->mCache = NULL;
 				}
 			}
 
-
-			if (flags & SUBSURF_ALLOC_PAINT_MASK)
-				ccg_flags |= CCG_ALLOC_MASK;
-
 			ss = _getSubSurf(prevSS, levels, 3, ccg_flags);
 #ifdef WITH_OPENSUBDIV
 			ccgSubSurf_setSkipGrids(ss, use_gpu_backend);
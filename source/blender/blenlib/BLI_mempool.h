@@ -41,8 +41,10 @@ extern "C"
 
 struct BLI_mempool;
 struct BLI_mempool_chunk;
+struct BLI_mempool_local;
 
 typedef struct BLI_mempool BLI_mempool;
+typedef struct BLI_mempool_local BLI_mempool_local;
 
 BLI_mempool *BLI_mempool_create(unsigned int esize, unsigned int totelem,
                                 unsigned int pchunk, unsigned int flag) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
@@ -61,6 +63,13 @@ void      **BLI_mempool_as_tableN(BLI_mempool *pool, const char *allocstr) ATTR_
 void        BLI_mempool_as_array(BLI_mempool *pool, void *data) ATTR_NONNULL(1, 2);
 void       *BLI_mempool_as_arrayN(BLI_mempool *pool, const char *allocstr) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT ATTR_NONNULL(1, 2);
 
+BLI_mempool_local *BLI_mempool_local_create(BLI_mempool *pool) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT ATTR_NONNULL(1);
+/* not ATTR_MALLOC, elements stay reachable through the pool (iterators) once allocated */
+void        *BLI_mempool_local_alloc(BLI_mempool_local *local) ATTR_WARN_UNUSED_RESULT ATTR_NONNULL(1);
+void        *BLI_mempool_local_calloc(BLI_mempool_local *local) ATTR_WARN_UNUSED_RESULT ATTR_NONNULL(1);
+void         BLI_mempool_local_free(BLI_mempool_local *local, void *addr) ATTR_NONNULL(1, 2);
+void         BLI_mempool_local_destroy(BLI_mempool_local *local) ATTR_NONNULL(1);
+
 #ifndef NDEBUG
 void        BLI_mempool_set_memory_debug(void);
 #endif
@@ -39,8 +39,9 @@ struct BLI_mempool;
 
 /* Task Scheduler
  * 
- * Central scheduler that holds running threads ready to execute tasks. A single
- * queue holds the task from all pools.
+ * Central scheduler that holds running threads ready to execute tasks. A global
+ * queue holds the tasks pushed from outside of worker threads, tasks pushed from
+ * a worker thread go to its own queue, from which idle threads can steal them.
  *
  * Init/exit must be called before/after any task pools are created/freed, and
  * must be called from the main threads. All other scheduler and pool functions
@@ -155,11 +156,22 @@ void BLI_task_parallel_listbase(
 typedef struct MempoolIterData MempoolIterData;
 typedef void (*TaskParallelMempoolFunc)(void *userdata,
                                         MempoolIterData *iter);
+typedef void (*TaskParallelMempoolFuncEx)(void *userdata,
+                                          void *userdata_chunk,
+                                          MempoolIterData *iter);
 void BLI_task_parallel_mempool(
         struct BLI_mempool *mempool,
         void *userdata,
         TaskParallelMempoolFunc func,
         const bool use_threading);
+void BLI_task_parallel_mempool_finalize(
+        struct BLI_mempool *mempool,
+        void *userdata,
+        void *userdata_chunk,
+        const size_t userdata_chunk_size,
+        TaskParallelMempoolFuncEx func_ex,
+        TaskParallelRangeFuncFinalize func_finalize,
+        const bool use_threading);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,892 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file blender/blenlib/intern/BLI_flathash.c
+ *  \ingroup bli
+ *
+ * A general (pointer -> pointer) open addressing hash table, see BLI_ghash.c for the chaining one.
+ *
+ * Keys and values are stored inline in an array of slots. Each slot has a control byte,
+ * either #CTRL_EMPTY, #CTRL_DELETED or the 7 high bits of the hash of its key when used.
+ *
+ * Lookups probe groups of #GROUP_WIDTH control bytes at once (with SSE2 when available),
+ * only the slots whose control byte matches the hash are compared with the key,
+ * and the probing stops at the first group with an empty slot.
+ *
+ * Control bytes of the first group are mirrored after the last one,
+ * so a group can be loaded from any slot without wrapping.
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_sys_types.h"  /* for intptr_t support */
+#include "BLI_utildefines.h"
+#include "BLI_math_bits.h"
+
+#include "BLI_flathash.h"
+#include "BLI_strict_flags.h"
+
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
+#define GROUP_WIDTH 16
+
+#define CTRL_EMPTY   ((signed char)-128)
+#define CTRL_DELETED ((signed char)-2)
+
+#define SLOT_NOT_FOUND UINT_MAX
+
+/* Minimum capacity, must be at least #GROUP_WIDTH for the mirrored control bytes. */
+#define CAPACITY_MIN GROUP_WIDTH
+
+/* One bit per slot of a group. */
+typedef unsigned int GroupMask;
+
+struct FlatHash {
+	GHashHashFP hashfp;
+	GHashCmpFP cmpfp;
+
+	/* capacity + GROUP_WIDTH control bytes. */
+	signed char *ctrl;
+	/* capacity * slot_len pointers, key then value. */
+	void **slots;
+	/* Power of two. */
+	uint capacity;
+	uint nentries;
+	/* Number of slots that can still be filled before resizing, deleted slots are not reused by it. */
+	uint growth_left;
+	/* 2 for FlatHash, 1 for FlatSet. */
+	uint slot_len;
+};
+
+#define SLOT(fh, index) (&(fh)->slots[(size_t)(index) * (fh)->slot_len])
+
+/* -------------------------------------------------------------------- */
+/* FlatHash Internal API */
+
+/** \name Internal Utility API
+ * \{ */
+
+/* The maximum number of used slots is 7/8 of the capacity. */
+BLI_INLINE uint flathash_growth_limit(const uint capacity)
+{
+	return capacity - capacity / 8;
+}
+
+static uint flathash_capacity_for(const uint nentries)
+{
+	uint capacity = CAPACITY_MIN;
+
+	while (flathash_growth_limit(capacity) < nentries) {
+		capacity <<= 1;
+	}
+
+	return capacity;
+}
+
+/* Mix the user hash, many of them (pointers, integers) have their entropy in only a part of the bits. */
+BLI_INLINE uint flathash_mix(const uint hash)
+{
+	const uint mix = hash * 0x9E3779B1u;
+	return mix ^ (mix >> 16);
+}
+
+/* Position where probing starts. */
+BLI_INLINE uint flathash_h1(const uint mix)
+{
+	return mix;
+}
+
+/* Control byte of a slot used by the key. */
+BLI_INLINE signed char flathash_h2(const uint mix)
+{
+	return (signed char)(mix >> 25);
+}
+
+BLI_INLINE GroupMask group_match(const signed char *group, const signed char h2)
+{
+#ifdef __SSE2__
+	const __m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+	return (GroupMask)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8((char)h2), ctrl));
+#else
+	GroupMask mask = 0;
+	uint i;
+
+	for (i = 0; i < GROUP_WIDTH; i++) {
+		if (group[i] == h2) {
+			mask |= 1u << i;
+		}
+	}
+
+	return mask;
+#endif
+}
+
+BLI_INLINE GroupMask group_match_empty(const signed char *group)
+{
+	return group_match(group, CTRL_EMPTY);
+}
+
+BLI_INLINE GroupMask group_match_empty_or_deleted(const signed char *group)
+{
+#ifdef __SSE2__
+	const __m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+	return (GroupMask)_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8((char)-1), ctrl));
+#else
+	GroupMask mask = 0;
+	uint i;
+
+	for (i = 0; i < GROUP_WIDTH; i++) {
+		if (group[i] < -1) {
+			mask |= 1u << i;
+		}
+	}
+
+	return mask;
+#endif
+}
+
+/* Number of slots before the last empty one of a group. */
+BLI_INLINE uint group_mask_leading_zeros(const GroupMask mask)
+{
+	uint count = 0;
+
+	while (count < GROUP_WIDTH && !(mask & (1u << (GROUP_WIDTH - 1 - count)))) {
+		count++;
+	}
+
+	return count;
+}
+
+BLI_INLINE void flathash_ctrl_set(FlatHash *fh, const uint index, const signed char ctrl)
+{
+	const uint mask = fh->capacity - 1;
+
+	fh->ctrl[index] = ctrl;
+	/* Mirror of the first group, same byte for other slots. */
+	fh->ctrl[((index - GROUP_WIDTH) & mask) + GROUP_WIDTH] = ctrl;
+}
+
+static void flathash_buffers_alloc(FlatHash *fh, const uint capacity)
+{
+	fh->capacity = capacity;
+	fh->ctrl = MEM_mallocN(sizeof(*fh->ctrl) * (size_t)(capacity + GROUP_WIDTH), "FlatHash ctrl");
+	fh->slots = MEM_mallocN(sizeof(*fh->slots) * (size_t)capacity * fh->slot_len, "FlatHash slots");
+	memset(fh->ctrl, CTRL_EMPTY, sizeof(*fh->ctrl) * (size_t)(capacity + GROUP_WIDTH));
+	fh->growth_left = flathash_growth_limit(capacity) - fh->nentries;
+}
+
+/**
+ * Find the slot of a key, or #SLOT_NOT_FOUND.
+ */
+static uint flathash_find(FlatHash *fh, const void *key, const uint mix)
+{
+	const uint mask = fh->capacity - 1;
+	const signed char h2 = flathash_h2(mix);
+	uint pos = flathash_h1(mix) & mask;
+	uint stride = 0;
+
+	while (true) {
+		const signed char *group = &fh->ctrl[pos];
+		GroupMask match = group_match(group, h2);
+
+		while (match) {
+			const uint index = (pos + bitscan_forward_clear_uint(&match)) & mask;
+			if (fh->cmpfp(key, SLOT(fh, index)[0]) == false) {
+				return index;
+			}
+		}
+
+		if (group_match_empty(group)) {
+			return SLOT_NOT_FOUND;
+		}
+
+		stride += GROUP_WIDTH;
+		pos = (pos + stride) & mask;
+	}
+}
+
+/**
+ * Find the first empty or deleted slot on the probe sequence of a hash.
+ */
+static uint flathash_find_free(FlatHash *fh, const uint mix)
+{
+	const uint mask = fh->capacity - 1;
+	uint pos = flathash_h1(mix) & mask;
+	uint stride = 0;
+
+	while (true) {
+		GroupMask match = group_match_empty_or_deleted(&fh->ctrl[pos]);
+
+		if (match) {
+			return (pos + bitscan_forward_uint(match)) & mask;
+		}
+
+		stride += GROUP_WIDTH;
+		pos = (pos + stride) & mask;
+	}
+}
+
+/**
+ * Move all entries in new buffers of \a capacity, this also drops the deleted slots.
+ */
+static void flathash_resize(FlatHash *fh, const uint capacity)
+{
+	signed char *ctrl_old = fh->ctrl;
+	void **slots_old = fh->slots;
+	const uint capacity_old = fh->capacity;
+	uint i;
+
+	BLI_assert(flathash_growth_limit(capacity) >= fh->nentries);
+
+	flathash_buffers_alloc(fh, capacity);
+
+	for (i = 0; i < capacity_old; i++) {
+		if (ctrl_old[i] >= 0) {
+			void **slot_old = &slots_old[(size_t)i * fh->slot_len];
+			const uint mix = flathash_mix(fh->hashfp(slot_old[0]));
+			const uint index = flathash_find_free(fh, mix);
+
+			flathash_ctrl_set(fh, index, flathash_h2(mix));
+			memcpy(SLOT(fh, index), slot_old, sizeof(*slot_old) * fh->slot_len);
+		}
+	}
+
+	MEM_freeN(ctrl_old);
+	MEM_freeN(slots_old);
+}
+
+/**
+ * Use a free slot for a key not in the hash yet.
+ */
+static void **flathash_insert_slot(FlatHash *fh, void *key, const uint mix)
+{
+	uint index;
+	void **slot;
+
+	BLI_assert(flathash_find(fh, key, mix) == SLOT_NOT_FOUND);
+
+	if (fh->growth_left == 0) {
+		/* Only purge the deleted slots when there are enough of them, else grow. */
+		if (fh->nentries * 2 <= flathash_growth_limit(fh->capacity)) {
+			flathash_resize(fh, fh->capacity);
+		}
+		else {
+			flathash_resize(fh, fh->capacity * 2);
+		}
+	}
+
+	index = flathash_find_free(fh, mix);
+	if (fh->ctrl[index] == CTRL_EMPTY) {
+		fh->growth_left--;
+	}
+
+	flathash_ctrl_set(fh, index, flathash_h2(mix));
+	fh->nentries++;
+
+	slot = SLOT(fh, index);
+	slot[0] = key;
+	return slot;
+}
+
+static void flathash_remove_index(FlatHash *fh, const uint index)
+{
+	const uint mask = fh->capacity - 1;
+	const GroupMask empty_before = group_match_empty(&fh->ctrl[(index - GROUP_WIDTH) & mask]);
+	const GroupMask empty_after = group_match_empty(&fh->ctrl[index]);
+
+	/* When the slot lies between empty slots closer than a group, no probing ever went past it
+	 * because of a full group, so it can be emptied instead of being marked deleted. */
+	if (empty_before && empty_after &&
+	    (bitscan_forward_uint(empty_after) + group_mask_leading_zeros(empty_before) < GROUP_WIDTH))
+	{
+		flathash_ctrl_set(fh, index, CTRL_EMPTY);
+		fh->growth_left++;
+	}
+	else {
+		flathash_ctrl_set(fh, index, CTRL_DELETED);
+	}
+
+	fh->nentries--;
+}
+
+static void flathash_free_slots(FlatHash *fh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp)
+{
+	uint i;
+
+	BLI_assert(keyfreefp || valfreefp);
+	BLI_assert(!valfreefp || fh->slot_len == 2);
+
+	for (i = 0; i < fh->capacity; i++) {
+		if (fh->ctrl[i] >= 0) {
+			void **slot = SLOT(fh, i);
+			if (keyfreefp) keyfreefp(slot[0]);
+			if (valfreefp) valfreefp(slot[1]);
+		}
+	}
+}
+
+static FlatHash *flathash_new(
+        GHashHashFP hashfp, GHashCmpFP cmpfp, const char *info,
+        const uint nentries_reserve, const uint slot_len)
+{
+	FlatHash *fh = MEM_mallocN(sizeof(*fh), info);
+
+	fh->hashfp = hashfp;
+	fh->cmpfp = cmpfp;
+	fh->nentries = 0;
+	fh->slot_len = slot_len;
+
+	flathash_buffers_alloc(fh, flathash_capacity_for(nentries_reserve));
+
+	return fh;
+}
+
+static void flathash_clear(FlatHash *fh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp, const uint nentries_reserve)
+{
+	const uint capacity = flathash_capacity_for(nentries_reserve);
+
+	if (keyfreefp || valfreefp) {
+		flathash_free_slots(fh, keyfreefp, valfreefp);
+	}
+
+	fh->nentries = 0;
+
+	if (capacity != fh->capacity) {
+		MEM_freeN(fh->ctrl);
+		MEM_freeN(fh->slots);
+		flathash_buffers_alloc(fh, capacity);
+	}
+	else {
+		memset(fh->ctrl, CTRL_EMPTY, sizeof(*fh->ctrl) * (size_t)(capacity + GROUP_WIDTH));
+		fh->growth_left = flathash_growth_limit(capacity);
+	}
+}
+
+/** \} */
+
+
+/** \name Public API
+ * \{ */
+
+/**
+ * Creates a new, empty FlatHash.
+ *
+ * \param hashfp  Hash callback.
+ * \param cmpfp  Comparison callback.
+ * \param info  Identifier string for the FlatHash.
+ * \param nentries_reserve  Optionally reserve the number of members that the hash will hold.
+ * Use this to avoid resizing buckets if the size is known or can be closely approximated.
+ * \return  An empty FlatHash.
+ */
+FlatHash *BLI_flathash_new_ex(GHashHashFP hashfp, GHashCmpFP cmpfp, const char *info,
+                              const unsigned int nentries_reserve)
+{
+	return flathash_new(hashfp, cmpfp, info, nentries_reserve, 2);
+}
+
+/**
+ * Wraps #BLI_flathash_new_ex with zero entries reserved.
+ */
+FlatHash *BLI_flathash_new(GHashHashFP hashfp, GHashCmpFP cmpfp, const char *info)
+{
+	return BLI_flathash_new_ex(hashfp, cmpfp, info, 0);
+}
+
+/**
+ * Frees the FlatHash and its members.
+ *
+ * \param fh  The FlatHash to free.
+ * \param keyfreefp  Optional callback to free the key.
+ * \param valfreefp  Optional callback to free the value.
+ */
+void BLI_flathash_free(FlatHash *fh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp)
+{
+	if (keyfreefp || valfreefp) {
+		flathash_free_slots(fh, keyfreefp, valfreefp);
+	}
+
+	MEM_freeN(fh->ctrl);
+	MEM_freeN(fh->slots);
+	MEM_freeN(fh);
+}
+
+/**
+ * Reserve given amount of entries (resize \a fh accordingly if needed).
+ */
+void BLI_flathash_reserve(FlatHash *fh, const unsigned int nentries_reserve)
+{
+	const uint capacity = flathash_capacity_for(nentries_reserve);
+
+	if (capacity > fh->capacity) {
+		flathash_resize(fh, capacity);
+	}
+}
+
+/**
+ * Insert a key/value pair into the \a fh.
+ *
+ * \note Duplicates are not checked,
+ * the caller is expected to ensure elements are unique.
+ */
+void BLI_flathash_insert(FlatHash *fh, void *key, void *val)
+{
+	void **slot = flathash_insert_slot(fh, key, flathash_mix(fh->hashfp(key)));
+	slot[1] = val;
+}
+
+/**
+ * Inserts a new value to a key that may already be in the FlatHash.
+ *
+ * Avoids #BLI_flathash_remove, #BLI_flathash_insert calls (double lookups)
+ *
+ * \returns true if a new key has been added.
+ */
+bool BLI_flathash_reinsert(FlatHash *fh, void *key, void *val, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp)
+{
+	const uint mix = flathash_mix(fh->hashfp(key));
+	const uint index = flathash_find(fh, key, mix);
+	void **slot;
+
+	if (index != SLOT_NOT_FOUND) {
+		slot = SLOT(fh, index);
+		if (keyfreefp) keyfreefp(slot[0]);
+		if (valfreefp) valfreefp(slot[1]);
+		slot[0] = key;
+		slot[1] = val;
+		return false;
+	}
+
+	slot = flathash_insert_slot(fh, key, mix);
+	slot[1] = val;
+	return true;
+}
+
+/**
+ * Lookup the value of \a key in \a fh.
+ *
+ * \param key  The key to lookup.
+ * \returns the value for \a key or NULL.
+ */
+void *BLI_flathash_lookup(FlatHash *fh, const void *key)
+{
+	const uint index = flathash_find(fh, key, flathash_mix(fh->hashfp(key)));
+	return (index != SLOT_NOT_FOUND) ? SLOT(fh, index)[1] : NULL;
+}
+
+/**
+ * A version of #BLI_flathash_lookup which accepts a fallback argument.
+ */
+void *BLI_flathash_lookup_default(FlatHash *fh, const void *key, void *val_default)
+{
+	const uint index = flathash_find(fh, key, flathash_mix(fh->hashfp(key)));
+	return (index != SLOT_NOT_FOUND) ? SLOT(fh, index)[1] : val_default;
+}
+
+/**
+ * Lookup a pointer to the value of \a key in \a fh.
+ *
+ * \returns the pointer to value for \a key or NULL.
+ * The pointer is only valid until the next insertion.
+ */
+void **BLI_flathash_lookup_p(FlatHash *fh, const void *key)
+{
+	const uint index = flathash_find(fh, key, flathash_mix(fh->hashfp(key)));
+	return (index != SLOT_NOT_FOUND) ? &SLOT(fh, index)[1] : NULL;
+}
+
+/**
+ * Ensure \a key is exists in \a fh, see #BLI_ghash_ensure_p.
+ *
+ * \returns true when the value didn't need to be added.
+ * (when false, the caller _must_ initialize the value).
+ */
+bool BLI_flathash_ensure_p(FlatHash *fh, void *key, void ***r_val)
+{
+	const uint mix = flathash_mix(fh->hashfp(key));
+	const uint index = flathash_find(fh, key, mix);
+
+	if (index != SLOT_NOT_FOUND) {
+		*r_val = &SLOT(fh, index)[1];
+		return true;
+	}
+
+	*r_val = &flathash_insert_slot(fh, key, mix)[1];
+	return false;
+}
+
+/**
+ * A version of #BLI_flathash_ensure_p that allows caller to re-assign the key.
+ * Typically used when the key is to be duplicated.
+ *
+ * \warning Caller _must_ write to \a r_key when returning false.
+ */
+bool BLI_flathash_ensure_p_ex(FlatHash *fh, const void *key, void ***r_key, void ***r_val)
+{
+	const uint mix = flathash_mix(fh->hashfp(key));
+	const uint index = flathash_find(fh, key, mix);
+	void **slot;
+
+	if (index != SLOT_NOT_FOUND) {
+		slot = SLOT(fh, index);
+		*r_key = &slot[0];
+		*r_val = &slot[1];
+		return true;
+	}
+
+	/* pass 'key' in case we resize */
+	slot = flathash_insert_slot(fh, (void *)key, mix);
+	*r_key = &slot[0];
+	*r_val = &slot[1];
+	return false;
+}
+
+/**
+ * Remove \a key from \a fh, or return false if the key wasn't found.
+ *
+ * \param key  The key to remove.
+ * \param keyfreefp  Optional callback to free the key.
+ * \param valfreefp  Optional callback to free the value.
+ * \return true if \a key was removed from \a fh.
+ */
+bool BLI_flathash_remove(FlatHash *fh, const void *key, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp)
+{
+	const uint index = flathash_find(fh, key, flathash_mix(fh->hashfp(key)));
+	void **slot;
+
+	if (index == SLOT_NOT_FOUND) {
+		return false;
+	}
+
+	slot = SLOT(fh, index);
+	if (keyfreefp) keyfreefp(slot[0]);
+	if (valfreefp) valfreefp(slot[1]);
+
+	flathash_remove_index(fh, index);
+	return true;
+}
+
+/**
+ * Remove \a key from \a fh, returning the value or NULL if the key wasn't found.
+ *
+ * \param key  The key to remove.
+ * \param keyfreefp  Optional callback to free the key.
+ * \return the value of \a key int \a fh or NULL.
+ */
+void *BLI_flathash_popkey(FlatHash *fh, const void *key, GHashKeyFreeFP keyfreefp)
+{
+	const uint index = flathash_find(fh, key, flathash_mix(fh->hashfp(key)));
+	void **slot;
+
+	if (index == SLOT_NOT_FOUND) {
+		return NULL;
+	}
+
+	slot = SLOT(fh, index);
+	if (keyfreefp) keyfreefp(slot[0]);
+
+	flathash_remove_index(fh, index);
+	return slot[1];
+}
+
+/**
+ * Reset \a fh clearing all entries.
+ *
+ * \param keyfreefp  Optional callback to free the key.
+ * \param valfreefp  Optional callback to free the value.
+ */
+void BLI_flathash_clear(FlatHash *fh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp)
+{
+	flathash_clear(fh, keyfreefp, valfreefp, 0);
+}
+
+/**
+ * Wraps #BLI_flathash_clear with explicit buckets reserve size.
+ */
+void BLI_flathash_clear_ex(
+        FlatHash *fh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp,
+        const unsigned int nentries_reserve)
+{
+	flathash_clear(fh, keyfreefp, valfreefp, nentries_reserve);
+}
+
+/**
+ * \return true if the \a key is in \a fh.
+ */
+bool BLI_flathash_haskey(FlatHash *fh, const void *key)
+{
+	return (flathash_find(fh, key, flathash_mix(fh->hashfp(key))) != SLOT_NOT_FOUND);
+}
+
+/**
+ * \return size of the FlatHash.
+ */
+unsigned int BLI_flathash_size(FlatHash *fh)
+{
+	return fh->nentries;
+}
+
+/** \} */
+
+
+/** \name Iterator API
+ * \{ */
+
+static void flathashIterator_find(FlatHashIterator *fhi, uint index)
+{
+	FlatHash *fh = fhi->fh;
+
+	for (; index < fh->capacity; index++) {
+		if (fh->ctrl[index] >= 0) {
+			fhi->curr_index = index;
+			fhi->curr_slot = SLOT(fh, index);
+			return;
+		}
+	}
+
+	fhi->curr_index = fh->capacity;
+	fhi->curr_slot = NULL;
+}
+
+/**
+ * Init an already allocated FlatHashIterator. Removing the current entry while iterating is supported.
+ *
+ * \param fhi  The FlatHashIterator to initialize.
+ * \param fh  The FlatHash to iterate over.
+ */
+void BLI_flathashIterator_init(FlatHashIterator *fhi, FlatHash *fh)
+{
+	fhi->fh = fh;
+	flathashIterator_find(fhi, 0);
+}
+
+/**
+ * Steps the iterator to the next index.
+ *
+ * \param fhi  The iterator.
+ */
+void BLI_flathashIterator_step(FlatHashIterator *fhi)
+{
+	if (fhi->curr_slot) {
+		flathashIterator_find(fhi, fhi->curr_index + 1);
+	}
+}
+
+/** \} */
+
+
+/** \name Convenience FlatHash Creation Functions
+ * \{ */
+
+FlatHash *BLI_flathash_ptr_new_ex(const char *info, const unsigned int nentries_reserve)
+{
+	return BLI_flathash_new_ex(BLI_ghashutil_ptrhash, BLI_ghashutil_ptrcmp, info, nentries_reserve);
+}
+FlatHash *BLI_flathash_ptr_new(const char *info)
+{
+	return BLI_flathash_ptr_new_ex(info, 0);
+}
+
+FlatHash *BLI_flathash_str_new_ex(const char *info, const unsigned int nentries_reserve)
+{
+	return BLI_flathash_new_ex(BLI_ghashutil_strhash_p, BLI_ghashutil_strcmp, info, nentries_reserve);
+}
+FlatHash *BLI_flathash_str_new(const char *info)
+{
+	return BLI_flathash_str_new_ex(info, 0);
+}
+
+FlatHash *BLI_flathash_int_new_ex(const char *info, const unsigned int nentries_reserve)
+{
+	return BLI_flathash_new_ex(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, info, nentries_reserve);
+}
+FlatHash *BLI_flathash_int_new(const char *info)
+{
+	return BLI_flathash_int_new_ex(info, 0);
+}
+
+/** \} */
+
+
+/** \name FlatSet Public API
+ *
+ * Use ghash API to give 'set' functionality
+ * \{ */
+
+FlatSet *BLI_flatset_new_ex(GSetHashFP hashfp, GSetCmpFP cmpfp, const char *info,
+                            const unsigned int nentries_reserve)
+{
+	return (FlatSet *)flathash_new(hashfp, cmpfp, info, nentries_reserve, 1);
+}
+
+FlatSet *BLI_flatset_new(GSetHashFP hashfp, GSetCmpFP cmpfp, const char *info)
+{
+	return BLI_flatset_new_ex(hashfp, cmpfp, info, 0);
+}
+
+void BLI_flatset_free(FlatSet *fs, GSetKeyFreeFP keyfreefp)
+{
+	BLI_flathash_free((FlatHash *)fs, keyfreefp, NULL);
+}
+
+void BLI_flatset_reserve(FlatSet *fs, const unsigned int nentries_reserve)
+{
+	BLI_flathash_reserve((FlatHash *)fs, nentries_reserve);
+}
+
+/**
+ * Adds the key to the set (no checks for unique keys!).
+ * Matching #BLI_flathash_insert
+ */
+void BLI_flatset_insert(FlatSet *fs, void *key)
+{
+	FlatHash *fh = (FlatHash *)fs;
+	flathash_insert_slot(fh, key, flathash_mix(fh->hashfp(key)));
+}
+
+/**
+ * A version of BLI_flatset_insert which checks first if the key is in the set.
+ * \returns true if a new key has been added.
+ */
+bool BLI_flatset_add(FlatSet *fs, void *key)
+{
+	FlatHash *fh = (FlatHash *)fs;
+	const uint mix = flathash_mix(fh->hashfp(key));
+
+	if (flathash_find(fh, key, mix) != SLOT_NOT_FOUND) {
+		return false;
+	}
+
+	flathash_insert_slot(fh, key, mix);
+	return true;
+}
+
+/**
+ * Set counterpart to #BLI_flathash_ensure_p_ex.
+ * similar to BLI_flatset_add, except it returns the key pointer.
+ *
+ * \warning Caller _must_ write to \a r_key when returning false.
+ */
+bool BLI_flatset_ensure_p_ex(FlatSet *fs, const void *key, void ***r_key)
+{
+	FlatHash *fh = (FlatHash *)fs;
+	const uint mix = flathash_mix(fh->hashfp(key));
+	const uint index = flathash_find(fh, key, mix);
+	void **slot;
+
+	if (index != SLOT_NOT_FOUND) {
+		*r_key = &SLOT(fh, index)[0];
+		return true;
+	}
+
+	/* pass 'key' in case we resize */
+	slot = flathash_insert_slot(fh, (void *)key, mix);
+	*r_key = &slot[0];
+	return false;
+}
+
+/**
+ * Adds the key to the set (duplicates are managed).
+ * Matching #BLI_flathash_reinsert
+ *
+ * \returns true if a new key has been added.
+ */
+bool BLI_flatset_reinsert(FlatSet *fs, void *key, GSetKeyFreeFP keyfreefp)
+{
+	FlatHash *fh = (FlatHash *)fs;
+	const uint mix = flathash_mix(fh->hashfp(key));
+	const uint index = flathash_find(fh, key, mix);
+
+	if (index != SLOT_NOT_FOUND) {
+		void **slot = SLOT(fh, index);
+		if (keyfreefp) keyfreefp(slot[0]);
+		slot[0] = key;
+		return false;
+	}
+
+	flathash_insert_slot(fh, key, mix);
+	return true;
+}
+
+/**
+ * Returns the pointer to the key if it's found.
+ */
+void *BLI_flatset_lookup(FlatSet *fs, const void *key)
+{
+	FlatHash *fh = (FlatHash *)fs;
+	const uint index = flathash_find(fh, key, flathash_mix(fh->hashfp(key)));
+	return (index != SLOT_NOT_FOUND) ? SLOT(fh, index)[0] : NULL;
+}
+
+bool BLI_flatset_haskey(FlatSet *fs, const void *key)
+{
+	return BLI_flathash_haskey((FlatHash *)fs, key);
+}
+
+bool BLI_flatset_remove(FlatSet *fs, const void *key, GSetKeyFreeFP keyfreefp)
+{
+	return BLI_flathash_remove((FlatHash *)fs, key, keyfreefp, NULL);
+}
+
+void BLI_flatset_clear(FlatSet *fs, GSetKeyFreeFP keyfreefp)
+{
+	flathash_clear((FlatHash *)fs, keyfreefp, NULL, 0);
+}
+
+void BLI_flatset_clear_ex(FlatSet *fs, GSetKeyFreeFP keyfreefp, const unsigned int nentries_reserve)
+{
+	flathash_clear((FlatHash *)fs, keyfreefp, NULL, nentries_reserve);
+}
+
+unsigned int BLI_flatset_size(FlatSet *fs)
+{
+	return ((FlatHash *)fs)->nentries;
+}
+
+/** \} */
+
+
+/** \name Convenience FlatSet Creation Functions
+ * \{ */
+
+FlatSet *BLI_flatset_ptr_new_ex(const char *info, const unsigned int nentries_reserve)
+{
+	return BLI_flatset_new_ex(BLI_ghashutil_ptrhash, BLI_ghashutil_ptrcmp, info, nentries_reserve);
+}
+FlatSet *BLI_flatset_ptr_new(const char *info)
+{
+	return BLI_flatset_ptr_new_ex(info, 0);
+}
+
+FlatSet *BLI_flatset_str_new_ex(const char *info, const unsigned int nentries_reserve)
+{
+	return BLI_flatset_new_ex(BLI_ghashutil_strhash_p, BLI_ghashutil_strcmp, info, nentries_reserve);
+}
+FlatSet *BLI_flatset_str_new(const char *info)
+{
+	return BLI_flatset_str_new_ex(info, 0);
+}
+
+/** \} */
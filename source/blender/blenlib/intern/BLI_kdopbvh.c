@@ -76,8 +76,10 @@
  */
 #ifdef DEBUG
 #  define KDOPBVH_THREAD_LEAF_THRESHOLD 0
+#  define KDOPBVH_THREAD_QUERY_THRESHOLD 0
 #else
 #  define KDOPBVH_THREAD_LEAF_THRESHOLD 1024
+#  define KDOPBVH_THREAD_QUERY_THRESHOLD 256
 #endif
 
 
@@ -1584,6 +1586,60 @@ int BLI_bvhtree_find_nearest(
 	return data.nearest.index;
 }
 
+typedef struct BVHNearestBatchData {
+	BVHTree *tree;
+	const float (*co)[3];
+	BVHTreeNearest *nearest;
+	BVHTree_NearestPointCallback callback;
+	void *userdata;
+} BVHNearestBatchData;
+
+static void bvhtree_find_nearest_batch_task_cb(
+        void *userdata, void *userdata_chunk, const int i, const int UNUSED(threadid))
+{
+	BVHNearestBatchData *batch_data = userdata;
+	BVHTreeNearest *nearest_prev = userdata_chunk;
+	BVHTreeNearest *nearest = &batch_data->nearest[i];
+
+	/* Use local proximity heuristics (to reduce the nearest search)
+	 *
+	 * Consecutive coordinates are usually close to each other (vertices of a mesh), so the nearest node
+	 * is not further away than the previous hit of this thread, which prunes the search. Only unbounded
+	 * queries are seeded, the ones given a distance keep it. */
+	if ((nearest_prev->index != -1) && (nearest->index == -1) && (nearest->dist_sq == FLT_MAX)) {
+		*nearest = *nearest_prev;
+		nearest->dist_sq = len_squared_v3v3(batch_data->co[i], nearest_prev->co);
+	}
+
+	BLI_bvhtree_find_nearest(
+	        batch_data->tree, batch_data->co[i], nearest,
+	        batch_data->callback, batch_data->userdata);
+
+	if (nearest->index != -1) {
+		*nearest_prev = *nearest;
+	}
+}
+
+/**
+ * Find the nearest node of many coordinates, splitting them between threads.
+ *
+ * \param nearest: Array of \a co_num results, initialized as for #BLI_bvhtree_find_nearest.
+ * Queries with an index of -1 and a distance of FLT_MAX start from the previous hit of the same thread,
+ * queries with a distance of zero are skipped.
+ * \note \a callback is called from multiple threads at once.
+ */
+void BLI_bvhtree_find_nearest_batch(
+        BVHTree *tree, const float (*co)[3], const int co_num, BVHTreeNearest *nearest,
+        BVHTree_NearestPointCallback callback, void *userdata)
+{
+	BVHNearestBatchData batch_data = {tree, co, nearest, callback, userdata};
+	BVHTreeNearest nearest_prev = {.index = -1};
+
+	BLI_task_parallel_range_ex(
+	        0, co_num, &batch_data, &nearest_prev, sizeof(nearest_prev), bvhtree_find_nearest_batch_task_cb,
+	        co_num > KDOPBVH_THREAD_QUERY_THRESHOLD, false);
+}
+
 /** \} */
 
 
@@ -1840,6 +1896,44 @@ int BLI_bvhtree_ray_cast(
 	return BLI_bvhtree_ray_cast_ex(tree, co, dir, radius, hit, callback, userdata, BVH_RAYCAST_DEFAULT);
 }
 
+typedef struct BVHRayCastBatchData {
+	BVHTree *tree;
+	const float (*co)[3];
+	const float (*dir)[3];
+	float radius;
+	BVHTreeRayHit *hit;
+	BVHTree_RayCastCallback callback;
+	void *userdata;
+	int flag;
+} BVHRayCastBatchData;
+
+static void bvhtree_ray_cast_batch_task_cb(void *userdata, const int i)
+{
+	BVHRayCastBatchData *batch_data = userdata;
+
+	BLI_bvhtree_ray_cast_ex(
+	        batch_data->tree, batch_data->co[i], batch_data->dir[i], batch_data->radius, &batch_data->hit[i],
+	        batch_data->callback, batch_data->userdata, batch_data->flag);
+}
+
+/**
+ * Cast many rays, splitting them between threads.
+ *
+ * \param hit: Array of \a rays_num results, initialized as for #BLI_bvhtree_ray_cast_ex.
+ * \note \a callback is called from multiple threads at once.
+ */
+void BLI_bvhtree_ray_cast_batch(
+        BVHTree *tree, const float (*co)[3], const float (*dir)[3], const int rays_num, float radius,
+        BVHTreeRayHit *hit, BVHTree_RayCastCallback callback, void *userdata,
+        int flag)
+{
+	BVHRayCastBatchData batch_data = {tree, co, dir, radius, hit, callback, userdata, flag};
+
+	BLI_task_parallel_range(
+	        0, rays_num, &batch_data, bvhtree_ray_cast_batch_task_cb,
+	        rays_num > KDOPBVH_THREAD_QUERY_THRESHOLD);
+}
+
 float BLI_bvhtree_bb_raycast(const float bv[6], const float light_start[3], const float light_end[3], float pos[3])
 {
 	BVHRayCastData data;
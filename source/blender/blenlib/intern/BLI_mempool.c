@@ -36,6 +36,7 @@
  * - Freeing chunks.
  * - Iterating over allocated chunks
  *   (optionally when using the #BLI_MEMPOOL_ALLOW_ITER flag).
+ * - Allocating from many threads through per-thread #BLI_mempool_local caches.
  */
 
 #include <string.h>
@@ -141,6 +142,24 @@ struct BLI_mempool {
 #ifdef USE_TOTALLOC
 	uint totalloc;          /* number of elements allocated in total */
 #endif
+
+	/* protects the chunks, the free list and totused while #BLI_mempool_local caches exist */
+	uint lock;
+#ifndef NDEBUG
+	uint totlocal;      /* number of local caches, which must all be destroyed before using the pool directly */
+#endif
+};
+
+/**
+ * A per-thread cache of a pool, elements are allocated from its own free list,
+ * which is refilled from the pool free list or from a new chunk.
+ */
+struct BLI_mempool_local {
+	BLI_mempool *pool;
+	BLI_freenode *free;
+	BLI_freenode *free_tail;  /* last element of \a free, to give it back to the pool in one go */
+	/* change of pool->totused not applied yet */
+	int totused;
 };
 
 #define MEMPOOL_ELEM_SIZE_MIN (sizeof(void *) * 2)
@@ -174,6 +193,24 @@ static uint power_of_2_max_u(uint x)
 }
 #endif
 
+/**
+ * Lock taken by #BLI_mempool_local caches, only held for a few list operations,
+ * not using #SpinLock so this file can be built without the thread API (for makesrna).
+ */
+BLI_INLINE void mempool_lock(BLI_mempool *pool)
+{
+	while (atomic_cas_uint32(&pool->lock, 0, 1) != 0) {
+		while (*(volatile uint *)&pool->lock) {
+			/* pass */
+		}
+	}
+}
+
+BLI_INLINE void mempool_unlock(BLI_mempool *pool)
+{
+	atomic_cas_uint32(&pool->lock, 1, 0);
+}
+
 BLI_INLINE BLI_mempool_chunk *mempool_chunk_find(BLI_mempool_chunk *head, uint index)
 {
 	while (index-- && head) {
@@ -208,37 +245,16 @@ static BLI_mempool_chunk *mempool_chunk_alloc(BLI_mempool *pool)
 }
 
 /**
- * Initialize a chunk and add into \a pool->chunks
+ * Link all the elements of a chunk into a free list, which starts at the chunk data.
  *
- * \param pool  The pool to add the chunk into.
- * \param mpchunk  The new uninitialized chunk (can be malloc'd)
- * \param lasttail  The last element of the previous chunk
- * (used when building free chunks initially)
- * \return The last chunk,
+ * \return The last element of the list.
  */
-static BLI_freenode *mempool_chunk_add(BLI_mempool *pool, BLI_mempool_chunk *mpchunk,
-                                       BLI_freenode *lasttail)
+static BLI_freenode *mempool_chunk_init_free(const BLI_mempool *pool, BLI_mempool_chunk *mpchunk)
 {
 	const uint esize = pool->esize;
 	BLI_freenode *curnode = CHUNK_DATA(mpchunk);
 	uint j;
 
-	/* append */
-	if (pool->chunk_tail) {
-		pool->chunk_tail->next = mpchunk;
-	}
-	else {
-		BLI_assert(pool->chunks == NULL);
-		pool->chunks = mpchunk;
-	}
-
-	mpchunk->next = NULL;
-	pool->chunk_tail = mpchunk;
-
-	if (UNLIKELY(pool->free == NULL)) {
-		pool->free = curnode;
-	}
-
 	/* loop through the allocated data, building the pointer structures */
 	j = pool->pchunk;
 	if (pool->flag & BLI_MEMPOOL_ALLOW_ITER) {
@@ -260,6 +276,48 @@ static BLI_freenode *mempool_chunk_add(BLI_mempool *pool, BLI_mempool_chunk *mpc
 	curnode = NODE_STEP_PREV(curnode);
 	curnode->next = NULL;
 
+	return curnode;
+}
+
+/**
+ * Append a chunk to \a pool->chunks, keeping the order of allocation for iteration.
+ */
+static void mempool_chunk_link(BLI_mempool *pool, BLI_mempool_chunk *mpchunk)
+{
+	if (pool->chunk_tail) {
+		pool->chunk_tail->next = mpchunk;
+	}
+	else {
+		BLI_assert(pool->chunks == NULL);
+		pool->chunks = mpchunk;
+	}
+
+	mpchunk->next = NULL;
+	pool->chunk_tail = mpchunk;
+}
+
+/**
+ * Initialize a chunk and add into \a pool->chunks
+ *
+ * \param pool  The pool to add the chunk into.
+ * \param mpchunk  The new uninitialized chunk (can be malloc'd)
+ * \param lasttail  The last element of the previous chunk
+ * (used when building free chunks initially)
+ * \return The last chunk,
+ */
+static BLI_freenode *mempool_chunk_add(BLI_mempool *pool, BLI_mempool_chunk *mpchunk,
+                                       BLI_freenode *lasttail)
+{
+	BLI_freenode *curnode;
+
+	mempool_chunk_link(pool, mpchunk);
+
+	if (UNLIKELY(pool->free == NULL)) {
+		pool->free = CHUNK_DATA(mpchunk);
+	}
+
+	curnode = mempool_chunk_init_free(pool, mpchunk);
+
 #ifdef USE_TOTALLOC
 	pool->totalloc += pool->pchunk;
 #endif
@@ -337,6 +395,11 @@ BLI_mempool *BLI_mempool_create(uint esize, uint totelem,
 #endif
 	pool->totused = 0;
 
+	pool->lock = 0;
+#ifndef NDEBUG
+	pool->totlocal = 0;
+#endif
+
 	if (totelem) {
 		/* allocate the actual chunks */
 		for (i = 0; i < maxchunks; i++) {
@@ -356,6 +419,8 @@ void *BLI_mempool_alloc(BLI_mempool *pool)
 {
 	BLI_freenode *free_pop;
 
+	BLI_assert(pool->totlocal == 0);
+
 	if (UNLIKELY(pool->free == NULL)) {
 		/* need to allocate a new chunk */
 		BLI_mempool_chunk *mpchunk = mempool_chunk_alloc(pool);
@@ -396,6 +461,8 @@ void BLI_mempool_free(BLI_mempool *pool, void *addr)
 {
 	BLI_freenode *newhead = addr;
 
+	BLI_assert(pool->totlocal == 0);
+
 #ifndef NDEBUG
 	{
 		BLI_mempool_chunk *chunk;
@@ -474,6 +541,168 @@ void BLI_mempool_free(BLI_mempool *pool, void *addr)
 	}
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Thread local caches
+ *
+ * Allocating from a pool in parallel tasks, each thread creates its own cache
+ * and destroys it when done, typically in the finalize callback of #BLI_task_parallel_range_finalize.
+ *
+ * Elements are taken from the cache free list without locking. When it runs out the cache takes
+ * up to a chunk worth of elements from the pool free list, or a new chunk is initialized
+ * outside the lock and only linked into the pool.
+ * Freed elements go back into the cache of the freeing thread (whatever thread allocated them)
+ * and are returned to the pool free list when the cache is destroyed.
+ *
+ * While caches exist the pool itself must not be used directly (allocating, freeing, iterating...).
+ * Chunks are only released again by #BLI_mempool_free once all the caches are destroyed.
+ *
+ * \{ */
+
+BLI_mempool_local *BLI_mempool_local_create(BLI_mempool *pool)
+{
+	BLI_mempool_local *local;
+
+	local = MEM_mallocN(sizeof(*local), __func__);
+	local->pool = pool;
+	local->free = NULL;
+	local->free_tail = NULL;
+	local->totused = 0;
+
+#ifndef NDEBUG
+	atomic_add_and_fetch_uint32(&pool->totlocal, 1);
+#endif
+
+	return local;
+}
+
+static void mempool_local_refill(BLI_mempool_local *local)
+{
+	BLI_mempool *pool = local->pool;
+	BLI_mempool_chunk *mpchunk;
+
+	mempool_lock(pool);
+	pool->totused = (uint)((int)pool->totused + local->totused);
+	local->totused = 0;
+	if (pool->free) {
+		/* take a chunk worth of elements, so preallocated elements are shared among the caches */
+		BLI_freenode *tail = pool->free;
+		uint i;
+
+		for (i = 1; i < pool->pchunk && tail->next; i++) {
+			tail = tail->next;
+		}
+		local->free = pool->free;
+		local->free_tail = tail;
+		pool->free = tail->next;
+		tail->next = NULL;
+		mempool_unlock(pool);
+		return;
+	}
+	mempool_unlock(pool);
+
+	mpchunk = mempool_chunk_alloc(pool);
+	local->free_tail = mempool_chunk_init_free(pool, mpchunk);
+	local->free = CHUNK_DATA(mpchunk);
+
+	mempool_lock(pool);
+	mempool_chunk_link(pool, mpchunk);
+#ifdef USE_TOTALLOC
+	pool->totalloc += pool->pchunk;
+#endif
+	mempool_unlock(pool);
+}
+
+void *BLI_mempool_local_alloc(BLI_mempool_local *local)
+{
+	BLI_freenode *free_pop;
+
+	if (UNLIKELY(local->free == NULL)) {
+		mempool_local_refill(local);
+	}
+
+	free_pop = local->free;
+
+	if (local->pool->flag & BLI_MEMPOOL_ALLOW_ITER) {
+		free_pop->freeword = USEDWORD;
+	}
+
+	local->free = free_pop->next;
+	local->totused++;
+
+#ifdef WITH_MEM_VALGRIND
+	VALGRIND_MEMPOOL_ALLOC(local->pool, free_pop, local->pool->esize);
+#endif
+
+	return (void *)free_pop;
+}
+
+void *BLI_mempool_local_calloc(BLI_mempool_local *local)
+{
+	void *retval = BLI_mempool_local_alloc(local);
+	memset(retval, 0, (size_t)local->pool->esize);
+	return retval;
+}
+
+/**
+ * Free an element into the cache, the element may have been allocated by any thread.
+ */
+void BLI_mempool_local_free(BLI_mempool_local *local, void *addr)
+{
+	BLI_freenode *newhead = addr;
+
+#ifndef NDEBUG
+	if (UNLIKELY(mempool_debug_memset)) {
+		memset(addr, 255, local->pool->esize);
+	}
+#endif
+
+	if (local->pool->flag & BLI_MEMPOOL_ALLOW_ITER) {
+#ifndef NDEBUG
+		/* this will detect double free's */
+		BLI_assert(newhead->freeword != FREEWORD);
+#endif
+		newhead->freeword = FREEWORD;
+	}
+
+	if (local->free == NULL) {
+		local->free_tail = newhead;
+	}
+	newhead->next = local->free;
+	local->free = newhead;
+	local->totused--;
+
+#ifdef WITH_MEM_VALGRIND
+	VALGRIND_MEMPOOL_FREE(local->pool, addr);
+#endif
+}
+
+/**
+ * Return the cached elements to the pool and free the cache.
+ */
+void BLI_mempool_local_destroy(BLI_mempool_local *local)
+{
+	BLI_mempool *pool = local->pool;
+
+	mempool_lock(pool);
+	pool->totused = (uint)((int)pool->totused + local->totused);
+	if (local->free) {
+		local->free_tail->next = pool->free;
+		pool->free = local->free;
+	}
+	mempool_unlock(pool);
+
+#ifndef NDEBUG
+	atomic_sub_and_fetch_uint32(&pool->totlocal, 1);
+#endif
+
+	MEM_freeN(local);
+}
+
+/** \} */
+
+/**
+ * \note elements allocated or freed through existing #BLI_mempool_local caches may not be counted yet.
+ */
 int BLI_mempool_count(BLI_mempool *pool)
 {
 	return (int)pool->totused;
@@ -714,6 +943,8 @@ void BLI_mempool_clear_ex(BLI_mempool *pool, const int totelem_reserve)
 	BLI_mempool_chunk *chunks_temp;
 	BLI_freenode *lasttail = NULL;
 
+	BLI_assert(pool->totlocal == 0);
+
 #ifdef WITH_MEM_VALGRIND
 	VALGRIND_DESTROY_MEMPOOL(pool);
 	VALGRIND_CREATE_MEMPOOL(pool, 0, false);
@@ -770,6 +1001,8 @@ void BLI_mempool_clear(BLI_mempool *pool)
  */
 void BLI_mempool_destroy(BLI_mempool *pool)
 {
+	BLI_assert(pool->totlocal == 0);
+
 	mempool_chunk_free_all(pool->chunks);
 
 #ifdef WITH_MEM_VALGRIND
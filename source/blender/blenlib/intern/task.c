@@ -204,6 +204,18 @@ struct TaskPool {
 #endif
 };
 
+/* Queue of tasks pushed from a worker thread.
+ *
+ * The owner thread pushes and pops tasks at the head, so it keeps working on
+ * the most recent tasks whose data is likely still in cache. Idle threads steal
+ * the oldest tasks from the tail. Each queue has its own lock, so threads which
+ * spawn lots of small tasks do not contend on the global queue lock.
+ */
+typedef struct TaskQueue {
+	ListBase list;
+	SpinLock lock;
+} TaskQueue;
+
 struct TaskScheduler {
 	pthread_t *threads;
 	struct TaskThread *task_threads;
@@ -214,6 +226,11 @@ struct TaskScheduler {
 	ThreadMutex queue_mutex;
 	ThreadCondition queue_cond;
 
+	/* Number of tasks in all threads' queues, and number of threads sleeping
+	 * on queue_cond, used to wake up threads to steal tasks. */
+	uint32_t num_queued;
+	uint32_t num_waiting;
+
 	volatile bool do_exit;
 
 	/* NOTE: In pthread's TLS we store the whole TaskThread structure. */
@@ -224,6 +241,8 @@ typedef struct TaskThread {
 	TaskScheduler *scheduler;
 	int id;
 	TaskThreadLocalStorage tls;
+	/* Only used by worker threads, see task_scheduler_use_thread_queues(). */
+	TaskQueue queue;
 } TaskThread;
 
 /* Helper */
@@ -352,54 +371,157 @@ static void task_pool_num_increase(TaskPool *pool, size_t new)
 	BLI_mutex_unlock(&pool->num_mutex);
 }
 
-static bool task_scheduler_thread_wait_pop(TaskScheduler *scheduler, Task **task)
+/* Thread queues are not used when the single worker thread is reserved for
+ * background pools, it must not run other pools' tasks. */
+BLI_INLINE bool task_scheduler_use_thread_queues(TaskScheduler *scheduler, const int thread_id)
 {
-	bool found_task = false;
-	BLI_mutex_lock(&scheduler->queue_mutex);
+	return (thread_id > 0) && !scheduler->background_thread_only;
+}
+
+static void task_queue_push(TaskScheduler *scheduler, TaskQueue *queue, Task *task)
+{
+	task_pool_num_increase(task->pool, 1);
+
+	BLI_spin_lock(&queue->lock);
+	BLI_addhead(&queue->list, task);
+	BLI_spin_unlock(&queue->lock);
+
+	atomic_add_and_fetch_uint32(&scheduler->num_queued, 1);
+
+	/* Wake up an idle thread to steal the task. num_queued is increased before
+	 * reading num_waiting, while waiting threads do the opposite, so either we
+	 * see the waiting thread or it sees the task. */
+	if (atomic_add_and_fetch_uint32(&scheduler->num_waiting, 0) != 0) {
+		BLI_mutex_lock(&scheduler->queue_mutex);
+		BLI_condition_notify_one(&scheduler->queue_cond);
+		BLI_mutex_unlock(&scheduler->queue_mutex);
+	}
+}
+
+/* Pop a task from the head (owner) or the tail (thief) of the queue,
+ * optionally only a task of the given pool. */
+static Task *task_queue_pop(TaskScheduler *scheduler, TaskQueue *queue, TaskPool *pool, const bool from_head)
+{
+	Task *task;
+
+	if (queue->list.first == NULL) {
+		return NULL;
+	}
+
+	BLI_spin_lock(&queue->lock);
+	if (from_head) {
+		for (task = queue->list.first; task && pool && task->pool != pool; task = task->next) {
+			/* pass */
+		}
+	}
+	else {
+		for (task = queue->list.last; task && pool && task->pool != pool; task = task->prev) {
+			/* pass */
+		}
+	}
+	if (task) {
+		BLI_remlink(&queue->list, task);
+	}
+	BLI_spin_unlock(&queue->lock);
+
+	if (task) {
+		atomic_sub_and_fetch_uint32(&scheduler->num_queued, 1);
+	}
+
+	return task;
+}
+
+/* Steal a task from the queues of other threads, starting after our own. */
+static Task *task_scheduler_steal(TaskScheduler *scheduler, TaskPool *pool, const int thread_id)
+{
+	const int num_threads = scheduler->num_threads;
+	int attempts = num_threads;
+	int i;
+
+	if (scheduler->background_thread_only ||
+	    atomic_add_and_fetch_uint32(&scheduler->num_queued, 0) == 0)
+	{
+		return NULL;
+	}
+
+	for (i = thread_id % num_threads; attempts--; i = (i + 1) % num_threads) {
+		/* Worker threads are 1..num_threads. */
+		const int victim_id = i + 1;
+		Task *task;
+
+		if (victim_id == thread_id) {
+			continue;
+		}
+		if ((task = task_queue_pop(scheduler, &scheduler->task_threads[victim_id].queue, pool, false))) {
+			return task;
+		}
+	}
+
+	return NULL;
+}
+
+/* Find a task the thread may run in the global queue, queue_mutex must be locked. */
+static Task *task_scheduler_global_find(TaskScheduler *scheduler)
+{
+	Task *task;
+
+	for (task = scheduler->queue.first; task != NULL; task = task->next) {
+		TaskPool *pool = task->pool;
+
+		if (scheduler->background_thread_only && !pool->run_in_background) {
+			continue;
+		}
+		break;
+	}
+
+	return task;
+}
 
-	while (!scheduler->queue.first && !scheduler->do_exit)
-		BLI_condition_wait(&scheduler->queue_cond, &scheduler->queue_mutex);
+static bool task_scheduler_thread_wait_pop(TaskScheduler *scheduler, TaskThread *thread, Task **task)
+{
+	const bool use_thread_queues = task_scheduler_use_thread_queues(scheduler, thread->id);
+
+	while (true) {
+		/* Own queue first, it has the most recent tasks pushed by this thread. */
+		if (use_thread_queues && (*task = task_queue_pop(scheduler, &thread->queue, NULL, true))) {
+			return true;
+		}
 
-	do {
-		Task *current_task;
+		BLI_mutex_lock(&scheduler->queue_mutex);
 
-		/* Assuming we can only have a void queue in 'exit' case here seems logical (we should only be here after
-		 * our worker thread has been woken up from a condition_wait(), which only happens after a new task was
-		 * added to the queue), but it is wrong.
-		 * Waiting on condition may wake up the thread even if condition is not signaled (spurious wake-ups), and some
-		 * race condition may also empty the queue **after** condition has been signaled, but **before** awoken thread
-		 * reaches this point...
+		/* Only abort if do_exit is set, waiting on condition may wake up the thread
+		 * even if condition is not signaled (spurious wake-ups), and some race
+		 * condition may also empty the queue after condition has been signaled.
 		 * See http://stackoverflow.com/questions/8594591
-		 *
-		 * So we only abort here if do_exit is set.
 		 */
 		if (scheduler->do_exit) {
 			BLI_mutex_unlock(&scheduler->queue_mutex);
 			return false;
 		}
 
-		for (current_task = scheduler->queue.first;
-		     current_task != NULL;
-		     current_task = current_task->next)
-		{
-			TaskPool *pool = current_task->pool;
-
-			if (scheduler->background_thread_only && !pool->run_in_background) {
-				continue;
-			}
-
-			*task = current_task;
-			found_task = true;
+		if ((*task = task_scheduler_global_find(scheduler))) {
 			BLI_remlink(&scheduler->queue, *task);
-			break;
+			BLI_mutex_unlock(&scheduler->queue_mutex);
+			return true;
 		}
-		if (!found_task)
-			BLI_condition_wait(&scheduler->queue_cond, &scheduler->queue_mutex);
-	} while (!found_task);
 
-	BLI_mutex_unlock(&scheduler->queue_mutex);
+		BLI_mutex_unlock(&scheduler->queue_mutex);
+
+		if ((*task = task_scheduler_steal(scheduler, NULL, thread->id))) {
+			return true;
+		}
 
-	return true;
+		BLI_mutex_lock(&scheduler->queue_mutex);
+		atomic_add_and_fetch_uint32(&scheduler->num_waiting, 1);
+		if (!scheduler->do_exit &&
+		    task_scheduler_global_find(scheduler) == NULL &&
+		    (scheduler->background_thread_only || atomic_add_and_fetch_uint32(&scheduler->num_queued, 0) == 0))
+		{
+			BLI_condition_wait(&scheduler->queue_cond, &scheduler->queue_mutex);
+		}
+		atomic_sub_and_fetch_uint32(&scheduler->num_waiting, 1);
+		BLI_mutex_unlock(&scheduler->queue_mutex);
+	}
 }
 
 BLI_INLINE void handle_local_queue(TaskThreadLocalStorage *tls,
@@ -433,7 +555,7 @@ static void *task_scheduler_thread_run(void *thread_p)
 	pthread_setspecific(scheduler->tls_id_key, thread);
 
 	/* keep popping off tasks */
-	while (task_scheduler_thread_wait_pop(scheduler, &task)) {
+	while (task_scheduler_thread_wait_pop(scheduler, thread, &task)) {
 		TaskPool *pool = task->pool;
 
 		/* run task */
@@ -486,6 +608,11 @@ TaskScheduler *BLI_task_scheduler_create(int num_threads)
 	/* Initialize TLS for main thread. */
 	initialize_task_tls(&scheduler->task_threads[0].tls);
 
+	for (int i = 0; i < num_threads + 1; i++) {
+		BLI_listbase_clear(&scheduler->task_threads[i].queue.list);
+		BLI_spin_init(&scheduler->task_threads[i].queue.lock);
+	}
+
 	pthread_key_create(&scheduler->tls_id_key, NULL);
 
 	/* launch threads that will be waiting for work */
@@ -538,7 +665,15 @@ void BLI_task_scheduler_free(TaskScheduler *scheduler)
 	if (scheduler->task_threads) {
 		for (int i = 0; i < scheduler->num_threads + 1; ++i) {
 			TaskThreadLocalStorage *tls = &scheduler->task_threads[i].tls;
+			TaskQueue *queue = &scheduler->task_threads[i].queue;
 			free_task_tls(tls);
+
+			/* delete leftover tasks */
+			for (task = queue->list.first; task; task = task->next) {
+				task_data_free(task, 0);
+			}
+			BLI_freelistN(&queue->list);
+			BLI_spin_end(&queue->lock);
 		}
 
 		MEM_freeN(scheduler->task_threads);
@@ -620,6 +755,30 @@ static void task_scheduler_clear(TaskScheduler *scheduler, TaskPool *pool)
 
 	BLI_mutex_unlock(&scheduler->queue_mutex);
 
+	/* and from the threads' queues */
+	for (int i = 0; i < scheduler->num_threads + 1; i++) {
+		TaskQueue *queue = &scheduler->task_threads[i].queue;
+		size_t done_queue = 0;
+
+		BLI_spin_lock(&queue->lock);
+		for (task = queue->list.first; task; task = nexttask) {
+			nexttask = task->next;
+
+			if (task->pool == pool) {
+				task_data_free(task, pool->thread_id);
+				BLI_freelinkN(&queue->list, task);
+
+				done_queue++;
+			}
+		}
+		BLI_spin_unlock(&queue->lock);
+
+		if (done_queue) {
+			atomic_sub_and_fetch_uint32(&scheduler->num_queued, (uint32_t)done_queue);
+			done += done_queue;
+		}
+	}
+
 	/* notify done */
 	task_pool_num_decrease(pool, done);
 }
@@ -816,6 +975,15 @@ static void task_pool_push(
 			return;
 		}
 	}
+	/* Worker threads push to their own queue, where the task is either picked up
+	 * by the thread itself once its current task is done, or stolen by an idle thread.
+	 */
+	if (task_can_use_local_queues(pool, thread_id) &&
+	    task_scheduler_use_thread_queues(pool->scheduler, thread_id))
+	{
+		task_queue_push(pool->scheduler, &pool->scheduler->task_threads[thread_id].queue, task);
+		return;
+	}
 	/* Do push to a global execution ppol, slowest possible method,
 	 * causes quite reasonable amount of threading overhead.
 	 */
@@ -870,21 +1038,33 @@ void BLI_task_pool_work_and_wait(TaskPool *pool)
 
 		BLI_mutex_unlock(&pool->num_mutex);
 
-		BLI_mutex_lock(&scheduler->queue_mutex);
-
 		/* find task from this pool. if we get a task from another pool,
 		 * we can get into deadlock */
 
-		for (task = scheduler->queue.first; task; task = task->next) {
-			if (task->pool == pool) {
-				work_task = task;
-				found_task = true;
-				BLI_remlink(&scheduler->queue, task);
-				break;
+		if (task_scheduler_use_thread_queues(scheduler, pool->thread_id)) {
+			work_task = task_queue_pop(scheduler, &scheduler->task_threads[pool->thread_id].queue, pool, true);
+		}
+
+		if (work_task == NULL) {
+			BLI_mutex_lock(&scheduler->queue_mutex);
+
+			for (task = scheduler->queue.first; task; task = task->next) {
+				if (task->pool == pool) {
+					work_task = task;
+					BLI_remlink(&scheduler->queue, task);
+					break;
+				}
 			}
+
+			BLI_mutex_unlock(&scheduler->queue_mutex);
 		}
 
-		BLI_mutex_unlock(&scheduler->queue_mutex);
+		if (work_task == NULL) {
+			work_task = task_scheduler_steal(scheduler, pool, pool->thread_id);
+		}
+
+		task = work_task;
+		found_task = (work_task != NULL);
 
 		/* if found task, do it, otherwise wait until other tasks are done */
 		if (found_task) {
@@ -998,13 +1178,34 @@ typedef struct ParallelRangeState {
 
 	int iter;
 	int chunk_size;
+	/* When non-zero, chunks are a share of the remaining iterations (at least chunk_size),
+	 * so they start big and get smaller towards the end of the range. */
+	int num_shares;
 } ParallelRangeState;
 
 BLI_INLINE bool parallel_range_next_iter_get(
         ParallelRangeState * __restrict state,
         int * __restrict iter, int * __restrict count)
 {
-	int previter = atomic_fetch_and_add_int32(&state->iter, state->chunk_size);
+	int previter;
+
+	if (state->num_shares) {
+		int chunk_size;
+
+		do {
+			previter = state->iter;
+			if (previter >= state->stop) {
+				return false;
+			}
+			chunk_size = max_ii(state->chunk_size, (state->stop - previter) / state->num_shares);
+		} while (atomic_cas_int32(&state->iter, previter, previter + chunk_size) != previter);
+
+		*iter = previter;
+		*count = min_ii(chunk_size, state->stop - previter);
+		return true;
+	}
+
+	previter = atomic_fetch_and_add_int32(&state->iter, state->chunk_size);
 
 	*iter = previter;
 	*count = max_ii(0, min_ii(state->chunk_size, state->stop - previter));
@@ -1117,10 +1318,14 @@ static void task_parallel_range_ex(
 	state.func_ex = func_ex;
 	state.iter = start;
 	if (use_dynamic_scheduling) {
+		/* Guided scheduling: few big chunks first to keep the number of atomic operations low,
+		 * then smaller ones down to 32 iterations to balance the end of the range. */
 		state.chunk_size = 32;
+		state.num_shares = num_tasks * 2;
 	}
 	else {
 		state.chunk_size = max_ii(1, (stop - start) / (num_tasks));
+		state.num_shares = 0;
 	}
 
 	num_tasks = min_ii(num_tasks, (stop - start) / state.chunk_size);
@@ -1169,7 +1374,8 @@ static void task_parallel_range_ex(
  * \param func_ex Callback function (advanced version).
  * \param use_threading If \a true, actually split-execute loop in threads, else just do a sequential forloop
  *                      (allows caller to use any kind of test to switch on parallelization or not).
- * \param use_dynamic_scheduling If \a true, the whole range is divided in a lot of small chunks (of size 32 currently),
+ * \param use_dynamic_scheduling If \a true, the whole range is divided in chunks of decreasing size
+ *                               (a share of the remaining iterations, down to 32 currently),
  *                               otherwise whole range is split in a few big chunks (num_threads * 2 chunks currently).
  */
 void BLI_task_parallel_range_ex(
@@ -1221,7 +1427,8 @@ void BLI_task_parallel_range(
  * useful to finalize accumulative tasks.
  * \param use_threading If \a true, actually split-execute loop in threads, else just do a sequential forloop
  *                      (allows caller to use any kind of test to switch on parallelization or not).
- * \param use_dynamic_scheduling If \a true, the whole range is divided in a lot of small chunks (of size 32 currently),
+ * \param use_dynamic_scheduling If \a true, the whole range is divided in chunks of decreasing size
+ *                               (a share of the remaining iterations, down to 32 currently),
  *                               otherwise whole range is split in a few big chunks (num_threads * 2 chunks currently).
  */
 void BLI_task_parallel_range_finalize(
@@ -1239,8 +1446,6 @@ void BLI_task_parallel_range_finalize(
 	            use_threading, use_dynamic_scheduling);
 }
 
-#undef MALLOCA
-#undef MALLOCA_FREE
 
 typedef struct ParallelListbaseState {
 	void *userdata;
@@ -1360,6 +1565,12 @@ void BLI_task_parallel_listbase(
 typedef struct ParallelMempoolState {
 	void *userdata;
 	TaskParallelMempoolFunc func;
+	TaskParallelMempoolFuncEx func_ex;
+
+	/* one iterator and one copy of the userdata chunk per task */
+	BLI_mempool_iter *iterators;
+	void *userdata_chunk_array;
+	size_t userdata_chunk_size;
 } ParallelMempoolState;
 
 static void parallel_mempool_func(
@@ -1371,26 +1582,29 @@ static void parallel_mempool_func(
 	BLI_mempool_iter *iter = taskdata;
 	MempoolIterData *item;
 
-	while ((item = BLI_mempool_iterstep(iter)) != NULL) {
-		state->func(state->userdata, item);
+	if (state->func_ex) {
+		void *userdata_chunk = (char *)state->userdata_chunk_array +
+		                       (state->userdata_chunk_size * (size_t)(iter - state->iterators));
+
+		while ((item = BLI_mempool_iterstep(iter)) != NULL) {
+			state->func_ex(state->userdata, userdata_chunk, item);
+		}
+	}
+	else {
+		while ((item = BLI_mempool_iterstep(iter)) != NULL) {
+			state->func(state->userdata, item);
+		}
 	}
 }
 
-/**
- * This function allows to parallelize for loops over Mempool items.
- *
- * \param pool The iterable BLI_mempool to loop over.
- * \param userdata Common userdata passed to all instances of \a func.
- * \param func Callback function.
- * \param use_threading If \a true, actually split-execute loop in threads, else just do a sequential forloop
- *                      (allows caller to use any kind of test to switch on parallelization or not).
- *
- * \note There is no static scheduling here.
- */
-void BLI_task_parallel_mempool(
+static void task_parallel_mempool_ex(
         BLI_mempool *mempool,
         void *userdata,
+        void *userdata_chunk,
+        const size_t userdata_chunk_size,
         TaskParallelMempoolFunc func,
+        TaskParallelMempoolFuncEx func_ex,
+        TaskParallelRangeFuncFinalize func_finalize,
         const bool use_threading)
 {
 	TaskScheduler *task_scheduler;
@@ -1398,16 +1612,42 @@ void BLI_task_parallel_mempool(
 	ParallelMempoolState state;
 	int i, num_threads, num_tasks;
 
+	void *userdata_chunk_local = NULL;
+	const bool use_userdata_chunk = (func_ex != NULL) && (userdata_chunk_size != 0) && (userdata_chunk != NULL);
+
 	if (BLI_mempool_count(mempool) == 0) {
 		return;
 	}
 
+	if (userdata_chunk_size != 0) {
+		BLI_assert(func_ex != NULL && func == NULL);
+		BLI_assert(userdata_chunk != NULL);
+	}
+
 	if (!use_threading) {
 		BLI_mempool_iter iter;
 		BLI_mempool_iternew(mempool, &iter);
 
-		for (void *item = BLI_mempool_iterstep(&iter); item != NULL; item = BLI_mempool_iterstep(&iter)) {
-			func(userdata, item);
+		if (func_ex) {
+			if (use_userdata_chunk) {
+				userdata_chunk_local = MALLOCA(userdata_chunk_size);
+				memcpy(userdata_chunk_local, userdata_chunk, userdata_chunk_size);
+			}
+
+			for (void *item = BLI_mempool_iterstep(&iter); item != NULL; item = BLI_mempool_iterstep(&iter)) {
+				func_ex(userdata, userdata_chunk_local, item);
+			}
+
+			if (func_finalize) {
+				func_finalize(userdata, userdata_chunk_local);
+			}
+
+			MALLOCA_FREE(userdata_chunk_local, userdata_chunk_size);
+		}
+		else {
+			for (void *item = BLI_mempool_iterstep(&iter); item != NULL; item = BLI_mempool_iterstep(&iter)) {
+				func(userdata, item);
+			}
 		}
 		return;
 	}
@@ -1424,14 +1664,25 @@ void BLI_task_parallel_mempool(
 
 	state.userdata = userdata;
 	state.func = func;
+	state.func_ex = func_ex;
+	state.userdata_chunk_array = NULL;
+	state.userdata_chunk_size = userdata_chunk_size;
+
+	state.iterators = BLI_mempool_iter_threadsafe_create(mempool, (size_t)num_tasks);
 
-	BLI_mempool_iter *mempool_iterators = BLI_mempool_iter_threadsafe_create(mempool, (size_t)num_tasks);
+	if (use_userdata_chunk) {
+		state.userdata_chunk_array = MALLOCA(userdata_chunk_size * num_tasks);
+		for (i = 0; i < num_tasks; i++) {
+			userdata_chunk_local = (char *)state.userdata_chunk_array + (userdata_chunk_size * i);
+			memcpy(userdata_chunk_local, userdata_chunk, userdata_chunk_size);
+		}
+	}
 
 	for (i = 0; i < num_tasks; i++) {
 		/* Use this pool's pre-allocated tasks. */
 		BLI_task_pool_push_from_thread(task_pool,
 		                               parallel_mempool_func,
-		                               &mempool_iterators[i], false,
+		                               &state.iterators[i], false,
 		                               TASK_PRIORITY_HIGH,
 		                               task_pool->thread_id);
 	}
@@ -1439,5 +1690,66 @@ void BLI_task_parallel_mempool(
 	BLI_task_pool_work_and_wait(task_pool);
 	BLI_task_pool_free(task_pool);
 
-	BLI_mempool_iter_threadsafe_free(mempool_iterators);
+	BLI_mempool_iter_threadsafe_free(state.iterators);
+
+	if (use_userdata_chunk) {
+		if (func_finalize) {
+			for (i = 0; i < num_tasks; i++) {
+				userdata_chunk_local = (char *)state.userdata_chunk_array + (userdata_chunk_size * i);
+				func_finalize(userdata, userdata_chunk_local);
+			}
+		}
+		MALLOCA_FREE(state.userdata_chunk_array, userdata_chunk_size * num_tasks);
+	}
+}
+
+/**
+ * This function allows to parallelize for loops over Mempool items.
+ *
+ * \param pool The iterable BLI_mempool to loop over.
+ * \param userdata Common userdata passed to all instances of \a func.
+ * \param func Callback function.
+ * \param use_threading If \a true, actually split-execute loop in threads, else just do a sequential forloop
+ *                      (allows caller to use any kind of test to switch on parallelization or not).
+ *
+ * \note There is no static scheduling here.
+ */
+void BLI_task_parallel_mempool(
+        BLI_mempool *mempool,
+        void *userdata,
+        TaskParallelMempoolFunc func,
+        const bool use_threading)
+{
+	task_parallel_mempool_ex(mempool, userdata, NULL, 0, func, NULL, NULL, use_threading);
+}
+
+/**
+ * This function allows to parallelize for loops over Mempool items, with a copy of \a userdata_chunk
+ * for each task and an additional 'finalize' func called from calling thread once all items have been processed.
+ *
+ * \param pool The iterable BLI_mempool to loop over.
+ * \param userdata Common userdata passed to all instances of \a func.
+ * \param userdata_chunk Optional, each instance of looping chunks will get a copy of this data
+ *                       (similar to OpenMP's firstprivate).
+ * \param userdata_chunk_size Memory size of \a userdata_chunk.
+ * \param func_ex Callback function (advanced version).
+ * \param func_finalize Callback function, called after all workers have finished,
+ * useful to release per-thread data such as #BLI_mempool_local caches.
+ * \param use_threading If \a true, actually split-execute loop in threads, else just do a sequential forloop
+ *                      (allows caller to use any kind of test to switch on parallelization or not).
+ */
+void BLI_task_parallel_mempool_finalize(
+        BLI_mempool *mempool,
+        void *userdata,
+        void *userdata_chunk,
+        const size_t userdata_chunk_size,
+        TaskParallelMempoolFuncEx func_ex,
+        TaskParallelRangeFuncFinalize func_finalize,
+        const bool use_threading)
+{
+	task_parallel_mempool_ex(
+	            mempool, userdata, userdata_chunk, userdata_chunk_size, NULL, func_ex, func_finalize, use_threading);
 }
+
+#undef MALLOCA
+#undef MALLOCA_FREE
@@ -36,8 +36,14 @@
 typedef struct {
 	void *next, *prev;
 	
+	/* Reference counted buffer, shared by the chunks of all undo steps with the same content. */
 	char *buf;
+	/* Set when the buffer is shared with a chunk of the previous undo step. */
 	unsigned int ident, size;
+	/* Content hash, used to find identical chunks of the previous step at any position. */
+	unsigned int hash;
+	/* Key of the ID the chunk belongs to, 0 for data written outside of IDs. */
+	unsigned int id_key;
 	
 } MemFileChunk;
 
@@ -47,7 +53,8 @@ typedef struct MemFile {
 } MemFile;
 
 /* actually only used writefile.c */
-extern void memfile_chunk_add(MemFile *compare, MemFile *current, const char *buf, unsigned int size);
+extern void memfile_chunk_add(
+        MemFile *compare, MemFile *current, const char *buf, unsigned int size, unsigned int id_key);
 
 /* exports */
 extern void BLO_memfile_free(MemFile *memfile);
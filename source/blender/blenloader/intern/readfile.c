@@ -45,6 +45,8 @@
 #include "BLI_utildefines.h"
 #ifndef WIN32
 #  include <unistd.h> // for read close
+#  include <sys/mman.h> // for mmap munmap
+#  include <sys/stat.h> // for fstat
 #else
 #  include <io.h> // for open close read
 #  include "winsock2.h"
@@ -110,6 +112,7 @@
 #include "BLI_math.h"
 #include "BLI_threads.h"
 #include "BLI_mempool.h"
+#include "BLI_task.h"
 
 #include "BLT_translation.h"
 
@@ -224,6 +227,13 @@
 /* Use GHash for restoring pointers by name */
 #define USE_GHASH_RESTORE_POINTER
 
+/* Map uncompressed files in memory, DATA blocks are only indexed when the file is scanned
+ * and their data is accessed in the mapping when they are read (see blo_bhead_data),
+ * so the data of the blocks which are never read (not linked or expanded) isn't loaded. */
+#ifndef WIN32
+#  define USE_BHEAD_MMAP
+#endif
+
 /***/
 
 typedef struct OldNew {
@@ -232,11 +242,22 @@ typedef struct OldNew {
 	int nr;
 } OldNew;
 
+/* Slot of the hash index of an OldNewMap, slots of another generation are empty. */
+typedef struct OldNewSlot {
+	int index;
+	unsigned int generation;
+} OldNewSlot;
+
 typedef struct OldNewMap {
 	OldNew *entries;
 	int nentries, entriessize;
-	bool sorted;
 	int lasthit;
+	/* Open addressing index of the entries on their old address,
+	 * the number of slots is a power of two, twice the entries size. */
+	OldNewSlot *slots;
+	unsigned int slotsmask;
+	/* Incremented on clear, so the index is emptied without touching the slots. */
+	unsigned int generation;
 } OldNewMap;
 
 
@@ -279,31 +300,47 @@ static const char *library_parent_filepath(Library *lib)
 	return lib->parent ? lib->parent->filepath : "<direct>";
 }
 
+static void oldnewmap_slots_alloc(OldNewMap *onm)
+{
+	const unsigned int slotssize = (unsigned int)onm->entriessize * 2;
+
+	/* Zero generation slots are empty. */
+	onm->slots = MEM_callocN(sizeof(*onm->slots) * slotssize, "OldNewMap.slots");
+	onm->slotsmask = slotssize - 1;
+	onm->generation = 1;
+}
+
 static OldNewMap *oldnewmap_new(void) 
 {
 	OldNewMap *onm= MEM_callocN(sizeof(*onm), "OldNewMap");
 	
 	onm->entriessize = 1024;
 	onm->entries = MEM_mallocN(sizeof(*onm->entries)*onm->entriessize, "OldNewMap.entries");
+	oldnewmap_slots_alloc(onm);
 	
 	return onm;
 }
 
-static int verg_oldnewmap(const void *v1, const void *v2)
+BLI_INLINE unsigned int oldnewmap_hash(const void *addr)
 {
-	const struct OldNew *x1=v1, *x2=v2;
-	
-	if (x1->old > x2->old) return 1;
-	else if (x1->old < x2->old) return -1;
-	return 0;
+	/* Fibonacci hashing, the high bits of the product mix all the bits of the address. */
+	return (unsigned int)(((uint64_t)(uintptr_t)addr * 0x9E3779B97F4A7C15ull) >> 32);
 }
 
-
-static void oldnewmap_sort(FileData *fd) 
+static void oldnewmap_index_insert(OldNewMap *onm, const void *oldaddr, int index)
 {
-	BLI_assert(fd->libmap->sorted == false);
-	qsort(fd->libmap->entries, fd->libmap->nentries, sizeof(OldNew), verg_oldnewmap);
-	fd->libmap->sorted = 1;
+	unsigned int slot = oldnewmap_hash(oldaddr) & onm->slotsmask;
+
+	while (onm->slots[slot].generation == onm->generation) {
+		/* Newer entries shadow older entries of the same address. */
+		if (onm->entries[onm->slots[slot].index].old == oldaddr) {
+			break;
+		}
+		slot = (slot + 1) & onm->slotsmask;
+	}
+
+	onm->slots[slot].index = index;
+	onm->slots[slot].generation = onm->generation;
 }
 
 /* nr is zero for data, and ID code for libdata */
@@ -314,14 +351,25 @@ static void oldnewmap_insert(OldNewMap *onm, const void *oldaddr, void *newaddr,
 	if (oldaddr==NULL || newaddr==NULL) return;
 	
 	if (UNLIKELY(onm->nentries == onm->entriessize)) {
+		int i;
+
 		onm->entriessize *= 2;
 		onm->entries = MEM_reallocN(onm->entries, sizeof(*onm->entries) * onm->entriessize);
+
+		/* Rebuild the index to keep its load factor under a half. */
+		MEM_freeN(onm->slots);
+		oldnewmap_slots_alloc(onm);
+		for (i = 0; i < onm->nentries; i++) {
+			oldnewmap_index_insert(onm, onm->entries[i].old, i);
+		}
 	}
 
-	entry = &onm->entries[onm->nentries++];
+	entry = &onm->entries[onm->nentries];
 	entry->old = oldaddr;
 	entry->newp = newaddr;
 	entry->nr = nr;
+
+	oldnewmap_index_insert(onm, oldaddr, onm->nentries++);
 }
 
 void blo_do_versions_oldnewmap_insert(OldNewMap *onm, const void *oldaddr, void *newaddr, int nr)
@@ -330,50 +378,23 @@ void blo_do_versions_oldnewmap_insert(OldNewMap *onm, const void *oldaddr, void
 }
 
 /**
- * Do a full search (no state).
+ * Do a full search (no state) using the hash index.
  *
- * \param lasthit: Use as a reference position to avoid a full search
- * from either end of the array, giving more efficient lookups.
- *
- * \note This would seem an ideal case for hash or btree lookups.
- * However the data is written in-order, using the \a lasthit will normally avoid calling this function.
- * Creating a btree/hash structure adds overhead for the common-case to optimize the corner-case
- * (since most entries will never be retrieved).
- * So just keep full lookups as a fall-back.
+ * \note The data is written in-order, so the lasthit check done by the callers
+ * will normally avoid calling this function. But when the access pattern breaks
+ * locality, e.g. for libdata or pointers to other data-blocks, a linear search
+ * makes the relinking quadratic on large files.
  */
-static int oldnewmap_lookup_entry_full(const OldNewMap *onm, const void *addr, int lasthit)
+static int oldnewmap_lookup_entry_full(const OldNewMap *onm, const void *addr)
 {
-	const int nentries = onm->nentries;
-	const OldNew *entries = onm->entries;
-	int i;
-
-	/* search relative to lasthit where possible */
-	if (lasthit >= 0 && lasthit < nentries) {
-
-		/* search forwards */
-		i = lasthit;
-		while (++i != nentries) {
-			if (entries[i].old == addr) {
-				return i;
-			}
-		}
+	unsigned int slot = oldnewmap_hash(addr) & onm->slotsmask;
 
-		/* search backwards */
-		i = lasthit + 1;
-		while (i--) {
-			if (entries[i].old == addr) {
-				return i;
-			}
-		}
-	}
-	else {
-		/* search backwards (full) */
-		i = nentries;
-		while (i--) {
-			if (entries[i].old == addr) {
-				return i;
-			}
+	while (onm->slots[slot].generation == onm->generation) {
+		const int index = onm->slots[slot].index;
+		if (onm->entries[index].old == addr) {
+			return index;
 		}
+		slot = (slot + 1) & onm->slotsmask;
 	}
 
 	return -1;
@@ -395,7 +416,7 @@ static void *oldnewmap_lookup_and_inc(OldNewMap *onm, const void *addr, bool inc
 		}
 	}
 	
-	i = oldnewmap_lookup_entry_full(onm, addr, onm->lasthit);
+	i = oldnewmap_lookup_entry_full(onm, addr);
 	if (i != -1) {
 		OldNew *entry = &onm->entries[i];
 		BLI_assert(entry->old == addr);
@@ -411,32 +432,21 @@ static void *oldnewmap_lookup_and_inc(OldNewMap *onm, const void *addr, bool inc
 /* for libdata, nr has ID code, no increment */
 static void *oldnewmap_liblookup(OldNewMap *onm, const void *addr, const void *lib)
 {
+	int i;
+
 	if (addr == NULL) {
 		return NULL;
 	}
 
-	/* lasthit works fine for non-libdata, linking there is done in same sequence as writing */
-	if (onm->sorted) {
-		const OldNew entry_s = {.old = addr};
-		OldNew *entry = bsearch(&entry_s, onm->entries, onm->nentries, sizeof(OldNew), verg_oldnewmap);
-		if (entry) {
-			ID *id = entry->newp;
-
-			if (id && (!lib || id->lib)) {
-				return id;
-			}
-		}
-	}
-	else {
-		/* note, this can be a bottle neck when loading some files */
-		const int i = oldnewmap_lookup_entry_full(onm, addr, -1);
-		if (i != -1) {
-			OldNew *entry = &onm->entries[i];
-			ID *id = entry->newp;
-			BLI_assert(entry->old == addr);
-			if (id && (!lib || id->lib)) {
-				return id;
-			}
+	/* lasthit works fine for non-libdata, linking there is done in same sequence as writing,
+	 * libdata is looked up in the hash index directly */
+	i = oldnewmap_lookup_entry_full(onm, addr);
+	if (i != -1) {
+		OldNew *entry = &onm->entries[i];
+		ID *id = entry->newp;
+		BLI_assert(entry->old == addr);
+		if (id && (!lib || id->lib)) {
+			return id;
 		}
 	}
 
@@ -460,10 +470,16 @@ static void oldnewmap_clear(OldNewMap *onm)
 {
 	onm->nentries = 0;
 	onm->lasthit = 0;
+
+	if (UNLIKELY(++onm->generation == 0)) {
+		memset(onm->slots, 0, sizeof(*onm->slots) * (onm->slotsmask + 1));
+		onm->generation = 1;
+	}
 }
 
 static void oldnewmap_free(OldNewMap *onm) 
 {
+	MEM_freeN(onm->slots);
 	MEM_freeN(onm->entries);
 	MEM_freeN(onm);
 }
@@ -792,10 +808,32 @@ static BHeadN *get_bhead(FileData *fd)
 			/* bhead now contains the (converted) bhead structure. Now read
 			 * the associated data and put everything in a BHeadN (creative naming !)
 			 */
-			if (!fd->eof) {
+			if (fd->eof) {
+				/* pass */
+			}
+#ifdef USE_BHEAD_MMAP
+			else if (fd->mmapdata && bhead.code == DATA &&
+			         ((uintptr_t)(fd->mmapdata + fd->mmapseek) % sizeof(void *)) == 0)
+			{
+				/* Only index the block, its data stays in the mapping until read. */
+				if ((size_t)bhead.len <= fd->mmapsize - fd->mmapseek) {
+					new_bhead = MEM_mallocN(sizeof(BHeadN), "new_bhead");
+					new_bhead->next = new_bhead->prev = NULL;
+					new_bhead->mapped_data = (void *)(fd->mmapdata + fd->mmapseek);
+					new_bhead->bhead = bhead;
+
+					fd->mmapseek += bhead.len;
+				}
+				else {
+					fd->eof = 1;
+				}
+			}
+#endif
+			else {
 				new_bhead = MEM_mallocN(sizeof(BHeadN) + bhead.len, "new_bhead");
 				if (new_bhead) {
 					new_bhead->next = new_bhead->prev = NULL;
+					new_bhead->mapped_data = NULL;
 					new_bhead->bhead = bhead;
 					
 					readsize = fd->read(fd, new_bhead + 1, bhead.len);
@@ -877,6 +915,14 @@ BHead *blo_nextbhead(FileData *fd, BHead *thisblock)
 	return(bhead);
 }
 
+/* Return the data of a block, stored after the BHead or in the memory mapped file. */
+void *blo_bhead_data(BHead *bhead)
+{
+	BHeadN *bheadn = (BHeadN *)POINTER_OFFSET(bhead, -offsetof(BHeadN, bhead));
+
+	return (bheadn->mapped_data) ? bheadn->mapped_data : (void *)(bhead + 1);
+}
+
 /* Warning! Caller's responsibility to ensure given bhead **is** and ID one! */
 const char *bhead_id_name(const FileData *fd, const BHead *bhead)
 {
@@ -1029,6 +1075,19 @@ static int fd_read_from_memory(FileData *filedata, void *buffer, unsigned int si
 	return (readsize);
 }
 
+#ifdef USE_BHEAD_MMAP
+static int fd_read_from_mmap(FileData *filedata, void *buffer, unsigned int size)
+{
+	/* don't read more bytes then there are available in the mapping */
+	const size_t readsize = MIN2((size_t)size, filedata->mmapsize - filedata->mmapseek);
+
+	memcpy(buffer, filedata->mmapdata + filedata->mmapseek, readsize);
+	filedata->mmapseek += readsize;
+
+	return (int)readsize;
+}
+#endif
+
 static int fd_read_from_memfile(FileData *filedata, void *buffer, unsigned int size)
 {
 	static unsigned int seek = (1<<30);	/* the current position */
@@ -1127,6 +1186,50 @@ static FileData *blo_decode_and_check(FileData *fd, ReportList *reports)
 	return fd;
 }
 
+#ifdef USE_BHEAD_MMAP
+/**
+ * Map an uncompressed file in memory.
+ *
+ * \return NULL for compressed files or when the mapping fails, to fall back to stream reading.
+ */
+static FileData *blo_openblenderfile_mmap(const char *filepath)
+{
+	FileData *fd;
+	struct stat st;
+	unsigned char magic[2];
+	void *data;
+	const int file = BLI_open(filepath, O_BINARY | O_RDONLY, 0);
+
+	if (file == -1) {
+		return NULL;
+	}
+
+	if ((fstat(file, &st) == -1) || (st.st_size < SIZEOFBLENDERHEADER) ||
+	    (read(file, magic, sizeof(magic)) != sizeof(magic)) ||
+	    (magic[0] == 0x1f && magic[1] == 0x8b))
+	{
+		close(file);
+		return NULL;
+	}
+
+	/* A private mapping lets the endian switch of structs be done in place, without writing the file. */
+	data = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+	/* The mapping stays valid after closing the file. */
+	close(file);
+
+	if (data == MAP_FAILED) {
+		return NULL;
+	}
+
+	fd = filedata_new();
+	fd->mmapdata = data;
+	fd->mmapsize = (size_t)st.st_size;
+	fd->read = fd_read_from_mmap;
+
+	return fd;
+}
+#endif
+
 /* cannot be called with relative paths anymore! */
 /* on each new library added, it now checks for the current FileData and expands relativeness */
 FileData *blo_openblenderfile(const char *filepath, ReportList *reports)
@@ -1136,6 +1239,19 @@ FileData *blo_openblenderfile(const char *filepath, ReportList *reports)
 	if (typeencryption <= SPINDLE_NO_ENCRYPTION) {
 #endif
 		gzFile gzfile;
+
+#ifdef USE_BHEAD_MMAP
+		{
+			FileData *fd = blo_openblenderfile_mmap(filepath);
+			if (fd) {
+				/* needed for library_append and read_libraries */
+				BLI_strncpy(fd->relabase, filepath, sizeof(fd->relabase));
+
+				return blo_decode_and_check(fd, reports);
+			}
+		}
+#endif
+
 		errno = 0;
 		gzfile = BLI_gzopen(filepath, "rb");
 
@@ -1199,17 +1315,31 @@ static int fd_read_gzip_from_memory(FileData *filedata, void *buffer, unsigned i
 	filedata->strm.next_out = (Bytef *) buffer;
 	filedata->strm.avail_out = size;
 
-	// Inflate another chunk.
-	err = inflate (&filedata->strm, Z_SYNC_FLUSH);
+	/* Saved files are a sequence of gzip members (one per compressed frame, see writefile.c),
+	 * inflate them one after the other as a single stream. */
+	while (filedata->strm.avail_out > 0) {
+		// Inflate another chunk.
+		err = inflate(&filedata->strm, Z_SYNC_FLUSH);
 
-	if (err == Z_STREAM_END) {
-		return 0;
-	}
-	else if (err != Z_OK) {
-		printf("fd_read_gzip_from_memory: zlib error\n");
-		return 0;
+		if (err == Z_STREAM_END) {
+			if (filedata->strm.avail_in == 0) {
+				break;
+			}
+			if (inflateReset(&filedata->strm) != Z_OK) {
+				printf("fd_read_gzip_from_memory: zlib error\n");
+				return 0;
+			}
+		}
+		else if (err != Z_OK) {
+			printf("fd_read_gzip_from_memory: zlib error\n");
+			return 0;
+		}
+		else if (filedata->strm.avail_in == 0) {
+			break;
+		}
 	}
 
+	size -= filedata->strm.avail_out;
 	filedata->seek += size;
 
 	return (size);
@@ -1294,6 +1424,12 @@ void blo_freefiledata(FileData *fd)
 		if (fd->gzfiledes != NULL) {
 			gzclose(fd->gzfiledes);
 		}
+
+#ifdef USE_BHEAD_MMAP
+		if (fd->mmapdata) {
+			munmap((void *)fd->mmapdata, fd->mmapsize);
+		}
+#endif
 		
 		if (fd->strm.next_in) {
 			if (inflateEnd(&fd->strm) != Z_OK) {
@@ -1564,9 +1700,6 @@ static void change_idid_adr_fd(FileData *fd, const void *old, void *new)
 {
 	int i;
 	
-	/* use a binary search if we have a sorted libmap, for now it's not needed. */
-	BLI_assert(fd->libmap->sorted == false);
-
 	for (i = 0; i < fd->libmap->nentries; i++) {
 		OldNew *entry = &fd->libmap->entries[i];
 		
@@ -1886,7 +2019,7 @@ static void switch_endian_structs(const struct SDNA *filesdna, BHead *bhead)
 	int blocksize, nblocks;
 	char *data;
 	
-	data = (char *)(bhead+1);
+	data = blo_bhead_data(bhead);
 	blocksize = filesdna->typelens[ filesdna->structs[bhead->SDNAnr][0] ];
 	
 	nblocks = bhead->nr;
@@ -1902,18 +2035,21 @@ static void *read_struct(FileData *fd, BHead *bh, const char *blockname)
 	void *temp = NULL;
 	
 	if (bh->len) {
+		/* Data of mapped blocks is used in place, without intermediate copy. */
+		const void *data = blo_bhead_data(bh);
+
 		/* switch is based on file dna */
 		if (bh->SDNAnr && (fd->flags & FD_FLAGS_SWITCH_ENDIAN))
 			switch_endian_structs(fd->filesdna, bh);
 		
 		if (fd->compflags[bh->SDNAnr] != SDNA_CMP_REMOVED) {
 			if (fd->compflags[bh->SDNAnr] == SDNA_CMP_NOT_EQUAL) {
-				temp = DNA_struct_reconstruct(fd->memsdna, fd->filesdna, fd->compflags, bh->SDNAnr, bh->nr, (bh+1));
+				temp = DNA_struct_reconstruct(fd->memsdna, fd->filesdna, fd->compflags, bh->SDNAnr, bh->nr, data);
 			}
 			else {
 				/* SDNA_CMP_EQUAL */
 				temp = MEM_mallocN(bh->len, blockname);
-				memcpy(temp, (bh+1), bh->len);
+				memcpy(temp, data, bh->len);
 			}
 		}
 	}
@@ -4610,6 +4746,7 @@ static void direct_link_customdata(FileData *fd, CustomData *data, int count)
 			layer->flag &= ~CD_FLAG_IN_MEMORY;
 
 		layer->flag &= ~CD_FLAG_NOFREE;
+		layer->shared = NULL;
 		
 		if (CustomData_verify_versions(data, i)) {
 			layer->data = newdataadr(fd, layer->data);
@@ -5684,6 +5821,8 @@ static void direct_link_object(FileData *fd, Object *ob)
 
 	/* Runtime curve data  */
 	ob->curve_cache = NULL;
+	ob->modifier_cache = NULL;
+	ob->dupli_table = NULL;
 
 	/* in case this value changes in future, clamp else we get undefined behavior */
 	CLAMP(ob->rotmode, ROT_MODE_MIN, ROT_MODE_MAX);
@@ -8127,11 +8266,71 @@ static const char *dataname(short id_code)
 	
 }
 
+/* Direct data of a datablock is decoded in parallel tasks when it has at least
+ * this number of blocks and this total size, below the task overhead dominates. */
+#define READ_DATA_PARALLEL_MIN_BLOCKS 4
+#define READ_DATA_PARALLEL_MIN_SIZE (256 * 1024)
+
+typedef struct ReadDataTaskData {
+	FileData *fd;
+	BHead **bheads;
+	void **data;
+	const char *allocname;
+} ReadDataTaskData;
+
+static void read_data_task_cb(void *userdata, const int index)
+{
+	ReadDataTaskData *task_data = userdata;
+
+	/* Only reads the file and memory SDNA, the endian switch and reconstruction
+	 * of a block don't touch any other block. */
+	task_data->data[index] = read_struct(task_data->fd, task_data->bheads[index], task_data->allocname);
+}
+
 static BHead *read_data_into_oldnewmap(FileData *fd, BHead *bhead, const char *allocname)
 {
-	bhead = blo_nextbhead(fd, bhead);
-	
-	while (bhead && bhead->code==DATA) {
+	BHead *bhead_first, *bhead_end;
+	size_t totsize = 0;
+	int totblock = 0;
+
+	/* Blocks are read from the file serially, count them to decide if the
+	 * decoding is worth splitting in tasks. */
+	bhead_first = bhead_end = blo_nextbhead(fd, bhead);
+	while (bhead_end && bhead_end->code == DATA) {
+		totsize += bhead_end->len;
+		totblock++;
+		bhead_end = blo_nextbhead(fd, bhead_end);
+	}
+
+	if (totblock >= READ_DATA_PARALLEL_MIN_BLOCKS && totsize >= READ_DATA_PARALLEL_MIN_SIZE) {
+		ReadDataTaskData task_data;
+		int i;
+
+		task_data.fd = fd;
+		task_data.bheads = MEM_mallocN(sizeof(*task_data.bheads) * totblock, __func__);
+		task_data.data = MEM_mallocN(sizeof(*task_data.data) * totblock, __func__);
+		task_data.allocname = allocname;
+
+		for (bhead = bhead_first, i = 0; bhead != bhead_end; bhead = blo_nextbhead(fd, bhead), i++) {
+			task_data.bheads[i] = bhead;
+		}
+
+		BLI_task_parallel_range(0, totblock, &task_data, read_data_task_cb, true);
+
+		/* Insert in file order, so lookups during linking stay as local as in serial reading. */
+		for (i = 0; i < totblock; i++) {
+			if (task_data.data[i]) {
+				oldnewmap_insert(fd->datamap, task_data.bheads[i]->old, task_data.data[i], 0);
+			}
+		}
+
+		MEM_freeN(task_data.bheads);
+		MEM_freeN(task_data.data);
+
+		return bhead_end;
+	}
+
+	for (bhead = bhead_first; bhead != bhead_end; bhead = blo_nextbhead(fd, bhead)) {
 		void *data;
 #if 0
 		/* XXX DUMB DEBUGGING OPTION TO GIVE NAMES for guarded malloc errors */
@@ -8147,11 +8346,9 @@ static BHead *read_data_into_oldnewmap(FileData *fd, BHead *bhead, const char *a
 		if (data) {
 			oldnewmap_insert(fd->datamap, bhead->old, data, 0);
 		}
-		
-		bhead = blo_nextbhead(fd, bhead);
 	}
 	
-	return bhead;
+	return bhead_end;
 }
 
 static BHead *read_libblock(FileData *fd, Main *main, BHead *bhead, const short tag, ID **r_id)
@@ -8538,8 +8735,6 @@ static void do_versions_after_linking(Main *main)
 
 static void lib_link_all(FileData *fd, Main *main)
 {
-	oldnewmap_sort(fd);
-	
 	/* No load UI for undo memfiles */
 	if (fd->memfile == NULL) {
 		lib_link_windowmanager(fd, main);
@@ -62,6 +62,11 @@ typedef struct FileData {
 	int filedes;
 	gzFile gzfiledes;
 
+	// variables needed for reading from a memory mapped file, see USE_BHEAD_MMAP
+	const char *mmapdata;
+	size_t mmapsize;
+	size_t mmapseek;
+
 	// now only in use for library appending
 	char relabase[FILE_MAX];
 	
@@ -109,6 +114,8 @@ typedef struct FileData {
 
 typedef struct BHeadN {
 	struct BHeadN *next, *prev;
+	/* Data of the block in the memory mapped file, NULL when the data is stored after the BHead. */
+	void *mapped_data;
 	struct BHead bhead;
 } BHeadN;
 
@@ -153,6 +160,7 @@ BHead *blo_nextbhead(FileData *fd, BHead *thisblock);
 BHead *blo_prevbhead(FileData *fd, BHead *thisblock);
 
 const char *bhead_id_name(const FileData *fd, const BHead *bhead);
+void *blo_bhead_data(BHead *bhead);
 
 /* do versions stuff */
 
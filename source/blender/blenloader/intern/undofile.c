@@ -40,19 +40,49 @@
 #include "DNA_listBase.h"
 
 #include "BLI_blenlib.h"
+#include "BLI_ghash.h"
+#include "BLI_hash_mm2a.h"
 
 #include "BLO_undofile.h"
 
 /* **************** support for memory-write, for undo buffers *************** */
 
+/* Chunk buffers are shared between undo steps, their number of users is stored before the data. */
+typedef struct MemFileBuffer {
+	unsigned int users;
+	unsigned int pad;
+} MemFileBuffer;
+
+#define MEMFILE_BUFFER(buf) ((MemFileBuffer *)(buf) - 1)
+
+static char *memfile_buffer_new(const char *data, unsigned int size)
+{
+	MemFileBuffer *buffer = MEM_mallocN(sizeof(MemFileBuffer) + size, "Chunk buffer");
+	char *buf = (char *)(buffer + 1);
+
+	buffer->users = 1;
+	memcpy(buf, data, size);
+
+	return buf;
+}
+
+static void memfile_buffer_release(char *buf)
+{
+	MemFileBuffer *buffer = MEMFILE_BUFFER(buf);
+
+	BLI_assert(buffer->users > 0);
+	if (--buffer->users == 0) {
+		MEM_freeN(buffer);
+	}
+}
+
 /* not memfile itself */
 void BLO_memfile_free(MemFile *memfile)
 {
 	MemFileChunk *chunk;
 	
 	while ((chunk = BLI_pophead(&memfile->chunks))) {
-		if (chunk->ident == 0)
-			MEM_freeN(chunk->buf);
+		memfile_buffer_release(chunk->buf);
 		MEM_freeN(chunk);
 	}
 	memfile->size = 0;
@@ -62,36 +92,105 @@ void BLO_memfile_free(MemFile *memfile)
 /* result is that 'first' is being freed */
 void BLO_memfile_merge(MemFile *first, MemFile *second)
 {
-	MemFileChunk *fc, *sc;
+	MemFileChunk *sc;
 	
-	fc = first->chunks.first;
-	sc = second->chunks.first;
-	while (fc || sc) {
-		if (fc && sc) {
-			if (sc->ident) {
-				sc->ident = 0;
-				fc->ident = 1;
-			}
+	/* Buffers shared with 'first' are now only accounted in 'second'. */
+	for (sc = second->chunks.first; sc; sc = sc->next) {
+		if (sc->ident) {
+			sc->ident = 0;
+			second->size += sc->size;
 		}
-		if (fc) fc = fc->next;
-		if (sc) sc = sc->next;
 	}
 	
 	BLO_memfile_free(first);
 }
 
-void memfile_chunk_add(MemFile *compare, MemFile *current, const char *buf, unsigned int size)
+static unsigned int memfile_chunk_hash(const void *key)
+{
+	const MemFileChunk *chunk = key;
+	return (unsigned int)BLI_ghashutil_combine_hash(chunk->hash, chunk->id_key);
+}
+
+static bool memfile_chunk_cmp(const void *a, const void *b)
+{
+	const MemFileChunk *chunk_a = a;
+	const MemFileChunk *chunk_b = b;
+
+	return ((chunk_a->id_key != chunk_b->id_key) ||
+	        (chunk_a->size != chunk_b->size) ||
+	        (memcmp(chunk_a->buf, chunk_b->buf, chunk_a->size) != 0));
+}
+
+/* Map of the chunks of a file by ID and content, identical chunks are added only once. */
+static GHash *memfile_chunk_map_new(MemFile *memfile)
+{
+	GHash *map = BLI_ghash_new_ex(memfile_chunk_hash, memfile_chunk_cmp, __func__,
+	                              BLI_listbase_count(&memfile->chunks));
+	MemFileChunk *chunk;
+
+	for (chunk = memfile->chunks.first; chunk; chunk = chunk->next) {
+		void **val_p;
+
+		if (!BLI_ghash_ensure_p(map, chunk, &val_p)) {
+			*val_p = chunk;
+		}
+	}
+
+	return map;
+}
+
+/* Map of the first chunk of each ID of a file, by ID key. */
+static GHash *memfile_chunk_id_map_new(MemFile *memfile)
+{
+	GHash *map = BLI_ghash_int_new(__func__);
+	MemFileChunk *chunk;
+	unsigned int id_key_prev = 0;
+
+	for (chunk = memfile->chunks.first; chunk; chunk = chunk->next) {
+		if (chunk->id_key && (chunk->id_key != id_key_prev)) {
+			void **val_p;
+
+			if (!BLI_ghash_ensure_p(map, SET_UINT_IN_POINTER(chunk->id_key), &val_p)) {
+				*val_p = chunk;
+			}
+		}
+		id_key_prev = chunk->id_key;
+	}
+
+	return map;
+}
+
+/**
+ * Add a chunk to \a current, sharing the buffer of an identical chunk of the previous step.
+ *
+ * \param id_key: Key of the ID written, chunks never span several IDs (see writefile.c).
+ * The first chunk of each ID is compared with the first chunk of the same ID in the previous step,
+ * data inserted or removed in one ID doesn't shift the chunks of the other IDs.
+ */
+void memfile_chunk_add(
+        MemFile *compare, MemFile *current, const char *buf, unsigned int size, unsigned int id_key)
 {
 	static MemFileChunk *compchunk = NULL;
+	static MemFile *compfile = NULL;
+	/* Created on demand, most chunks match the chunk at the same position. */
+	static GHash *compmap = NULL;
+	static GHash *compidmap = NULL;
+	static unsigned int id_key_prev = 0;
 	MemFileChunk *curchunk;
 	
 	/* this function inits when compare != NULL or when current == NULL  */
-	if (compare) {
-		compchunk = compare->chunks.first;
-		return;
-	}
-	if (current == NULL) {
-		compchunk = NULL;
+	if (compare || current == NULL) {
+		if (compmap) {
+			BLI_ghash_free(compmap, NULL, NULL);
+			compmap = NULL;
+		}
+		if (compidmap) {
+			BLI_ghash_free(compidmap, NULL, NULL);
+			compidmap = NULL;
+		}
+		compfile = compare;
+		compchunk = compare ? compare->chunks.first : NULL;
+		id_key_prev = 0;
 		return;
 	}
 	
@@ -99,24 +198,64 @@ void memfile_chunk_add(MemFile *compare, MemFile *current, const char *buf, unsi
 	curchunk->size = size;
 	curchunk->buf = NULL;
 	curchunk->ident = 0;
+	curchunk->hash = 0;
+	curchunk->id_key = id_key;
 	BLI_addtail(&current->chunks, curchunk);
 	
-	/* we compare compchunk with buf */
+	/* first chunk of an ID, continue from the same ID in the previous step */
+	if (id_key && (id_key != id_key_prev) && compfile) {
+		if ((compchunk == NULL) || (compchunk->id_key != id_key)) {
+			if (compidmap == NULL) {
+				compidmap = memfile_chunk_id_map_new(compfile);
+			}
+			compchunk = BLI_ghash_lookup(compidmap, SET_UINT_IN_POINTER(id_key));
+		}
+	}
+	id_key_prev = id_key;
+	
+	/* we compare compchunk with buf, most chunks don't move between undo steps */
 	if (compchunk) {
-		if (compchunk->size == curchunk->size) {
+		if ((compchunk->size == curchunk->size) && (compchunk->id_key == id_key)) {
 			if (memcmp(compchunk->buf, buf, size) == 0) {
 				curchunk->buf = compchunk->buf;
-				curchunk->ident = 1;
+				curchunk->hash = compchunk->hash;
 			}
 		}
 		compchunk = compchunk->next;
 	}
 	
-	/* not equal... */
+	/* otherwise look for the same content anywhere in the previous step,
+	 * within the same ID when the chunk belongs to one */
 	if (curchunk->buf == NULL) {
-		curchunk->buf = MEM_mallocN(size, "Chunk buffer");
-		memcpy(curchunk->buf, buf, size);
+		curchunk->hash = BLI_hash_mm2((const unsigned char *)buf, size, 0);
+
+		if (compfile) {
+			MemFileChunk key;
+			MemFileChunk *found;
+
+			if (compmap == NULL) {
+				compmap = memfile_chunk_map_new(compfile);
+			}
+
+			key.buf = (char *)buf;
+			key.size = size;
+			key.hash = curchunk->hash;
+			key.id_key = id_key;
+			found = BLI_ghash_lookup(compmap, &key);
+
+			if (found) {
+				curchunk->buf = found->buf;
+			}
+		}
+	}
+	
+	if (curchunk->buf) {
+		curchunk->ident = 1;
+		MEMFILE_BUFFER(curchunk->buf)->users++;
+	}
+	else {
+		/* not equal... */
+		curchunk->buf = memfile_buffer_new(buf, size);
 		current->size += size;
 	}
 }
-
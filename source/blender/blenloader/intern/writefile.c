@@ -153,8 +153,11 @@
 #include "MEM_guardedalloc.h" // MEM_freeN
 #include "BLI_bitmap.h"
 #include "BLI_blenlib.h"
+#include "BLI_ghash.h"
 #include "BLI_linklist.h"
 #include "BLI_mempool.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
 
 #include "BKE_action.h"
 #include "BKE_blender_version.h"
@@ -206,6 +209,8 @@ typedef enum {
 	WW_WRAP_ZLIB,
 } eWriteWrapType;
 
+typedef struct ZlibWrap ZlibWrap;
+
 typedef struct WriteWrap WriteWrap;
 struct WriteWrap {
 	/* callbacks */
@@ -216,7 +221,7 @@ struct WriteWrap {
 	/* internal */
 	union {
 		int file_handle;
-		gzFile gz_handle;
+		ZlibWrap *zlib;
 	} _user_data;
 };
 
@@ -249,32 +254,155 @@ static size_t ww_write_none(WriteWrap *ww, const char *buf, size_t buf_len)
 #undef FILE_HANDLE
 
 /* zlib */
-#define FILE_HANDLE(ww) \
-	(ww)->_user_data.gz_handle
 
-static bool ww_open_zlib(WriteWrap *ww, const char *filepath)
+/**
+ * The file is written as a sequence of independent gzip members, one per frame,
+ * so the frames can be compressed in parallel. zlib reads concatenated members
+ * as a single stream, the files are readable as any other compressed file.
+ */
+#define WW_ZLIB_FRAME_SIZE (1 << 20)  /* 1mb */
+#define WW_ZLIB_LEVEL 1
+/* Size of the gzip header and trailer, replacing the zlib ones counted by compressBound(). */
+#define WW_ZLIB_GZIP_OVERHEAD 18
+/* Memory of the input and output buffers of all the frames, limits the frames on many core systems. */
+#define WW_ZLIB_MEMORY_MAX (32 << 20)  /* 32mb */
+
+typedef struct ZlibFrame {
+	char *in, *out;
+	size_t in_len, out_len;
+	bool error;
+} ZlibFrame;
+
+struct ZlibWrap {
+	int file_handle;
+	/* Frames compressed together, the last used one is being filled. */
+	ZlibFrame *frames;
+	int frames_num, frames_len;
+	bool error;
+};
+
+#define ZLIB_WRAP(ww) \
+	(ww)->_user_data.zlib
+
+static void ww_zlib_compress_frame_cb(void *userdata, const int index)
 {
-	gzFile file;
+	ZlibWrap *zw = userdata;
+	ZlibFrame *frame = &zw->frames[index];
+	z_stream stream = {NULL};
 
-	file = BLI_gzopen(filepath, "wb1");
+	/* Window bits over 15 write a gzip header and trailer. */
+	if (deflateInit2(&stream, WW_ZLIB_LEVEL, Z_DEFLATED, MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+		frame->error = true;
+		return;
+	}
 
-	if (file != Z_NULL) {
-		FILE_HANDLE(ww) = file;
-		return true;
+	stream.next_in = (Bytef *)frame->in;
+	stream.avail_in = (uInt)frame->in_len;
+	stream.next_out = (Bytef *)frame->out;
+	stream.avail_out = (uInt)(compressBound(WW_ZLIB_FRAME_SIZE) + WW_ZLIB_GZIP_OVERHEAD);
+
+	frame->error = (deflate(&stream, Z_FINISH) != Z_STREAM_END);
+	frame->out_len = stream.total_out;
+
+	deflateEnd(&stream);
+}
+
+/* Compress the pending frames and write them in order. */
+static void ww_zlib_flush(ZlibWrap *zw)
+{
+	int i;
+
+	if (zw->frames_len == 0) {
+		return;
 	}
-	else {
+
+	BLI_task_parallel_range(0, zw->frames_len, zw, ww_zlib_compress_frame_cb, (zw->frames_len > 1));
+
+	for (i = 0; i < zw->frames_len; i++) {
+		ZlibFrame *frame = &zw->frames[i];
+
+		if (frame->error || ((size_t)write(zw->file_handle, frame->out, frame->out_len) != frame->out_len)) {
+			zw->error = true;
+		}
+		frame->in_len = 0;
+	}
+
+	zw->frames_len = 0;
+}
+
+static bool ww_open_zlib(WriteWrap *ww, const char *filepath)
+{
+	ZlibWrap *zw;
+	int file, i;
+
+	file = BLI_open(filepath, O_BINARY + O_WRONLY + O_CREAT + O_TRUNC, 0666);
+
+	if (file == -1) {
 		return false;
 	}
+
+	zw = MEM_callocN(sizeof(*zw), __func__);
+	zw->file_handle = file;
+	zw->frames_num = CLAMPIS(
+	        BLI_system_thread_count(), 1,
+	        (int)(WW_ZLIB_MEMORY_MAX / (WW_ZLIB_FRAME_SIZE + compressBound(WW_ZLIB_FRAME_SIZE) + WW_ZLIB_GZIP_OVERHEAD)));
+	zw->frames = MEM_callocN(sizeof(*zw->frames) * zw->frames_num, __func__);
+
+	for (i = 0; i < zw->frames_num; i++) {
+		zw->frames[i].in = MEM_mallocN(WW_ZLIB_FRAME_SIZE, "ww_zlib_frame_in");
+		zw->frames[i].out = MEM_mallocN(compressBound(WW_ZLIB_FRAME_SIZE) + WW_ZLIB_GZIP_OVERHEAD, "ww_zlib_frame_out");
+	}
+
+	ZLIB_WRAP(ww) = zw;
+
+	return true;
 }
 static bool ww_close_zlib(WriteWrap *ww)
 {
-	return (gzclose(FILE_HANDLE(ww)) == Z_OK);
+	ZlibWrap *zw = ZLIB_WRAP(ww);
+	bool ok;
+	int i;
+
+	ww_zlib_flush(zw);
+
+	ok = !zw->error && (close(zw->file_handle) != -1);
+
+	for (i = 0; i < zw->frames_num; i++) {
+		MEM_freeN(zw->frames[i].in);
+		MEM_freeN(zw->frames[i].out);
+	}
+	MEM_freeN(zw->frames);
+	MEM_freeN(zw);
+
+	return ok;
 }
 static size_t ww_write_zlib(WriteWrap *ww, const char *buf, size_t buf_len)
 {
-	return gzwrite(FILE_HANDLE(ww), buf, buf_len);
+	ZlibWrap *zw = ZLIB_WRAP(ww);
+	size_t len = buf_len;
+
+	while (len > 0) {
+		ZlibFrame *frame;
+		size_t frame_len;
+
+		if (zw->frames_len == 0 || zw->frames[zw->frames_len - 1].in_len == WW_ZLIB_FRAME_SIZE) {
+			if (zw->frames_len == zw->frames_num) {
+				ww_zlib_flush(zw);
+			}
+			zw->frames_len++;
+		}
+
+		frame = &zw->frames[zw->frames_len - 1];
+		frame_len = MIN2(len, WW_ZLIB_FRAME_SIZE - frame->in_len);
+		memcpy(frame->in + frame->in_len, buf, frame_len);
+		frame->in_len += frame_len;
+		buf += frame_len;
+		len -= frame_len;
+	}
+
+	return zw->error ? 0 : buf_len;
 }
-#undef FILE_HANDLE
+#undef ZLIB_WRAP
 
 /* --- end compression types --- */
 
@@ -309,6 +437,8 @@ typedef struct {
 
 	unsigned char *buf;
 	MemFile *compare, *current;
+	/* Key of the ID being written to the undo memory file, 0 outside of IDs. */
+	unsigned int id_key;
 
 	int tot, count;
 	bool error;
@@ -348,7 +478,7 @@ static void writedata_do_write(WriteData *wd, const void *mem, int memlen)
 
 	/* memory based save */
 	if (wd->current) {
-		memfile_chunk_add(NULL, wd->current, mem, memlen);
+		memfile_chunk_add(NULL, wd->current, mem, memlen, wd->id_key);
 	}
 	else {
 		if (wd->ww->write(wd->ww, mem, memlen) != memlen) {
@@ -377,6 +507,27 @@ static void mywrite_flush(WriteData *wd)
 	}
 }
 
+/**
+ * For undo, each ID starts a new chunk keyed on the ID.
+ * Chunks of an ID are compared with the chunks of the same ID in the previous undo step,
+ * so an ID growing or shrinking doesn't shift the chunks of all IDs written after it.
+ */
+static void mywrite_id_begin(WriteData *wd, const ID *id)
+{
+	if (wd->current) {
+		mywrite_flush(wd);
+		wd->id_key = BLI_ghashutil_strhash_p(id->name);
+	}
+}
+
+static void mywrite_id_end(WriteData *wd)
+{
+	if (wd->current) {
+		mywrite_flush(wd);
+		wd->id_key = 0;
+	}
+}
+
 /**
  * Low level WRITE(2) wrapper that buffers data
  * \param adr Pointer to new chunk of data
@@ -443,7 +594,7 @@ static WriteData *bgnwrite(WriteWrap *ww, MemFile *compare, MemFile *current)
 	wd->compare = compare;
 	wd->current = current;
 	/* this inits comparing */
-	memfile_chunk_add(compare, NULL, NULL, 0);
+	memfile_chunk_add(compare, NULL, NULL, 0, 0);
 
 	return wd;
 }
@@ -461,6 +612,9 @@ static bool endwrite(WriteData *wd)
 		wd->count = 0;
 	}
 
+	/* this ends comparing */
+	memfile_chunk_add(NULL, NULL, NULL, 0, 0);
+
 	const bool err = wd->error;
 	writedata_free(wd);
 
@@ -3879,6 +4033,8 @@ static bool write_file_handle(
 			/* We should never attempt to write non-regular IDs (i.e. all kind of temp/runtime ones). */
 			BLI_assert((id->tag & (LIB_TAG_NO_MAIN | LIB_TAG_NO_USER_REFCOUNT | LIB_TAG_NOT_ALLOCATED)) == 0);
 
+			mywrite_id_begin(wd, id);
+
 			switch ((ID_Type)GS(id->name)) {
 				case ID_WM:
 					write_windowmanager(wd, (wmWindowManager *)id);
@@ -3988,6 +4144,8 @@ static bool write_file_handle(
 					BLI_assert(0);
 					break;
 			}
+
+			mywrite_id_end(wd);
 		}
 
 		mywrite_flush(wd);
@@ -103,6 +103,52 @@ static void bm_mempool_init(BMesh *bm, const BMAllocTemplate *allocsize, const b
 #endif
 }
 
+typedef struct BMToolFlagsEnsureData {
+	BLI_mempool *toolflagpool;
+	/* offset of 'oflags' in #BMVert_OFlag, #BMEdge_OFlag or #BMFace_OFlag */
+	size_t oflags_offset;
+} BMToolFlagsEnsureData;
+
+/* Per-thread toolflag allocation, only the #BLI_mempool_local cache of each task differs. */
+typedef struct BMToolFlagsEnsureChunk {
+	BLI_mempool_local *toolflagpool_local;
+} BMToolFlagsEnsureChunk;
+
+static void bm_mesh_elem_toolflags_ensure_cb(
+        void *userdata, void *userdata_chunk, MempoolIterData *mp_ele)
+{
+	BMToolFlagsEnsureData *data = userdata;
+	BMToolFlagsEnsureChunk *chunk = userdata_chunk;
+	BMFlagLayer **oflags = POINTER_OFFSET((void *)mp_ele, data->oflags_offset);
+
+	if (chunk->toolflagpool_local == NULL) {
+		chunk->toolflagpool_local = BLI_mempool_local_create(data->toolflagpool);
+	}
+
+	*oflags = BLI_mempool_local_calloc(chunk->toolflagpool_local);
+}
+
+static void bm_mesh_elem_toolflags_ensure_finalize(void *UNUSED(userdata), void *userdata_chunk)
+{
+	BMToolFlagsEnsureChunk *chunk = userdata_chunk;
+
+	if (chunk->toolflagpool_local) {
+		BLI_mempool_local_destroy(chunk->toolflagpool_local);
+	}
+}
+
+static void bm_mesh_elem_toolflags_ensure_pool(
+        BLI_mempool *elem_pool, BLI_mempool *toolflagpool, const size_t oflags_offset, const int totelem)
+{
+	BMToolFlagsEnsureData data = {toolflagpool, oflags_offset};
+	BMToolFlagsEnsureChunk chunk = {NULL};
+
+	BLI_task_parallel_mempool_finalize(
+	        elem_pool, &data, &chunk, sizeof(chunk),
+	        bm_mesh_elem_toolflags_ensure_cb, bm_mesh_elem_toolflags_ensure_finalize,
+	        totelem >= BM_OMP_LIMIT);
+}
+
 void BM_mesh_elem_toolflags_ensure(BMesh *bm)
 {
 	BLI_assert(bm->use_toolflags);
@@ -115,24 +161,12 @@ void BM_mesh_elem_toolflags_ensure(BMesh *bm)
 	bm->etoolflagpool = BLI_mempool_create(sizeof(BMFlagLayer), bm->totedge, 512, BLI_MEMPOOL_NOP);
 	bm->ftoolflagpool = BLI_mempool_create(sizeof(BMFlagLayer), bm->totface, 512, BLI_MEMPOOL_NOP);
 
-	BMIter iter;
-	BMVert_OFlag *v_olfag;
-	BLI_mempool *toolflagpool = bm->vtoolflagpool;
-	BM_ITER_MESH (v_olfag, &iter, bm, BM_VERTS_OF_MESH) {
-		v_olfag->oflags = BLI_mempool_calloc(toolflagpool);
-	}
-
-	BMEdge_OFlag *e_olfag;
-	toolflagpool = bm->etoolflagpool;
-	BM_ITER_MESH (e_olfag, &iter, bm, BM_EDGES_OF_MESH) {
-		e_olfag->oflags = BLI_mempool_calloc(toolflagpool);
-	}
-
-	BMFace_OFlag *f_olfag;
-	toolflagpool = bm->ftoolflagpool;
-	BM_ITER_MESH (f_olfag, &iter, bm, BM_FACES_OF_MESH) {
-		f_olfag->oflags = BLI_mempool_calloc(toolflagpool);
-	}
+	bm_mesh_elem_toolflags_ensure_pool(
+	        bm->vpool, bm->vtoolflagpool, offsetof(BMVert_OFlag, oflags), bm->totvert);
+	bm_mesh_elem_toolflags_ensure_pool(
+	        bm->epool, bm->etoolflagpool, offsetof(BMEdge_OFlag, oflags), bm->totedge);
+	bm_mesh_elem_toolflags_ensure_pool(
+	        bm->fpool, bm->ftoolflagpool, offsetof(BMFace_OFlag, oflags), bm->totface);
 
 	bm->totflags = 1;
 }
@@ -34,12 +34,15 @@
 #include "BLI_math.h"
 #include "BLI_quadric.h"
 #include "BLI_heap.h"
+#include "BLI_bitmap.h"
 #include "BLI_linklist.h"
 #include "BLI_alloca.h"
 #include "BLI_memarena.h"
 #include "BLI_edgehash.h"
 #include "BLI_polyfill2d.h"
 #include "BLI_polyfill2d_beautify.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
 #include "BLI_utildefines_stack.h"
 
 
@@ -366,10 +369,9 @@ static void bm_decim_build_edge_cost(
 {
 	BMIter iter;
 	BMEdge *e;
-	uint i;
 
-	BM_ITER_MESH_INDEX (e, &iter, bm, BM_EDGES_OF_MESH, i) {
-		eheap_table[i] = NULL;  /* keep sanity check happy */
+	BM_ITER_MESH (e, &iter, bm, BM_EDGES_OF_MESH) {
+		eheap_table[BM_elem_index_get(e)] = NULL;  /* keep sanity check happy */
 		bm_decim_build_edge_cost_single(e, vquadrics, vweights, vweight_factor, eheap, eheap_table);
 	}
 }
@@ -815,38 +817,67 @@ static void bm_edge_collapse_loop_customdata(
  * after the cost is calculated, so instead, check just before collapsing.
  */
 
-static void bm_edge_tag_enable(BMEdge *e)
+/**
+ * Tags used by the degenerate check, when NULL the elements BM_ELEM_TAG is used.
+ *
+ * When collapsing from multiple threads each one needs its own tags,
+ * the checked elements can be next to another slab (or locked vertices shared with it).
+ */
+typedef struct DegenerateTags {
+	BLI_bitmap *verts;
+	BLI_bitmap *faces;
+} DegenerateTags;
+
+BLI_INLINE void bm_vert_tag_set(BMVert *v, const bool value, const DegenerateTags *tags)
 {
-	BM_elem_flag_enable(e->v1, BM_ELEM_TAG);
-	BM_elem_flag_enable(e->v2, BM_ELEM_TAG);
-	if (e->l) {
-		BM_elem_flag_enable(e->l->f, BM_ELEM_TAG);
-		if (e->l != e->l->radial_next) {
-			BM_elem_flag_enable(e->l->radial_next->f, BM_ELEM_TAG);
-		}
+	if (tags) {
+		BLI_BITMAP_SET(tags->verts, BM_elem_index_get(v), value);
+	}
+	else {
+		BM_elem_flag_set(v, BM_ELEM_TAG, value);
 	}
 }
 
-static void bm_edge_tag_disable(BMEdge *e)
+BLI_INLINE void bm_face_tag_set(BMFace *f, const bool value, const DegenerateTags *tags)
 {
-	BM_elem_flag_disable(e->v1, BM_ELEM_TAG);
-	BM_elem_flag_disable(e->v2, BM_ELEM_TAG);
+	if (tags) {
+		BLI_BITMAP_SET(tags->faces, BM_elem_index_get(f), value);
+	}
+	else {
+		BM_elem_flag_set(f, BM_ELEM_TAG, value);
+	}
+}
+
+BLI_INLINE bool bm_vert_tag_test(BMVert *v, const DegenerateTags *tags)
+{
+	return tags ? BLI_BITMAP_TEST_BOOL(tags->verts, BM_elem_index_get(v)) : BM_elem_flag_test_bool(v, BM_ELEM_TAG);
+}
+
+BLI_INLINE bool bm_face_tag_test(BMFace *f, const DegenerateTags *tags)
+{
+	return tags ? BLI_BITMAP_TEST_BOOL(tags->faces, BM_elem_index_get(f)) : BM_elem_flag_test_bool(f, BM_ELEM_TAG);
+}
+
+static void bm_edge_tag_set(BMEdge *e, const bool value, const DegenerateTags *tags)
+{
+	bm_vert_tag_set(e->v1, value, tags);
+	bm_vert_tag_set(e->v2, value, tags);
 	if (e->l) {
-		BM_elem_flag_disable(e->l->f, BM_ELEM_TAG);
+		bm_face_tag_set(e->l->f, value, tags);
 		if (e->l != e->l->radial_next) {
-			BM_elem_flag_disable(e->l->radial_next->f, BM_ELEM_TAG);
+			bm_face_tag_set(e->l->radial_next->f, value, tags);
 		}
 	}
 }
 
-static bool bm_edge_tag_test(BMEdge *e)
+static bool bm_edge_tag_test(BMEdge *e, const DegenerateTags *tags)
 {
 	/* is the edge or one of its faces tagged? */
-	return (BM_elem_flag_test(e->v1, BM_ELEM_TAG) ||
-	        BM_elem_flag_test(e->v2, BM_ELEM_TAG) ||
-	        (e->l && (BM_elem_flag_test(e->l->f, BM_ELEM_TAG) ||
+	return (bm_vert_tag_test(e->v1, tags) ||
+	        bm_vert_tag_test(e->v2, tags) ||
+	        (e->l && (bm_face_tag_test(e->l->f, tags) ||
 	                  (e->l != e->l->radial_next &&
-	                  BM_elem_flag_test(e->l->radial_next->f, BM_ELEM_TAG))))
+	                  bm_face_tag_test(e->l->radial_next->f, tags))))
 	        );
 }
 
@@ -862,7 +893,7 @@ BLI_INLINE int bm_edge_is_manifold_or_boundary(BMLoop *l)
 #endif
 }
 
-static bool bm_edge_collapse_is_degenerate_topology(BMEdge *e_first)
+static bool bm_edge_collapse_is_degenerate_topology(BMEdge *e_first, const DegenerateTags *tags)
 {
 	/* simply check that there is no overlap between faces and edges of each vert,
 	 * (excluding the 2 faces attached to 'e' and 'e' its self) */
@@ -875,7 +906,7 @@ static bool bm_edge_collapse_is_degenerate_topology(BMEdge *e_first)
 		if (!bm_edge_is_manifold_or_boundary(e_iter->l)) {
 			return true;
 		}
-		bm_edge_tag_disable(e_iter);
+		bm_edge_tag_set(e_iter, false, tags);
 	} while ((e_iter = bmesh_disk_edge_next(e_iter, e_first->v1)) != e_first);
 
 	e_iter = e_first;
@@ -883,19 +914,19 @@ static bool bm_edge_collapse_is_degenerate_topology(BMEdge *e_first)
 		if (!bm_edge_is_manifold_or_boundary(e_iter->l)) {
 			return true;
 		}
-		bm_edge_tag_disable(e_iter);
+		bm_edge_tag_set(e_iter, false, tags);
 	} while ((e_iter = bmesh_disk_edge_next(e_iter, e_first->v2)) != e_first);
 
 	/* now enable one side... */
 	e_iter = e_first;
 	do {
-		bm_edge_tag_enable(e_iter);
+		bm_edge_tag_set(e_iter, true, tags);
 	} while ((e_iter = bmesh_disk_edge_next(e_iter, e_first->v1)) != e_first);
 
 	/* ... except for the edge we will collapse, we know thats shared,
 	 * disable this to avoid false positive. We could be smart and never enable these
 	 * face/edge tags in the first place but easier to do this */
-	// bm_edge_tag_disable(e_first);
+	// bm_edge_tag_set(e_first, false, tags);
 	/* do inline... */
 	{
 #if 0
@@ -904,9 +935,9 @@ static bool bm_edge_collapse_is_degenerate_topology(BMEdge *e_first)
 		BMLoop *l;
 		BMVert *v;
 		BM_ITER_ELEM (l, &liter, e_first, BM_LOOPS_OF_EDGE) {
-			BM_elem_flag_disable(l->f, BM_ELEM_TAG);
+			bm_face_tag_set(l->f, false, tags);
 			BM_ITER_ELEM (v, &iter, l->f, BM_VERTS_OF_FACE) {
-				BM_elem_flag_disable(v, BM_ELEM_TAG);
+				bm_vert_tag_set(v, false, tags);
 			}
 		}
 #else
@@ -918,17 +949,17 @@ static bool bm_edge_collapse_is_degenerate_topology(BMEdge *e_first)
 		l_radial = e_first->l;
 		l_face = l_radial;
 		BLI_assert(l_face->f->len == 3);
-		BM_elem_flag_disable(l_face->f, BM_ELEM_TAG);
-		BM_elem_flag_disable((l_face = l_radial)->v,     BM_ELEM_TAG);
-		BM_elem_flag_disable((l_face = l_face->next)->v, BM_ELEM_TAG);
-		BM_elem_flag_disable((         l_face->next)->v, BM_ELEM_TAG);
+		bm_face_tag_set(l_face->f, false, tags);
+		bm_vert_tag_set((l_face = l_radial)->v,     false, tags);
+		bm_vert_tag_set((l_face = l_face->next)->v, false, tags);
+		bm_vert_tag_set((         l_face->next)->v, false, tags);
 		l_face = l_radial->radial_next;
 		if (l_radial != l_face) {
 			BLI_assert(l_face->f->len == 3);
-			BM_elem_flag_disable(l_face->f, BM_ELEM_TAG);
-			BM_elem_flag_disable((l_face = l_radial->radial_next)->v, BM_ELEM_TAG);
-			BM_elem_flag_disable((l_face = l_face->next)->v,          BM_ELEM_TAG);
-			BM_elem_flag_disable((         l_face->next)->v,          BM_ELEM_TAG);
+			bm_face_tag_set(l_face->f, false, tags);
+			bm_vert_tag_set((l_face = l_radial->radial_next)->v, false, tags);
+			bm_vert_tag_set((l_face = l_face->next)->v,          false, tags);
+			bm_vert_tag_set((         l_face->next)->v,          false, tags);
 		}
 #endif
 	}
@@ -936,7 +967,7 @@ static bool bm_edge_collapse_is_degenerate_topology(BMEdge *e_first)
 	/* and check for overlap */
 	e_iter = e_first;
 	do {
-		if (bm_edge_tag_test(e_iter)) {
+		if (bm_edge_tag_test(e_iter, tags)) {
 			return true;
 		}
 	} while ((e_iter = bmesh_disk_edge_next(e_iter, e_first->v2)) != e_first);
@@ -944,6 +975,17 @@ static bool bm_edge_collapse_is_degenerate_topology(BMEdge *e_first)
 	return false;
 }
 
+/**
+ * A task collapsing one slab of the mesh (see Partitioned Decimation).
+ */
+typedef struct DecimPartitionTask {
+	/* held while elements are removed (the mesh element pools and counters are shared) */
+	SpinLock *topology_lock;
+	/* slab of each vertex, -1 for vertices connected to another slab */
+	const int *vert_part;
+	DegenerateTags tags;
+} DecimPartitionTask;
+
 /**
  * special, highly limited edge collapse function
  * intended for speed over flexibility.
@@ -953,6 +995,8 @@ static bool bm_edge_collapse_is_degenerate_topology(BMEdge *e_first)
  *
  * \param r_e_clear_other: Let caller know what edges we remove besides \a e_clear
  * \param customdata_flag: Merge factor, scales from 0 - 1 ('v_clear' -> 'v_other')
+ * \param topology_lock: When collapsing from multiple threads, held while elements are removed
+ * (the mesh element pools and counters are shared).
  */
 static bool bm_edge_collapse(
         BMesh *bm, BMEdge *e_clear, BMVert *v_clear, int r_e_clear_other[2],
@@ -961,11 +1005,12 @@ static bool bm_edge_collapse(
 #endif
 #ifdef USE_CUSTOMDATA
         const CD_UseFlag customdata_flag,
-        const float customdata_fac
+        const float customdata_fac,
 #else
         const CD_UseFlag UNUSED(customdata_flag),
-        const float UNUSED(customdata_fac)
+        const float UNUSED(customdata_fac),
 #endif
+        SpinLock *topology_lock
         )
 {
 	BMVert *v_other;
@@ -1039,6 +1084,10 @@ static bool bm_edge_collapse(
 		}
 #endif
 
+		if (topology_lock) {
+			BLI_spin_lock(topology_lock);
+		}
+
 		BM_edge_kill(bm, e_clear);
 
 		v_other->head.hflag |= v_clear->head.hflag;
@@ -1049,6 +1098,10 @@ static bool bm_edge_collapse(
 		BM_edge_splice(bm, e_a_other[1], e_a_other[0]);
 		BM_edge_splice(bm, e_b_other[1], e_b_other[0]);
 
+		if (topology_lock) {
+			BLI_spin_unlock(topology_lock);
+		}
+
 #ifdef USE_SYMMETRY
 		/* update mirror map */
 		if (edge_symmetry_map) {
@@ -1100,6 +1153,10 @@ static bool bm_edge_collapse(
 		}
 #endif
 
+		if (topology_lock) {
+			BLI_spin_lock(topology_lock);
+		}
+
 		BM_edge_kill(bm, e_clear);
 
 		v_other->head.hflag |= v_clear->head.hflag;
@@ -1108,6 +1165,10 @@ static bool bm_edge_collapse(
 		e_a_other[1]->head.hflag |= e_a_other[0]->head.hflag;
 		BM_edge_splice(bm, e_a_other[1], e_a_other[0]);
 
+		if (topology_lock) {
+			BLI_spin_unlock(topology_lock);
+		}
+
 #ifdef USE_SYMMETRY
 		/* update mirror map */
 		if (edge_symmetry_map) {
@@ -1130,6 +1191,7 @@ static bool bm_edge_collapse(
 /**
  * Collapse e the edge, removing e->v2
  *
+ * \param ptask: The task collapsing the slab of \a e, NULL when collapsing the whole mesh.
  * \return true when the edge was collapsed.
  */
 static bool bm_decim_edge_collapse(
@@ -1141,6 +1203,7 @@ static bool bm_decim_edge_collapse(
         int *edge_symmetry_map,
 #endif
         const CD_UseFlag customdata_flag,
+        const DecimPartitionTask *ptask,
         float optimize_co[3], bool optimize_co_calc
         )
 {
@@ -1158,7 +1221,7 @@ static bool bm_decim_edge_collapse(
 	/* when false, use without degenerate checks */
 	if (optimize_co_calc) {
 		/* disallow collapsing which results in degenerate cases */
-		if (UNLIKELY(bm_edge_collapse_is_degenerate_topology(e))) {
+		if (UNLIKELY(bm_edge_collapse_is_degenerate_topology(e, ptask ? &ptask->tags : NULL))) {
 			bm_decim_invalid_edge_cost_single(e, eheap, eheap_table);  /* add back with a high cost */
 			return false;
 		}
@@ -1192,7 +1255,7 @@ static bool bm_decim_edge_collapse(
 #ifdef USE_SYMMETRY
 	        edge_symmetry_map,
 #endif
-	        customdata_flag, customdata_fac))
+	        customdata_flag, customdata_fac, ptask ? ptask->topology_lock : NULL))
 	{
 		/* update collapse info */
 		int i;
@@ -1260,6 +1323,15 @@ static bool bm_decim_edge_collapse(
 
 					BLI_assert(BM_vert_in_edge(e_outer, l->v) == false);
 
+					/* an edge between two locked vertices may be in the fan of another slab too,
+					 * it's not collapsed by the slabs, its cost is calculated again afterwards */
+					if (ptask &&
+					    (ptask->vert_part[BM_elem_index_get(e_outer->v1)] == -1) &&
+					    (ptask->vert_part[BM_elem_index_get(e_outer->v2)] == -1))
+					{
+						continue;
+					}
+
 					bm_decim_build_edge_cost_single(e_outer, vquadrics, vweights, vweight_factor, eheap, eheap_table);
 				}
 			}
@@ -1276,6 +1348,270 @@ static bool bm_decim_edge_collapse(
 }
 
 
+/* Partitioned Decimation
+ * ***********************
+ *
+ * The mesh is split into slabs along its longest axis, each one decimated by its own task with its own heap.
+ * Vertices connected to another slab are locked, so tasks never collapse the same elements
+ * (collapsing two unlocked vertices only connects vertices of the same slab).
+ * Locked vertices and their faces are still read by the tasks on both sides,
+ * so each task tags elements in its own bitmaps instead of the element flags.
+ * The edges left between slabs are collapsed afterwards by the regular (single threaded) decimation,
+ * which also brings the face count to the exact target. */
+
+/* smaller meshes are quick to decimate in one go */
+#define PARTITION_FACE_MIN 10000
+/* resolution used to find slabs with about the same number of vertices */
+#define PARTITION_BINS 4096
+
+typedef struct DecimPartition {
+	BMEdge **edges;
+	int edges_len;
+	int totface, face_tot_target;
+} DecimPartition;
+
+typedef struct DecimPartitionData {
+	const int *vert_part;
+	Quadric *vquadrics;
+	float *vweights;
+	float vweight_factor;
+	HeapNode **eheap_table;
+	CD_UseFlag customdata_flag;
+	BMesh *bm;
+	/* element counts before collapsing (the mesh totals change while tasks run) */
+	int totvert, totface;
+	SpinLock topology_lock;
+} DecimPartitionData;
+
+/**
+ * \return vertex index aligned slab index, -1 for locked vertices, or NULL when the mesh can't be split.
+ */
+static int *bm_decim_partition_verts(BMesh *bm, const int parts_len)
+{
+	BMIter iter;
+	BMVert *v;
+	BMEdge *e;
+	float min[3], max[3], size[3];
+	int bins[PARTITION_BINS], bin_part[PARTITION_BINS];
+	BLI_bitmap *verts_locked;
+	int *vert_part;
+	int axis, i, totvert_bin;
+	float bin_scale;
+
+	INIT_MINMAX(min, max);
+	BM_ITER_MESH (v, &iter, bm, BM_VERTS_OF_MESH) {
+		minmax_v3v3_v3(min, max, v->co);
+	}
+	sub_v3_v3v3(size, max, min);
+	axis = max_axis_v3(size);
+
+	if (!(size[axis] > FLT_EPSILON)) {
+		return NULL;
+	}
+
+	vert_part = MEM_mallocN(sizeof(*vert_part) * bm->totvert, __func__);
+	bin_scale = (float)PARTITION_BINS / size[axis];
+	memset(bins, 0, sizeof(bins));
+
+	BM_ITER_MESH (v, &iter, bm, BM_VERTS_OF_MESH) {
+		int bin = (int)((v->co[axis] - min[axis]) * bin_scale);
+		CLAMP(bin, 0, PARTITION_BINS - 1);
+		vert_part[BM_elem_index_get(v)] = bin;
+		bins[bin]++;
+	}
+
+	/* give each slab about the same number of vertices */
+	totvert_bin = 0;
+	for (i = 0; i < PARTITION_BINS; i++) {
+		bin_part[i] = min_ii((int)(((int64_t)totvert_bin * parts_len) / bm->totvert), parts_len - 1);
+		totvert_bin += bins[i];
+	}
+
+	verts_locked = BLI_BITMAP_NEW(bm->totvert, __func__);
+	BM_ITER_MESH (v, &iter, bm, BM_VERTS_OF_MESH) {
+		const int v_index = BM_elem_index_get(v);
+		vert_part[v_index] = bin_part[vert_part[v_index]];
+	}
+	BM_ITER_MESH (e, &iter, bm, BM_EDGES_OF_MESH) {
+		const int v1_index = BM_elem_index_get(e->v1);
+		const int v2_index = BM_elem_index_get(e->v2);
+		if (vert_part[v1_index] != vert_part[v2_index]) {
+			BLI_BITMAP_ENABLE(verts_locked, v1_index);
+			BLI_BITMAP_ENABLE(verts_locked, v2_index);
+		}
+	}
+	for (i = 0; i < bm->totvert; i++) {
+		if (BLI_BITMAP_TEST(verts_locked, i)) {
+			vert_part[i] = -1;
+		}
+	}
+
+	MEM_freeN(verts_locked);
+
+	return vert_part;
+}
+
+static bool bm_decim_partition_edge_is_locked(const int *vert_part, BMEdge *e)
+{
+	return ((vert_part[BM_elem_index_get(e->v1)] == -1) ||
+	        (vert_part[BM_elem_index_get(e->v2)] == -1));
+}
+
+static void bm_decim_partition_collapse_cb(TaskPool * __restrict pool, void *taskdata, int UNUSED(threadid))
+{
+	DecimPartitionData *data = BLI_task_pool_userdata(pool);
+	DecimPartition *part = taskdata;
+	HeapNode **eheap_table = data->eheap_table;
+	Heap *eheap = BLI_heap_new_ex((uint)part->edges_len);
+	DecimPartitionTask ptask;
+	int i;
+
+	ptask.topology_lock = &data->topology_lock;
+	ptask.vert_part = data->vert_part;
+	ptask.tags.verts = BLI_BITMAP_NEW(data->totvert, __func__);
+	ptask.tags.faces = BLI_BITMAP_NEW(data->totface, __func__);
+
+	for (i = 0; i < part->edges_len; i++) {
+		bm_decim_build_edge_cost_single(
+		        part->edges[i], data->vquadrics, data->vweights, data->vweight_factor, eheap, eheap_table);
+	}
+
+	while ((part->totface > part->face_tot_target) &&
+	       (BLI_heap_is_empty(eheap) == false) &&
+	       (BLI_heap_node_value(BLI_heap_top(eheap)) != COST_INVALID))
+	{
+		BMEdge *e = BLI_heap_popmin(eheap);
+		const int e_face_tot = BM_edge_is_manifold(e) ? 2 : 1;
+		float optimize_co[3];
+
+		eheap_table[BM_elem_index_get(e)] = NULL;
+
+		/* edges next to the slab boundary are added back when their neighbors are collapsed */
+		if (bm_decim_partition_edge_is_locked(data->vert_part, e)) {
+			bm_decim_invalid_edge_cost_single(e, eheap, eheap_table);
+			continue;
+		}
+
+		if (bm_decim_edge_collapse(
+		        data->bm, e, data->vquadrics, data->vweights, data->vweight_factor, eheap, eheap_table,
+#ifdef USE_SYMMETRY
+		        NULL,
+#endif
+		        data->customdata_flag, &ptask,
+		        optimize_co, true))
+		{
+			part->totface -= e_face_tot;
+		}
+	}
+
+	/* nodes are freed with the heap, the table is cleared by the caller */
+	BLI_heap_free(eheap, NULL);
+
+	MEM_freeN(ptask.tags.verts);
+	MEM_freeN(ptask.tags.faces);
+}
+
+/**
+ * Decimate the slabs of the mesh in parallel, each down to \a factor of its own faces.
+ * \a eheap_table is left cleared.
+ */
+static void bm_decim_partition_collapse(
+        BMesh *bm, const float factor,
+        Quadric *vquadrics,
+        float *vweights, const float vweight_factor,
+        HeapNode **eheap_table, const int tot_edge_orig,
+        const CD_UseFlag customdata_flag)
+{
+	TaskScheduler *scheduler = BLI_task_scheduler_get();
+	TaskPool *pool;
+	DecimPartitionData data;
+	DecimPartition *parts;
+	BMEdge **part_edges;
+	BMIter iter;
+	BMEdge *e;
+	BMFace *f;
+	int *vert_part;
+	const int parts_len = max_ii(BLI_task_scheduler_num_threads(scheduler) * 2, 2);
+	int i, edges_len;
+
+	memset(eheap_table, 0, sizeof(*eheap_table) * (size_t)tot_edge_orig);
+
+	/* faces are indexed for the degenerate checks */
+	BM_mesh_elem_index_ensure(bm, BM_FACE);
+
+	vert_part = bm_decim_partition_verts(bm, parts_len);
+	if (vert_part == NULL) {
+		return;
+	}
+
+	/* sort the edges of each slab, locked ones are left for later */
+	parts = MEM_callocN(sizeof(*parts) * parts_len, __func__);
+	BM_ITER_MESH (e, &iter, bm, BM_EDGES_OF_MESH) {
+		if (!bm_decim_partition_edge_is_locked(vert_part, e)) {
+			parts[vert_part[BM_elem_index_get(e->v1)]].edges_len++;
+		}
+	}
+
+	part_edges = MEM_mallocN(sizeof(*part_edges) * (size_t)bm->totedge, __func__);
+	edges_len = 0;
+	for (i = 0; i < parts_len; i++) {
+		parts[i].edges = &part_edges[edges_len];
+		edges_len += parts[i].edges_len;
+		parts[i].edges_len = 0;
+	}
+	BM_ITER_MESH (e, &iter, bm, BM_EDGES_OF_MESH) {
+		if (!bm_decim_partition_edge_is_locked(vert_part, e)) {
+			DecimPartition *part = &parts[vert_part[BM_elem_index_get(e->v1)]];
+			part->edges[part->edges_len++] = e;
+		}
+	}
+
+	/* faces using an unlocked vertex can be removed by its slab */
+	BM_ITER_MESH (f, &iter, bm, BM_FACES_OF_MESH) {
+		BMLoop *l_iter, *l_first;
+		l_iter = l_first = BM_FACE_FIRST_LOOP(f);
+		do {
+			const int v_part = vert_part[BM_elem_index_get(l_iter->v)];
+			if (v_part != -1) {
+				parts[v_part].totface++;
+				break;
+			}
+		} while ((l_iter = l_iter->next) != l_first);
+	}
+	for (i = 0; i < parts_len; i++) {
+		parts[i].face_tot_target = (int)(parts[i].totface * factor);
+	}
+
+	data.vert_part = vert_part;
+	data.vquadrics = vquadrics;
+	data.vweights = vweights;
+	data.vweight_factor = vweight_factor;
+	data.eheap_table = eheap_table;
+	data.customdata_flag = customdata_flag;
+	data.bm = bm;
+	data.totvert = bm->totvert;
+	data.totface = bm->totface;
+	BLI_spin_init(&data.topology_lock);
+
+	pool = BLI_task_pool_create(scheduler, &data);
+	for (i = 0; i < parts_len; i++) {
+		if (parts[i].edges_len != 0) {
+			BLI_task_pool_push(pool, bm_decim_partition_collapse_cb, &parts[i], false, TASK_PRIORITY_HIGH);
+		}
+	}
+	BLI_task_pool_work_and_wait(pool);
+	BLI_task_pool_free(pool);
+
+	BLI_spin_end(&data.topology_lock);
+
+	/* the heaps are freed, don't leave dangling nodes */
+	memset(eheap_table, 0, sizeof(*eheap_table) * (size_t)tot_edge_orig);
+
+	MEM_freeN(parts);
+	MEM_freeN(part_edges);
+	MEM_freeN(vert_part);
+}
+
 /* Main Decimate Function
  * ********************** */
 
@@ -1287,13 +1623,15 @@ static bool bm_decim_edge_collapse(
  *        a vertex group is the usual source for this.
  * \param symmetry_axis: Axis of symmetry, -1 to disable mirror decimate.
  * \param symmetry_eps: Threshold when matching mirror verts.
+ * \param use_partition: Decimate slabs of the mesh in parallel first (ignored with symmetry).
  */
 void BM_mesh_decimate_collapse(
         BMesh *bm,
         const float factor,
         float *vweights, float vweight_factor,
         const bool do_triangulate,
-        const int symmetry_axis, const float symmetry_eps)
+        const int symmetry_axis, const float symmetry_eps,
+        const bool use_partition)
 {
 	Heap *eheap;             /* edge heap */
 	HeapNode **eheap_table;  /* edge index aligned table pointing to the eheap */
@@ -1328,9 +1666,29 @@ void BM_mesh_decimate_collapse(
 	/* build initial edge collapse cost data */
 	bm_decim_build_quadrics(bm, vquadrics);
 
+	face_tot_target = bm->totface * factor;
+
+#ifdef USE_CUSTOMDATA
+	/* initialize customdata flag, we only need math for loops */
+	if (CustomData_has_interp(&bm->vdata))  customdata_flag |= CD_DO_VERT;
+	if (CustomData_has_interp(&bm->edata))  customdata_flag |= CD_DO_EDGE;
+	if (CustomData_has_math(&bm->ldata))    customdata_flag |= CD_DO_LOOP;
+#endif
+
+	if (use_partition &&
+#ifdef USE_SYMMETRY
+	    (use_symmetry == false) &&
+#endif
+	    (bm->totface >= PARTITION_FACE_MIN))
+	{
+		/* the edges left are collapsed below, with costs from the updated quadrics */
+		bm_decim_partition_collapse(
+		        bm, factor, vquadrics, vweights, vweight_factor,
+		        eheap_table, tot_edge_orig, customdata_flag);
+	}
+
 	bm_decim_build_edge_cost(bm, vquadrics, vweights, vweight_factor, eheap, eheap_table);
 
-	face_tot_target = bm->totface * factor;
 	bm->elem_index_dirty |= BM_ALL;
 
 #ifdef USE_SYMMETRY
@@ -1339,13 +1697,6 @@ void BM_mesh_decimate_collapse(
 	UNUSED_VARS(symmetry_axis, symmetry_eps);
 #endif
 
-#ifdef USE_CUSTOMDATA
-	/* initialize customdata flag, we only need math for loops */
-	if (CustomData_has_interp(&bm->vdata))  customdata_flag |= CD_DO_VERT;
-	if (CustomData_has_interp(&bm->edata))  customdata_flag |= CD_DO_EDGE;
-	if (CustomData_has_math(&bm->ldata))    customdata_flag |= CD_DO_LOOP;
-#endif
-
 	/* iterative edge collapse and maintain the eheap */
 #ifdef USE_SYMMETRY
 	if (use_symmetry == false)
@@ -1370,7 +1721,7 @@ void BM_mesh_decimate_collapse(
 #ifdef USE_SYMMETRY
 			        edge_symmetry_map,
 #endif
-			        customdata_flag,
+			        customdata_flag, NULL,
 			        optimize_co, true
 			        );
 		}
@@ -1425,8 +1776,8 @@ void BM_mesh_decimate_collapse(
 				/* run both before checking (since they invalidate surrounding geometry) */
 				bool ok_a, ok_b;
 
-				ok_a = !bm_edge_collapse_is_degenerate_topology(e);
-				ok_b = e_mirr ? !bm_edge_collapse_is_degenerate_topology(e_mirr) : true;
+				ok_a = !bm_edge_collapse_is_degenerate_topology(e, NULL);
+				ok_b = e_mirr ? !bm_edge_collapse_is_degenerate_topology(e_mirr, NULL) : true;
 
 				/* disallow collapsing which results in degenerate cases */
 
@@ -1451,7 +1802,7 @@ void BM_mesh_decimate_collapse(
 			if (bm_decim_edge_collapse(
 			        bm, e, vquadrics, vweights, vweight_factor, eheap, eheap_table,
 			        edge_symmetry_map,
-			        customdata_flag,
+			        customdata_flag, NULL,
 			        optimize_co, false))
 			{
 				if (e_mirr && (eheap_table[e_index_mirr])) {
@@ -1462,7 +1813,7 @@ void BM_mesh_decimate_collapse(
 					bm_decim_edge_collapse(
 					        bm, e_mirr, vquadrics, vweights, vweight_factor, eheap, eheap_table,
 					        edge_symmetry_map,
-					        customdata_flag,
+					        customdata_flag, NULL,
 					        optimize_co, false);
 				}
 			}
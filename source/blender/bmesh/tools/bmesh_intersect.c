@@ -51,6 +51,7 @@
 
 #include "BLI_kdopbvh.h"
 #include "BLI_buffer.h"
+#include "BLI_task.h"
 
 #include "bmesh.h"
 #include "intern/bmesh_private.h"
@@ -366,18 +367,28 @@ static enum ISectType intersect_line_tri(
 	return IX_NONE;
 }
 
+/**
+ * #intersect_line_tri result for an edge against a triangle.
+ */
+struct ISectEdgeTri {
+	float ix[3];
+	enum ISectType side;
+	/* false when the edge is skipped */
+	bool test;
+};
+
 static BMVert *bm_isect_edge_tri(
         struct ISectState *s,
         BMVert *e_v0, BMVert *e_v1,
         BMVert *t[3], const int t_index,
-        const float *t_cos[3], const float t_nor[3],
+        const struct ISectEdgeTri *edge_tri,
         enum ISectType *r_side)
 {
 	BMesh *bm = s->bm;
 	int k_arr[IX_TOT][4];
 	uint i;
 	const int ti[3] = {UNPACK3_EX(BM_elem_index_get, t, )};
-	float ix[3];
+	const float *ix = edge_tri->ix;
 
 	if (BM_elem_index_get(e_v0) > BM_elem_index_get(e_v1)) {
 		SWAP(BMVert *, e_v0, e_v1);
@@ -439,7 +450,8 @@ static BMVert *bm_isect_edge_tri(
 		}
 	}
 
-	*r_side = intersect_line_tri(e_v0->co, e_v1->co, t_cos, t_nor, ix, &s->epsilon);
+	/* calculated by #bm_isect_tri_tri_classify */
+	*r_side = edge_tri->side;
 	if (*r_side != IX_NONE) {
 		BMVert *iv;
 		BMEdge *e;
@@ -522,29 +534,95 @@ static bool bm_loop_filter_fn(const BMLoop *l, void *user_data)
 }
 
 /**
- * Return true if we have any intersections.
+ * Vertices touching one triangle of a pair, in the order they're found.
+ * Checking membership stands in for walk flags, so pairs can be classified from threads.
  */
-static void bm_isect_tri_tri(
-        struct ISectState *s,
-        int a_index, int b_index,
-        BMLoop **a, BMLoop **b)
+struct ISectVertStack {
+	/* should be enough but may need to bump */
+	BMVert *verts[8];
+	uint len;
+};
+
+static bool isect_vert_stack_has(const struct ISectVertStack *stack, const BMVert *v)
+{
+	uint i;
+	for (i = 0; i < stack->len; i++) {
+		if (stack->verts[i] == v) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static void isect_vert_stack_push_test(struct ISectVertStack *stack, BMVert *v)
+{
+	if (!isect_vert_stack_has(stack, v)) {
+		BLI_assert(stack->len < ARRAY_SIZE(stack->verts));
+		stack->verts[stack->len++] = v;
+	}
+}
+
+/**
+ * Result of the geometric tests for a triangle pair.
+ *
+ * This only depends on the coordinates of the original vertices,
+ * so it's calculated from threads, then applied serially by #bm_isect_tri_tri.
+ */
+struct ISectTriTri {
+	/* original vertices touching each triangle */
+	struct ISectVertStack iv_ls_a, iv_ls_b;
+	/* edge of the other triangle each vertex lies on, -1 for none */
+	int vert_edge_a[3], vert_edge_b[3];
+	/* no edge-tri tests are needed (also set when the triangles share a vertex) */
+	bool is_overlap;
+	/* edges of 'a' against 'b', then edges of 'b' against 'a' */
+	struct ISectEdgeTri edge_tri[6];
+};
+
+static void bm_isect_edge_tri_classify(
+        BMVert *e_v0, BMVert *e_v1,
+        const float *t_cos[3], const float t_nor[3],
+        const struct ISectEpsilon *e,
+        struct ISectEdgeTri *r_edge_tri)
+{
+	/* same order as #bm_isect_edge_tri */
+	if (BM_elem_index_get(e_v0) > BM_elem_index_get(e_v1)) {
+		SWAP(BMVert *, e_v0, e_v1);
+	}
+
+	r_edge_tri->test = true;
+	r_edge_tri->side = intersect_line_tri(e_v0->co, e_v1->co, t_cos, t_nor, r_edge_tri->ix, e);
+}
+
+/**
+ * Run the tests for a triangle pair without changing the mesh,
+ * safe to call from multiple threads at once.
+ */
+static void bm_isect_tri_tri_classify(
+        const struct ISectEpsilon *e,
+        BMLoop **a, BMLoop **b,
+        struct ISectTriTri *r_isect)
 {
-	BMFace *f_a = (*a)->f;
-	BMFace *f_b = (*b)->f;
 	BMVert *fv_a[3] = {UNPACK3_EX(, a, ->v)};
 	BMVert *fv_b[3] = {UNPACK3_EX(, b, ->v)};
 	const float *f_a_cos[3] = {UNPACK3_EX(, fv_a, ->co)};
 	const float *f_b_cos[3] = {UNPACK3_EX(, fv_b, ->co)};
 	float f_a_nor[3];
 	float f_b_nor[3];
+	struct ISectVertStack *iv_ls_a = &r_isect->iv_ls_a;
+	struct ISectVertStack *iv_ls_b = &r_isect->iv_ls_b;
 	uint i;
 
-
-	/* should be enough but may need to bump */
-	BMVert *iv_ls_a[8];
-	BMVert *iv_ls_b[8];
-	STACK_DECLARE(iv_ls_a);
-	STACK_DECLARE(iv_ls_b);
+	iv_ls_a->len = 0;
+	iv_ls_b->len = 0;
+	for (i = 0; i < 3; i++) {
+		r_isect->vert_edge_a[i] = -1;
+		r_isect->vert_edge_b[i] = -1;
+	}
+	for (i = 0; i < ARRAY_SIZE(r_isect->edge_tri); i++) {
+		r_isect->edge_tri[i].test = false;
+	}
+	r_isect->is_overlap = true;
 
 	if (UNLIKELY(ELEM(fv_a[0], UNPACK3(fv_b)) ||
 	             ELEM(fv_a[1], UNPACK3(fv_b)) ||
@@ -553,24 +631,7 @@ static void bm_isect_tri_tri(
 		return;
 	}
 
-	STACK_INIT(iv_ls_a, ARRAY_SIZE(iv_ls_a));
-	STACK_INIT(iv_ls_b, ARRAY_SIZE(iv_ls_b));
-
-#define VERT_VISIT_A _FLAG_WALK
-#define VERT_VISIT_B _FLAG_WALK_ALT
-
-#define STACK_PUSH_TEST_A(ele) \
-	if (BM_ELEM_API_FLAG_TEST(ele, VERT_VISIT_A) == 0) { \
-		BM_ELEM_API_FLAG_ENABLE(ele, VERT_VISIT_A); \
-		STACK_PUSH(iv_ls_a, ele); \
-	} ((void)0)
-
-#define STACK_PUSH_TEST_B(ele) \
-	if (BM_ELEM_API_FLAG_TEST(ele, VERT_VISIT_B) == 0) { \
-		BM_ELEM_API_FLAG_ENABLE(ele, VERT_VISIT_B); \
-		STACK_PUSH(iv_ls_b, ele); \
-	} ((void)0)
-
+	r_isect->is_overlap = false;
 
 	/* vert-vert
 	 * --------- */
@@ -582,19 +643,19 @@ static void bm_isect_tri_tri(
 		for (i_a = 0; i_a < 3; i_a++) {
 			uint i_b;
 			for (i_b = 0; i_b < 3; i_b++) {
-				if (len_squared_v3v3(fv_a[i_a]->co, fv_b[i_b]->co) <= s->epsilon.eps2x_sq) {
+				if (len_squared_v3v3(fv_a[i_a]->co, fv_b[i_b]->co) <= e->eps2x_sq) {
 #ifdef USE_DUMP
-					if (BM_ELEM_API_FLAG_TEST(fv_a[i_a], VERT_VISIT) == 0) {
+					if (!isect_vert_stack_has(iv_ls_a, fv_a[i_a])) {
 						printf("  ('VERT-VERT-A') %d, %d),\n",
 						       i_a, BM_elem_index_get(fv_a[i_a]));
 					}
-					if (BM_ELEM_API_FLAG_TEST(fv_b[i_b], VERT_VISIT) == 0) {
+					if (!isect_vert_stack_has(iv_ls_b, fv_b[i_b])) {
 						printf("  ('VERT-VERT-B') %d, %d),\n",
 						       i_b, BM_elem_index_get(fv_b[i_b]));
 					}
 #endif
-					STACK_PUSH_TEST_A(fv_a[i_a]);
-					STACK_PUSH_TEST_B(fv_b[i_b]);
+					isect_vert_stack_push_test(iv_ls_a, fv_a[i_a]);
+					isect_vert_stack_push_test(iv_ls_b, fv_b[i_b]);
 				}
 			}
 		}
@@ -605,36 +666,28 @@ static void bm_isect_tri_tri(
 	{
 		uint i_a;
 		for (i_a = 0; i_a < 3; i_a++) {
-			if (BM_ELEM_API_FLAG_TEST(fv_a[i_a], VERT_VISIT_A) == 0) {
+			if (!isect_vert_stack_has(iv_ls_a, fv_a[i_a])) {
 				uint i_b_e0;
 				for (i_b_e0 = 0; i_b_e0 < 3; i_b_e0++) {
 					uint i_b_e1 = (i_b_e0 + 1) % 3;
 
-					if (BM_ELEM_API_FLAG_TEST(fv_b[i_b_e0], VERT_VISIT_B) ||
-					    BM_ELEM_API_FLAG_TEST(fv_b[i_b_e1], VERT_VISIT_B))
+					if (isect_vert_stack_has(iv_ls_b, fv_b[i_b_e0]) ||
+					    isect_vert_stack_has(iv_ls_b, fv_b[i_b_e1]))
 					{
 						continue;
 					}
 
 					const float fac = line_point_factor_v3(fv_a[i_a]->co, fv_b[i_b_e0]->co, fv_b[i_b_e1]->co);
-					if ((fac > 0.0f - s->epsilon.eps) && (fac < 1.0f + s->epsilon.eps)) {
+					if ((fac > 0.0f - e->eps) && (fac < 1.0f + e->eps)) {
 						float ix[3];
 						interp_v3_v3v3(ix, fv_b[i_b_e0]->co, fv_b[i_b_e1]->co, fac);
-						if (len_squared_v3v3(ix, fv_a[i_a]->co) <= s->epsilon.eps2x_sq) {
-							BMEdge *e;
-							STACK_PUSH_TEST_B(fv_a[i_a]);
-							// STACK_PUSH_TEST_A(fv_a[i_a]);
-							e = BM_edge_exists(fv_b[i_b_e0], fv_b[i_b_e1]);
+						if (len_squared_v3v3(ix, fv_a[i_a]->co) <= e->eps2x_sq) {
+							isect_vert_stack_push_test(iv_ls_b, fv_a[i_a]);
 #ifdef USE_DUMP
 							printf("  ('VERT-EDGE-A', %d, %d),\n",
 							       BM_elem_index_get(fv_b[i_b_e0]), BM_elem_index_get(fv_b[i_b_e1]));
 #endif
-							if (e) {
-#ifdef USE_DUMP
-								printf("# adding to edge %d\n", BM_elem_index_get(e));
-#endif
-								edge_verts_add(s, e, fv_a[i_a], true);
-							}
+							r_isect->vert_edge_a[i_a] = (int)i_b_e0;
 							break;
 						}
 					}
@@ -646,36 +699,28 @@ static void bm_isect_tri_tri(
 	{
 		uint i_b;
 		for (i_b = 0; i_b < 3; i_b++) {
-			if (BM_ELEM_API_FLAG_TEST(fv_b[i_b], VERT_VISIT_B) == 0) {
+			if (!isect_vert_stack_has(iv_ls_b, fv_b[i_b])) {
 				uint i_a_e0;
 				for (i_a_e0 = 0; i_a_e0 < 3; i_a_e0++) {
 					uint i_a_e1 = (i_a_e0 + 1) % 3;
 
-					if (BM_ELEM_API_FLAG_TEST(fv_a[i_a_e0], VERT_VISIT_A) ||
-					    BM_ELEM_API_FLAG_TEST(fv_a[i_a_e1], VERT_VISIT_A))
+					if (isect_vert_stack_has(iv_ls_a, fv_a[i_a_e0]) ||
+					    isect_vert_stack_has(iv_ls_a, fv_a[i_a_e1]))
 					{
 						continue;
 					}
 
 					const float fac = line_point_factor_v3(fv_b[i_b]->co, fv_a[i_a_e0]->co, fv_a[i_a_e1]->co);
-					if ((fac > 0.0f - s->epsilon.eps) && (fac < 1.0f + s->epsilon.eps)) {
+					if ((fac > 0.0f - e->eps) && (fac < 1.0f + e->eps)) {
 						float ix[3];
 						interp_v3_v3v3(ix, fv_a[i_a_e0]->co, fv_a[i_a_e1]->co, fac);
-						if (len_squared_v3v3(ix, fv_b[i_b]->co) <= s->epsilon.eps2x_sq) {
-							BMEdge *e;
-							STACK_PUSH_TEST_A(fv_b[i_b]);
-							// STACK_PUSH_NOTEST(iv_ls_b, fv_b[i_b]);
-							e = BM_edge_exists(fv_a[i_a_e0], fv_a[i_a_e1]);
+						if (len_squared_v3v3(ix, fv_b[i_b]->co) <= e->eps2x_sq) {
+							isect_vert_stack_push_test(iv_ls_a, fv_b[i_b]);
 #ifdef USE_DUMP
 							printf("  ('VERT-EDGE-B', %d, %d),\n",
 							       BM_elem_index_get(fv_a[i_a_e0]), BM_elem_index_get(fv_a[i_a_e1]));
 #endif
-							if (e) {
-#ifdef USE_DUMP
-								printf("# adding to edge %d\n", BM_elem_index_get(e));
-#endif
-								edge_verts_add(s, e, fv_b[i_b], true);
-							}
+							r_isect->vert_edge_b[i_b] = (int)i_a_e0;
 							break;
 						}
 					}
@@ -694,19 +739,19 @@ static void bm_isect_tri_tri(
 		copy_v3_v3(t_scale[0], fv_b[0]->co);
 		copy_v3_v3(t_scale[1], fv_b[1]->co);
 		copy_v3_v3(t_scale[2], fv_b[2]->co);
-		tri_v3_scale(UNPACK3(t_scale), 1.0f - s->epsilon.eps2x);
+		tri_v3_scale(UNPACK3(t_scale), 1.0f - e->eps2x);
 
 		// second check for verts intersecting the triangle
 		for (i_a = 0; i_a < 3; i_a++) {
-			if (BM_ELEM_API_FLAG_TEST(fv_a[i_a], VERT_VISIT_A)) {
+			if (isect_vert_stack_has(iv_ls_a, fv_a[i_a])) {
 				continue;
 			}
 
 			float ix[3];
 			if (isect_point_tri_v3(fv_a[i_a]->co, UNPACK3(t_scale), ix)) {
-				if (len_squared_v3v3(ix, fv_a[i_a]->co) <= s->epsilon.eps2x_sq) {
-					STACK_PUSH_TEST_A(fv_a[i_a]);
-					STACK_PUSH_TEST_B(fv_a[i_a]);
+				if (len_squared_v3v3(ix, fv_a[i_a]->co) <= e->eps2x_sq) {
+					isect_vert_stack_push_test(iv_ls_a, fv_a[i_a]);
+					isect_vert_stack_push_test(iv_ls_b, fv_a[i_a]);
 #ifdef USE_DUMP
 					printf("  'VERT TRI-A',\n");
 #endif
@@ -722,18 +767,18 @@ static void bm_isect_tri_tri(
 		copy_v3_v3(t_scale[0], fv_a[0]->co);
 		copy_v3_v3(t_scale[1], fv_a[1]->co);
 		copy_v3_v3(t_scale[2], fv_a[2]->co);
-		tri_v3_scale(UNPACK3(t_scale), 1.0f - s->epsilon.eps2x);
+		tri_v3_scale(UNPACK3(t_scale), 1.0f - e->eps2x);
 
 		for (i_b = 0; i_b < 3; i_b++) {
-			if (BM_ELEM_API_FLAG_TEST(fv_b[i_b], VERT_VISIT_B)) {
+			if (isect_vert_stack_has(iv_ls_b, fv_b[i_b])) {
 				continue;
 			}
 
 			float ix[3];
 			if (isect_point_tri_v3(fv_b[i_b]->co, UNPACK3(t_scale), ix)) {
-				if (len_squared_v3v3(ix, fv_b[i_b]->co) <= s->epsilon.eps2x_sq) {
-					STACK_PUSH_TEST_A(fv_b[i_b]);
-					STACK_PUSH_TEST_B(fv_b[i_b]);
+				if (len_squared_v3v3(ix, fv_b[i_b]->co) <= e->eps2x_sq) {
+					isect_vert_stack_push_test(iv_ls_a, fv_b[i_b]);
+					isect_vert_stack_push_test(iv_ls_b, fv_b[i_b]);
 #ifdef USE_DUMP
 					printf("  'VERT TRI-B',\n");
 #endif
@@ -742,36 +787,120 @@ static void bm_isect_tri_tri(
 		}
 	}
 
-	if ((STACK_SIZE(iv_ls_a) >= 3) &&
-	    (STACK_SIZE(iv_ls_b) >= 3))
+	if ((iv_ls_a->len >= 3) &&
+	    (iv_ls_b->len >= 3))
 	{
 #ifdef USE_DUMP
 		printf("# OVERLAP\n");
 #endif
-		goto finally;
+		r_isect->is_overlap = true;
+		return;
 	}
 
 	normal_tri_v3(f_a_nor, UNPACK3(f_a_cos));
 	normal_tri_v3(f_b_nor, UNPACK3(f_b_cos));
 
 	/* edge-tri & edge-edge
-	 * -------------------- */
+	 * --------------------
+	 * Vertices created for these are never original vertices of the pair,
+	 * so which edges are tested is known before any are added. */
 	{
 		for (uint i_a_e0 = 0; i_a_e0 < 3; i_a_e0++) {
 			uint i_a_e1 = (i_a_e0 + 1) % 3;
+
+			if (isect_vert_stack_has(iv_ls_a, fv_a[i_a_e0]) ||
+			    isect_vert_stack_has(iv_ls_a, fv_a[i_a_e1]))
+			{
+				continue;
+			}
+
+			bm_isect_edge_tri_classify(
+			        fv_a[i_a_e0], fv_a[i_a_e1], f_b_cos, f_b_nor, e,
+			        &r_isect->edge_tri[i_a_e0]);
+		}
+
+		for (uint i_b_e0 = 0; i_b_e0 < 3; i_b_e0++) {
+			uint i_b_e1 = (i_b_e0 + 1) % 3;
+
+			if (isect_vert_stack_has(iv_ls_b, fv_b[i_b_e0]) ||
+			    isect_vert_stack_has(iv_ls_b, fv_b[i_b_e1]))
+			{
+				continue;
+			}
+
+			bm_isect_edge_tri_classify(
+			        fv_b[i_b_e0], fv_b[i_b_e1], f_a_cos, f_a_nor, e,
+			        &r_isect->edge_tri[3 + i_b_e0]);
+		}
+	}
+}
+
+/**
+ * Add the intersections found by #bm_isect_tri_tri_classify to the mesh.
+ */
+static void bm_isect_tri_tri(
+        struct ISectState *s,
+        int a_index, int b_index,
+        BMLoop **a, BMLoop **b,
+        const struct ISectTriTri *isect)
+{
+	BMFace *f_a = (*a)->f;
+	BMFace *f_b = (*b)->f;
+	BMVert *fv_a[3] = {UNPACK3_EX(, a, ->v)};
+	BMVert *fv_b[3] = {UNPACK3_EX(, b, ->v)};
+	struct ISectVertStack iv_ls_a = isect->iv_ls_a;
+	struct ISectVertStack iv_ls_b = isect->iv_ls_b;
+	uint i;
+
+	/* vert-edge
+	 * ---------
+	 * Looked up here since edges are created by earlier pairs. */
+	for (i = 0; i < 3; i++) {
+		if (isect->vert_edge_a[i] != -1) {
+			const uint i_b_e0 = (uint)isect->vert_edge_a[i];
+			BMEdge *e = BM_edge_exists(fv_b[i_b_e0], fv_b[(i_b_e0 + 1) % 3]);
+			if (e) {
+#ifdef USE_DUMP
+				printf("# adding to edge %d\n", BM_elem_index_get(e));
+#endif
+				edge_verts_add(s, e, fv_a[i], true);
+			}
+		}
+	}
+
+	for (i = 0; i < 3; i++) {
+		if (isect->vert_edge_b[i] != -1) {
+			const uint i_a_e0 = (uint)isect->vert_edge_b[i];
+			BMEdge *e = BM_edge_exists(fv_a[i_a_e0], fv_a[(i_a_e0 + 1) % 3]);
+			if (e) {
+#ifdef USE_DUMP
+				printf("# adding to edge %d\n", BM_elem_index_get(e));
+#endif
+				edge_verts_add(s, e, fv_b[i], true);
+			}
+		}
+	}
+
+	if (isect->is_overlap) {
+		return;
+	}
+
+	/* edge-tri & edge-edge
+	 * -------------------- */
+	{
+		for (uint i_a_e0 = 0; i_a_e0 < 3; i_a_e0++) {
+			const struct ISectEdgeTri *edge_tri = &isect->edge_tri[i_a_e0];
 			enum ISectType side;
 			BMVert *iv;
 
-			if (BM_ELEM_API_FLAG_TEST(fv_a[i_a_e0], VERT_VISIT_A) ||
-			    BM_ELEM_API_FLAG_TEST(fv_a[i_a_e1], VERT_VISIT_A))
-			{
+			if (edge_tri->test == false) {
 				continue;
 			}
 
-			iv = bm_isect_edge_tri(s, fv_a[i_a_e0], fv_a[i_a_e1], fv_b, b_index, f_b_cos, f_b_nor, &side);
+			iv = bm_isect_edge_tri(s, fv_a[i_a_e0], fv_a[(i_a_e0 + 1) % 3], fv_b, b_index, edge_tri, &side);
 			if (iv) {
-				STACK_PUSH_TEST_A(iv);
-				STACK_PUSH_TEST_B(iv);
+				isect_vert_stack_push_test(&iv_ls_a, iv);
+				isect_vert_stack_push_test(&iv_ls_b, iv);
 #ifdef USE_DUMP
 				printf("  ('EDGE-TRI-A', %d),\n", side);
 #endif
@@ -779,20 +908,18 @@ static void bm_isect_tri_tri(
 		}
 
 		for (uint i_b_e0 = 0; i_b_e0 < 3; i_b_e0++) {
-			uint i_b_e1 = (i_b_e0 + 1) % 3;
+			const struct ISectEdgeTri *edge_tri = &isect->edge_tri[3 + i_b_e0];
 			enum ISectType side;
 			BMVert *iv;
 
-			if (BM_ELEM_API_FLAG_TEST(fv_b[i_b_e0], VERT_VISIT_B) ||
-			    BM_ELEM_API_FLAG_TEST(fv_b[i_b_e1], VERT_VISIT_B))
-			{
+			if (edge_tri->test == false) {
 				continue;
 			}
 
-			iv = bm_isect_edge_tri(s, fv_b[i_b_e0], fv_b[i_b_e1], fv_a, a_index, f_a_cos, f_a_nor, &side);
+			iv = bm_isect_edge_tri(s, fv_b[i_b_e0], fv_b[(i_b_e0 + 1) % 3], fv_a, a_index, edge_tri, &side);
 			if (iv) {
-				STACK_PUSH_TEST_A(iv);
-				STACK_PUSH_TEST_B(iv);
+				isect_vert_stack_push_test(&iv_ls_a, iv);
+				isect_vert_stack_push_test(&iv_ls_b, iv);
 #ifdef USE_DUMP
 				printf("  ('EDGE-TRI-B', %d),\n", side);
 #endif
@@ -808,15 +935,15 @@ static void bm_isect_tri_tri(
 			BMEdge *ie;
 
 			if (i == 0) {
-				if (STACK_SIZE(iv_ls_a) != 2)
+				if (iv_ls_a.len != 2)
 					continue;
-				ie_vs = iv_ls_a;
+				ie_vs = iv_ls_a.verts;
 				f = f_a;
 			}
 			else {
-				if (STACK_SIZE(iv_ls_b) != 2)
+				if (iv_ls_b.len != 2)
 					continue;
-				ie_vs = iv_ls_b;
+				ie_vs = iv_ls_b.verts;
 				f = f_b;
 			}
 
@@ -845,15 +972,6 @@ static void bm_isect_tri_tri(
 			// BLI_assert(len(ie_vs) <= 2)
 		}
 	}
-
-finally:
-	for (i = 0; i < STACK_SIZE(iv_ls_a); i++) {
-		BM_ELEM_API_FLAG_DISABLE(iv_ls_a[i], VERT_VISIT_A); \
-	}
-	for (i = 0; i < STACK_SIZE(iv_ls_b); i++) {
-		BM_ELEM_API_FLAG_DISABLE(iv_ls_b[i], VERT_VISIT_B); \
-	}
-
 }
 
 #ifdef USE_BVH
@@ -971,13 +1089,137 @@ static int isect_bvhtree_point_v3(
 	return num_isect;
 }
 
+/**
+ * Check if \a t_a is entirely on one side of the plane of \a t_b,
+ * too far from it for any of the tests in #bm_isect_tri_tri to succeed.
+ */
+static bool tri_tri_plane_is_separated(
+        const float *t_a[3], const float *t_b[3],
+        const struct ISectEpsilon *e)
+{
+	float t_b_nor[3];
+	float dist[3];
+	float dist_min, dist_max, margin;
+	uint i;
+
+	if (UNLIKELY(normal_tri_v3(t_b_nor, UNPACK3(t_b)) == 0.0f)) {
+		return false;
+	}
+
+	for (i = 0; i < 3; i++) {
+		float dir[3];
+		sub_v3_v3v3(dir, t_a[i], t_b[0]);
+		dist[i] = dot_v3v3(dir, t_b_nor);
+	}
+
+	dist_min = min_fff(UNPACK3(dist));
+	dist_max = max_fff(UNPACK3(dist));
+
+	/* Points up to 'eps_margin' apart count as touching,
+	 * vertices are also tested against edges extended by 'eps' of their length.
+	 * Allow for single precision error in those tests too. */
+	margin = (e->eps_margin * 2.0f) +
+	         (e->eps + FLT_EPSILON * 16.0f) * ((dist_max - dist_min) + fabsf(dot_v3v3(t_b[0], t_b_nor)));
+
+	return (dist_min > margin) || (dist_max < -margin);
+}
+
+struct OverlapFilterData {
+	BMLoop *(*looptris)[3];
+	const struct ISectEpsilon *epsilon;
+};
+
+/**
+ * Skip the pairs #bm_isect_tri_tri would do nothing with.
+ * This runs from the threads of #BLI_bvhtree_overlap, so only the remaining pairs
+ * need to be checked serially, skipping them doesn't change the result.
+ */
+static bool bm_isect_overlap_filter_cb(void *userdata, int index_a, int index_b, int UNUSED(thread))
+{
+	struct OverlapFilterData *data = userdata;
+	BMLoop **a = data->looptris[index_a];
+	BMLoop **b = data->looptris[index_b];
+	const float *f_a_cos[3] = {UNPACK3_EX(, a, ->v->co)};
+	const float *f_b_cos[3] = {UNPACK3_EX(, b, ->v->co)};
+
+	/* triangles sharing a vertex are skipped, see #bm_isect_tri_tri */
+	if (ELEM(a[0]->v, UNPACK3_EX(, b, ->v)) ||
+	    ELEM(a[1]->v, UNPACK3_EX(, b, ->v)) ||
+	    ELEM(a[2]->v, UNPACK3_EX(, b, ->v)))
+	{
+		return false;
+	}
+
+	return !(tri_tri_plane_is_separated(f_a_cos, f_b_cos, data->epsilon) ||
+	         tri_tri_plane_is_separated(f_b_cos, f_a_cos, data->epsilon));
+}
+
+/* overlapping pairs to classify at once, limits memory use for dense meshes */
+#define ISECT_CLASSIFY_CHUNK_SIZE 4096u
+
+struct ISectClassifyData {
+	BMLoop *(*looptris)[3];
+	const BVHTreeOverlap *overlap;
+	const struct ISectEpsilon *epsilon;
+	struct ISectTriTri *isect;
+};
+
+static void bm_isect_tri_tri_classify_cb(void *userdata, const int i)
+{
+	struct ISectClassifyData *data = userdata;
+	const BVHTreeOverlap *overlap = &data->overlap[i];
+
+	bm_isect_tri_tri_classify(
+	        data->epsilon,
+	        data->looptris[overlap->indexA],
+	        data->looptris[overlap->indexB],
+	        &data->isect[i]);
+}
+
+struct BVHTreeBuildData {
+	BMLoop *(*looptris)[3];
+	int looptris_tot;
+	int (*test_fn)(BMFace *f, void *user_data);
+	void *user_data;
+	/* the value of test_fn for the triangles to add */
+	int side;
+	float epsilon;
+
+	BVHTree *tree;
+};
+
+static void bm_isect_bvhtree_build_cb(TaskPool *__restrict UNUSED(pool), void *taskdata, int UNUSED(threadid))
+{
+	struct BVHTreeBuildData *data = taskdata;
+	BMLoop *(*looptris)[3] = data->looptris;
+	BVHTree *tree;
+	int i;
+
+	tree = BLI_bvhtree_new(data->looptris_tot, data->epsilon, 8, 8);
+	for (i = 0; i < data->looptris_tot; i++) {
+		if (data->test_fn(looptris[i][0]->f, data->user_data) == data->side) {
+			const float t_cos[3][3] = {
+				{UNPACK3(looptris[i][0]->v->co)},
+				{UNPACK3(looptris[i][1]->v->co)},
+				{UNPACK3(looptris[i][2]->v->co)},
+			};
+
+			BLI_bvhtree_insert(tree, i, (const float *)t_cos, 3);
+		}
+	}
+	BLI_bvhtree_balance(tree);
+
+	data->tree = tree;
+}
+
 #endif  /* USE_BVH */
 
 /**
  * Intersect tessellated faces
  * leaving the resulting edges tagged.
  *
- * \param test_fn Return value: -1: skip, 0: tree_a, 1: tree_b (use_self == false)
+ * \param test_fn Return value: -1: skip, 0: tree_a, 1: tree_b (use_self == false),
+ * may be called from multiple threads at once.
  * \param boolean_mode -1: no-boolean, 0: intersection... see #BMESH_ISECT_BOOLEAN_ISECT.
  * \return true if the mesh is changed (intersections cut or faces removed from boolean).
  */
@@ -1004,6 +1246,7 @@ bool BM_mesh_intersect(
 	BVHTreeOverlap *overlap;
 #else
 	int i_a, i_b;
+	struct ISectTriTri isect;
 #endif
 
 #ifdef USE_BOOLEAN_RAYCAST_DRAW
@@ -1078,63 +1321,88 @@ bool BM_mesh_intersect(
 
 #ifdef USE_BVH
 	{
-		int i;
-		tree_a = BLI_bvhtree_new(looptris_tot, s.epsilon.eps_margin, 8, 8);
-		for (i = 0; i < looptris_tot; i++) {
-			if (test_fn(looptris[i][0]->f, user_data) == 0) {
-				const float t_cos[3][3] = {
-					{UNPACK3(looptris[i][0]->v->co)},
-					{UNPACK3(looptris[i][1]->v->co)},
-					{UNPACK3(looptris[i][2]->v->co)},
-				};
-
-				BLI_bvhtree_insert(tree_a, i, (const float *)t_cos, 3);
+		struct BVHTreeBuildData tree_build_data[2] = {
+			{.looptris = looptris, .looptris_tot = looptris_tot,
+			 .test_fn = test_fn, .user_data = user_data, .side = 0, .epsilon = s.epsilon.eps_margin},
+			{.looptris = looptris, .looptris_tot = looptris_tot,
+			 .test_fn = test_fn, .user_data = user_data, .side = 1, .epsilon = s.epsilon.eps_margin},
+		};
+
+		if (use_self == false) {
+			/* balancing is only threaded once the tree is split into enough nodes,
+			 * so build both trees at once */
+			TaskScheduler *scheduler = BLI_task_scheduler_get();
+			TaskPool *task_pool = BLI_task_pool_create(scheduler, NULL);
+			int i;
+
+			for (i = 0; i < 2; i++) {
+				BLI_task_pool_push(task_pool, bm_isect_bvhtree_build_cb, &tree_build_data[i], false, TASK_PRIORITY_HIGH);
 			}
+			BLI_task_pool_work_and_wait(task_pool);
+			BLI_task_pool_free(task_pool);
+
+			tree_a = tree_build_data[0].tree;
+			tree_b = tree_build_data[1].tree;
 		}
-		BLI_bvhtree_balance(tree_a);
-	}
+		else {
+			bm_isect_bvhtree_build_cb(NULL, &tree_build_data[0], 0);
 
-	if (use_self == false) {
-		int i;
-		tree_b = BLI_bvhtree_new(looptris_tot, s.epsilon.eps_margin, 8, 8);
-		for (i = 0; i < looptris_tot; i++) {
-			if (test_fn(looptris[i][0]->f, user_data) == 1) {
-				const float t_cos[3][3] = {
-					{UNPACK3(looptris[i][0]->v->co)},
-					{UNPACK3(looptris[i][1]->v->co)},
-					{UNPACK3(looptris[i][2]->v->co)},
-				};
-
-				BLI_bvhtree_insert(tree_b, i, (const float *)t_cos, 3);
-			}
+			tree_a = tree_b = tree_build_data[0].tree;
 		}
-		BLI_bvhtree_balance(tree_b);
-	}
-	else {
-		tree_b = tree_a;
 	}
 
-	overlap = BLI_bvhtree_overlap(tree_b, tree_a, &tree_overlap_tot, NULL, NULL);
+	{
+		struct OverlapFilterData overlap_filter_data = {
+			.looptris = looptris,
+			.epsilon = &s.epsilon,
+		};
+
+		overlap = BLI_bvhtree_overlap(
+		        tree_b, tree_a, &tree_overlap_tot,
+		        bm_isect_overlap_filter_cb, &overlap_filter_data);
+	}
 
 	if (overlap) {
-		uint i;
+		/* the tests run in parallel, new geometry is added serially in the order of the pairs */
+		const uint isect_len = MIN2(tree_overlap_tot, ISECT_CLASSIFY_CHUNK_SIZE);
+		struct ISectTriTri *isect = MEM_mallocN(sizeof(*isect) * isect_len, __func__);
+		struct ISectClassifyData classify_data = {
+			.looptris = looptris,
+			.epsilon = &s.epsilon,
+			.isect = isect,
+		};
+		uint i, j;
+
+		for (i = 0; i < tree_overlap_tot; i += isect_len) {
+			const uint chunk_len = MIN2(tree_overlap_tot - i, isect_len);
+			const BVHTreeOverlap *overlap_chunk = &overlap[i];
 
-		for (i = 0; i < tree_overlap_tot; i++) {
+			classify_data.overlap = overlap_chunk;
 #ifdef USE_DUMP
-			printf("  ((%d, %d), (\n",
-			       overlap[i].indexA,
-			       overlap[i].indexB);
+			BLI_task_parallel_range(0, (int)chunk_len, &classify_data, bm_isect_tri_tri_classify_cb, false);
+#else
+			BLI_task_parallel_range(0, (int)chunk_len, &classify_data, bm_isect_tri_tri_classify_cb, chunk_len > 256);
 #endif
-			bm_isect_tri_tri(
-			        &s,
-			        overlap[i].indexA,
-			        overlap[i].indexB,
-			        looptris[overlap[i].indexA],
-			        looptris[overlap[i].indexB]);
+
+			for (j = 0; j < chunk_len; j++) {
 #ifdef USE_DUMP
-			printf(")),\n");
+				printf("  ((%d, %d), (\n",
+				       overlap_chunk[j].indexA,
+				       overlap_chunk[j].indexB);
 #endif
+				bm_isect_tri_tri(
+				        &s,
+				        overlap_chunk[j].indexA,
+				        overlap_chunk[j].indexB,
+				        looptris[overlap_chunk[j].indexA],
+				        looptris[overlap_chunk[j].indexB],
+				        &isect[j]);
+#ifdef USE_DUMP
+				printf(")),\n");
+#endif
+			}
 		}
+		MEM_freeN(isect);
 		MEM_freeN(overlap);
 	}
 
@@ -1168,12 +1436,14 @@ bool BM_mesh_intersect(
 				printf("  ((%d, %d), (",
 				       i_a, i_b);
 #endif
+				bm_isect_tri_tri_classify(&s.epsilon, looptris[i_a], looptris[i_b], &isect);
 				bm_isect_tri_tri(
 				        &s,
 				        i_a,
 				        i_b,
 				        looptris[i_a],
-				        looptris[i_b]);
+				        looptris[i_b],
+				        &isect);
 #ifdef USE_DUMP
 			printf(")),\n");
 #endif
@@ -8209,21 +8209,21 @@ void draw_object_select(Scene *scene, ARegion *ar, View3D *v3d, Base *base, cons
 
 	/* we draw duplicators for selection too */
 	if ((base->object->transflag & OB_DUPLI)) {
-		ListBase *lb;
-		DupliObject *dob;
+		DupliTable *table;
+		DupliInstance *inst;
 		Base tbase;
 
 		tbase.flag = OB_FROMDUPLI;
-		lb = object_duplilist(G.main->eval_ctx, scene, base->object);
+		table = object_dupli_table_cached(G.main->eval_ctx, scene, base->object);
 
-		for (dob = lb->first; dob; dob = dob->next) {
+		DUPLI_TABLE_ITER (inst, table) {
 			float omat[4][4];
 			char dt;
 			short dtx;
 
-			tbase.object = dob->ob;
-			copy_m4_m4(omat, dob->ob->obmat);
-			copy_m4_m4(dob->ob->obmat, dob->mat);
+			tbase.object = inst->ob;
+			copy_m4_m4(omat, inst->ob->obmat);
+			dupli_instance_mat_get(inst, inst->ob->obmat);
 
 			/* extra service: draw the duplicator in drawtype of parent */
 			/* MIN2 for the drawtype to allow bounding box objects in groups for lods */
@@ -8235,9 +8235,8 @@ void draw_object_select(Scene *scene, ARegion *ar, View3D *v3d, Base *base, cons
 			tbase.object->dt = dt;
 			tbase.object->dtx = dtx;
 
-			copy_m4_m4(dob->ob->obmat, omat);
+			copy_m4_m4(inst->ob->obmat, omat);
 		}
-		free_object_duplilist(lb);
 	}
 }
 
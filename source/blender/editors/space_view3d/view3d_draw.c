@@ -2076,11 +2076,12 @@ int dupli_ob_sort(void *arg1, void *arg2)
 #endif
 
 
-static DupliObject *dupli_step(DupliObject *dob)
+static DupliInstance *dupli_step(const DupliTable *table, DupliInstance *inst)
 {
-	while (dob && dob->no_draw)
-		dob = dob->next;
-	return dob;
+	const DupliInstance *inst_end = table->instances + table->totinstance;
+	while (inst != inst_end && inst->no_draw)
+		inst++;
+	return (inst != inst_end) ? inst : NULL;
 }
 
 static void draw_dupli_objects_color(
@@ -2088,9 +2089,9 @@ static void draw_dupli_objects_color(
         const short dflag, const int color)
 {
 	RegionView3D *rv3d = ar->regiondata;
-	ListBase *lb;
+	DupliTable *table;
 	LodLevel *savedlod;
-	DupliObject *dob_prev = NULL, *dob, *dob_next = NULL;
+	DupliInstance *inst_prev = NULL, *inst, *inst_next = NULL;
 	Base tbase = {NULL};
 	BoundBox bb, *bb_tmp; /* use a copy because draw_object, calls clear_mesh_caches */
 	GLuint displist = 0;
@@ -2113,25 +2114,27 @@ static void draw_dupli_objects_color(
 	}
 
 	tbase.flag = OB_FROMDUPLI | base->flag;
-	lb = object_duplilist(G.main->eval_ctx, scene, base->object);
-	// BLI_listbase_sort(lb, dupli_ob_sort); /* might be nice to have if we have a dupli list with mixed objects. */
+	/* owned by the object, only regenerated after depsgraph updates or frame changes */
+	table = object_dupli_table_cached(G.main->eval_ctx, scene, base->object);
 
-	apply_data = duplilist_apply(base->object, scene, lb);
+	apply_data = dupli_table_apply(base->object, scene, table);
 
-	dob = dupli_step(lb->first);
-	if (dob) dob_next = dupli_step(dob->next);
+	inst = dupli_step(table, table->instances);
+	if (inst) inst_next = dupli_step(table, inst + 1);
 
-	for (; dob; dob_prev = dob, dob = dob_next, dob_next = dob_next ? dupli_step(dob_next->next) : NULL) {
+	for (; inst; inst_prev = inst, inst = inst_next, inst_next = inst_next ? dupli_step(table, inst_next + 1) : NULL) {
+		DupliObject dob;
 		bool testbb = false;
 
-		tbase.object = dob->ob;
+		dupli_instance_to_dupli_object(inst, &dob);
+		tbase.object = inst->ob;
 
 		/* Make sure lod is updated from dupli's position */
-		savedlod = dob->ob->currentlod;
+		savedlod = inst->ob->currentlod;
 
 #ifdef WITH_GAMEENGINE
 		if (rv3d->rflag & RV3D_IS_GAME_ENGINE) {
-			BKE_object_lod_update(dob->ob, rv3d->viewinv[3]);
+			BKE_object_lod_update(inst->ob, rv3d->viewinv[3]);
 		}
 #endif
 
@@ -2150,7 +2153,7 @@ static void draw_dupli_objects_color(
 		/* negative scale flag has to propagate */
 		transflag = tbase.object->transflag;
 
-		if (is_negative_m4(dob->mat))
+		if (is_negative_m4(dob.mat))
 			tbase.object->transflag |= OB_NEG_SCALE;
 		else
 			tbase.object->transflag &= ~OB_NEG_SCALE;
@@ -2161,47 +2164,47 @@ static void draw_dupli_objects_color(
 		}
 		
 		/* generate displist, test for new object */
-		if (dob_prev && dob_prev->ob != dob->ob) {
+		if (inst_prev && inst_prev->ob != inst->ob) {
 			if (use_displist == true)
 				glDeleteLists(displist, 1);
 			
 			use_displist = false;
 		}
 		
-		if ((bb_tmp = BKE_object_boundbox_get(dob->ob))) {
+		if ((bb_tmp = BKE_object_boundbox_get(inst->ob))) {
 			bb = *bb_tmp; /* must make a copy  */
 			testbb = true;
 		}
 
-		if (!testbb || ED_view3d_boundbox_clip_ex(rv3d, &bb, dob->mat)) {
+		if (!testbb || ED_view3d_boundbox_clip_ex(rv3d, &bb, dob.mat)) {
 			/* generate displist */
 			if (use_displist == false) {
 				
-				/* note, since this was added, its checked (dob->type == OB_DUPLIGROUP)
+				/* note, since this was added, its checked (inst->type == OB_DUPLIGROUP)
 				 * however this is very slow, it was probably needed for the NLA
 				 * offset feature (used in group-duplicate.blend but no longer works in 2.5)
 				 * so for now it should be ok to - campbell */
 				
 				if ( /* if this is the last no need  to make a displist */
-				     (dob_next == NULL || dob_next->ob != dob->ob) ||
+				     (inst_next == NULL || inst_next->ob != inst->ob) ||
 				     /* lamp drawing messes with matrices, could be handled smarter... but this works */
-				     (dob->ob->type == OB_LAMP) ||
-				     (dob->type == OB_DUPLIGROUP && dob->animated) ||
+				     (inst->ob->type == OB_LAMP) ||
+				     (inst->type == OB_DUPLIGROUP && inst->animated) ||
 				     !bb_tmp ||
-				     draw_glsl_material(scene, dob->ob, v3d, dt) ||
+				     draw_glsl_material(scene, inst->ob, v3d, dt) ||
 				     check_object_draw_texture(scene, v3d, dt) ||
 				     (v3d->flag2 & V3D_SOLID_MATCAP) != 0)
 				{
-					// printf("draw_dupli_objects_color: skipping displist for %s\n", dob->ob->id.name + 2);
+					// printf("draw_dupli_objects_color: skipping displist for %s\n", inst->ob->id.name + 2);
 					use_displist = false;
 				}
 				else {
-					// printf("draw_dupli_objects_color: using displist for %s\n", dob->ob->id.name + 2);
+					// printf("draw_dupli_objects_color: using displist for %s\n", inst->ob->id.name + 2);
 					
 					/* disable boundbox check for list creation */
-					BKE_object_boundbox_flag(dob->ob, BOUNDBOX_DISABLED, 1);
+					BKE_object_boundbox_flag(inst->ob, BOUNDBOX_DISABLED, 1);
 					/* need this for next part of code */
-					unit_m4(dob->ob->obmat);    /* obmat gets restored */
+					unit_m4(inst->ob->obmat);    /* obmat gets restored */
 					
 					displist = glGenLists(1);
 					glNewList(displist, GL_COMPILE);
@@ -2209,19 +2212,19 @@ static void draw_dupli_objects_color(
 					glEndList();
 					
 					use_displist = true;
-					BKE_object_boundbox_flag(dob->ob, BOUNDBOX_DISABLED, 0);
+					BKE_object_boundbox_flag(inst->ob, BOUNDBOX_DISABLED, 0);
 				}		
 			}
 			
 			if (use_displist) {
 				glPushMatrix();
-				glMultMatrixf(dob->mat);
+				glMultMatrixf(dob.mat);
 				glCallList(displist);
 				glPopMatrix();
 			}	
 			else {
-				copy_m4_m4(dob->ob->obmat, dob->mat);
-				GPU_begin_dupli_object(dob);
+				copy_m4_m4(inst->ob->obmat, dob.mat);
+				GPU_begin_dupli_object(&dob);
 				draw_object(scene, ar, v3d, &tbase, dflag_dupli);
 				GPU_end_dupli_object();
 			}
@@ -2234,11 +2237,9 @@ static void draw_dupli_objects_color(
 	}
 
 	if (apply_data) {
-		duplilist_restore(lb, apply_data);
+		dupli_table_restore(table, apply_data);
 		duplilist_free_apply_data(apply_data);
 	}
-
-	free_object_duplilist(lb);
 	
 	if (use_displist)
 		glDeleteLists(displist, 1);
@@ -2629,14 +2630,16 @@ static void gpu_update_lamps_shadows_world(Scene *scene, View3D *v3d)
 			gpu_render_lamp_update(scene, v3d, ob, NULL, ob->obmat, ob->lay, &shadows, srl);
 		
 		if (ob->transflag & OB_DUPLI) {
-			DupliObject *dob;
-			ListBase *lb = object_duplilist(G.main->eval_ctx, scene, ob);
-			
-			for (dob = lb->first; dob; dob = dob->next)
-				if (dob->ob->type == OB_LAMP)
-					gpu_render_lamp_update(scene, v3d, dob->ob, ob, dob->mat, ob->lay, &shadows, srl);
+			DupliTable *table = object_dupli_table_cached(G.main->eval_ctx, scene, ob);
+			DupliInstance *inst;
 			
-			free_object_duplilist(lb);
+			DUPLI_TABLE_ITER (inst, table) {
+				if (inst->ob->type == OB_LAMP) {
+					float mat[4][4];
+					dupli_instance_mat_get(inst, mat);
+					gpu_render_lamp_update(scene, v3d, inst->ob, ob, mat, ob->lay, &shadows, srl);
+				}
+			}
 		}
 	}
 	
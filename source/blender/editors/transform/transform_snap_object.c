@@ -165,13 +165,14 @@ static void iter_snap_objects(
 			bool use_obedit;
 			Object *obj = base->object;
 			if (obj->transflag & OB_DUPLI) {
-				DupliObject *dupli_ob;
-				ListBase *lb = object_duplilist(sctx->bmain->eval_ctx, sctx->scene, obj);
-				for (dupli_ob = lb->first; dupli_ob; dupli_ob = dupli_ob->next) {
-					use_obedit = obedit && dupli_ob->ob->data == obedit->data;
-					sob_callback(sctx, use_obedit, use_obedit ? obedit : dupli_ob->ob, dupli_ob->mat, data);
+				DupliTable *table = object_dupli_table_cached(sctx->bmain->eval_ctx, sctx->scene, obj);
+				DupliInstance *inst;
+				DUPLI_TABLE_ITER (inst, table) {
+					float inst_mat[4][4];
+					dupli_instance_mat_get(inst, inst_mat);
+					use_obedit = obedit && inst->ob->data == obedit->data;
+					sob_callback(sctx, use_obedit, use_obedit ? obedit : inst->ob, inst_mat, data);
 				}
-				free_object_duplilist(lb);
 			}
 
 			use_obedit = obedit && obj->data == obedit->data;
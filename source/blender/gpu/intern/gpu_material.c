@@ -1151,15 +1151,16 @@ static void material_lights(GPUShadeInput *shi, GPUShadeResult *shr)
 		}
 
 		if (ob->transflag & OB_DUPLI) {
-			ListBase *lb = object_duplilist(G.main->eval_ctx, shi->gpumat->scene, ob);
+			DupliTable *table = object_dupli_table_cached(G.main->eval_ctx, shi->gpumat->scene, ob);
+			DupliInstance *inst;
 			
-			for (DupliObject *dob = lb->first; dob; dob = dob->next) {
-				Object *ob_iter = dob->ob;
+			DUPLI_TABLE_ITER (inst, table) {
+				Object *ob_iter = inst->ob;
 
 				if (ob_iter->type == OB_LAMP) {
 					float omat[4][4];
 					copy_m4_m4(omat, ob_iter->obmat);
-					copy_m4_m4(ob_iter->obmat, dob->mat);
+					dupli_instance_mat_get(inst, ob_iter->obmat);
 
 					GPULamp *lamp = GPU_lamp_from_blender(shi->gpumat->scene, ob_iter, ob);
 					if (lamp)
@@ -1168,8 +1169,6 @@ static void material_lights(GPUShadeInput *shi, GPUShadeResult *shr)
 					copy_m4_m4(ob_iter->obmat, omat);
 				}
 			}
-			
-			free_object_duplilist(lb);
 		}
 	}
 
@@ -50,6 +50,7 @@ typedef struct CustomDataLayer {
 	int uid;        /* shape keyblock unique id reference*/
 	char name[64];  /* layer name, MAX_CUSTOMDATA_LAYER_NAME */
 	void *data;     /* layer data */
+	struct CustomDataLayerShared *shared;  /* runtime only, users of data shared with copies (CD_SHARE) */
 } CustomDataLayer;
 
 #define MAX_CUSTOMDATA_LAYER_NAME 64
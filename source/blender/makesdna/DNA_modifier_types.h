@@ -98,6 +98,7 @@ typedef enum ModifierMode {
 	eModifierMode_Expanded          = (1 << 4),
 	eModifierMode_Virtual           = (1 << 5),
 	eModifierMode_ApplyOnSpline     = (1 << 6),
+	eModifierMode_CacheResult       = (1 << 7),
 	eModifierMode_DisableTemporary  = (1u << 31)
 } ModifierMode;
 
@@ -457,6 +458,7 @@ enum {
 	MOD_DECIM_FLAG_TRIANGULATE         = (1 << 1),  /* for collapse only. dont convert tri pairs back to quads */
 	MOD_DECIM_FLAG_ALL_BOUNDARY_VERTS  = (1 << 2),  /* for dissolve only. collapse all verts between 2 faces */
 	MOD_DECIM_FLAG_SYMMETRY            = (1 << 3),
+	MOD_DECIM_FLAG_PARTITION           = (1 << 4),  /* for collapse only. decimate slabs of the mesh in parallel */
 };
 
 enum {
@@ -53,6 +53,7 @@ struct SoftBody;
 struct FluidsimSettings;
 struct ParticleSystem;
 struct DerivedMesh;
+struct ModifierStackCache;
 struct SculptSession;
 struct bGPdata;
 struct RigidBodyOb;
@@ -319,7 +320,8 @@ typedef struct Object {
 
 	float ima_ofs[2];		/* offset for image empties */
 	ImageUser *iuser;		/* must be non-null when oject is an empty image */
-	void *pad3;
+	struct ModifierStackCache *modifier_cache;	/* runtime, results of modifiers with eModifierMode_CacheResult */
+	struct DupliTable *dupli_table;	/* runtime, dupli instances cached for viewport drawing */
 
 	ListBase lodlevels;		/* contains data for levels of detail */
 	LodLevel *currentlod;
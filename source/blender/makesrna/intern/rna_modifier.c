@@ -1634,6 +1634,13 @@ static void rna_def_modifier_decimate(BlenderRNA *brna)
 	RNA_def_property_ui_text(prop, "Triangulate", "Keep triangulated faces resulting from decimation (collapse only)");
 	RNA_def_property_update(prop, 0, "rna_Modifier_update");
 
+	prop = RNA_def_property(srna, "use_collapse_partition", PROP_BOOLEAN, PROP_NONE);
+	RNA_def_property_boolean_sdna(prop, NULL, "flag", MOD_DECIM_FLAG_PARTITION);
+	RNA_def_property_ui_text(prop, "Partition",
+	                         "Decimate slabs of the mesh in parallel before the edges between them, "
+	                         "faster on large meshes (collapse only, not used with symmetry)");
+	RNA_def_property_update(prop, 0, "rna_Modifier_update");
+
 	prop = RNA_def_property(srna, "use_symmetry", PROP_BOOLEAN, PROP_NONE);
 	RNA_def_property_boolean_sdna(prop, NULL, "flag", MOD_DECIM_FLAG_SYMMETRY);
 	RNA_def_property_ui_text(prop, "Symmetry", "Maintain symmetry on an axis");
@@ -4875,6 +4882,13 @@ void RNA_def_modifier(BlenderRNA *brna)
 	RNA_def_property_ui_icon(prop, ICON_SURFACE_DATA, 0);
 	RNA_def_property_update(prop, 0, "rna_Modifier_update");
 
+	prop = RNA_def_property(srna, "use_cache_result", PROP_BOOLEAN, PROP_NONE);
+	RNA_def_property_boolean_sdna(prop, NULL, "mode", eModifierMode_CacheResult);
+	RNA_def_property_ui_text(prop, "Cache Result",
+	                         "Keep the result of this modifier in memory, to only re-evaluate the following "
+	                         "modifiers when they change (mesh modifiers not using other data-blocks only)");
+	RNA_def_property_update(prop, 0, "rna_Modifier_update");
+
 	/* types */
 	rna_def_modifier_subsurf(brna);
 	rna_def_modifier_lattice(brna);
@@ -48,6 +48,8 @@
 
 #include "depsgraph_private.h"
 
+#include "MEM_guardedalloc.h"
+
 #include "MOD_util.h"
 
 static void initData(ModifierData *md)
@@ -134,22 +136,97 @@ static void updateDepsgraph(ModifierData *md,
 	}
 }
 
+typedef struct CastUserdata {
+	const CastModifierData *cmd;
+	float (*vertexCos)[3];
+	const float *weights;
+	bool use_ctrl_ob;
+	bool has_radius;
+	short flag, type;
+	float len;
+	float center[3];
+	float mat[4][4], imat[4][4];
+	float bb[8][3];
+} CastUserdata;
+
+static void sphere_do_chunk(void *userdata, const int start, const int end)
+{
+	CastUserdata *data = userdata;
+	const CastModifierData *cmd = data->cmd;
+	const float *weights = data->weights;
+	const short flag = data->flag;
+	const float len = data->len;
+	int i;
+
+	for (i = start; i < end; i++) {
+		float tmp_co[3], vec[3];
+		float fac = cmd->fac;
+		float facm;
+
+		copy_v3_v3(tmp_co, data->vertexCos[i]);
+		if (data->use_ctrl_ob) {
+			if (flag & MOD_CAST_USE_OB_TRANSFORM) {
+				mul_m4_v3(data->mat, tmp_co);
+			}
+			else {
+				sub_v3_v3(tmp_co, data->center);
+			}
+		}
+
+		copy_v3_v3(vec, tmp_co);
+
+		if (data->type == MOD_CAST_TYPE_CYLINDER)
+			vec[2] = 0.0f;
+
+		if (data->has_radius) {
+			if (len_v3(vec) > cmd->radius) continue;
+		}
+
+		if (weights) {
+			const float weight = weights[i];
+			if (weight == 0.0f) {
+				continue;
+			}
+
+			fac *= weight;
+		}
+		facm = 1.0f - fac;
+
+		normalize_v3(vec);
+
+		if (flag & MOD_CAST_X)
+			tmp_co[0] = fac * vec[0] * len + facm * tmp_co[0];
+		if (flag & MOD_CAST_Y)
+			tmp_co[1] = fac * vec[1] * len + facm * tmp_co[1];
+		if (flag & MOD_CAST_Z)
+			tmp_co[2] = fac * vec[2] * len + facm * tmp_co[2];
+
+		if (data->use_ctrl_ob) {
+			if (flag & MOD_CAST_USE_OB_TRANSFORM) {
+				mul_m4_v3(data->imat, tmp_co);
+			}
+			else {
+				add_v3_v3(tmp_co, data->center);
+			}
+		}
+
+		copy_v3_v3(data->vertexCos[i], tmp_co);
+	}
+}
+
 static void sphere_do(
         CastModifierData *cmd, Object *ob, DerivedMesh *dm,
         float (*vertexCos)[3], int numVerts)
 {
-	MDeformVert *dvert = NULL;
-
+	CastUserdata data = {NULL};
 	Object *ctrl_ob = NULL;
 
-	int i, defgrp_index;
+	int i;
+
 	bool has_radius = false;
 	short flag, type;
 	float len = 0.0f;
-	float fac = cmd->fac;
-	float facm = 1.0f - fac;
-	const float fac_orig = fac;
-	float vec[3], center[3] = {0.0f, 0.0f, 0.0f};
+	float center[3] = {0.0f, 0.0f, 0.0f};
 	float mat[4][4], imat[4][4];
 
 	flag = cmd->flag;
@@ -183,7 +260,7 @@ static void sphere_do(
 
 	/* 3) if we were given a vertex group name,
 	 * only those vertices should be affected */
-	modifier_get_vgroup(ob, dm, cmd->defgrp_name, &dvert, &defgrp_index);
+	data.weights = modifier_get_vgroup_weights(ob, dm, cmd->defgrp_name, false, numVerts);
 
 	if (flag & MOD_CAST_SIZE_FROM_RADIUS) {
 		len = cmd->radius;
@@ -201,57 +278,131 @@ static void sphere_do(
 		if (len == 0.0f) len = 10.0f;
 	}
 
-	for (i = 0; i < numVerts; i++) {
+	data.cmd = cmd;
+	data.vertexCos = vertexCos;
+	data.use_ctrl_ob = (ctrl_ob != NULL);
+	data.has_radius = has_radius;
+	data.flag = flag;
+	data.type = type;
+	data.len = len;
+	copy_v3_v3(data.center, center);
+	if (ctrl_ob && (flag & MOD_CAST_USE_OB_TRANSFORM)) {
+		copy_m4_m4(data.mat, mat);
+		copy_m4_m4(data.imat, imat);
+	}
+
+	modifier_deform_verts_parallel(&data, numVerts, sphere_do_chunk);
+
+	if (data.weights) {
+		MEM_freeN((void *)data.weights);
+	}
+}
+
+static void cuboid_do_chunk(void *userdata, const int start, const int end)
+{
+	CastUserdata *data = userdata;
+	const CastModifierData *cmd = data->cmd;
+	const float *weights = data->weights;
+	const short flag = data->flag;
+	int i;
+
+	for (i = start; i < end; i++) {
+		int octant, coord;
+		float d[3], dmax, apex[3], fbb;
 		float tmp_co[3];
+		float fac = cmd->fac;
+		float facm;
 
-		copy_v3_v3(tmp_co, vertexCos[i]);
-		if (ctrl_ob) {
+		copy_v3_v3(tmp_co, data->vertexCos[i]);
+		if (data->use_ctrl_ob) {
 			if (flag & MOD_CAST_USE_OB_TRANSFORM) {
-				mul_m4_v3(mat, tmp_co);
+				mul_m4_v3(data->mat, tmp_co);
 			}
 			else {
-				sub_v3_v3(tmp_co, center);
+				sub_v3_v3(tmp_co, data->center);
 			}
 		}
 
-		copy_v3_v3(vec, tmp_co);
-
-		if (type == MOD_CAST_TYPE_CYLINDER)
-			vec[2] = 0.0f;
-
-		if (has_radius) {
-			if (len_v3(vec) > cmd->radius) continue;
+		if (data->has_radius) {
+			if (fabsf(tmp_co[0]) > cmd->radius ||
+			    fabsf(tmp_co[1]) > cmd->radius ||
+			    fabsf(tmp_co[2]) > cmd->radius)
+			{
+				continue;
+			}
 		}
 
-		if (dvert) {
-			const float weight = defvert_find_weight(&dvert[i], defgrp_index);
+		if (weights) {
+			const float weight = weights[i];
 			if (weight == 0.0f) {
 				continue;
 			}
 
-			fac = fac_orig * weight;
-			facm = 1.0f - fac;
+			fac *= weight;
 		}
+		facm = 1.0f - fac;
 
-		normalize_v3(vec);
+		/* The algo used to project the vertices to their
+		 * bounding box (bb) is pretty simple:
+		 * for each vertex v:
+		 * 1) find in which octant v is in;
+		 * 2) find which outer "wall" of that octant is closer to v;
+		 * 3) calculate factor (var fbb) to project v to that wall;
+		 * 4) project. */
+
+		/* find in which octant this vertex is in */
+		octant = 0;
+		if (tmp_co[0] > 0.0f) octant += 1;
+		if (tmp_co[1] > 0.0f) octant += 2;
+		if (tmp_co[2] > 0.0f) octant += 4;
+
+		/* apex is the bb's vertex at the chosen octant */
+		copy_v3_v3(apex, data->bb[octant]);
+
+		/* find which bb plane is closest to this vertex ... */
+		d[0] = tmp_co[0] / apex[0];
+		d[1] = tmp_co[1] / apex[1];
+		d[2] = tmp_co[2] / apex[2];
+
+		/* ... (the closest has the higher (closer to 1) d value) */
+		dmax = d[0];
+		coord = 0;
+		if (d[1] > dmax) {
+			dmax = d[1];
+			coord = 1;
+		}
+		if (d[2] > dmax) {
+			/* dmax = d[2]; */ /* commented, we don't need it */
+			coord = 2;
+		}
 
+		/* ok, now we know which coordinate of the vertex to use */
+
+		if (fabsf(tmp_co[coord]) < FLT_EPSILON) /* avoid division by zero */
+			continue;
+
+		/* finally, this is the factor we wanted, to project the vertex
+		 * to its bounding box (bb) */
+		fbb = apex[coord] / tmp_co[coord];
+
+		/* calculate the new vertex position */
 		if (flag & MOD_CAST_X)
-			tmp_co[0] = fac * vec[0] * len + facm * tmp_co[0];
+			tmp_co[0] = facm * tmp_co[0] + fac * tmp_co[0] * fbb;
 		if (flag & MOD_CAST_Y)
-			tmp_co[1] = fac * vec[1] * len + facm * tmp_co[1];
+			tmp_co[1] = facm * tmp_co[1] + fac * tmp_co[1] * fbb;
 		if (flag & MOD_CAST_Z)
-			tmp_co[2] = fac * vec[2] * len + facm * tmp_co[2];
+			tmp_co[2] = facm * tmp_co[2] + fac * tmp_co[2] * fbb;
 
-		if (ctrl_ob) {
+		if (data->use_ctrl_ob) {
 			if (flag & MOD_CAST_USE_OB_TRANSFORM) {
-				mul_m4_v3(imat, tmp_co);
+				mul_m4_v3(data->imat, tmp_co);
 			}
 			else {
-				add_v3_v3(tmp_co, center);
+				add_v3_v3(tmp_co, data->center);
 			}
 		}
 
-		copy_v3_v3(vertexCos[i], tmp_co);
+		copy_v3_v3(data->vertexCos[i], tmp_co);
 	}
 }
 
@@ -259,15 +410,12 @@ static void cuboid_do(
         CastModifierData *cmd, Object *ob, DerivedMesh *dm,
         float (*vertexCos)[3], int numVerts)
 {
-	MDeformVert *dvert = NULL;
+	CastUserdata data = {NULL};
 	Object *ctrl_ob = NULL;
 
-	int i, defgrp_index;
+	int i;
 	bool has_radius = false;
 	short flag;
-	float fac = cmd->fac;
-	float facm = 1.0f - fac;
-	const float fac_orig = fac;
 	float min[3], max[3], bb[8][3];
 	float center[3] = {0.0f, 0.0f, 0.0f};
 	float mat[4][4], imat[4][4];
@@ -285,7 +433,7 @@ static void cuboid_do(
 
 	/* 3) if we were given a vertex group name,
 	 * only those vertices should be affected */
-	modifier_get_vgroup(ob, dm, cmd->defgrp_name, &dvert, &defgrp_index);
+	data.weights = modifier_get_vgroup_weights(ob, dm, cmd->defgrp_name, false, numVerts);
 
 	if (ctrl_ob) {
 		if (flag & MOD_CAST_USE_OB_TRANSFORM) {
@@ -353,102 +501,23 @@ static void cuboid_do(
 	bb[0][2] = bb[1][2] = bb[2][2] = bb[3][2] = min[2];
 	bb[4][2] = bb[5][2] = bb[6][2] = bb[7][2] = max[2];
 
-	/* ready to apply the effect, one vertex at a time */
-	for (i = 0; i < numVerts; i++) {
-		int octant, coord;
-		float d[3], dmax, apex[3], fbb;
-		float tmp_co[3];
-
-		copy_v3_v3(tmp_co, vertexCos[i]);
-		if (ctrl_ob) {
-			if (flag & MOD_CAST_USE_OB_TRANSFORM) {
-				mul_m4_v3(mat, tmp_co);
-			}
-			else {
-				sub_v3_v3(tmp_co, center);
-			}
-		}
-
-		if (has_radius) {
-			if (fabsf(tmp_co[0]) > cmd->radius ||
-			    fabsf(tmp_co[1]) > cmd->radius ||
-			    fabsf(tmp_co[2]) > cmd->radius)
-			{
-				continue;
-			}
-		}
-
-		if (dvert) {
-			const float weight = defvert_find_weight(&dvert[i], defgrp_index);
-			if (weight == 0.0f) {
-				continue;
-			}
-
-			fac = fac_orig * weight;
-			facm = 1.0f - fac;
-		}
-
-		/* The algo used to project the vertices to their
-		 * bounding box (bb) is pretty simple:
-		 * for each vertex v:
-		 * 1) find in which octant v is in;
-		 * 2) find which outer "wall" of that octant is closer to v;
-		 * 3) calculate factor (var fbb) to project v to that wall;
-		 * 4) project. */
-
-		/* find in which octant this vertex is in */
-		octant = 0;
-		if (tmp_co[0] > 0.0f) octant += 1;
-		if (tmp_co[1] > 0.0f) octant += 2;
-		if (tmp_co[2] > 0.0f) octant += 4;
-
-		/* apex is the bb's vertex at the chosen octant */
-		copy_v3_v3(apex, bb[octant]);
-
-		/* find which bb plane is closest to this vertex ... */
-		d[0] = tmp_co[0] / apex[0];
-		d[1] = tmp_co[1] / apex[1];
-		d[2] = tmp_co[2] / apex[2];
-
-		/* ... (the closest has the higher (closer to 1) d value) */
-		dmax = d[0];
-		coord = 0;
-		if (d[1] > dmax) {
-			dmax = d[1];
-			coord = 1;
-		}
-		if (d[2] > dmax) {
-			/* dmax = d[2]; */ /* commented, we don't need it */
-			coord = 2;
-		}
-
-		/* ok, now we know which coordinate of the vertex to use */
-
-		if (fabsf(tmp_co[coord]) < FLT_EPSILON) /* avoid division by zero */
-			continue;
-
-		/* finally, this is the factor we wanted, to project the vertex
-		 * to its bounding box (bb) */
-		fbb = apex[coord] / tmp_co[coord];
-
-		/* calculate the new vertex position */
-		if (flag & MOD_CAST_X)
-			tmp_co[0] = facm * tmp_co[0] + fac * tmp_co[0] * fbb;
-		if (flag & MOD_CAST_Y)
-			tmp_co[1] = facm * tmp_co[1] + fac * tmp_co[1] * fbb;
-		if (flag & MOD_CAST_Z)
-			tmp_co[2] = facm * tmp_co[2] + fac * tmp_co[2] * fbb;
+	data.cmd = cmd;
+	data.vertexCos = vertexCos;
+	data.use_ctrl_ob = (ctrl_ob != NULL);
+	data.has_radius = has_radius;
+	data.flag = flag;
+	copy_v3_v3(data.center, center);
+	if (ctrl_ob && (flag & MOD_CAST_USE_OB_TRANSFORM)) {
+		copy_m4_m4(data.mat, mat);
+		copy_m4_m4(data.imat, imat);
+	}
+	memcpy(data.bb, bb, sizeof(data.bb));
 
-		if (ctrl_ob) {
-			if (flag & MOD_CAST_USE_OB_TRANSFORM) {
-				mul_m4_v3(imat, tmp_co);
-			}
-			else {
-				add_v3_v3(tmp_co, center);
-			}
-		}
+	/* ready to apply the effect, one vertex at a time */
+	modifier_deform_verts_parallel(&data, numVerts, cuboid_do_chunk);
 
-		copy_v3_v3(vertexCos[i], tmp_co);
+	if (data.weights) {
+		MEM_freeN((void *)data.weights);
 	}
 }
 
@@ -158,6 +158,7 @@ struct HookData_cb {
 
 	MDeformVert *dvert;
 	int defgrp_index;
+	const float *weights;  /* dense vertex group weights, when all vertices are hooked */
 
 	struct CurveMapping *curfalloff;
 
@@ -267,7 +268,10 @@ static void hook_co_apply(struct HookData_cb *hd, const int j)
 	}
 
 	if (fac) {
-		if (hd->dvert) {
+		if (hd->weights) {
+			fac *= hd->weights[j];
+		}
+		else if (hd->dvert) {
 			fac *= defvert_find_weight(&hd->dvert[j], hd->defgrp_index);
 		}
 
@@ -279,6 +283,16 @@ static void hook_co_apply(struct HookData_cb *hd, const int j)
 	}
 }
 
+static void hook_co_apply_chunk(void *userdata, const int start, const int end)
+{
+	struct HookData_cb *hd = userdata;
+	int j;
+
+	for (j = start; j < end; j++) {
+		hook_co_apply(hd, j);
+	}
+}
+
 static void deformVerts_do(HookModifierData *hmd, Object *ob, DerivedMesh *dm,
                            float (*vertexCos)[3], int numVerts)
 {
@@ -299,6 +313,7 @@ static void deformVerts_do(HookModifierData *hmd, Object *ob, DerivedMesh *dm,
 	/* Generic data needed for applying per-vertex calculations (initialize all members) */
 	hd.vertexCos = vertexCos;
 	modifier_get_vgroup(ob, dm, hmd->name, &hd.dvert, &hd.defgrp_index);
+	hd.weights = NULL;
 
 	hd.curfalloff = hmd->curfalloff;
 
@@ -370,9 +385,11 @@ static void deformVerts_do(HookModifierData *hmd, Object *ob, DerivedMesh *dm,
 		}
 	}
 	else if (hd.dvert) {  /* vertex group hook */
-		for (i = 0; i < numVerts; i++) {
-			hook_co_apply(&hd, i);
-		}
+		hd.weights = modifier_get_vgroup_weights(ob, dm, hmd->name, false, numVerts);
+
+		modifier_deform_verts_parallel(&hd, numVerts, hook_co_apply_chunk);
+
+		MEM_freeN((void *)hd.weights);
 	}
 }
 
@@ -28,6 +28,7 @@
 
 #include "BLI_math_base.h"
 #include "BLI_math_vector.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "BKE_cdderivedmesh.h"
@@ -142,6 +143,26 @@ static void dualcon_add_quad(void *output_v, const int vert_indices[4])
 	output->curface++;
 }
 
+/* run dualcon's parallel ranges with the task scheduler */
+typedef struct DualConParallelData {
+	DualConParallelFunc func;
+	void *userdata;
+} DualConParallelData;
+
+static void dualcon_parallel_range_cb(void *userdata, const int iter)
+{
+	DualConParallelData *data = userdata;
+
+	data->func(data->userdata, iter);
+}
+
+static void dualcon_parallel_range(int tot, void *userdata, DualConParallelFunc func)
+{
+	DualConParallelData data = {func, userdata};
+
+	BLI_task_parallel_range(0, tot, &data, dualcon_parallel_range_cb, true);
+}
+
 static DerivedMesh *applyModifier(ModifierData *md,
                                   Object *UNUSED(ob),
                                   DerivedMesh *dm,
@@ -177,6 +198,7 @@ static DerivedMesh *applyModifier(ModifierData *md,
 	                 dualcon_alloc_output,
 	                 dualcon_add_vert,
 	                 dualcon_add_quad,
+	                 dualcon_parallel_range,
 	                 flags,
 	                 mode,
 	                 rmd->threshold,
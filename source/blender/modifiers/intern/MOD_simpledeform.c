@@ -47,6 +47,8 @@
 
 #include "depsgraph_private.h"
 
+#include "MEM_guardedalloc.h"
+
 #include "MOD_util.h"
 
 #define BEND_EPS 0.000001f
@@ -142,11 +144,59 @@ static void simpleDeform_bend(const float factor, const float dcut[3], float r_c
 
 
 /* simple deform modifier */
-static void SimpleDeformModifier_do(SimpleDeformModifierData *smd, struct Object *ob, struct DerivedMesh *dm,
-                                    float (*vertexCos)[3], int numVerts)
+typedef struct SimpleDeformUserdata {
+	const SimpleDeformModifierData *smd;
+	float (*vertexCos)[3];
+	const float *weights;
+	const SpaceTransform *transf;
+	void (*simpleDeform_callback)(const float factor, const float dcut[3], float co[3]);
+	int limit_axis;
+	float smd_limit[2], smd_factor;
+} SimpleDeformUserdata;
+
+static void SimpleDeformModifier_do_chunk(void *userdata, const int start, const int end)
 {
 	static const float lock_axis[2] = {0.0f, 0.0f};
 
+	const SimpleDeformUserdata *data = userdata;
+	const SimpleDeformModifierData *smd = data->smd;
+	const SpaceTransform *transf = data->transf;
+	float (*vertexCos)[3] = data->vertexCos;
+	int i;
+
+	for (i = start; i < end; i++) {
+		const float weight = data->weights ? data->weights[i] : 1.0f;
+
+		if (weight != 0.0f) {
+			float co[3], dcut[3] = {0.0f, 0.0f, 0.0f};
+
+			if (transf) {
+				BLI_space_transform_apply(transf, vertexCos[i]);
+			}
+
+			copy_v3_v3(co, vertexCos[i]);
+
+			/* Apply axis limits */
+			if (smd->mode != MOD_SIMPLEDEFORM_MODE_BEND) { /* Bend mode shoulnt have any lock axis */
+				if (smd->axis & MOD_SIMPLEDEFORM_LOCK_AXIS_X) axis_limit(0, lock_axis, co, dcut);
+				if (smd->axis & MOD_SIMPLEDEFORM_LOCK_AXIS_Y) axis_limit(1, lock_axis, co, dcut);
+			}
+			axis_limit(data->limit_axis, data->smd_limit, co, dcut);
+
+			data->simpleDeform_callback(data->smd_factor, dcut, co);  /* apply deform */
+			interp_v3_v3v3(vertexCos[i], vertexCos[i], co, weight);  /* Use vertex weight has coef of linear interpolation */
+
+			if (transf) {
+				BLI_space_transform_invert(transf, vertexCos[i]);
+			}
+		}
+	}
+}
+
+static void SimpleDeformModifier_do(SimpleDeformModifierData *smd, struct Object *ob, struct DerivedMesh *dm,
+                                    float (*vertexCos)[3], int numVerts)
+{
+	SimpleDeformUserdata data = {NULL};
 	int i;
 	int limit_axis = 0;
 	float smd_limit[2], smd_factor;
@@ -216,36 +266,31 @@ static void SimpleDeformModifier_do(SimpleDeformModifierData *smd, struct Object
 	modifier_get_vgroup(ob, dm, smd->vgroup_name, &dvert, &vgroup);
 	const bool invert_vgroup = (smd->flag & MOD_SIMPLEDEFORM_FLAG_INVERT_VGROUP) != 0;
 
-	for (i = 0; i < numVerts; i++) {
-		float weight = defvert_array_find_weight_safe(dvert, i, vgroup);
-
-		if (invert_vgroup) {
-			weight = 1.0f - weight;
-		}
-
-		if (weight != 0.0f) {
-			float co[3], dcut[3] = {0.0f, 0.0f, 0.0f};
-
-			if (transf) {
-				BLI_space_transform_apply(transf, vertexCos[i]);
-			}
+	if (invert_vgroup && vgroup == -1) {
+		/* Missing vertex group weights 1.0, inverted nothing gets deformed. */
+		return;
+	}
 
-			copy_v3_v3(co, vertexCos[i]);
+	if (dvert) {
+		data.weights = modifier_get_vgroup_weights(ob, dm, smd->vgroup_name, invert_vgroup, numVerts);
+	}
+	else if (vgroup != -1 && !invert_vgroup) {
+		/* Valid but empty vertex group, all weights are zero. */
+		return;
+	}
 
-			/* Apply axis limits */
-			if (smd->mode != MOD_SIMPLEDEFORM_MODE_BEND) { /* Bend mode shoulnt have any lock axis */
-				if (smd->axis & MOD_SIMPLEDEFORM_LOCK_AXIS_X) axis_limit(0, lock_axis, co, dcut);
-				if (smd->axis & MOD_SIMPLEDEFORM_LOCK_AXIS_Y) axis_limit(1, lock_axis, co, dcut);
-			}
-			axis_limit(limit_axis, smd_limit, co, dcut);
+	data.smd = smd;
+	data.vertexCos = vertexCos;
+	data.transf = transf;
+	data.simpleDeform_callback = simpleDeform_callback;
+	data.limit_axis = limit_axis;
+	copy_v2_v2(data.smd_limit, smd_limit);
+	data.smd_factor = smd_factor;
 
-			simpleDeform_callback(smd_factor, dcut, co);  /* apply deform */
-			interp_v3_v3v3(vertexCos[i], vertexCos[i], co, weight);  /* Use vertex weight has coef of linear interpolation */
+	modifier_deform_verts_parallel(&data, numVerts, SimpleDeformModifier_do_chunk);
 
-			if (transf) {
-				BLI_space_transform_invert(transf, vertexCos[i]);
-			}
-		}
+	if (data.weights) {
+		MEM_freeN((void *)data.weights);
 	}
 }
 
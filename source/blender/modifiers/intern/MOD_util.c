@@ -39,8 +39,10 @@
 #include "DNA_scene_types.h"
 
 #include "BLI_utildefines.h"
+#include "BLI_kdtree.h"
 #include "BLI_math_vector.h"
 #include "BLI_math_matrix.h"
+#include "BLI_task.h"
 
 #include "BKE_cdderivedmesh.h"
 #include "BKE_deform.h"
@@ -230,6 +232,187 @@ void modifier_get_vgroup(Object *ob, DerivedMesh *dm, const char *name, MDeformV
 }
 
 
+typedef struct ModifierDeformChunkData {
+	void *userdata;
+	ModifierDeformChunkFunc func;
+	int numVerts;
+} ModifierDeformChunkData;
+
+static void modifier_deform_chunk_task(void *userdata, const int iter)
+{
+	const ModifierDeformChunkData *data = userdata;
+	const int start = iter * MOD_DEFORM_CHUNK_SIZE;
+	const int end = min_ii(start + MOD_DEFORM_CHUNK_SIZE, data->numVerts);
+
+	data->func(data->userdata, start, end);
+}
+
+/**
+ * Run \a func over all vertices, split into chunks of #MOD_DEFORM_CHUNK_SIZE vertices processed in parallel.
+ *
+ * Chunks are contiguous, so loops over coordinates and dense weights inside them can be vectorized.
+ * \a func must only write to the vertices of its own chunk.
+ */
+void modifier_deform_verts_parallel(void *userdata, const int numVerts, ModifierDeformChunkFunc func)
+{
+	const int numChunks = (numVerts + MOD_DEFORM_CHUNK_SIZE - 1) / MOD_DEFORM_CHUNK_SIZE;
+
+	if (numChunks <= 1) {
+		if (numVerts > 0) {
+			func(userdata, 0, numVerts);
+		}
+	}
+	else {
+		ModifierDeformChunkData data = {
+		    .userdata = userdata,
+		    .func = func,
+		    .numVerts = numVerts,
+		};
+
+		BLI_task_parallel_range(0, numChunks, &data, modifier_deform_chunk_task, true);
+	}
+}
+
+typedef struct ModifierVGroupWeightsData {
+	const MDeformVert *dvert;
+	int defgrp_index;
+	bool invert;
+	float *weights;
+} ModifierVGroupWeightsData;
+
+static void modifier_vgroup_weights_chunk(void *userdata, const int start, const int end)
+{
+	const ModifierVGroupWeightsData *data = userdata;
+	int i;
+
+	for (i = start; i < end; i++) {
+		const float weight = defvert_find_weight(&data->dvert[i], data->defgrp_index);
+		data->weights[i] = data->invert ? 1.0f - weight : weight;
+	}
+}
+
+/**
+ * Gather the weights of a vertex group into a dense array, instead of looking them up vertex per vertex.
+ *
+ * \return NULL when there is no such group (all weights are 1.0), to be freed by the caller otherwise.
+ */
+float *modifier_get_vgroup_weights(Object *ob, DerivedMesh *dm, const char *name, const bool invert, const int numVerts)
+{
+	ModifierVGroupWeightsData data;
+	MDeformVert *dvert;
+	int defgrp_index;
+
+	modifier_get_vgroup(ob, dm, name, &dvert, &defgrp_index);
+
+	if (dvert == NULL) {
+		return NULL;
+	}
+
+	data.dvert = dvert;
+	data.defgrp_index = defgrp_index;
+	data.invert = invert;
+	data.weights = MEM_mallocN(sizeof(*data.weights) * (size_t)numVerts, __func__);
+
+	modifier_deform_verts_parallel(&data, numVerts, modifier_vgroup_weights_chunk);
+
+	return data.weights;
+}
+
+typedef struct MVertMapDoublesData {
+	/* Read-only data. */
+	const KDTree *tree;
+	const MVert *mverts;
+	const int *doubles_map;
+	int source_start;
+	float dist;
+
+	/* Written per source vertex. */
+	int *source_map;
+} MVertMapDoublesData;
+
+static void mvert_map_doubles_cb(void *userdata, const int i)
+{
+	const MVertMapDoublesData *data = userdata;
+	const MVert *mverts = data->mverts;
+	const int *doubles_map = data->doubles_map;
+	const int i_source = data->source_start + i;
+	const float *co = mverts[i_source].co;
+	KDTreeNearest nearest;
+	int best_target_vertex = -1;
+
+	/* If source has already been assigned to a target (in an earlier call, with other vertices) */
+	if (doubles_map[i_source] != -1) {
+		data->source_map[i] = doubles_map[i_source];
+		return;
+	}
+
+	if ((BLI_kdtree_find_nearest(data->tree, co, &nearest) != -1) &&
+	    (len_squared_v3v3(co, mverts[nearest.index].co) <= data->dist * data->dist))
+	{
+		best_target_vertex = nearest.index;
+
+		/* If target is already mapped, we only follow that mapping if final target remains
+		 * close enough from current vert (otherwise no mapping at all). */
+		while (best_target_vertex != -1 && !ELEM(doubles_map[best_target_vertex], -1, best_target_vertex)) {
+			if (compare_len_v3v3(co, mverts[doubles_map[best_target_vertex]].co, data->dist)) {
+				best_target_vertex = doubles_map[best_target_vertex];
+			}
+			else {
+				best_target_vertex = -1;
+			}
+		}
+	}
+
+	data->source_map[i] = best_target_vertex;
+}
+
+/**
+ * Take as inputs two sets of verts, to be processed for detection of doubles and mapping.
+ * Each set of verts is defined by its start within mverts array and its num_verts;
+ * It builds a mapping for all vertices within source, to the closest vertex within target
+ * (at most \a dist away), or -1 if no double found.
+ * The int doubles_map[num_verts] array must have been allocated by caller.
+ *
+ * Target vertices are stored in a KD-tree and source vertices are looked up in parallel,
+ * so the cost doesn't depend on how the vertices are laid out (planar or regular grids...).
+ */
+void modifier_mvert_map_doubles(
+        int *doubles_map, const MVert *mverts,
+        const int target_start, const int target_num_verts,
+        const int source_start, const int source_num_verts,
+        const float dist)
+{
+	MVertMapDoublesData data;
+	KDTree *tree;
+	int i;
+
+	if (target_num_verts == 0 || source_num_verts == 0) {
+		return;
+	}
+
+	tree = BLI_kdtree_new((unsigned int)target_num_verts);
+	for (i = target_start; i < target_start + target_num_verts; i++) {
+		BLI_kdtree_insert(tree, i, mverts[i].co);
+	}
+	BLI_kdtree_balance(tree);
+
+	data.tree = tree;
+	data.mverts = mverts;
+	data.doubles_map = doubles_map;
+	data.source_start = source_start;
+	data.dist = dist;
+	/* Results are only written back once all lookups are done,
+	 * since following chains of doubles may read source vertices too. */
+	data.source_map = MEM_mallocN(sizeof(*data.source_map) * (size_t)source_num_verts, __func__);
+
+	BLI_task_parallel_range(0, source_num_verts, &data, mvert_map_doubles_cb, source_num_verts > 1024);
+
+	memcpy(&doubles_map[source_start], data.source_map, sizeof(*data.source_map) * (size_t)source_num_verts);
+
+	MEM_freeN(data.source_map);
+	BLI_kdtree_free(tree);
+}
+
 /* only called by BKE_modifier.h/modifier.c */
 void modifier_type_init(ModifierTypeInfo *types[])
 {
@@ -35,6 +35,7 @@
 
 struct DerivedMesh;
 struct MDeformVert;
+struct MVert;
 struct ModifierData;
 struct Object;
 struct Scene;
@@ -51,5 +52,20 @@ struct DerivedMesh *get_dm(struct Object *ob, struct BMEditMesh *em, struct Deri
 struct DerivedMesh *get_dm_for_modifier(struct Object *ob, ModifierApplyFlag flag);
 void modifier_get_vgroup(struct Object *ob, struct DerivedMesh *dm,
                          const char *name, struct MDeformVert **dvert, int *defgrp_index);
+float *modifier_get_vgroup_weights(struct Object *ob, struct DerivedMesh *dm,
+                                   const char *name, const bool invert, const int numVerts);
+
+/* Deform-only modifiers, vertices are processed in parallel by contiguous chunks. */
+#define MOD_DEFORM_CHUNK_SIZE 1024
+
+typedef void (*ModifierDeformChunkFunc)(void *userdata, const int start, const int end);
+
+void modifier_deform_verts_parallel(void *userdata, const int numVerts, ModifierDeformChunkFunc func);
+
+void modifier_mvert_map_doubles(
+        int *doubles_map, const struct MVert *mverts,
+        const int target_start, const int target_num_verts,
+        const int source_start, const int source_num_verts,
+        const float dist);
 
 #endif /* __MOD_UTIL_H__ */
@@ -39,6 +39,7 @@
 #include "BKE_library_query.h"
 #include "BKE_modifier.h"
 #include "BKE_deform.h"
+#include "BKE_image.h"
 #include "BKE_texture.h"
 #include "BKE_colortools.h"
 
@@ -176,90 +177,47 @@ static void updateDepsgraph(ModifierData *md,
 	}
 }
 
-static void warpModifier_do(WarpModifierData *wmd, Object *ob,
-                            DerivedMesh *dm, float (*vertexCos)[3], int numVerts)
-{
-	float obinv[4][4];
+typedef struct WarpUserdata {
+	const WarpModifierData *wmd;
+	struct ImagePool *pool;
+	float (*vertexCos)[3];
+	const float *weights;
+	const float (*tex_co)[3];
 	float mat_from[4][4];
 	float mat_from_inv[4][4];
-	float mat_to[4][4];
 	float mat_unit[4][4];
 	float mat_final[4][4];
+	float falloff_radius_sq;
+	float strength;
+} WarpUserdata;
 
-	float tmat[4][4];
-
-	const float falloff_radius_sq = SQUARE(wmd->falloff_radius);
-	float strength = wmd->strength;
-	float fac = 1.0f, weight;
+static void warpModifier_do_chunk(void *userdata, const int start, const int end)
+{
+	WarpUserdata *data = userdata;
+	const WarpModifierData *wmd = data->wmd;
+	float (*vertexCos)[3] = data->vertexCos;
+	const float *weights = data->weights;
+	const float (*tex_co)[3] = data->tex_co;
+	const float falloff_radius_sq = data->falloff_radius_sq;
+	const float strength = data->strength;
 	int i;
-	int defgrp_index;
-	MDeformVert *dvert, *dv = NULL;
-
-	float (*tex_co)[3] = NULL;
-
-	if (!(wmd->object_from && wmd->object_to))
-		return;
-
-	modifier_get_vgroup(ob, dm, wmd->defgrp_name, &dvert, &defgrp_index);
-	if (dvert == NULL) {
-		defgrp_index = -1;
-	}
-
-	if (wmd->curfalloff == NULL) /* should never happen, but bad lib linking could cause it */
-		wmd->curfalloff = curvemapping_add(1, 0.0f, 0.0f, 1.0f, 1.0f);
-
-	if (wmd->curfalloff) {
-		curvemapping_initialize(wmd->curfalloff);
-	}
-
-	invert_m4_m4(obinv, ob->obmat);
 
-	mul_m4_m4m4(mat_from, obinv, wmd->object_from->obmat);
-	mul_m4_m4m4(mat_to, obinv, wmd->object_to->obmat);
-
-	invert_m4_m4(tmat, mat_from); // swap?
-	mul_m4_m4m4(mat_final, tmat, mat_to);
-
-	invert_m4_m4(mat_from_inv, mat_from);
-
-	unit_m4(mat_unit);
-
-	if (strength < 0.0f) {
-		float loc[3];
-		strength = -strength;
-
-		/* inverted location is not useful, just use the negative */
-		copy_v3_v3(loc, mat_final[3]);
-		invert_m4(mat_final);
-		negate_v3_v3(mat_final[3], loc);
-
-	}
-	weight = strength;
-
-	if (wmd->texture) {
-		tex_co = MEM_mallocN(sizeof(*tex_co) * numVerts, "warpModifier_do tex_co");
-		get_texture_coords((MappingInfoModifierData *)wmd, ob, dm, vertexCos, tex_co, numVerts);
-
-		modifier_init_texture(wmd->modifier.scene, wmd->texture);
-	}
-
-	for (i = 0; i < numVerts; i++) {
+	for (i = start; i < end; i++) {
 		float *co = vertexCos[i];
+		float fac = 1.0f, weight = strength;
 
 		if (wmd->falloff_type == eWarp_Falloff_None ||
-		    ((fac = len_squared_v3v3(co, mat_from[3])) < falloff_radius_sq &&
+		    ((fac = len_squared_v3v3(co, data->mat_from[3])) < falloff_radius_sq &&
 		     (fac = (wmd->falloff_radius - sqrtf(fac)) / wmd->falloff_radius)))
 		{
 			/* skip if no vert group found */
-			if (defgrp_index != -1) {
-				dv = &dvert[i];
-				weight = defvert_find_weight(dv, defgrp_index) * strength;
+			if (weights) {
+				weight = weights[i] * strength;
 				if (weight <= 0.0f) {
 					continue;
 				}
 			}
 
-
 			/* closely match PROP_SMOOTH and similar */
 			switch (wmd->falloff_type) {
 				case eWarp_Falloff_None:
@@ -296,35 +254,113 @@ static void warpModifier_do(WarpModifierData *wmd, Object *ob,
 			if (tex_co) {
 				TexResult texres;
 				texres.nor = NULL;
-				BKE_texture_get_value(wmd->modifier.scene, wmd->texture, tex_co[i], &texres, false);
+				BKE_texture_get_value_ex(wmd->modifier.scene, wmd->texture, (float *)tex_co[i], &texres,
+				                         data->pool, false);
 				fac *= texres.tin;
 			}
 
 			if (fac != 0.0f) {
 				/* into the 'from' objects space */
-				mul_m4_v3(mat_from_inv, co);
+				mul_m4_v3(data->mat_from_inv, co);
 
 				if (fac == 1.0f) {
-					mul_m4_v3(mat_final, co);
+					mul_m4_v3(data->mat_final, co);
 				}
 				else {
 					if (wmd->flag & MOD_WARP_VOLUME_PRESERVE) {
 						/* interpolate the matrix for nicer locations */
-						blend_m4_m4m4(tmat, mat_unit, mat_final, fac);
+						float tmat[4][4];
+						blend_m4_m4m4(tmat, data->mat_unit, data->mat_final, fac);
 						mul_m4_v3(tmat, co);
 					}
 					else {
 						float tvec[3];
-						mul_v3_m4v3(tvec, mat_final, co);
+						mul_v3_m4v3(tvec, data->mat_final, co);
 						interp_v3_v3v3(co, co, tvec, fac);
 					}
 				}
 
 				/* out of the 'from' objects space */
-				mul_m4_v3(mat_from, co);
+				mul_m4_v3(data->mat_from, co);
 			}
 		}
 	}
+}
+
+static void warpModifier_do(WarpModifierData *wmd, Object *ob,
+                            DerivedMesh *dm, float (*vertexCos)[3], int numVerts)
+{
+	WarpUserdata data = {NULL};
+	float obinv[4][4];
+	float mat_to[4][4];
+
+	float tmat[4][4];
+
+	float strength = wmd->strength;
+	float *weights;
+
+	float (*tex_co)[3] = NULL;
+
+	if (!(wmd->object_from && wmd->object_to))
+		return;
+
+	weights = modifier_get_vgroup_weights(ob, dm, wmd->defgrp_name, false, numVerts);
+
+	if (wmd->curfalloff == NULL) /* should never happen, but bad lib linking could cause it */
+		wmd->curfalloff = curvemapping_add(1, 0.0f, 0.0f, 1.0f, 1.0f);
+
+	if (wmd->curfalloff) {
+		curvemapping_initialize(wmd->curfalloff);
+	}
+
+	invert_m4_m4(obinv, ob->obmat);
+
+	mul_m4_m4m4(data.mat_from, obinv, wmd->object_from->obmat);
+	mul_m4_m4m4(mat_to, obinv, wmd->object_to->obmat);
+
+	invert_m4_m4(tmat, data.mat_from); // swap?
+	mul_m4_m4m4(data.mat_final, tmat, mat_to);
+
+	invert_m4_m4(data.mat_from_inv, data.mat_from);
+
+	unit_m4(data.mat_unit);
+
+	if (strength < 0.0f) {
+		float loc[3];
+		strength = -strength;
+
+		/* inverted location is not useful, just use the negative */
+		copy_v3_v3(loc, data.mat_final[3]);
+		invert_m4(data.mat_final);
+		negate_v3_v3(data.mat_final[3], loc);
+
+	}
+
+	if (wmd->texture) {
+		tex_co = MEM_mallocN(sizeof(*tex_co) * numVerts, "warpModifier_do tex_co");
+		get_texture_coords((MappingInfoModifierData *)wmd, ob, dm, vertexCos, tex_co, numVerts);
+
+		modifier_init_texture(wmd->modifier.scene, wmd->texture);
+
+		data.pool = BKE_image_pool_new();
+		BKE_texture_fetch_images_for_pool(wmd->texture, data.pool);
+	}
+
+	data.wmd = wmd;
+	data.vertexCos = vertexCos;
+	data.weights = weights;
+	data.tex_co = (const float (*)[3])tex_co;
+	data.falloff_radius_sq = SQUARE(wmd->falloff_radius);
+	data.strength = strength;
+
+	modifier_deform_verts_parallel(&data, numVerts, warpModifier_do_chunk);
+
+	if (data.pool) {
+		BKE_image_pool_free(data.pool);
+	}
+
+	if (weights)
+		MEM_freeN(weights);
 
 	if (tex_co)
 		MEM_freeN(tex_co);
@@ -44,6 +44,7 @@
 
 #include "BKE_deform.h"
 #include "BKE_DerivedMesh.h"
+#include "BKE_image.h"
 #include "BKE_library.h"
 #include "BKE_library_query.h"
 #include "BKE_scene.h"
@@ -182,21 +183,139 @@ static CustomDataMask requiredDataMask(Object *UNUSED(ob), ModifierData *md)
 	return dataMask;
 }
 
+typedef struct WaveUserdata {
+	const WaveModifierData *wmd;
+	struct ImagePool *pool;
+	float (*vertexCos)[3];
+	const MVert *mvert;
+	const float *weights;
+	const float (*tex_co)[3];
+	float ctime;
+	float minfac;
+	float lifefac;
+	float falloff_inv;
+	int wmd_axis;
+} WaveUserdata;
+
+static void waveModifier_do_chunk(void *userdata, const int start, const int end)
+{
+	const WaveUserdata *data = userdata;
+	const WaveModifierData *wmd = data->wmd;
+	const MVert *mvert = data->mvert;
+	const float *weights = data->weights;
+	const float ctime = data->ctime;
+	const float lifefac = data->lifefac;
+	const float falloff = wmd->falloff;
+	const int wmd_axis = data->wmd_axis;
+	int i;
+
+	for (i = start; i < end; i++) {
+		float *co = data->vertexCos[i];
+		float x = co[0] - wmd->startx;
+		float y = co[1] - wmd->starty;
+		float amplit = 0.0f;
+		float def_weight = 1.0f;
+		float falloff_fac = 1.0f; /* when falloff == 0.0f this stays at 1.0f */
+
+		/* get weights */
+		if (weights) {
+			def_weight = weights[i];
+
+			/* if this vert isn't in the vgroup, don't deform it */
+			if (def_weight == 0.0f) {
+				continue;
+			}
+		}
+
+		switch (wmd_axis) {
+			case MOD_WAVE_X | MOD_WAVE_Y:
+				amplit = sqrtf(x * x + y * y);
+				break;
+			case MOD_WAVE_X:
+				amplit = x;
+				break;
+			case MOD_WAVE_Y:
+				amplit = y;
+				break;
+		}
+
+		/* this way it makes nice circles */
+		amplit -= (ctime - wmd->timeoffs) * wmd->speed;
+
+		if (wmd->flag & MOD_WAVE_CYCL) {
+			amplit = (float)fmodf(amplit - wmd->width, 2.0f * wmd->width) +
+			         wmd->width;
+		}
+
+		if (falloff != 0.0f) {
+			float dist = 0.0f;
+
+			switch (wmd_axis) {
+				case MOD_WAVE_X | MOD_WAVE_Y:
+					dist = sqrtf(x * x + y * y);
+					break;
+				case MOD_WAVE_X:
+					dist = fabsf(x);
+					break;
+				case MOD_WAVE_Y:
+					dist = fabsf(y);
+					break;
+			}
+
+			falloff_fac = (1.0f - (dist * data->falloff_inv));
+			CLAMP(falloff_fac, 0.0f, 1.0f);
+		}
+
+		/* GAUSSIAN */
+		if ((falloff_fac != 0.0f) && (amplit > -wmd->width) && (amplit < wmd->width)) {
+			amplit = amplit * wmd->narrow;
+			amplit = (float)(1.0f / expf(amplit * amplit) - data->minfac);
+
+			/*apply texture*/
+			if (wmd->texture) {
+				TexResult texres;
+				texres.nor = NULL;
+				BKE_texture_get_value_ex(wmd->modifier.scene, wmd->texture, (float *)data->tex_co[i], &texres,
+				                         data->pool, false);
+				amplit *= texres.tin;
+			}
+
+			/*apply weight & falloff */
+			amplit *= def_weight * falloff_fac;
+
+			if (mvert) {
+				/* move along normals */
+				if (wmd->flag & MOD_WAVE_NORM_X) {
+					co[0] += (lifefac * amplit) * mvert[i].no[0] / 32767.0f;
+				}
+				if (wmd->flag & MOD_WAVE_NORM_Y) {
+					co[1] += (lifefac * amplit) * mvert[i].no[1] / 32767.0f;
+				}
+				if (wmd->flag & MOD_WAVE_NORM_Z) {
+					co[2] += (lifefac * amplit) * mvert[i].no[2] / 32767.0f;
+				}
+			}
+			else {
+				/* move along local z axis */
+				co[2] += lifefac * amplit;
+			}
+		}
+	}
+}
+
 static void waveModifier_do(WaveModifierData *md, 
                             Scene *scene, Object *ob, DerivedMesh *dm,
                             float (*vertexCos)[3], int numVerts)
 {
 	WaveModifierData *wmd = (WaveModifierData *) md;
 	MVert *mvert = NULL;
-	MDeformVert *dvert;
-	int defgrp_index;
+	float *weights;
 	float ctime = BKE_scene_frame_get(scene);
 	float minfac = (float)(1.0 / exp(wmd->width * wmd->narrow * wmd->width * wmd->narrow));
 	float lifefac = wmd->height;
 	float (*tex_co)[3] = NULL;
 	const int wmd_axis = wmd->flag & (MOD_WAVE_X | MOD_WAVE_Y);
 	const float falloff = wmd->falloff;
-	float falloff_fac = 1.0f; /* when falloff == 0.0f this stays at 1.0f */
 
 	if ((wmd->flag & MOD_WAVE_NORM) && (ob->type == OB_MESH))
 		mvert = dm->getVertArray(dm);
@@ -211,8 +330,8 @@ static void waveModifier_do(WaveModifierData *md,
 		wmd->starty = mat[3][1];
 	}
 
-	/* get the index of the deform group */
-	modifier_get_vgroup(ob, dm, wmd->defgrp_name, &dvert, &defgrp_index);
+	/* get the weights of the deform group */
+	weights = modifier_get_vgroup_weights(ob, dm, wmd->defgrp_name, false, numVerts);
 
 	if (wmd->damp == 0) wmd->damp = 10.0f;
 
@@ -236,103 +355,37 @@ static void waveModifier_do(WaveModifierData *md,
 	}
 
 	if (lifefac != 0.0f) {
+		WaveUserdata data = {NULL};
+
+		data.wmd = wmd;
+		data.vertexCos = vertexCos;
+		data.mvert = mvert;
+		data.weights = weights;
+		data.tex_co = (const float (*)[3])tex_co;
+		data.ctime = ctime;
+		data.minfac = minfac;
+		data.lifefac = lifefac;
 		/* avoid divide by zero checks within the loop */
-		float falloff_inv = falloff ? 1.0f / falloff : 1.0f;
-		int i;
-
-		for (i = 0; i < numVerts; i++) {
-			float *co = vertexCos[i];
-			float x = co[0] - wmd->startx;
-			float y = co[1] - wmd->starty;
-			float amplit = 0.0f;
-			float def_weight = 1.0f;
-
-			/* get weights */
-			if (dvert) {
-				def_weight = defvert_find_weight(&dvert[i], defgrp_index);
-
-				/* if this vert isn't in the vgroup, don't deform it */
-				if (def_weight == 0.0f) {
-					continue;
-				}
-			}
+		data.falloff_inv = falloff ? 1.0f / falloff : 1.0f;
+		data.wmd_axis = wmd_axis;
 
-			switch (wmd_axis) {
-				case MOD_WAVE_X | MOD_WAVE_Y:
-					amplit = sqrtf(x * x + y * y);
-					break;
-				case MOD_WAVE_X:
-					amplit = x;
-					break;
-				case MOD_WAVE_Y:
-					amplit = y;
-					break;
-			}
-
-			/* this way it makes nice circles */
-			amplit -= (ctime - wmd->timeoffs) * wmd->speed;
-
-			if (wmd->flag & MOD_WAVE_CYCL) {
-				amplit = (float)fmodf(amplit - wmd->width, 2.0f * wmd->width) +
-				         wmd->width;
-			}
-
-			if (falloff != 0.0f) {
-				float dist = 0.0f;
-
-				switch (wmd_axis) {
-					case MOD_WAVE_X | MOD_WAVE_Y:
-						dist = sqrtf(x * x + y * y);
-						break;
-					case MOD_WAVE_X:
-						dist = fabsf(x);
-						break;
-					case MOD_WAVE_Y:
-						dist = fabsf(y);
-						break;
-				}
-
-				falloff_fac = (1.0f - (dist * falloff_inv));
-				CLAMP(falloff_fac, 0.0f, 1.0f);
-			}
+		if (wmd->texture) {
+			data.pool = BKE_image_pool_new();
+			BKE_texture_fetch_images_for_pool(wmd->texture, data.pool);
+		}
 
-			/* GAUSSIAN */
-			if ((falloff_fac != 0.0f) && (amplit > -wmd->width) && (amplit < wmd->width)) {
-				amplit = amplit * wmd->narrow;
-				amplit = (float)(1.0f / expf(amplit * amplit) - minfac);
-
-				/*apply texture*/
-				if (wmd->texture) {
-					TexResult texres;
-					texres.nor = NULL;
-					BKE_texture_get_value(wmd->modifier.scene, wmd->texture, tex_co[i], &texres, false);
-					amplit *= texres.tin;
-				}
+		modifier_deform_verts_parallel(&data, numVerts, waveModifier_do_chunk);
 
-				/*apply weight & falloff */
-				amplit *= def_weight * falloff_fac;
-
-				if (mvert) {
-					/* move along normals */
-					if (wmd->flag & MOD_WAVE_NORM_X) {
-						co[0] += (lifefac * amplit) * mvert[i].no[0] / 32767.0f;
-					}
-					if (wmd->flag & MOD_WAVE_NORM_Y) {
-						co[1] += (lifefac * amplit) * mvert[i].no[1] / 32767.0f;
-					}
-					if (wmd->flag & MOD_WAVE_NORM_Z) {
-						co[2] += (lifefac * amplit) * mvert[i].no[2] / 32767.0f;
-					}
-				}
-				else {
-					/* move along local z axis */
-					co[2] += lifefac * amplit;
-				}
-			}
+		if (data.pool) {
+			BKE_image_pool_free(data.pool);
 		}
 	}
 
 	if (wmd->texture) MEM_freeN(tex_co);
+
+	if (weights) {
+		MEM_freeN(weights);
+	}
 }
 
 static void deformVerts(ModifierData *md, Object *ob,
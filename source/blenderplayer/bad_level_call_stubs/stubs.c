@@ -781,6 +781,7 @@ void *dualcon(const DualConInput *input_mesh,
               DualConAllocOutput alloc_output,
               DualConAddVert add_vert,
               DualConAddQuad add_quad,
+              DualConParallelRange parallel_range,
 
               DualConFlags flags,
               DualConMode mode,
@@ -0,0 +1,241 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Common/CM_Arena.cpp
+ *  \ingroup common
+ */
+
+#include "CM_Arena.h"
+
+#include "MEM_guardedalloc.h"
+
+#include <algorithm>
+
+thread_local CM_Arena *CM_Arena::m_current = nullptr;
+
+CM_Arena::Scope::Scope(CM_Arena *arena)
+	:m_previous(m_current)
+{
+	BLI_assert(!arena || (!arena->m_closed && arena->CheckOwnerThread()));
+	m_current = arena;
+}
+
+CM_Arena::Scope::~Scope()
+{
+	m_current = m_previous;
+}
+
+CM_Arena::CM_Arena()
+	:m_freeBlocks(SIZE_CLASS_COUNT, nullptr),
+	m_reservedSize(0),
+	m_closed(false),
+	m_scratchSlab(0),
+	m_scratchOffset(0)
+{
+	for (Statistics& stats : m_statistics) {
+		stats = {0, 0, 0};
+	}
+}
+
+CM_Arena::~CM_Arena()
+{
+	BLI_assert(m_current != this);
+
+	// All the blocks are freed, release the slabs at once.
+	for (void *slab : m_slabs) {
+		MEM_freeN(slab);
+	}
+	for (const ScratchSlab& slab : m_scratchSlabs) {
+		MEM_freeN(slab.m_data);
+	}
+}
+
+bool CM_Arena::CheckOwnerThread()
+{
+	const std::thread::id thread = std::this_thread::get_id();
+	if (m_ownerThread == std::thread::id()) {
+		m_ownerThread = thread;
+	}
+
+	return (m_ownerThread == thread);
+}
+
+void *CM_Arena::AllocateBlock(unsigned int sizeClass)
+{
+	FreeNode *node = m_freeBlocks[sizeClass];
+	if (!node) {
+		// Split a new slab in blocks of the size class.
+		const unsigned int blockSize = (sizeClass + 1) << SIZE_CLASS_SHIFT;
+		const unsigned int count = SLAB_SIZE / blockSize;
+		uint8_t *slab = (uint8_t *)MEM_mallocN_aligned(blockSize * count, HEADER_SIZE, "CM_Arena slab");
+		m_slabs.push_back(slab);
+		m_reservedSize += blockSize * count;
+
+		for (unsigned int i = count; i > 0; --i) {
+			FreeNode *block = (FreeNode *)(slab + (i - 1) * blockSize);
+			block->m_next = node;
+			node = block;
+		}
+	}
+
+	m_freeBlocks[sizeClass] = node->m_next;
+	return node;
+}
+
+void CM_Arena::FreeBlock(BlockHeader *header)
+{
+	BLI_assert(CheckOwnerThread());
+
+	const unsigned int sizeClass = header->m_sizeClass;
+	Statistics& stats = m_statistics[header->m_category];
+	--stats.m_live;
+
+	FreeNode *node = (FreeNode *)header;
+	node->m_next = m_freeBlocks[sizeClass];
+	m_freeBlocks[sizeClass] = node;
+}
+
+void *CM_Arena::Allocate(std::size_t size, Category category)
+{
+	BLI_STATIC_ASSERT(sizeof(BlockHeader) <= HEADER_SIZE, "Block header doesn't fit in the header size");
+
+	const std::size_t blockSize = size + HEADER_SIZE;
+
+	CM_Arena *arena = m_current;
+	BlockHeader *header;
+	if (arena && blockSize <= MAX_BLOCK_SIZE) {
+		const unsigned int sizeClass = (blockSize - 1) >> SIZE_CLASS_SHIFT;
+		header = (BlockHeader *)arena->AllocateBlock(sizeClass);
+		header->m_arena = arena;
+		header->m_sizeClass = sizeClass;
+
+		Statistics& stats = arena->m_statistics[category];
+		++stats.m_total;
+		if (++stats.m_live > stats.m_peak) {
+			stats.m_peak = stats.m_live;
+		}
+
+		// Every block keeps its arena alive.
+		arena->AddRef();
+	}
+	else {
+		header = (BlockHeader *)MEM_mallocN_aligned(blockSize, HEADER_SIZE, "CM_Arena heap block");
+		header->m_arena = nullptr;
+		header->m_sizeClass = 0;
+	}
+
+	header->m_category = category;
+
+	return ((uint8_t *)header) + HEADER_SIZE;
+}
+
+void CM_Arena::Free(void *ptr)
+{
+	if (!ptr) {
+		return;
+	}
+
+	BlockHeader *header = (BlockHeader *)(((uint8_t *)ptr) - HEADER_SIZE);
+	CM_Arena *arena = header->m_arena;
+	if (arena) {
+		// A closed arena only waits for its last block to free all the slabs.
+		if (!arena->m_closed.load(std::memory_order_acquire)) {
+			arena->FreeBlock(header);
+		}
+		arena->Release();
+	}
+	else {
+		MEM_freeN(header);
+	}
+}
+
+CM_Arena *CM_Arena::GetCurrent()
+{
+	return m_current;
+}
+
+void *CM_Arena::AllocateScratch(std::size_t size)
+{
+	BLI_assert(CheckOwnerThread());
+
+	size = (size + HEADER_SIZE - 1) & ~((std::size_t)HEADER_SIZE - 1);
+
+	// Move to the next slab big enough, the slabs skipped are used again after the next reset.
+	while (m_scratchSlab < m_scratchSlabs.size() &&
+	       m_scratchOffset + size > m_scratchSlabs[m_scratchSlab].m_size)
+	{
+		++m_scratchSlab;
+		m_scratchOffset = 0;
+	}
+
+	if (m_scratchSlab == m_scratchSlabs.size()) {
+		const std::size_t slabSize = std::max<std::size_t>(SLAB_SIZE, size);
+		uint8_t *data = (uint8_t *)MEM_mallocN_aligned(slabSize, HEADER_SIZE, "CM_Arena scratch slab");
+		m_scratchSlabs.push_back({data, slabSize});
+		m_reservedSize += slabSize;
+		m_scratchOffset = 0;
+	}
+
+	void *ptr = m_scratchSlabs[m_scratchSlab].m_data + m_scratchOffset;
+	m_scratchOffset += size;
+
+	return ptr;
+}
+
+void CM_Arena::ResetScratch()
+{
+	BLI_assert(CheckOwnerThread());
+
+	m_scratchSlab = 0;
+	m_scratchOffset = 0;
+}
+
+void CM_Arena::Close()
+{
+	BLI_assert(m_current != this);
+
+	m_closed.store(true, std::memory_order_release);
+	m_freeBlocks.assign(SIZE_CLASS_COUNT, nullptr);
+}
+
+const CM_Arena::Statistics& CM_Arena::GetStatistics(Category category) const
+{
+	return m_statistics[category];
+}
+
+const char *CM_Arena::GetCategoryName(Category category)
+{
+	static const char *names[CATEGORY_MAX] = {
+		"gameObject",
+		"sceneNode",
+		"sceneController",
+		"logicBrick",
+		"physicsController"
+	};
+
+	return names[category];
+}
+
+std::size_t CM_Arena::GetReservedSize() const
+{
+	return m_reservedSize;
+}
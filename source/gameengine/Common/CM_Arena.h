@@ -0,0 +1,216 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file CM_Arena.h
+ *  \ingroup common
+ */
+
+#ifndef __CM_ARENA_H__
+#define __CM_ARENA_H__
+
+#include "CM_RefCount.h"
+
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+/** \brief Slab allocator of the objects owned by a scene.
+ * Blocks are grouped in size classes of 16 bytes and taken from slabs, freed blocks
+ * are kept in a free list of their size class to be reused by the next allocations.
+ * The slabs are released all together when the arena and all its blocks are freed.
+ *
+ * An arena is used for allocation only when it is the current arena of the thread,
+ * see Scope. Without current arena or for too big objects the heap is used.
+ * Every block references its arena, so a block can be freed from anywhere and
+ * the arena stays alive until the last of its blocks is freed.
+ *
+ * The owner closes the arena on teardown (see Close), the blocks still alive are then
+ * only released and never reused, and the slabs are freed in one pass with the last one.
+ *
+ * Trivially destructible data can also be allocated in a scratch region (see NewScratch),
+ * these allocations are never freed one by one but all at once by ResetScratch.
+ *
+ * An arena is not synchronized: it belongs to the thread which made it current first,
+ * allocations and frees of an open arena must happen on this thread (asserted in debug).
+ * A closed arena can release its blocks from any thread.
+ */
+class CM_Arena : public CM_AtomicRefCount<CM_Arena>
+{
+public:
+	/// The types of object allocated, used for statistics.
+	enum Category {
+		GAME_OBJECT = 0,
+		SCENE_NODE,
+		SCENE_CONTROLLER,
+		LOGIC_BRICK,
+		PHYSICS_CONTROLLER,
+		CATEGORY_MAX
+	};
+
+	struct Statistics {
+		/// Number of allocated blocks.
+		unsigned int m_live;
+		/// Maximum number of blocks allocated at the same time.
+		unsigned int m_peak;
+		/// Number of allocations since the arena creation.
+		unsigned int m_total;
+	};
+
+	/// Make an arena current for the calling thread until the scope exits.
+	class Scope
+	{
+	private:
+		CM_Arena *m_previous;
+
+	public:
+		Scope(CM_Arena *arena);
+		~Scope();
+	};
+
+private:
+	/// Header placed before every block, including heap blocks.
+	struct BlockHeader {
+		/// The owner arena, nullptr for heap blocks.
+		CM_Arena *m_arena;
+		uint32_t m_sizeClass;
+		uint32_t m_category;
+	};
+
+	struct FreeNode {
+		FreeNode *m_next;
+	};
+
+	struct ScratchSlab {
+		uint8_t *m_data;
+		std::size_t m_size;
+	};
+
+	enum {
+		/// Size of the header keeping the objects aligned for SIMD.
+		HEADER_SIZE = 16,
+		SIZE_CLASS_SHIFT = 4,
+		/// Maximum size of a block including the header.
+		MAX_BLOCK_SIZE = 2048,
+		SIZE_CLASS_COUNT = MAX_BLOCK_SIZE >> SIZE_CLASS_SHIFT,
+		SLAB_SIZE = 64 * 1024
+	};
+
+	static thread_local CM_Arena *m_current;
+
+	/// Free blocks per size class.
+	std::vector<FreeNode *> m_freeBlocks;
+	std::vector<void *> m_slabs;
+	std::size_t m_reservedSize;
+	Statistics m_statistics[CATEGORY_MAX];
+	/// No allocation can happen anymore, freed blocks are not put back in the free lists.
+	std::atomic<bool> m_closed;
+	/// The thread allowed to allocate and free in the open arena, set by the first Scope.
+	std::thread::id m_ownerThread;
+
+	/// Slabs of the scratch region, kept for the allocations following a reset.
+	std::vector<ScratchSlab> m_scratchSlabs;
+	/// Slab and offset of the next scratch allocation.
+	unsigned int m_scratchSlab;
+	std::size_t m_scratchOffset;
+
+	void *AllocateBlock(unsigned int sizeClass);
+	void FreeBlock(BlockHeader *header);
+	/// Return true if the calling thread owns the arena, the first caller becomes the owner.
+	bool CheckOwnerThread();
+
+public:
+	CM_Arena();
+	virtual ~CM_Arena();
+
+	/** Allocate an object in the current arena of the thread or in the heap.
+	 * \param size The size of the object.
+	 * \param category The category used for statistics.
+	 * \return A 16 bytes aligned memory.
+	 */
+	static void *Allocate(std::size_t size, Category category);
+	/// Free an object allocated by Allocate.
+	static void Free(void *ptr);
+
+	/// Return the current arena of the thread or nullptr.
+	static CM_Arena *GetCurrent();
+
+	/** Allocate memory in the scratch region, valid until the next call to ResetScratch.
+	 * \param size The size of the memory.
+	 * \return A 16 bytes aligned memory.
+	 */
+	void *AllocateScratch(std::size_t size);
+	/// Release all the scratch allocations at once, the memory is kept for the next allocations.
+	void ResetScratch();
+
+	/// Construct an object in the scratch region, it is never destructed.
+	template <class T, class ... Args>
+	T *NewScratch(Args&& ... args)
+	{
+		static_assert(std::is_trivially_destructible<T>::value, "Scratch objects are released without destruction");
+		return new (AllocateScratch(sizeof(T))) T(std::forward<Args>(args) ...);
+	}
+
+	/** Stop allocating in the arena and drop the free lists, called by the owner on teardown
+	 * before its release. The slabs are freed right away once all the blocks are freed.
+	 */
+	void Close();
+
+	const Statistics& GetStatistics(Category category) const;
+	static const char *GetCategoryName(Category category);
+
+	/// Return the number of bytes reserved in slabs.
+	std::size_t GetReservedSize() const;
+};
+
+/** \brief Class overloading new and delete to allocate its instances with CM_Arena.
+ * \param category The category of the class used for statistics.
+ */
+template <CM_Arena::Category category>
+class CM_ArenaObject
+{
+public:
+	static void *operator new(std::size_t size)
+	{
+		return CM_Arena::Allocate(size, category);
+	}
+
+	static void operator delete(void *ptr)
+	{
+		CM_Arena::Free(ptr);
+	}
+
+	static void *operator new(std::size_t UNUSED(size), void *place)
+	{
+		return place;
+	}
+
+	static void operator delete(void *UNUSED(ptr), void *UNUSED(place))
+	{
+	}
+};
+
+#endif  // __CM_ARENA_H__
@@ -29,6 +29,8 @@
 
 #include "BLI_utildefines.h"
 
+#include <atomic>
+
 /** \brief Reference counter base class. This class manages the destruction of an object
  * based on a reference counter, when the counter is to zero the object is destructed.
  */
@@ -81,6 +83,58 @@ public:
 	}
 };
 
+/** \brief Reference counter base class safe to use from several threads at once.
+ * Only for objects shared between threads, the counter costs an atomic operation.
+ */
+template <class T>
+class CM_AtomicRefCount
+{
+private:
+	std::atomic<int> m_refCount;
+
+public:
+	CM_AtomicRefCount()
+		:m_refCount(1)
+	{
+	}
+
+	virtual ~CM_AtomicRefCount()
+	{
+	}
+
+	CM_AtomicRefCount(const CM_AtomicRefCount& UNUSED(other))
+		:m_refCount(1)
+	{
+	}
+
+	/// Increase the reference count of the object.
+	T *AddRef()
+	{
+		BLI_assert(m_refCount > 0);
+		m_refCount.fetch_add(1, std::memory_order_relaxed);
+
+		return static_cast<T *>(this);
+	}
+
+	/// Decrease the reference count of the object and destruct at zero.
+	T *Release()
+	{
+		BLI_assert(m_refCount > 0);
+		// Other threads' changes to the object must be visible to the one destructing it.
+		if (m_refCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			delete this;
+			return nullptr;
+		}
+
+		return static_cast<T *>(this);
+	}
+
+	int GetRefCount() const
+	{
+		return m_refCount.load(std::memory_order_relaxed);
+	}
+};
+
 /** Increase the reference count of a object. Used in case of multiple levels
  * inheritance in the goal to return the value back.
  */
@@ -157,6 +157,7 @@ bool BL_ActionActuator::Update(double curtime)
 			EXP_Value *newval = new EXP_FloatValue(obj->GetActionFrame(m_layer));
 			if (oldprop) {
 				oldprop->SetValue(newval);
+				obj->WakePropertySensors(m_framepropname);
 			}
 			else {
 				obj->SetProperty(m_framepropname, newval);
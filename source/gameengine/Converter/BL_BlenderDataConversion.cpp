@@ -408,6 +408,19 @@ static RAS_MaterialBucket *BL_ConvertMaterial(Material *ma, int lightlayer, KX_S
 }
 
 /* blenderobj can be nullptr, make sure its checked for */
+/// Return true if a texture of the material uses the normal or tangent as texture coordinates.
+static bool BL_MaterialUsesNormalTexco(Material *ma)
+{
+	for (unsigned short i = 0; i < MAX_MTEX; ++i) {
+		MTex *mtex = ma->mtex[i];
+		if (mtex && (mtex->texco & (TEXCO_NORM | TEXCO_TANGENT))) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
 KX_Mesh *BL_ConvertMesh(Mesh *me, Object *blenderobj, KX_Scene *scene, BL_SceneConverter& converter)
 {
 	KX_Mesh *meshobj;
@@ -476,6 +489,12 @@ KX_Mesh *BL_ConvertMesh(Mesh *me, Object *blenderobj, KX_Scene *scene, BL_SceneC
 		RAS_IPolyMaterial *mat = meshmat->GetBucket()->GetPolyMaterial();
 
 		mats[i] = {meshmat->GetDisplayArray(), bucket, mat->IsVisible(), mat->IsTwoSided(), mat->IsCollider(), mat->IsWire()};
+
+		/* Upload packed normals and tangents, unless a texture reads them as texture coordinates:
+		 * glTexCoordPointer doesn't normalize integer data. */
+		if (!BL_MaterialUsesNormalTexco(ma)) {
+			mats[i].array->SetStorageFormat(RAS_IDisplayArray::STORAGE_COMPACT);
+		}
 	}
 
 	BL_ConvertDerivedMeshToArray(dm, me, mats, layersInfo);
@@ -189,7 +189,7 @@ void BL_ConvertSensors(struct Object *blenderobject,
 				}
 				case SENS_MESSAGE:
 				{
-					SCA_EventManager *eventmgr = logicmgr->FindEventManager(SCA_EventManager::BASIC_EVENTMGR);
+					SCA_EventManager *eventmgr = logicmgr->FindEventManager(SCA_EventManager::NETWORK_EVENTMGR);
 					bMessageSensor *msgSens = (bMessageSensor *)sens->data;
 
 					/* Get our NetworkScene */
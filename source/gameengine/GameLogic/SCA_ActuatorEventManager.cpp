@@ -50,9 +50,7 @@ SCA_ActuatorEventManager::~SCA_ActuatorEventManager()
 void SCA_ActuatorEventManager::NextFrame()
 {
 	// check for changed actuator
-	for (SCA_ISensor *sensor : m_sensors) {
-		sensor->Activate(m_logicmgr);
-	}
+	ActivateSensors();
 }
 
 void SCA_ActuatorEventManager::UpdateFrame()
@@ -49,8 +49,6 @@ SCA_BasicEventManager::~SCA_BasicEventManager()
 
 void SCA_BasicEventManager::NextFrame()
 {
-	for (SCA_ISensor *sensor : m_sensors) {
-		sensor->Activate(m_logicmgr);
-	}
+	ActivateSensors();
 }
 
@@ -47,18 +47,55 @@ SCA_EventManager::~SCA_EventManager()
 {
 	// all sensors should be removed
 	BLI_assert(m_sensors.empty());
+	BLI_assert(m_wakeSensors.empty());
 }
 
 bool SCA_EventManager::RegisterSensor(class SCA_ISensor *sensor)
 {
-	return CM_ListAddIfNotFound(m_sensors, sensor);
+	if (CM_ListAddIfNotFound(m_sensors, sensor)) {
+		// A newly registered sensor is always evaluated at least once.
+		WakeSensor(sensor);
+		return true;
+	}
+	return false;
 }
 
 bool SCA_EventManager::RemoveSensor(class SCA_ISensor *sensor)
 {
+	if (sensor->IsAwake()) {
+		CM_ListRemoveIfFound(m_wakeSensors, sensor);
+		sensor->SetAwake(false);
+	}
 	return CM_ListRemoveIfFound(m_sensors, sensor);
 }
 
+void SCA_EventManager::WakeSensor(SCA_ISensor *sensor)
+{
+	if (!sensor->IsAwake()) {
+		sensor->SetAwake(true);
+		m_wakeSensors.push_back(sensor);
+	}
+}
+
+void SCA_EventManager::ActivateSensors()
+{
+	/* Sensors are moved out of the wake list before their evaluation, the ones
+	 * which still need to be polled are queued back for the next frame. */
+	m_activeSensors.swap(m_wakeSensors);
+	for (SCA_ISensor *sensor : m_activeSensors) {
+		sensor->SetAwake(false);
+	}
+
+	for (SCA_ISensor *sensor : m_activeSensors) {
+		sensor->Activate(m_logicmgr);
+		if (sensor->NeedsPolling()) {
+			WakeSensor(sensor);
+		}
+	}
+
+	m_activeSensors.clear();
+}
+
 void SCA_EventManager::NextFrame(double curtime, double fixedtime)
 {
 	NextFrame();
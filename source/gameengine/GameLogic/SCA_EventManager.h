@@ -45,6 +45,17 @@ protected:
 
 	std::vector<SCA_ISensor *> m_sensors;
 
+	/** Sensors to evaluate on the next call to ActivateSensors(). Sensors needing
+	 * an evaluation each frame stay in this list, event driven sensors are only
+	 * added when woken by their event manager.
+	 */
+	std::vector<SCA_ISensor *> m_wakeSensors;
+	/// Sensors evaluated during the current call to ActivateSensors(), kept to reuse memory.
+	std::vector<SCA_ISensor *> m_activeSensors;
+
+	/// Evaluate all the sensors of the wake list.
+	void ActivateSensors();
+
 public:
 	enum EVENT_MANAGER_TYPE {
 		KEYBOARD_EVENTMGR = 0,
@@ -70,6 +81,8 @@ public:
 	virtual void    UpdateFrame();
 	virtual void	EndFrame();
 	virtual bool	RegisterSensor(class SCA_ISensor* sensor);
+	/// Request an evaluation of a registered sensor on the next frame.
+	void	WakeSensor(SCA_ISensor *sensor);
 	int		GetType();
 
 protected:
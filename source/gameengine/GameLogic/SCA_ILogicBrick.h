@@ -36,11 +36,13 @@
 #include "SCA_IObject.h"
 #include "EXP_BoolValue.h"
 
+#include "CM_Arena.h"
+
 class KX_NetworkMessageScene;
 class SCA_IScene;
 class SCA_LogicManager;
 
-class SCA_ILogicBrick : public EXP_Value, public SG_QList
+class SCA_ILogicBrick : public EXP_Value, public SG_QList, public CM_ArenaObject<CM_Arena::LOGIC_BRICK>
 {
 	Py_Header
 protected:
@@ -34,6 +34,7 @@
 
 #include "SCA_IObject.h"
 #include "SCA_ISensor.h"
+#include "SCA_PropertySensor.h"
 #include "SCA_IController.h"
 #include "SCA_IActuator.h"
 #include "EXP_ListValue.h"
@@ -205,6 +206,32 @@ void SCA_IObject::ReParentLogic()
 	}
 }
 
+void SCA_IObject::SetProperty(const std::string& name, EXP_Value *ioProperty)
+{
+	EXP_Value::SetProperty(name, ioProperty);
+	WakePropertySensors(name);
+}
+
+bool SCA_IObject::RemoveProperty(const std::string& inName)
+{
+	if (EXP_Value::RemoveProperty(inName)) {
+		WakePropertySensors(inName);
+		return true;
+	}
+	return false;
+}
+
+void SCA_IObject::WakePropertySensors(const std::string& name)
+{
+	for (SCA_ISensor *sensor : m_sensors) {
+		if (sensor->GetSensorType() == SCA_ISensor::ST_PROPERTY &&
+		    static_cast<SCA_PropertySensor *>(sensor)->GetPropertyName() == name)
+		{
+			sensor->Wake();
+		}
+	}
+}
+
 SCA_ISensor *SCA_IObject::FindSensor(const std::string& sensorname)
 {
 	for (SCA_ISensor *sensor : m_sensors) {
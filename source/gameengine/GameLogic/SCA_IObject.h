@@ -131,6 +131,13 @@ public:
 
 	virtual void ReParentLogic();
 
+	virtual void SetProperty(const std::string& name, EXP_Value *ioProperty);
+	virtual bool RemoveProperty(const std::string& inName);
+	/** Request an evaluation of the property sensors checking the property \a name,
+	 * to call after the property value is changed in place.
+	 */
+	void WakePropertySensors(const std::string& name);
+
 	/// Suspend all progress.
 	void SuspendLogic();
 
@@ -61,7 +61,8 @@ SCA_ISensor::SCA_ISensor(SCA_IObject *gameobj, SCA_EventManager *eventmgr)
 	m_suspended(false),
 	m_links(0),
 	m_state(false),
-	m_prev_state(false)
+	m_prev_state(false),
+	m_awake(false)
 {
 }
 
@@ -73,6 +74,7 @@ void SCA_ISensor::ProcessReplica()
 {
 	SCA_ILogicBrick::ProcessReplica();
 	m_linkedcontrollers.clear();
+	m_awake = false;
 }
 
 bool SCA_ISensor::IsPositiveTrigger()
@@ -134,6 +136,7 @@ bool SCA_ISensor::IsSuspended()
 void SCA_ISensor::Resume()
 {
 	m_suspended = false;
+	Wake();
 }
 
 bool SCA_ISensor::GetState()
@@ -173,6 +176,34 @@ bool SCA_ISensor::IsNoLink() const
 	return !m_links;
 }
 
+bool SCA_ISensor::IsSettled() const
+{
+	return !m_pos_pulsemode && !m_neg_pulsemode && !m_tap && !m_level && !m_reset && (m_state == m_prev_state);
+}
+
+bool SCA_ISensor::NeedsPolling() const
+{
+	return true;
+}
+
+void SCA_ISensor::Wake()
+{
+	// Only sensors registered to their manager can be evaluated.
+	if (m_links) {
+		m_eventmgr->WakeSensor(this);
+	}
+}
+
+bool SCA_ISensor::IsAwake() const
+{
+	return m_awake;
+}
+
+void SCA_ISensor::SetAwake(bool awake)
+{
+	m_awake = awake;
+}
+
 void SCA_ISensor::Init()
 {
 	CM_LogicBrickError(this, "sensor " << m_name << " has no init function, please report this bug to Blender.org");
@@ -334,6 +365,7 @@ EXP_PYMETHODDEF_DOC_NOARGS(SCA_ISensor, reset,
 {
 	Init();
 	m_prev_state = false;
+	Wake();
 	Py_RETURN_NONE;
 }
 
@@ -369,10 +401,10 @@ PyMethodDef SCA_ISensor::Methods[] = {
 };
 
 PyAttributeDef SCA_ISensor::Attributes[] = {
-	EXP_PYATTRIBUTE_BOOL_RW("usePosPulseMode", SCA_ISensor, m_pos_pulsemode),
-	EXP_PYATTRIBUTE_BOOL_RW("useNegPulseMode", SCA_ISensor, m_neg_pulsemode),
+	EXP_PYATTRIBUTE_BOOL_RW_CHECK("usePosPulseMode", SCA_ISensor, m_pos_pulsemode, pyattr_check_wake),
+	EXP_PYATTRIBUTE_BOOL_RW_CHECK("useNegPulseMode", SCA_ISensor, m_neg_pulsemode, pyattr_check_wake),
 	EXP_PYATTRIBUTE_INT_RW("skippedTicks", 0, 100000, true, SCA_ISensor, m_skipped_ticks),
-	EXP_PYATTRIBUTE_BOOL_RW("invert", SCA_ISensor, m_invert),
+	EXP_PYATTRIBUTE_BOOL_RW_CHECK("invert", SCA_ISensor, m_invert, pyattr_check_wake),
 	EXP_PYATTRIBUTE_BOOL_RW_CHECK("level", SCA_ISensor, m_level, pyattr_check_level),
 	EXP_PYATTRIBUTE_BOOL_RW_CHECK("tap", SCA_ISensor, m_tap, pyattr_check_tap),
 	EXP_PYATTRIBUTE_RO_FUNCTION("triggered", SCA_ISensor, pyattr_get_triggered),
@@ -437,6 +469,7 @@ int SCA_ISensor::pyattr_check_level(EXP_PyObjectPlus *self_v, const EXP_PYATTRIB
 	if (self->m_level) {
 		self->m_tap = false;
 	}
+	self->Wake();
 	return 0;
 }
 
@@ -446,6 +479,15 @@ int SCA_ISensor::pyattr_check_tap(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUT
 	if (self->m_tap) {
 		self->m_level = false;
 	}
+	self->Wake();
+	return 0;
+}
+
+int SCA_ISensor::pyattr_check_wake(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+	SCA_ISensor *self = static_cast<SCA_ISensor *>(self_v);
+	// The settings changed, the sensor output may change without any new event.
+	self->Wake();
 	return 0;
 }
 
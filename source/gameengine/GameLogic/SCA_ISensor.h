@@ -90,8 +90,16 @@ protected:
 	/// Previous state (for tap option).
 	bool m_prev_state;
 
+	/// Sensor is in the wake list of its event manager.
+	bool m_awake;
+
 	std::vector<SCA_IController *> m_linkedcontrollers;
 
+	/** Return true if the pulse, tap or level modes or the last state transition
+	 * don't require any evaluation without a new event.
+	 */
+	bool IsSettled() const;
+
 public:
 
 	enum sensortype {
@@ -99,6 +107,7 @@ public:
 		ST_TOUCH,
 		ST_NEAR,
 		ST_RADAR,
+		ST_PROPERTY,
 		// to be updated as needed
 	};
 
@@ -131,6 +140,16 @@ public:
 	void SetLevel(bool lvl);
 	void SetTap(bool tap);
 
+	/** Return true if the sensor must be evaluated on the next frame even if its event
+	 * manager doesn't signal any event to it. The default implementation always polls,
+	 * event driven sensors override it to be skipped on frames without activity.
+	 */
+	virtual bool NeedsPolling() const;
+	/// Request an evaluation of the sensor on the next frame.
+	void Wake();
+	bool IsAwake() const;
+	void SetAwake(bool awake);
+
 	virtual void RegisterToManager();
 	virtual void UnregisterToManager();
 	void Replace_EventManager(SCA_LogicManager *logicmgr);
@@ -184,6 +203,7 @@ public:
 
 	static int pyattr_check_level(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef);
 	static int pyattr_check_tap(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef);
+	static int pyattr_check_wake(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef);
 
 	enum SensorStatus {
 		KX_SENSOR_INACTIVE = 0,
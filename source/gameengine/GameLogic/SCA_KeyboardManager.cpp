@@ -37,6 +37,9 @@
 #include "SCA_KeyboardManager.h"
 #include "SCA_KeyboardSensor.h"
 #include "EXP_IntValue.h"
+
+#include "CM_List.h"
+
 #include <vector>
 
 SCA_KeyboardManager::SCA_KeyboardManager(SCA_LogicManager *logicmgr,
@@ -61,9 +64,76 @@ SCA_IInputDevice *SCA_KeyboardManager::GetInputDevice()
 
 
 
+void SCA_KeyboardManager::AddKeySensor(SCA_KeyboardSensor *sensor)
+{
+	if (sensor->IsAllKeys()) {
+		m_allKeysSensors.push_back(sensor);
+		return;
+	}
+
+	const int keys[3] = {sensor->GetHotKey(), sensor->GetQual(), sensor->GetQual2()};
+	for (unsigned short i = 0; i < 3; ++i) {
+		const int key = keys[i];
+		// Qualifiers are optional, the main key is always registered.
+		if ((i == 0 || key > 0) && key >= 0 && key <= SCA_IInputDevice::ENDKEY) {
+			CM_ListAddIfNotFound(m_keySensors[key], sensor);
+		}
+	}
+}
+
+void SCA_KeyboardManager::RemoveKeySensor(SCA_KeyboardSensor *sensor)
+{
+	CM_ListRemoveIfFound(m_allKeysSensors, sensor);
+	for (std::vector<SCA_KeyboardSensor *>& sensors : m_keySensors) {
+		CM_ListRemoveIfFound(sensors, sensor);
+	}
+}
+
+bool SCA_KeyboardManager::RegisterSensor(SCA_ISensor *sensor)
+{
+	if (SCA_EventManager::RegisterSensor(sensor)) {
+		AddKeySensor(static_cast<SCA_KeyboardSensor *>(sensor));
+		return true;
+	}
+	return false;
+}
+
+bool SCA_KeyboardManager::RemoveSensor(SCA_ISensor *sensor)
+{
+	if (SCA_EventManager::RemoveSensor(sensor)) {
+		RemoveKeySensor(static_cast<SCA_KeyboardSensor *>(sensor));
+		return true;
+	}
+	return false;
+}
+
+void SCA_KeyboardManager::UpdateKeySensor(SCA_KeyboardSensor *sensor)
+{
+	RemoveKeySensor(sensor);
+	AddKeySensor(sensor);
+	sensor->Wake();
+}
+
 void SCA_KeyboardManager::NextFrame()
 {
-	for (SCA_ISensor *sensor : m_sensors) {
-		sensor->Activate(m_logicmgr);
+	// Wake only the sensors waiting for the keys which received events.
+	bool events = false;
+	for (unsigned short i = 0; i <= SCA_IInputDevice::ENDKEY; ++i) {
+		const SCA_InputEvent& input = m_inputDevice->GetInput((SCA_IInputDevice::SCA_EnumInputs)i);
+		if (!input.m_queue.empty()) {
+			// Only key inputs wake the sensors using all keys.
+			events |= (i >= SCA_IInputDevice::BEGINKEY);
+			for (SCA_KeyboardSensor *sensor : m_keySensors[i]) {
+				WakeSensor(sensor);
+			}
+		}
 	}
+
+	if (events) {
+		for (SCA_KeyboardSensor *sensor : m_allKeysSensors) {
+			WakeSensor(sensor);
+		}
+	}
+
+	ActivateSensors();
 }
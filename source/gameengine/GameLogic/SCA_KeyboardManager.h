@@ -39,15 +39,29 @@
 #include "SCA_IInputDevice.h"
 
 
+class SCA_KeyboardSensor;
+
 class SCA_KeyboardManager : public SCA_EventManager
 {
 	class	SCA_IInputDevice*				m_inputDevice;
-	
+
+	/// Sensors interested in events of each key, indexed by SCA_IInputDevice::SCA_EnumInputs.
+	std::vector<SCA_KeyboardSensor *> m_keySensors[SCA_IInputDevice::ENDKEY + 1];
+	/// Sensors interested in events of any key.
+	std::vector<SCA_KeyboardSensor *> m_allKeysSensors;
+
+	void AddKeySensor(SCA_KeyboardSensor *sensor);
+	void RemoveKeySensor(SCA_KeyboardSensor *sensor);
+
 public:
 	SCA_KeyboardManager(class SCA_LogicManager* logicmgr,class SCA_IInputDevice* inputdev);
 	virtual ~SCA_KeyboardManager();
 
 	virtual void 	NextFrame();
+	virtual bool	RegisterSensor(SCA_ISensor *sensor);
+	virtual bool	RemoveSensor(SCA_ISensor *sensor);
+	/// Update the keys a registered sensor is waiting events for.
+	void UpdateKeySensor(SCA_KeyboardSensor *sensor);
 	SCA_IInputDevice* GetInputDevice();
 };
 
@@ -108,6 +108,32 @@ bool SCA_KeyboardSensor::IsPositiveTrigger()
 	return result;
 }
 
+bool SCA_KeyboardSensor::NeedsPolling() const
+{
+	// The keystrokes logging depends on a property value, not on key events.
+	return !IsSettled() || !m_toggleprop.empty();
+}
+
+int SCA_KeyboardSensor::GetHotKey() const
+{
+	return m_hotkey;
+}
+
+short int SCA_KeyboardSensor::GetQual() const
+{
+	return m_qual;
+}
+
+short int SCA_KeyboardSensor::GetQual2() const
+{
+	return m_qual2;
+}
+
+bool SCA_KeyboardSensor::IsAllKeys() const
+{
+	return m_bAllKeys;
+}
+
 bool SCA_KeyboardSensor::Evaluate()
 {
 	bool result    = false;
@@ -306,16 +332,33 @@ PyMethodDef SCA_KeyboardSensor::Methods[] = {
 PyAttributeDef SCA_KeyboardSensor::Attributes[] = {
 	EXP_PYATTRIBUTE_RO_FUNCTION("events", SCA_KeyboardSensor, pyattr_get_events),
 	EXP_PYATTRIBUTE_RO_FUNCTION("inputs", SCA_KeyboardSensor, pyattr_get_inputs),
-	EXP_PYATTRIBUTE_BOOL_RW("useAllKeys", SCA_KeyboardSensor, m_bAllKeys),
-	EXP_PYATTRIBUTE_INT_RW("key", 0, SCA_IInputDevice::ENDKEY, true, SCA_KeyboardSensor, m_hotkey),
-	EXP_PYATTRIBUTE_SHORT_RW("hold1", 0, SCA_IInputDevice::ENDKEY, true, SCA_KeyboardSensor, m_qual),
-	EXP_PYATTRIBUTE_SHORT_RW("hold2", 0, SCA_IInputDevice::ENDKEY, true, SCA_KeyboardSensor, m_qual2),
-	EXP_PYATTRIBUTE_STRING_RW("toggleProperty", 0, MAX_PROP_NAME, false, SCA_KeyboardSensor, m_toggleprop),
+	EXP_PYATTRIBUTE_BOOL_RW_CHECK("useAllKeys", SCA_KeyboardSensor, m_bAllKeys, pyattr_check_keys),
+	EXP_PYATTRIBUTE_INT_RW_CHECK("key", 0, SCA_IInputDevice::ENDKEY, true, SCA_KeyboardSensor, m_hotkey, pyattr_check_keys),
+	EXP_PYATTRIBUTE_SHORT_RW_CHECK("hold1", 0, SCA_IInputDevice::ENDKEY, true, SCA_KeyboardSensor, m_qual, pyattr_check_keys),
+	EXP_PYATTRIBUTE_SHORT_RW_CHECK("hold2", 0, SCA_IInputDevice::ENDKEY, true, SCA_KeyboardSensor, m_qual2, pyattr_check_keys),
+	EXP_PYATTRIBUTE_STRING_RW_CHECK("toggleProperty", 0, MAX_PROP_NAME, false, SCA_KeyboardSensor, m_toggleprop, pyattr_check_toggle),
 	EXP_PYATTRIBUTE_STRING_RW("targetProperty", 0, MAX_PROP_NAME, false, SCA_KeyboardSensor, m_targetprop),
 	EXP_PYATTRIBUTE_NULL    //Sentinel
 };
 
 
+int SCA_KeyboardSensor::pyattr_check_keys(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+	SCA_KeyboardSensor *self = static_cast<SCA_KeyboardSensor *>(self_v);
+	// Only sensors registered to the manager are indexed by keys.
+	if (!self->IsNoLink()) {
+		static_cast<SCA_KeyboardManager *>(self->m_eventmgr)->UpdateKeySensor(self);
+	}
+	return 0;
+}
+
+int SCA_KeyboardSensor::pyattr_check_toggle(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+	SCA_KeyboardSensor *self = static_cast<SCA_KeyboardSensor *>(self_v);
+	self->Wake();
+	return 0;
+}
+
 PyObject *SCA_KeyboardSensor::pyattr_get_inputs(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef)
 {
 	SCA_KeyboardSensor *self = static_cast<SCA_KeyboardSensor *>(self_v);
@@ -93,6 +93,12 @@ public:
 
 	virtual bool Evaluate();
 	virtual bool IsPositiveTrigger();
+	virtual bool NeedsPolling() const;
+
+	int GetHotKey() const;
+	short int GetQual() const;
+	short int GetQual2() const;
+	bool IsAllKeys() const;
 
 #ifdef WITH_PYTHON
 	/* --------------------------------------------------------------------- */
@@ -106,6 +112,8 @@ public:
 	
 	static PyObject*	pyattr_get_events(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef);
 	static PyObject*	pyattr_get_inputs(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef);
+	static int			pyattr_check_keys(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef);
+	static int			pyattr_check_toggle(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef);
 #endif
 };
 
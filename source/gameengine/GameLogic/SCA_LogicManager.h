@@ -49,7 +49,8 @@ typedef std::map<class SCA_ISensor*,controllerlist > sensormap_t;
 /**
  * This manager handles sensor, controllers and actuators.
  * logic executes each frame the following way:
- * find triggering sensors
+ * find triggering sensors (event managers only evaluate the sensors woken
+ * by an event or still needing to be polled, see SCA_EventManager::WakeSensor)
  * build list of controllers that are triggered by these triggering sensors
  * process all triggered controllers
  * during this phase actuators can be added to the active actuator list
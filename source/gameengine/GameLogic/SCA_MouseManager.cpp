@@ -86,9 +86,9 @@ void SCA_MouseManager::NextFrame()
 
 				mousesensor->setX(mx);
 				mousesensor->setY(my);
-
-				mousesensor->Activate(m_logicmgr);
 			}
 		}
+
+		ActivateSensors();
 	}
 }
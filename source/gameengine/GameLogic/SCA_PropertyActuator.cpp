@@ -71,7 +71,7 @@ bool SCA_PropertyActuator::Update()
 
 	bool bNegativeEvent = IsNegativeEvent();
 	RemoveAllEvents();
-	EXP_Value *propowner = GetParent();
+	SCA_IObject *propowner = GetParent();
 
 	if (bNegativeEvent) {
 		if (m_type == KX_ACT_PROP_LEVEL) {
@@ -79,6 +79,7 @@ bool SCA_PropertyActuator::Update()
 			EXP_Value *oldprop = propowner->GetProperty(m_propname);
 			if (oldprop) {
 				oldprop->SetValue(newval);
+				propowner->WakePropertySensors(m_propname);
 			}
 			newval->Release();
 		}
@@ -98,6 +99,7 @@ bool SCA_PropertyActuator::Update()
 		if (oldprop) {
 			newval = new EXP_BoolValue((oldprop->GetNumber() == 0.0) ? true : false);
 			oldprop->SetValue(newval);
+			propowner->WakePropertySensors(m_propname);
 		}
 		else { /* as not been assigned, evaluate as false, so assign true */
 			newval = new EXP_BoolValue(true);
@@ -110,6 +112,7 @@ bool SCA_PropertyActuator::Update()
 		EXP_Value *oldprop = propowner->GetProperty(m_propname);
 		if (oldprop) {
 			oldprop->SetValue(newval);
+			propowner->WakePropertySensors(m_propname);
 		}
 		else {
 			propowner->SetProperty(m_propname, newval);
@@ -126,6 +129,7 @@ bool SCA_PropertyActuator::Update()
 				EXP_Value *oldprop = propowner->GetProperty(m_propname);
 				if (oldprop) {
 					oldprop->SetValue(newval);
+					propowner->WakePropertySensors(m_propname);
 				}
 				else {
 					propowner->SetProperty(m_propname, newval);
@@ -143,6 +147,7 @@ bool SCA_PropertyActuator::Update()
 
 					EXP_Value *newprop = expr->Calculate();
 					oldprop->SetValue(newprop);
+					propowner->WakePropertySensors(m_propname);
 					newprop->Release();
 					expr->Release();
 
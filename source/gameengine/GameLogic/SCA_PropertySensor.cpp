@@ -253,6 +253,23 @@ EXP_Value *SCA_PropertySensor::FindIdentifier(const std::string& identifiername)
 	return GetParent()->FindIdentifier(identifiername);
 }
 
+bool SCA_PropertySensor::NeedsPolling() const
+{
+	if (!IsSettled()) {
+		return true;
+	}
+
+	/* The owner wakes the sensor when the property is set, but timer properties
+	 * are incremented in place by the time event manager every frame. */
+	EXP_Value *orgprop = m_gameobj->GetProperty(m_checkpropname);
+	return (orgprop && orgprop->GetProperty("timer"));
+}
+
+const std::string& SCA_PropertySensor::GetPropertyName() const
+{
+	return m_checkpropname;
+}
+
 #ifdef WITH_PYTHON
 
 /* ------------------------------------------------------------------------- */
@@ -266,6 +283,18 @@ int SCA_PropertySensor::validValueForProperty(EXP_PyObjectPlus *self, const PyAt
 	 * function directly */
 
 	/*  There is no type checking at this moment, unfortunately...           */
+	static_cast<SCA_PropertySensor *>(self)->Wake();
+	return 0;
+}
+
+int SCA_PropertySensor::checkPropertyName(EXP_PyObjectPlus *self, const PyAttributeDef *attrdef)
+{
+	if (CheckProperty(self, attrdef) != 0) {
+		return 1;
+	}
+
+	// Now checking a different property, its value isn't known yet.
+	static_cast<SCA_PropertySensor *>(self)->Wake();
 	return 0;
 }
 
@@ -297,8 +326,8 @@ PyMethodDef SCA_PropertySensor::Methods[] = {
 };
 
 PyAttributeDef SCA_PropertySensor::Attributes[] = {
-	EXP_PYATTRIBUTE_INT_RW("mode", KX_PROPSENSOR_NODEF, KX_PROPSENSOR_MAX - 1, false, SCA_PropertySensor, m_checktype),
-	EXP_PYATTRIBUTE_STRING_RW_CHECK("propName", 0, MAX_PROP_NAME, false, SCA_PropertySensor, m_checkpropname, CheckProperty),
+	EXP_PYATTRIBUTE_INT_RW_CHECK("mode", KX_PROPSENSOR_NODEF, KX_PROPSENSOR_MAX - 1, false, SCA_PropertySensor, m_checktype, pyattr_check_wake),
+	EXP_PYATTRIBUTE_STRING_RW_CHECK("propName", 0, MAX_PROP_NAME, false, SCA_PropertySensor, m_checkpropname, checkPropertyName),
 	EXP_PYATTRIBUTE_STRING_RW_CHECK("value", 0, 100, false, SCA_PropertySensor, m_checkpropval, validValueForProperty),
 	EXP_PYATTRIBUTE_STRING_RW_CHECK("min", 0, 100, false, SCA_PropertySensor, m_checkpropval, validValueForProperty),
 	EXP_PYATTRIBUTE_STRING_RW_CHECK("max", 0, 100, false, SCA_PropertySensor, m_checkpropmaxval, validValueForProperty),
@@ -78,8 +78,12 @@ public:
 
 	virtual bool Evaluate();
 	virtual bool	IsPositiveTrigger();
+	virtual bool NeedsPolling() const;
+	virtual sensortype GetSensorType() { return ST_PROPERTY; }
 	virtual EXP_Value*		FindIdentifier(const std::string& identifiername);
 
+	const std::string& GetPropertyName() const;
+
 #ifdef WITH_PYTHON
 
 	/* --------------------------------------------------------------------- */
@@ -90,6 +94,7 @@ public:
 	 * Test whether this is a sensible value (type check)
 	 */
 	static int validValueForProperty(EXP_PyObjectPlus *self, const PyAttributeDef*);
+	static int checkPropertyName(EXP_PyObjectPlus *self, const PyAttributeDef *attrdef);
 
 #endif
 };
@@ -261,6 +261,7 @@ bool SCA_RandomActuator::Update()
 	EXP_Value *prop = GetParent()->GetProperty(m_propname);
 	if (prop) {
 		prop->SetValue(tmpval);
+		GetParent()->WakePropertySensors(m_propname);
 	}
 	tmpval->Release();
 
@@ -0,0 +1,61 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2001-2002 by NaN Holding BV.
+ * All rights reserved.
+ *
+ * The Original Code is: all of this file.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ * Ketsji Logic Extension: Network Event Manager generic implementation
+ */
+
+/** \file gameengine/Ketsji/KXNetwork/KX_NetworkEventManager.cpp
+ *  \ingroup ketsjinet
+ */
+
+#include "KX_NetworkEventManager.h"
+#include "KX_NetworkMessageScene.h"
+#include "KX_NetworkMessageSensor.h"
+#include "SCA_IObject.h"
+
+KX_NetworkEventManager::KX_NetworkEventManager(SCA_LogicManager *logicmgr, KX_NetworkMessageScene *networkScene)
+	:SCA_EventManager(logicmgr, NETWORK_EVENTMGR),
+	m_networkScene(networkScene)
+{
+}
+
+KX_NetworkEventManager::~KX_NetworkEventManager()
+{
+}
+
+void KX_NetworkEventManager::NextFrame()
+{
+	// Wake only the sensors which can receive one of the messages sent during the last frame.
+	if (m_networkScene->HasMessages()) {
+		for (SCA_ISensor *sensor : m_sensors) {
+			const std::string& subject = static_cast<KX_NetworkMessageSensor *>(sensor)->GetSubject();
+			if (m_networkScene->HasMessages(sensor->GetParent()->GetName(), subject)) {
+				WakeSensor(sensor);
+			}
+		}
+	}
+
+	ActivateSensors();
+}
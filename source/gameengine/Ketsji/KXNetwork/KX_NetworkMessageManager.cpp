@@ -76,6 +76,33 @@ const std::vector<KX_NetworkMessageManager::Message> KX_NetworkMessageManager::G
 	return messages;
 }
 
+bool KX_NetworkMessageManager::HasMessages(const std::string& to, const std::string& subject) const
+{
+	const std::map<std::string, std::map<std::string, std::vector<Message> > >& messages = m_messages[1 - m_currentList];
+
+	// Look at messages without receiver, then at messages with the given receiver.
+	for (const std::string& receiver : {std::string(), to}) {
+		const auto it = messages.find(receiver);
+		if (it == messages.end()) {
+			continue;
+		}
+
+		for (const auto& pair : it->second) {
+			// GetMessages() can add empty lists.
+			if ((subject.empty() || pair.first == subject) && !pair.second.empty()) {
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+bool KX_NetworkMessageManager::HasMessages() const
+{
+	return !m_messages[1 - m_currentList].empty();
+}
+
 void KX_NetworkMessageManager::ClearMessages()
 {
 	// Clear previous list.
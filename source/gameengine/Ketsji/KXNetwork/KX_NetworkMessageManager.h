@@ -81,6 +81,14 @@ public:
 	 * \param subject The message subject/filter.
 	 */
 	const std::vector<Message> GetMessages(std::string to, std::string subject);
+	/** Return true if any message can be returned by GetMessages() for a given receiver object
+	 * name and message subject, without copying them.
+	 * \param to The object(s) name.
+	 * \param subject The message subject/filter.
+	 */
+	bool HasMessages(const std::string& to, const std::string& subject) const;
+	/// Return true if any message was sent during the last frame.
+	bool HasMessages() const;
 
 	/// Clear all messages
 	void ClearMessages();
@@ -57,3 +57,13 @@ const std::vector<KX_NetworkMessageManager::Message> KX_NetworkMessageScene::Fin
 {
 	return m_messageManager->GetMessages(to, subject);
 }
+
+bool KX_NetworkMessageScene::HasMessages(const std::string& to, const std::string& subject) const
+{
+	return m_messageManager->HasMessages(to, subject);
+}
+
+bool KX_NetworkMessageScene::HasMessages() const
+{
+	return m_messageManager->HasMessages();
+}
@@ -68,6 +68,14 @@ public:
 	 * \param subject The message subject/filter.
 	 */
 	const std::vector<KX_NetworkMessageManager::Message> FindMessages(std::string to, std::string subject);
+
+	/** Return true if FindMessages() would return any message.
+	 * \param to The object(s) name.
+	 * \param subject The message subject/filter.
+	 */
+	bool HasMessages(const std::string& to, const std::string& subject) const;
+	/// Return true if any message can be received during the current frame.
+	bool HasMessages() const;
 };
 
 #endif // __KX_NETWORKMESSAGESCENE_H__
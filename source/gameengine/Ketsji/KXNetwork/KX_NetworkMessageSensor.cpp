@@ -143,6 +143,17 @@ bool KX_NetworkMessageSensor::Evaluate()
 	return result;
 }
 
+bool KX_NetworkMessageSensor::NeedsPolling() const
+{
+	// The network event manager wakes the sensor when a message can be received.
+	return !IsSettled();
+}
+
+const std::string& KX_NetworkMessageSensor::GetSubject() const
+{
+	return m_subject;
+}
+
 /// return true for being up (no flank needed)
 bool KX_NetworkMessageSensor::IsPositiveTrigger()
 {
@@ -68,8 +68,11 @@ public:
 	virtual bool Evaluate();
 	virtual bool IsPositiveTrigger();
 	virtual void Init();
+	virtual bool NeedsPolling() const;
 	void EndFrame();
 
+	const std::string& GetSubject() const;
+
 	virtual void Replace_NetworkScene(KX_NetworkMessageScene *val)
 	{
 		m_NetworkScene = val;
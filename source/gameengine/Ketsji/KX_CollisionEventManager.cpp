@@ -37,6 +37,8 @@
 #include "PHY_IPhysicsEnvironment.h"
 #include "PHY_IPhysicsController.h"
 
+#include "CM_List.h"
+
 KX_CollisionEventManager::KX_CollisionEventManager(SCA_LogicManager *logicmgr, PHY_IPhysicsEnvironment *physEnv)
 	:SCA_EventManager(logicmgr, TOUCH_EVENTMGR),
 	m_physEnv(physEnv)
@@ -138,6 +140,10 @@ bool KX_CollisionEventManager::RegisterSensor(SCA_ISensor *sensor)
 		KX_CollisionSensor *collisionsensor = static_cast<KX_CollisionSensor *>(sensor);
 		// The sensor was effectively inserted, register it.
 		collisionsensor->RegisterSumo(this);
+		// Only near and radar sensors need a transform synchronization.
+		if (sensor->GetSensorType() != SCA_ISensor::ST_TOUCH) {
+			m_transformSensors.push_back(collisionsensor);
+		}
 		return true;
 	}
 
@@ -150,6 +156,10 @@ bool KX_CollisionEventManager::RemoveSensor(SCA_ISensor *sensor)
 		KX_CollisionSensor *collisionsensor = static_cast<KX_CollisionSensor *>(sensor);
 		// The sensor was effectively removed, unregister it.
 		collisionsensor->UnregisterSumo(this);
+		CM_ListRemoveIfFound(m_transformSensors, collisionsensor);
+		// The sensor can be touched by several collisions in the same frame.
+		m_touchedSensors.erase(std::remove(m_touchedSensors.begin(), m_touchedSensors.end(), collisionsensor),
+		                       m_touchedSensors.end());
 		return true;
 	}
 
@@ -158,23 +168,37 @@ bool KX_CollisionEventManager::RemoveSensor(SCA_ISensor *sensor)
 
 void KX_CollisionEventManager::EndFrame()
 {
-	for (SCA_ISensor *sensor : m_sensors) {
-		static_cast<KX_CollisionSensor *>(sensor)->EndFrame();
+	// Sensors without collision this frame have nothing to clear.
+	for (KX_CollisionSensor *sensor : m_touchedSensors) {
+		sensor->EndFrame();
+	}
+	m_touchedSensors.clear();
+}
+
+void KX_CollisionEventManager::HandleSensorsCollision(KX_ClientObjectInfo *client_info, PHY_IPhysicsController *ctrl1,
+                                                      PHY_IPhysicsController *ctrl2)
+{
+	for (SCA_ISensor *sensor : client_info->m_sensors) {
+		KX_CollisionSensor *collisionsensor = static_cast<KX_CollisionSensor *>(sensor);
+		collisionsensor->NewHandleCollision(ctrl1, ctrl2, nullptr);
+		// Sensors not linked to any controller are not registered and ignore the collision.
+		if (!sensor->IsNoLink()) {
+			m_touchedSensors.push_back(collisionsensor);
+			WakeSensor(sensor);
+		}
 	}
 }
 
 void KX_CollisionEventManager::NextFrame()
 {
-	for (SCA_ISensor *sensor : m_sensors) {
-		static_cast<KX_CollisionSensor *>(sensor)->SynchronizeTransform();
+	for (KX_CollisionSensor *sensor : m_transformSensors) {
+		sensor->SynchronizeTransform();
 	}
 
 	for (const NewCollision& collision : m_newCollisions) {
 		// Controllers
 		PHY_IPhysicsController *ctrl1 = collision.first;
 		PHY_IPhysicsController *ctrl2 = collision.second;
-		// Sensor iterator
-		std::list<SCA_ISensor *>::iterator sit;
 
 		// First client info
 		KX_ClientObjectInfo *client_info = static_cast<KX_ClientObjectInfo *>(ctrl1->GetNewClientInfo());
@@ -182,9 +206,7 @@ void KX_CollisionEventManager::NextFrame()
 		KX_GameObject *kxObj1 = KX_GameObject::GetClientObject(client_info);
 		// Invoke sensor response for each object
 		if (client_info) {
-			for (sit = client_info->m_sensors.begin(); sit != client_info->m_sensors.end(); ++sit) {
-				static_cast<KX_CollisionSensor *>(*sit)->NewHandleCollision(ctrl1, ctrl2, nullptr);
-			}
+			HandleSensorsCollision(client_info, ctrl1, ctrl2);
 		}
 
 		// Second client info
@@ -192,9 +214,7 @@ void KX_CollisionEventManager::NextFrame()
 		// Second gameobject
 		KX_GameObject *kxObj2 = KX_GameObject::GetClientObject(client_info);
 		if (client_info) {
-			for (sit = client_info->m_sensors.begin(); sit != client_info->m_sensors.end(); ++sit) {
-				static_cast<KX_CollisionSensor *>(*sit)->NewHandleCollision(ctrl2, ctrl1, nullptr);
-			}
+			HandleSensorsCollision(client_info, ctrl2, ctrl1);
 		}
 		// Run python callbacks
 		const PHY_ICollData *colldata = collision.colldata;
@@ -204,9 +224,7 @@ void KX_CollisionEventManager::NextFrame()
 		kxObj2->RunCollisionCallbacks(kxObj1, contactPointList1);
 	}
 
-	for (SCA_ISensor *sensor : m_sensors) {
-		sensor->Activate(m_logicmgr);
-	}
+	ActivateSensors();
 
 	RemoveNewCollisions();
 }
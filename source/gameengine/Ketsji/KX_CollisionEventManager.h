@@ -71,6 +71,11 @@ class KX_CollisionEventManager : public SCA_EventManager
 	PHY_IPhysicsEnvironment *m_physEnv;
 	std::set<NewCollision> m_newCollisions;
 
+	/// Near and radar sensors, their physics object follows the owner object.
+	std::vector<KX_CollisionSensor *> m_transformSensors;
+	/// Sensors which received collisions this frame and must be cleared at frame end.
+	std::vector<KX_CollisionSensor *> m_touchedSensors;
+
 	static bool newCollisionResponse(void *client_data, PHY_IPhysicsController *ctrl1, PHY_IPhysicsController *ctrl2,
 									 const PHY_ICollData *coll_data, bool first);
 	static bool newBroadphaseResponse(void *client_data, PHY_IPhysicsController *ctrl1, PHY_IPhysicsController *ctrl2,
@@ -78,6 +83,8 @@ class KX_CollisionEventManager : public SCA_EventManager
 
 	bool NewHandleCollision(PHY_IPhysicsController *ctrl1, PHY_IPhysicsController *ctrl2, const PHY_ICollData *coll_data, bool first);
 	void RemoveNewCollisions();
+	/// Send a collision to all the sensors of a client object and wake them.
+	void HandleSensorsCollision(KX_ClientObjectInfo *client_info, PHY_IPhysicsController *ctrl1, PHY_IPhysicsController *ctrl2);
 
 public:
 	KX_CollisionEventManager(SCA_LogicManager *logicmgr, PHY_IPhysicsEnvironment *physEnv);
@@ -100,6 +100,13 @@ bool KX_CollisionSensor::Evaluate()
 	return result;
 }
 
+bool KX_CollisionSensor::NeedsPolling() const
+{
+	/* Collisions wake the sensor, but the end of a collision is only detected
+	 * by an evaluation in the first frame without collision. */
+	return !IsSettled() || m_bLastTriggered;
+}
+
 KX_CollisionSensor::KX_CollisionSensor(SCA_EventManager *eventmgr, KX_GameObject *gameobj, bool bFindMaterial, bool bCollisionPulse, const std::string& touchedpropname)
 	:SCA_ISensor(gameobj, eventmgr),
 	m_touchedpropname(touchedpropname),
@@ -87,6 +87,7 @@ public:
 	virtual void ProcessReplica();
 	virtual void SynchronizeTransform();
 	virtual bool Evaluate();
+	virtual bool NeedsPolling() const;
 	virtual void Init();
 	virtual void ReParent(SCA_IObject *parent);
 
@@ -41,7 +41,7 @@
 class KX_RayCast;
 class KX_GameObject;
 
-class KX_ConstraintActuator : public SCA_IActuator, public mt::SimdClassAllocator
+class KX_ConstraintActuator : public SCA_IActuator
 {
 	Py_Header
 protected:
@@ -2189,6 +2189,7 @@ static int Map_SetItem(PyObject *self_v, PyObject *key, PyObject *val)
 
 				if (oldprop) {
 					oldprop->SetValue(vallie);
+					self->WakePropertySensors(attr_str);
 				}
 				else {
 					self->SetProperty(attr_str, vallie);
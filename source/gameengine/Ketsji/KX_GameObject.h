@@ -79,7 +79,7 @@ void KX_GameObject_Mathutils_Callback_Init(void);
 /**
  * KX_GameObject is the main class for dynamic objects.
  */
-class KX_GameObject : public SCA_IObject, public mt::SimdClassAllocator
+class KX_GameObject : public SCA_IObject, public CM_ArenaObject<CM_Arena::GAME_OBJECT>
 {
 	Py_Header
 public:
@@ -40,7 +40,7 @@
 
 #define KX_MAX_IPO_CHANNELS 19	//note- [0] is not used
 
-class KX_IpoController : public SG_Controller, public mt::SimdClassAllocator
+class KX_IpoController : public SG_Controller
 {
 	KX_IpoTransform m_ipo_xform;
 
@@ -432,6 +432,9 @@ bool KX_KetsjiEngine::NextFrame()
 #endif
 				KX_SetActiveScene(scene);
 
+				// Objects added by the logic are allocated in the scene arena.
+				CM_Arena::Scope arenaScope(scene->GetArena());
+
 				// Process sensors, and controllers
 				m_logger.StartLog(tc_logic, m_kxsystem->GetTimeInSeconds());
 				scene->LogicBeginFrame(m_frameTime, framestep);
@@ -1359,6 +1362,8 @@ KX_Scene *KX_KetsjiEngine::CreateScene(const std::string& scenename)
 
 void KX_KetsjiEngine::ConvertScene(KX_Scene *scene)
 {
+	CM_Arena::Scope arenaScope(scene->GetArena());
+
 	BL_SceneConverter sceneConverter(scene);
 	m_converter->ConvertScene(sceneConverter, false);
 	// Finalize material and mesh conversion.
@@ -15,7 +15,7 @@
 
 class RAS_IPolyMaterial;
 
-class KX_MaterialIpoController : public SG_Controller, public mt::SimdClassAllocator
+class KX_MaterialIpoController : public SG_Controller
 {
 public:
 	mt::vec4			m_rgba;
@@ -46,7 +46,7 @@ class KX_RayCast;
  *
  * - extend the valid modes?
  * - */
-class KX_MouseFocusSensor : public SCA_MouseSensor, public mt::SimdClassAllocator
+class KX_MouseFocusSensor : public SCA_MouseSensor
 {
 
 	Py_Header
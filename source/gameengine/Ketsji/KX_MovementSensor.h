@@ -37,7 +37,7 @@
 #include "mathfu.h"
 
 
-class KX_MovementSensor : public SCA_ISensor, public mt::SimdClassAllocator
+class KX_MovementSensor : public SCA_ISensor
 {
 	Py_Header
 
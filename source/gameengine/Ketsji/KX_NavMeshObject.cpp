@@ -56,8 +56,31 @@ extern "C" {
 #include "CM_Message.h"
 
 #define MAX_PATH_LEN 256
+/// Maximum number of corridors kept for reuse by the path requests.
+#define MAX_CACHED_CORRIDORS 16
+/// Number of corridor polygons ahead of the agent shortcut by a local search after an incremental update.
+#define CORRIDOR_OPTIMIZE_AHEAD 16
+/// Number of incremental updates of a corridor before it is searched again.
+#define MAX_CORRIDOR_UPDATES 32
 static const float polyPickExt[3] = {2, 4, 2};
 
+/// Return true if the polygon a has the polygon b as neighbour.
+static bool arePolysAdjacent(const dtStatNavMesh *navMesh, dtStatPolyRef a, dtStatPolyRef b)
+{
+	const dtStatPoly *poly = navMesh->getPolyByRef(a);
+	if (!poly) {
+		return false;
+	}
+
+	for (unsigned short i = 0; i < poly->nv; ++i) {
+		if (poly->n[i] == b) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
 static void calcMeshBounds(const float *vert, int nverts, float *bmin, float *bmax)
 {
 	bmin[0] = bmax[0] = vert[0];
@@ -98,7 +121,8 @@ inline void flipAxes(float vec[3])
 
 KX_NavMeshObject::KX_NavMeshObject(void *sgReplicationInfo, SG_Callbacks callbacks)
 	:KX_GameObject(sgReplicationInfo, callbacks),
-	m_navMesh(nullptr)
+	m_navMesh(nullptr),
+	m_pathQueryCount(0)
 {
 }
 
@@ -312,6 +336,9 @@ bool KX_NavMeshObject::BuildNavMesh()
 		m_navMesh = nullptr;
 	}
 
+	// The corridors reference polygons of the previous navigation mesh.
+	m_corridors.clear();
+
 	if (m_meshes.empty()) {
 		CM_Error("can't find mesh for navmesh object: " << m_name);
 		return false;
@@ -584,6 +611,110 @@ mt::vec3 KX_NavMeshObject::TransformToWorldCoords(const mt::vec3& lpos) const
 	return (NodeGetWorldTransform() * lpos);
 }
 
+bool KX_NavMeshObject::UpdateCorridor(std::vector<dtStatPolyRef>& polys, dtStatPolyRef startRef, dtStatPolyRef endRef,
+                                      const mt::vec3& localfrom, const mt::vec3& localto, bool& incremental) const
+{
+	incremental = false;
+
+	/* The goal moved into a neighbour of the last polygon, extend the corridor to it as
+	 * dtPathCorridor::moveTargetPosition does. */
+	if (polys.back() != endRef) {
+		if (!arePolysAdjacent(m_navMesh, endRef, polys.back())) {
+			return false;
+		}
+		polys.push_back(endRef);
+		incremental = true;
+	}
+
+	/* The agent moved along the corridor, drop the polygons behind it. If it moved out of the corridor
+	 * into a neighbour of one of its polygons, continue from the furthest of them as
+	 * dtPathCorridor::movePosition does. */
+	std::vector<dtStatPolyRef>::iterator start = std::find(polys.begin(), polys.end(), startRef);
+	if (start == polys.end()) {
+		const std::vector<dtStatPolyRef>::reverse_iterator next = std::find_if(polys.rbegin(), polys.rend(),
+		                                                                       [this, startRef](dtStatPolyRef ref) {
+			return arePolysAdjacent(m_navMesh, startRef, ref);
+		});
+		if (next == polys.rend()) {
+			return false;
+		}
+		start = polys.insert(next.base() - 1, startRef);
+		incremental = true;
+	}
+	polys.erase(polys.begin(), start);
+
+	if (!incremental) {
+		return true;
+	}
+
+	/* An incremental update can leave detours at the start of the corridor, shortcut them with a local
+	 * search toward a polygon a few steps ahead as dtPathCorridor::optimizePathTopology does. */
+	const unsigned int ahead = std::min<unsigned int>(CORRIDOR_OPTIMIZE_AHEAD, polys.size() - 1);
+	if (ahead > 1) {
+		dtStatPolyRef local[CORRIDOR_OPTIMIZE_AHEAD];
+		const int nlocal = m_navMesh->findPath(startRef, polys[ahead], localfrom.Data(), localto.Data(),
+		                                       local, CORRIDOR_OPTIMIZE_AHEAD);
+		if (nlocal > 0 && local[nlocal - 1] == polys[ahead] && (unsigned int)nlocal < ahead + 1) {
+			polys.erase(polys.begin(), polys.begin() + ahead + 1);
+			polys.insert(polys.begin(), local, local + nlocal);
+		}
+	}
+
+	return true;
+}
+
+void KX_NavMeshObject::FindCorridor(dtStatPolyRef startRef, dtStatPolyRef endRef, const mt::vec3& localfrom,
+                                    const mt::vec3& localto, unsigned int maxPathLen, std::vector<dtStatPolyRef>& polys) const
+{
+	++m_pathQueryCount;
+
+	for (PathCorridor& corridor : m_corridors) {
+		const std::vector<dtStatPolyRef>& cpolys = corridor.m_polys;
+		/* Only corridors toward the same goal or a neighbour of it are updated. Corridors updated
+		 * too many times may have drifted from a shortest path, they wait for their eviction. */
+		if (corridor.m_updates >= MAX_CORRIDOR_UPDATES ||
+		    (cpolys.back() != endRef && !arePolysAdjacent(m_navMesh, endRef, cpolys.back())))
+		{
+			continue;
+		}
+
+		polys = cpolys;
+		bool incremental;
+		if (UpdateCorridor(polys, startRef, endRef, localfrom, localto, incremental) && polys.size() <= maxPathLen) {
+			if (incremental) {
+				corridor.m_polys = polys;
+				++corridor.m_updates;
+			}
+			corridor.m_lastUse = m_pathQueryCount;
+			return;
+		}
+	}
+
+	// No cached corridor can be reused, run a new search.
+	polys.resize(maxPathLen);
+	const int npolys = m_navMesh->findPath(startRef, endRef, localfrom.Data(), localto.Data(), polys.data(), maxPathLen);
+	polys.resize(std::max(npolys, 0));
+
+	// A corridor not reaching its goal is only the path to the nearest polygon, don't cache it.
+	if (polys.empty() || polys.back() != endRef) {
+		return;
+	}
+
+	if (m_corridors.size() < MAX_CACHED_CORRIDORS) {
+		m_corridors.push_back({polys, m_pathQueryCount, 0});
+	}
+	else {
+		// Replace the least recently used corridor.
+		PathCorridor& corridor = *std::min_element(m_corridors.begin(), m_corridors.end(),
+		                                          [](const PathCorridor& a, const PathCorridor& b) {
+			return a.m_lastUse < b.m_lastUse;
+		});
+		corridor.m_polys = polys;
+		corridor.m_lastUse = m_pathQueryCount;
+		corridor.m_updates = 0;
+	}
+}
+
 KX_NavMeshObject::PathType KX_NavMeshObject::FindPath(const mt::vec3& from, const mt::vec3& to, unsigned int maxPathLen) const
 {
 	PathType path;
@@ -600,11 +731,12 @@ KX_NavMeshObject::PathType KX_NavMeshObject::FindPath(const mt::vec3& from, cons
 	dtStatPolyRef ePolyRef = m_navMesh->findNearestPoly(localto.Data(), polyPickExt);
 
 	if (sPolyRef && ePolyRef) {
-		dtStatPolyRef *polys = (dtStatPolyRef *)BLI_array_alloca(polys, maxPathLen);
-		const unsigned int npolys = m_navMesh->findPath(sPolyRef, ePolyRef, localfrom.Data(), localto.Data(), polys, maxPathLen);
+		std::vector<dtStatPolyRef>& polys = m_pathPolys;
+		FindCorridor(sPolyRef, ePolyRef, localfrom, localto, maxPathLen, polys);
+		const unsigned int npolys = polys.size();
 		if (npolys > 0) {
 			float(*points)[3] = (float(*)[3])BLI_array_alloca(points, maxPathLen);
-			const unsigned int pathLen = m_navMesh->findStraightPath(localfrom.Data(), localto.Data(), polys, npolys,
+			const unsigned int pathLen = m_navMesh->findStraightPath(localfrom.Data(), localto.Data(), polys.data(), npolys,
 			                                                         &points[0][0], maxPathLen);
 
 			path.resize(pathLen);
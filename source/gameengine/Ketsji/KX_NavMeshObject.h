@@ -38,6 +38,41 @@ class KX_NavMeshObject : public KX_GameObject
 protected:
 	dtStatNavMesh *m_navMesh;
 
+	/// Polygon corridor found by a previous path request.
+	struct PathCorridor
+	{
+		std::vector<dtStatPolyRef> m_polys;
+		/// Value of m_pathQueryCount at the last use, used for least recently used eviction.
+		unsigned int m_lastUse;
+		/// Number of incremental updates since the corridor was searched.
+		unsigned int m_updates;
+	};
+
+	/** Recently found corridors. A path request starting and ending on or next to a cached
+	 * corridor updates it instead of running a new search, as dtPathCorridor does in newer
+	 * Detour versions. Cleared when the navigation mesh is rebuilt.
+	 */
+	mutable std::vector<PathCorridor> m_corridors;
+	/// Number of path requests, used as time stamp of the corridors.
+	mutable unsigned int m_pathQueryCount;
+	/// Polygons of the corridor of the last path request, kept to not allocate per request.
+	mutable std::vector<dtStatPolyRef> m_pathPolys;
+
+	/** Move the start and goal of a corridor to the given polygons, when they lie on the corridor
+	 * or next to it, and shortcut the start of the corridor after such a move.
+	 * \param polys The polygons of the corridor, updated in place, partially when it fails.
+	 * \param incremental Set to true if polygons were added to the corridor.
+	 * \return False if the polygons are too far from the corridor.
+	 */
+	bool UpdateCorridor(std::vector<dtStatPolyRef>& polys, dtStatPolyRef startRef, dtStatPolyRef endRef,
+	                    const mt::vec3& localfrom, const mt::vec3& localto, bool& incremental) const;
+
+	/** Find the polygon corridor between two polygons, reusing a cached corridor if possible.
+	 * \param polys Receive the polygons of the corridor, empty if no path was found.
+	 */
+	void FindCorridor(dtStatPolyRef startRef, dtStatPolyRef endRef, const mt::vec3& localfrom,
+	                  const mt::vec3& localto, unsigned int maxPathLen, std::vector<dtStatPolyRef>& polys) const;
+
 	bool BuildVertIndArrays(float *&vertices, int& nverts,
 	                        unsigned short * &polys, int& npolys, unsigned short *&dmeshes,
 	                        float *&dvertices, int &ndvertsuniq, unsigned short * &dtris,
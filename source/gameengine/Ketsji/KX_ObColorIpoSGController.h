@@ -37,7 +37,7 @@
 #include "SG_Interpolator.h"
 #include "mathfu.h"
 
-class KX_ObColorIpoSGController : public SG_Controller, public mt::SimdClassAllocator
+class KX_ObColorIpoSGController : public SG_Controller
 {
 public:
 	mt::vec4			m_rgba;
@@ -84,7 +84,7 @@ struct KX_LocalFlags {
 	bool ServoControlAngular;
 };
 
-class KX_ObjectActuator : public SCA_IActuator, public mt::SimdClassAllocator
+class KX_ObjectActuator : public SCA_IActuator
 {
 	Py_Header
 
@@ -81,6 +81,7 @@
 #include "KX_NodeRelationships.h"
 
 #include "KX_NetworkMessageScene.h"
+#include "KX_NetworkEventManager.h"
 #include "PHY_IPhysicsEnvironment.h"
 #include "PHY_IGraphicController.h"
 #include "PHY_IPhysicsController.h"
@@ -193,10 +194,14 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
 
 	m_networkScene = new KX_NetworkMessageScene(messageManager);
 
+	KX_NetworkEventManager *netmgr = new KX_NetworkEventManager(m_logicmgr, m_networkScene);
+	m_logicmgr->RegisterEventManager(netmgr);
+
 	m_rendererManager = new KX_TextureRendererManager(this);
 	KX_TextMaterial *textMaterial = new KX_TextMaterial();
 	m_bucketmanager = new RAS_BucketManager(textMaterial);
 	m_boundingBoxManager = new RAS_BoundingBoxManager();
+	m_arena = new CM_Arena();
 
 	m_animationPool = BLI_task_pool_create(KX_GetActiveEngine()->GetTaskScheduler(), &m_animationPoolData);
 
@@ -293,6 +298,11 @@ KX_Scene::~KX_Scene()
 		Py_CLEAR(m_drawCallbacks[i]);
 	}
 #endif
+
+	/* The slabs are freed now if all the objects are, else when the
+	 * last object still referenced, e.g. by python, is freed. */
+	m_arena->Close();
+	m_arena->Release();
 }
 
 std::string KX_Scene::GetName()
@@ -320,6 +330,11 @@ RAS_BoundingBoxManager *KX_Scene::GetBoundingBoxManager() const
 	return m_boundingBoxManager;
 }
 
+CM_Arena *KX_Scene::GetArena() const
+{
+	return m_arena;
+}
+
 EXP_ListValue<KX_GameObject> *KX_Scene::GetObjectList() const
 {
 	return m_objectlist;
@@ -2089,6 +2104,28 @@ int KX_Scene::pyattr_set_gravity(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE
 	return PY_SET_ATTR_SUCCESS;
 }
 
+PyObject *KX_Scene::pyattr_get_allocation_statistics(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+	KX_Scene *self = static_cast<KX_Scene *>(self_v);
+	CM_Arena *arena = self->GetArena();
+
+	PyObject *dict = PyDict_New();
+	for (unsigned short i = 0; i < CM_Arena::CATEGORY_MAX; ++i) {
+		const CM_Arena::Category category = (CM_Arena::Category)i;
+		const CM_Arena::Statistics& stats = arena->GetStatistics(category);
+
+		PyObject *item = Py_BuildValue("{s:I,s:I,s:I}", "live", stats.m_live, "peak", stats.m_peak, "total", stats.m_total);
+		PyDict_SetItemString(dict, CM_Arena::GetCategoryName(category), item);
+		Py_DECREF(item);
+	}
+
+	PyObject *reserved = PyLong_FromSize_t(arena->GetReservedSize());
+	PyDict_SetItemString(dict, "reservedSize", reserved);
+	Py_DECREF(reserved);
+
+	return dict;
+}
+
 PyAttributeDef KX_Scene::Attributes[] = {
 	EXP_PYATTRIBUTE_RO_FUNCTION("name", KX_Scene, pyattr_get_name),
 	EXP_PYATTRIBUTE_RO_FUNCTION("objects", KX_Scene, pyattr_get_objects),
@@ -2104,6 +2141,7 @@ PyAttributeDef KX_Scene::Attributes[] = {
 	EXP_PYATTRIBUTE_RW_FUNCTION("post_draw", KX_Scene, pyattr_get_drawing_callback, pyattr_set_drawing_callback),
 	EXP_PYATTRIBUTE_RW_FUNCTION("pre_draw_setup", KX_Scene, pyattr_get_drawing_callback, pyattr_set_drawing_callback),
 	EXP_PYATTRIBUTE_RW_FUNCTION("gravity", KX_Scene, pyattr_get_gravity, pyattr_set_gravity),
+	EXP_PYATTRIBUTE_RO_FUNCTION("allocationStatistics", KX_Scene, pyattr_get_allocation_statistics),
 	EXP_PYATTRIBUTE_BOOL_RO("suspended", KX_Scene, m_suspend),
 	EXP_PYATTRIBUTE_BOOL_RO("activityCulling", KX_Scene, m_activityCulling),
 	EXP_PYATTRIBUTE_BOOL_RO("dbvt_culling", KX_Scene, m_dbvtCulling),
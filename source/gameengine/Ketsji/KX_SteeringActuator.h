@@ -39,7 +39,7 @@ struct KX_Obstacle;
 class KX_ObstacleSimulation;
 const int MAX_PATH_LENGTH  = 128;
 
-class KX_SteeringActuator : public SCA_IActuator, public mt::SimdClassAllocator
+class KX_SteeringActuator : public SCA_IActuator
 {
 	Py_Header
 
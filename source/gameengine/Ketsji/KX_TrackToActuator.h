@@ -38,7 +38,7 @@
 #include "KX_GameObject.h"
 
 
-class KX_TrackToActuator : public SCA_IActuator, public mt::SimdClassAllocator
+class KX_TrackToActuator : public SCA_IActuator
 {
 	Py_Header
 	// Object reference. Actually, we use the object's 'life'
@@ -36,7 +36,7 @@
 #include "SG_Node.h"
 #include "SG_Interpolator.h"
 
-class KX_WorldIpoController : public SG_Controller, public mt::SimdClassAllocator
+class KX_WorldIpoController : public SG_Controller
 {
 public:
 	float           m_mist_start;
@@ -22,6 +22,7 @@
 #define __CCDPHYSICSCONTROLLER_H__
 
 #include "CM_RefCount.h"
+#include "CM_Arena.h"
 
 #include <vector>
 #include <map>
@@ -538,7 +539,7 @@ public:
 };
 
 /// CcdPhysicsController is a physics object that supports continuous collision detection and time of impact based physics resolution.
-class CcdPhysicsController : public PHY_IPhysicsController, public mt::SimdClassAllocator
+class CcdPhysicsController : public PHY_IPhysicsController, public CM_ArenaObject<CM_Arena::PHYSICS_CONTROLLER>
 {
 protected:
 	btCollisionObject *m_object;
@@ -43,8 +43,19 @@
 #include "RAS_BucketManager.h"
 
 #include <algorithm>
+#include <cstring>
+
 /* sorting */
 
+/// Convert a float to an unsigned integer of same ordering.
+static uint32_t depth_key(float z)
+{
+	uint32_t bits;
+	memcpy(&bits, &z, sizeof(bits));
+	// Flip all bits of negative values and only the sign bit of positive values.
+	return (bits & 0x80000000) ? ~bits : (bits | 0x80000000);
+}
+
 RAS_BucketManager::SortedMeshSlot::SortedMeshSlot(RAS_MeshSlot *ms, const mt::vec3& pnorm)
 	:m_ms(ms)
 {
@@ -52,7 +63,7 @@ RAS_BucketManager::SortedMeshSlot::SortedMeshSlot(RAS_MeshSlot *ms, const mt::ve
 	float *matrix = m_ms->m_meshUser->GetMatrix();
 	const mt::vec3 pos(matrix[12], matrix[13], matrix[14]);
 
-	m_z = mt::dot(pnorm, pos);
+	m_key = depth_key(mt::dot(pnorm, pos));
 }
 
 RAS_BucketManager::SortedMeshSlot::SortedMeshSlot(RAS_MeshSlotUpwardNode *node, const mt::vec3& pnorm)
@@ -63,17 +74,89 @@ RAS_BucketManager::SortedMeshSlot::SortedMeshSlot(RAS_MeshSlotUpwardNode *node,
 	float *matrix = ms->m_meshUser->GetMatrix();
 	const mt::vec3 pos(matrix[12], matrix[13], matrix[14]);
 
-	m_z = mt::dot(pnorm, pos);
+	m_key = depth_key(mt::dot(pnorm, pos));
 }
 
 bool RAS_BucketManager::backtofront::operator()(const SortedMeshSlot &a, const SortedMeshSlot &b)
 {
-	return (a.m_z < b.m_z) || (a.m_z == b.m_z && a.m_ms < b.m_ms);
+	return (a.m_key < b.m_key) || (a.m_key == b.m_key && a.m_ms < b.m_ms);
 }
 
 bool RAS_BucketManager::fronttoback::operator()(const SortedMeshSlot &a, const SortedMeshSlot &b)
 {
-	return (a.m_z > b.m_z) || (a.m_z == b.m_z && a.m_ms > b.m_ms);
+	return (a.m_key > b.m_key) || (a.m_key == b.m_key && a.m_ms > b.m_ms);
+}
+
+/** Sort by insertion while the number of moved slots stays under a budget.
+ * \return False if the budget was exceeded, the slots are then partially sorted.
+ */
+static bool insertion_sort_bounded(std::vector<RAS_BucketManager::SortedMeshSlot>& slots, unsigned int budget)
+{
+	const unsigned int size = slots.size();
+	for (unsigned int i = 1; i < size; ++i) {
+		const RAS_BucketManager::SortedMeshSlot slot = slots[i];
+		unsigned int j = i;
+		for (; j > 0 && slots[j - 1].m_key > slot.m_key; --j) {
+			slots[j] = slots[j - 1];
+		}
+		slots[j] = slot;
+
+		const unsigned int moves = i - j;
+		if (moves > budget) {
+			return false;
+		}
+		budget -= moves;
+	}
+	return true;
+}
+
+/// Stable least significant digit radix sort on the 32 bits keys, by digits of 11 bits.
+static void radix_sort(std::vector<RAS_BucketManager::SortedMeshSlot>& slots,
+                       std::vector<RAS_BucketManager::SortedMeshSlot>& buffer)
+{
+	static const unsigned int digitBits = 11;
+	static const unsigned int numBins = 1 << digitBits;
+	static const unsigned int numPasses = (32 + digitBits - 1) / digitBits;
+
+	const unsigned int size = slots.size();
+	buffer.resize(size);
+
+	unsigned int histograms[numPasses][numBins] = {{0}};
+	for (const RAS_BucketManager::SortedMeshSlot& slot : slots) {
+		for (unsigned int pass = 0; pass < numPasses; ++pass) {
+			++histograms[pass][(slot.m_key >> (pass * digitBits)) & (numBins - 1)];
+		}
+	}
+
+	for (unsigned int pass = 0; pass < numPasses; ++pass) {
+		unsigned int *histogram = histograms[pass];
+		// A digit shared by all the slots doesn't change the order.
+		if (histogram[(slots[0].m_key >> (pass * digitBits)) & (numBins - 1)] == size) {
+			continue;
+		}
+
+		unsigned int offset = 0;
+		for (unsigned int bin = 0; bin < numBins; ++bin) {
+			const unsigned int count = histogram[bin];
+			histogram[bin] = offset;
+			offset += count;
+		}
+
+		for (const RAS_BucketManager::SortedMeshSlot& slot : slots) {
+			buffer[histogram[(slot.m_key >> (pass * digitBits)) & (numBins - 1)]++] = slot;
+		}
+		slots.swap(buffer);
+	}
+}
+
+void RAS_BucketManager::SortMeshSlots(std::vector<SortedMeshSlot>& slots, std::vector<SortedMeshSlot>& buffer)
+{
+	const unsigned int size = slots.size();
+	// Small lists or lists already nearly sorted don't need the radix sort.
+	const unsigned int budget = (size < 64) ? size * size : size * 2;
+	if (!insertion_sort_bounded(slots, budget)) {
+		radix_sort(slots, buffer);
+	}
 }
 
 RAS_BucketManager::RAS_BucketManager(RAS_IPolyMaterial *textMaterial)
@@ -114,18 +197,34 @@ void RAS_BucketManager::RenderSortedBuckets(RAS_Rasterizer *rasty, RAS_BucketMan
 		 * but we leave out pval since it's constant anyway */
 		const mt::mat3x4& trans = m_nodeData.m_trans;
 		const mt::vec3 pnorm(trans[2], trans[5], trans[8]);
-		std::vector<SortedMeshSlot> sortedSlots(leafs.size());
+
+		/* When the same mesh slots as in the last sort are rendered, start from their
+		 * last sorted order, with a small camera motion it is already nearly sorted. */
+		SortCache& cache = m_sortCache[bucketType];
+		const bool coherent = (cache.m_leafs == leafs);
+		const RAS_UpwardTreeLeafs& startLeafs = coherent ? cache.m_sortedLeafs : leafs;
+
+		m_sortedSlots.resize(startLeafs.size());
 		// Generate all SortedMeshSlot corresponding to all the leafs nodes.
-		std::transform(leafs.begin(), leafs.end(), sortedSlots.begin(),
+		std::transform(startLeafs.begin(), startLeafs.end(), m_sortedSlots.begin(),
 		               [&pnorm](RAS_MeshSlotUpwardNode *node) {
 			return SortedMeshSlot(node, pnorm);
 		});
 
-		std::sort(sortedSlots.begin(), sortedSlots.end(), backtofront());
+		SortMeshSlots(m_sortedSlots, m_sortBuffer);
+
+		if (!coherent) {
+			cache.m_leafs = leafs;
+			cache.m_sortedLeafs.resize(leafs.size());
+		}
+		std::transform(m_sortedSlots.begin(), m_sortedSlots.end(), cache.m_sortedLeafs.begin(),
+		               [](const SortedMeshSlot& slot) {
+			return slot.m_node;
+		});
 
-		std::vector<SortedMeshSlot>::const_iterator it = sortedSlots.begin();
+		std::vector<SortedMeshSlot>::const_iterator it = m_sortedSlots.begin();
 		RAS_MeshSlotUpwardNodeIterator iterator((it++)->m_node);
-		for (std::vector<SortedMeshSlot>::const_iterator end = sortedSlots.end(); it != end; ++it) {
+		for (std::vector<SortedMeshSlot>::const_iterator end = m_sortedSlots.end(); it != end; ++it) {
 			iterator.NextNode(it->m_node);
 		}
 	}
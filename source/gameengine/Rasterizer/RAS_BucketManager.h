@@ -46,8 +46,8 @@ public:
 	class SortedMeshSlot
 	{
 	public:
-		/// depth
-		float m_z;
+		/// Depth converted to an unsigned integer of same ordering, used as radix sort key.
+		uint32_t m_key;
 
 		union {
 			RAS_MeshSlot *m_ms;
@@ -68,6 +68,13 @@ public:
 		bool operator()(const SortedMeshSlot &a, const SortedMeshSlot &b);
 	};
 
+	/** Sort mesh slots back to front. Nearly sorted lists are sorted by insertion,
+	 * other lists by a stable radix sort on the depth keys.
+	 * \param slots The mesh slots to sort.
+	 * \param buffer Temporary storage, owned by the caller to reuse memory between sorts.
+	 */
+	static void SortMeshSlots(std::vector<SortedMeshSlot>& slots, std::vector<SortedMeshSlot>& buffer);
+
 protected:
 	enum BucketType {
 		SOLID_BUCKET = 0,
@@ -86,6 +93,21 @@ protected:
 
 	BucketList m_buckets[NUM_BUCKET_TYPE];
 
+	/** Result of the last sort of a bucket type, the sorted order is reused as starting
+	 * point when the same mesh slots are sorted again, e.g in the next frame.
+	 */
+	struct SortCache
+	{
+		/// Leafs of the last sort, in generation order.
+		RAS_UpwardTreeLeafs m_leafs;
+		/// Leafs of the last sort, in sorted order.
+		RAS_UpwardTreeLeafs m_sortedLeafs;
+	} m_sortCache[NUM_BUCKET_TYPE];
+
+	/// Sorted mesh slots and radix sort buffer, kept to avoid allocations each sort.
+	std::vector<SortedMeshSlot> m_sortedSlots;
+	std::vector<SortedMeshSlot> m_sortBuffer;
+
 	RAS_ManagerNodeData m_nodeData;
 	RAS_ManagerDownwardNode m_downwardNode;
 	RAS_ManagerUpwardNode m_upwardNode;
@@ -258,12 +258,13 @@ void RAS_DisplayArrayBucket::RunInstancingNode(const RAS_DisplayArrayNodeTuple&
 
 		const mt::mat3x4& trans = managerData->m_trans;
 		const mt::vec3 pnorm(trans[2], trans[5], trans[8]);
-		std::transform(m_activeMeshSlots.begin(), m_activeMeshSlots.end(), sortedMeshSlots.end(),
+		std::transform(m_activeMeshSlots.begin(), m_activeMeshSlots.end(), sortedMeshSlots.begin(),
 		               [&pnorm](RAS_MeshSlot *slot) {
 			return RAS_BucketManager::SortedMeshSlot(slot, pnorm);
 		});
 
-		std::sort(sortedMeshSlots.begin(), sortedMeshSlots.end(), RAS_BucketManager::backtofront());
+		std::vector<RAS_BucketManager::SortedMeshSlot> sortBuffer;
+		RAS_BucketManager::SortMeshSlots(sortedMeshSlots, sortBuffer);
 		RAS_MeshSlotList meshSlots(nummeshslots);
 		for (unsigned int i = 0; i < nummeshslots; ++i) {
 			meshSlots[i] = sortedMeshSlots[i].m_ms;
@@ -343,7 +344,8 @@ void RAS_DisplayArrayBucket::RunBatchingNode(const RAS_DisplayArrayNodeTuple& tu
 			return RAS_BucketManager::SortedMeshSlot(slot, pnorm);
 		});
 
-		std::sort(sortedMeshSlots.begin(), sortedMeshSlots.end(), RAS_BucketManager::backtofront());
+		std::vector<RAS_BucketManager::SortedMeshSlot> sortBuffer;
+		RAS_BucketManager::SortMeshSlots(sortedMeshSlots, sortBuffer);
 		for (unsigned int i = 0; i < nummeshslots; ++i) {
 			const short index = sortedMeshSlots[i].m_ms->m_batchPartIndex;
 			indices[i] = batchArray->GetPartIndexOffset(index);
@@ -60,6 +60,7 @@ RAS_IDisplayArray::RAS_IDisplayArray(const RAS_IDisplayArray& other)
 	:m_type(other.m_type),
 	m_format(other.m_format),
 	m_memoryFormat(other.m_memoryFormat),
+	m_storageFormat(other.m_storageFormat),
 	m_vertexInfos(other.m_vertexInfos),
 	m_vertexDataPtrs(other.m_vertexDataPtrs),
 	m_primitiveIndices(other.m_primitiveIndices),
@@ -74,6 +75,7 @@ RAS_IDisplayArray::RAS_IDisplayArray(PrimitiveType type, const RAS_VertexFormat&
 	:m_type(type),
 	m_format(format),
 	m_memoryFormat(memoryFormat),
+	m_storageFormat(STORAGE_FULL),
 	m_maxOrigIndex(0)
 {
 }
@@ -200,6 +202,16 @@ const RAS_VertexDataMemoryFormat& RAS_IDisplayArray::GetMemoryFormat() const
 	return m_memoryFormat;
 }
 
+RAS_IDisplayArray::StorageFormat RAS_IDisplayArray::GetStorageFormat() const
+{
+	return m_storageFormat;
+}
+
+void RAS_IDisplayArray::SetStorageFormat(StorageFormat format)
+{
+	m_storageFormat = format;
+}
+
 RAS_IDisplayArray::Type RAS_IDisplayArray::GetType() const
 {
 	return NORMAL;
@@ -50,6 +50,16 @@ public:
 		BATCHING
 	};
 
+	/// Layout of the vertex data uploaded to the GPU.
+	enum StorageFormat {
+		/// Same layout as the vertex data in memory.
+		STORAGE_FULL,
+		/** Normals and tangents packed in 10 bits per component, everything else as in memory.
+		 * The vertex data in memory stays in full precision.
+		 */
+		STORAGE_COMPACT
+	};
+
 	/// Modification categories.
 	enum {
 		NONE_MODIFIED = 0,
@@ -73,6 +83,8 @@ protected:
 	RAS_VertexFormat m_format;
 	/// The vertex memory format used.
 	RAS_VertexDataMemoryFormat m_memoryFormat;
+	/// The layout of the vertex data in the storage.
+	StorageFormat m_storageFormat;
 
 	/// The vertex infos unused for rendering, e.g original or soft body index, flag.
 	std::vector<RAS_VertexInfo> m_vertexInfos;
@@ -222,6 +234,13 @@ public:
 	/// Return the vertex memory format used.
 	const RAS_VertexDataMemoryFormat& GetMemoryFormat() const;
 
+	/// Return the layout of the vertex data in the storage.
+	StorageFormat GetStorageFormat() const;
+	/** Set the layout of the vertex data in the storage, must be called before the storage construction.
+	 * \param format One of the enumeration StorageFormat.
+	 */
+	void SetStorageFormat(StorageFormat format);
+
 	/// Return the type of the display array.
 	virtual Type GetType() const;
 
@@ -39,6 +39,17 @@ static const AttribData attribData[RAS_AttributeArray::RAS_ATTRIB_MAX] = {
 	{4, GL_UNSIGNED_BYTE, true} // RAS_ATTRIB_COLOR
 };
 
+/** Attribute types of the compact storage layout.
+ * The converter doesn't use it when normals or tangents are bound with glTexCoordPointer, which doesn't normalize.
+ */
+static const AttribData compactAttribData[RAS_AttributeArray::RAS_ATTRIB_MAX] = {
+	{3, GL_FLOAT, false}, // RAS_ATTRIB_POS
+	{2, GL_FLOAT, false}, // RAS_ATTRIB_UV
+	{4, GL_INT_2_10_10_10_REV, true}, // RAS_ATTRIB_NORM
+	{4, GL_INT_2_10_10_10_REV, true}, // RAS_ATTRIB_TANGENT
+	{4, GL_UNSIGNED_BYTE, true} // RAS_ATTRIB_COLOR
+};
+
 RAS_StorageVao::RAS_StorageVao(RAS_IDisplayArray *array, RAS_DisplayArrayStorage *arrayStorage,
                                const RAS_AttributeArray::AttribList& attribList)
 {
@@ -49,7 +60,9 @@ RAS_StorageVao::RAS_StorageVao(RAS_IDisplayArray *array, RAS_DisplayArrayStorage
 	vbo->BindVertexBuffer();
 	vbo->BindIndexBuffer();
 
-	const RAS_VertexDataMemoryFormat& memoryFormat = array->GetMemoryFormat();
+	// The vertex buffer layout can differ from the display array memory layout when compact.
+	const RAS_VertexDataMemoryFormat& memoryFormat = vbo->GetMemoryFormat();
+	const AttribData *attribTypes = vbo->IsCompact() ? compactAttribData : attribData;
 
 	const unsigned int stride = memoryFormat.size;
 
@@ -57,7 +70,7 @@ RAS_StorageVao::RAS_StorageVao(RAS_IDisplayArray *array, RAS_DisplayArrayStorage
 	glVertexPointer(3, GL_FLOAT, stride, (const void *)memoryFormat.position);
 
 	glEnableClientState(GL_NORMAL_ARRAY);
-	glNormalPointer(GL_FLOAT, stride, (const void *)memoryFormat.normal);
+	glNormalPointer(attribTypes[RAS_AttributeArray::RAS_ATTRIB_NORM].type, stride, (const void *)memoryFormat.normal);
 
 	glEnableClientState(GL_COLOR_ARRAY);
 	glColorPointer(4, GL_UNSIGNED_BYTE, stride, (const void *)memoryFormat.colors);
@@ -99,7 +112,7 @@ RAS_StorageVao::RAS_StorageVao(RAS_IDisplayArray *array, RAS_DisplayArrayStorage
 		}
 
 		const unsigned short loc = attrib.m_loc;
-		const AttribData& data = attribData[type];
+		const AttribData& data = attribTypes[type];
 
 		if (attrib.m_texco) {
 			glClientActiveTexture(GL_TEXTURE0 + loc);
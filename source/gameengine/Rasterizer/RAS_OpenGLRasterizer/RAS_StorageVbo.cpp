@@ -28,13 +28,51 @@
 #include "RAS_StorageVbo.h"
 #include "RAS_DisplayArray.h"
 
+#include "BLI_utildefines.h"
+
+#include <cmath>
+#include <cstring>
+
+/// Convert a float in [-1, 1] to a signed normalized integer of the given bit count.
+static uint32_t float_to_snorm(const float value, const unsigned short bits)
+{
+	const int max = (1 << (bits - 1)) - 1;
+	const int snorm = (int)roundf(CLAMPIS(value, -1.0f, 1.0f) * max);
+
+	return (uint32_t)snorm & ((1u << bits) - 1);
+}
+
+/// Pack a vector in the GL_INT_2_10_10_10_REV layout.
+static uint32_t pack_int_2_10_10_10_rev(const float x, const float y, const float z, const float w)
+{
+	return float_to_snorm(x, 10) | (float_to_snorm(y, 10) << 10) | (float_to_snorm(z, 10) << 20) |
+	       (float_to_snorm(w, 2) << 30);
+}
+
 RAS_StorageVbo::RAS_StorageVbo(RAS_IDisplayArray *array)
 	:m_array(array),
+	m_compact(false),
+	m_memoryFormat(m_array->GetMemoryFormat()),
 	m_size(0),
-	m_stride(m_array->GetMemoryFormat().size),
 	m_indices(0),
 	m_mode(m_array->GetOpenGLPrimitiveType())
 {
+	// Packed vertex attributes are core since OpenGL 3.3, without them the vertex data is uploaded as it is.
+	if (m_array->GetStorageFormat() == RAS_IDisplayArray::STORAGE_COMPACT &&
+	    (GLEW_VERSION_3_3 || GLEW_ARB_vertex_type_2_10_10_10_rev))
+	{
+		const RAS_VertexFormat& format = m_array->GetFormat();
+		m_compact = true;
+		m_memoryFormat.position = 0;
+		m_memoryFormat.normal = m_memoryFormat.position + sizeof(float[3]);
+		m_memoryFormat.tangent = m_memoryFormat.normal + sizeof(uint32_t);
+		m_memoryFormat.uvs = m_memoryFormat.tangent + sizeof(uint32_t);
+		m_memoryFormat.colors = m_memoryFormat.uvs + sizeof(float[2]) * format.uvSize;
+		m_memoryFormat.size = m_memoryFormat.colors + sizeof(unsigned int) * format.colorSize;
+	}
+
+	m_stride = m_memoryFormat.size;
+
 	glGenBuffers(1, &m_ibo);
 	glGenBuffers(1, &m_vbo);
 }
@@ -45,6 +83,48 @@ RAS_StorageVbo::~RAS_StorageVbo()
 	glDeleteBuffers(1, &m_vbo);
 }
 
+bool RAS_StorageVbo::IsCompact() const
+{
+	return m_compact;
+}
+
+const RAS_VertexDataMemoryFormat& RAS_StorageVbo::GetMemoryFormat() const
+{
+	return m_memoryFormat;
+}
+
+void RAS_StorageVbo::CopyCompactVertexData()
+{
+	if (m_size == 0) {
+		return;
+	}
+
+	uint8_t *dst = (uint8_t *)glMapBufferRange(GL_ARRAY_BUFFER, 0, m_stride * m_size,
+	                                           GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+	if (!dst) {
+		return;
+	}
+
+	const RAS_VertexFormat& format = m_array->GetFormat();
+	const RAS_VertexDataMemoryFormat& srcFormat = m_array->GetMemoryFormat();
+	const uint8_t *src = (const uint8_t *)m_array->GetVertexPointer();
+	// UVs and colors are contiguous and copied as they are.
+	const unsigned int extraSize = sizeof(float[2]) * format.uvSize + sizeof(unsigned int) * format.colorSize;
+	BLI_assert(srcFormat.colors == srcFormat.uvs + (intptr_t)sizeof(float[2]) * format.uvSize);
+
+	for (unsigned int i = 0; i < m_size; ++i, src += srcFormat.size, dst += m_stride) {
+		const float *normal = (const float *)(src + srcFormat.normal);
+		const float *tangent = (const float *)(src + srcFormat.tangent);
+
+		memcpy(dst + m_memoryFormat.position, src + srcFormat.position, sizeof(float[3]));
+		*(uint32_t *)(dst + m_memoryFormat.normal) = pack_int_2_10_10_10_rev(normal[0], normal[1], normal[2], 0.0f);
+		*(uint32_t *)(dst + m_memoryFormat.tangent) = pack_int_2_10_10_10_rev(tangent[0], tangent[1], tangent[2], tangent[3]);
+		memcpy(dst + m_memoryFormat.uvs, src + srcFormat.uvs, extraSize);
+	}
+
+	glUnmapBuffer(GL_ARRAY_BUFFER);
+}
+
 void RAS_StorageVbo::BindVertexBuffer()
 {
 	glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
@@ -68,7 +148,12 @@ void RAS_StorageVbo::UnbindIndexBuffer()
 void RAS_StorageVbo::UpdateVertexData()
 {
 	glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-	glBufferSubData(GL_ARRAY_BUFFER, 0, m_stride * m_size, m_array->GetVertexPointer());
+	if (m_compact) {
+		CopyCompactVertexData();
+	}
+	else {
+		glBufferSubData(GL_ARRAY_BUFFER, 0, m_stride * m_size, m_array->GetVertexPointer());
+	}
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
@@ -78,7 +163,13 @@ void RAS_StorageVbo::UpdateSize()
 	m_indices = m_array->GetPrimitiveIndexCount();
 
 	glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-	glBufferData(GL_ARRAY_BUFFER, m_stride * m_size, m_array->GetVertexPointer(), GL_DYNAMIC_DRAW);
+	if (m_compact) {
+		glBufferData(GL_ARRAY_BUFFER, m_stride * m_size, nullptr, GL_DYNAMIC_DRAW);
+		CopyCompactVertexData();
+	}
+	else {
+		glBufferData(GL_ARRAY_BUFFER, m_stride * m_size, m_array->GetVertexPointer(), GL_DYNAMIC_DRAW);
+	}
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
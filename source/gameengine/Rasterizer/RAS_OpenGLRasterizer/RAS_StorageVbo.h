@@ -28,6 +28,8 @@
 #ifndef __RAS_STORAGE_VBO_H__
 #define __RAS_STORAGE_VBO_H__
 
+#include "RAS_VertexData.h"
+
 #include "GPU_glew.h"
 
 #include <vector>
@@ -38,6 +40,10 @@ class RAS_StorageVbo
 {
 private:
 	RAS_IDisplayArray *m_array;
+	/// True when the vertex data is converted to the compact layout before upload.
+	bool m_compact;
+	/// Layout of the vertex data in the vertex buffer.
+	RAS_VertexDataMemoryFormat m_memoryFormat;
 	GLuint m_size;
 	GLuint m_stride;
 	GLuint m_indices;
@@ -45,10 +51,18 @@ private:
 	GLuint m_ibo;
 	GLuint m_vbo;
 
+	/// Convert the vertex data of the display array to the compact layout directly in the bound vertex buffer.
+	void CopyCompactVertexData();
+
 public:
 	RAS_StorageVbo(RAS_IDisplayArray *array);
 	~RAS_StorageVbo();
 
+	/// Return true if normals and tangents are stored in GL_INT_2_10_10_10_REV.
+	bool IsCompact() const;
+	/// Return the layout of the vertex data in the vertex buffer.
+	const RAS_VertexDataMemoryFormat& GetMemoryFormat() const;
+
 	void BindVertexBuffer();
 	void UnbindVertexBuffer();
 
@@ -37,12 +37,14 @@
 
 #include "SG_Interpolator.h"
 
+#include "CM_Arena.h"
+
 class SG_Node;
 
 /**
  * A scenegraph controller
  */
-class SG_Controller
+class SG_Controller : public CM_ArenaObject<CM_Arena::SCENE_CONTROLLER>
 {
 	friend SG_Node;
 public:
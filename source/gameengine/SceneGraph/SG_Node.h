@@ -38,6 +38,7 @@
 #include "mathfu.h"
 
 #include "CM_Thread.h"
+#include "CM_Arena.h"
 
 #include <vector>
 #include <memory>
@@ -104,7 +105,7 @@ typedef std::vector<SG_Node *> NodeList;
 /**
  * Scenegraph node.
  */
-class SG_Node : public SG_QList, public mt::SimdClassAllocator
+class SG_Node : public SG_QList, public CM_ArenaObject<CM_Arena::SCENE_NODE>
 {
 public:
 
@@ -0,0 +1,139 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_utildefines.h"
+#include "DNA_customdata_types.h"
+#include "BKE_customdata.h"
+}
+
+#define TOTELEM 16
+
+static void customdata_float_init(CustomData *data, const float offset)
+{
+	CustomData_reset(data);
+
+	float *values = (float *)CustomData_add_layer(data, CD_PROP_FLT, CD_CALLOC, NULL, TOTELEM);
+	for (int i = 0; i < TOTELEM; i++) {
+		values[i] = offset + (float)i;
+	}
+}
+
+static void customdata_float_expect(const CustomData *data, const float offset)
+{
+	const float *values = (const float *)CustomData_get_layer(data, CD_PROP_FLT);
+	ASSERT_TRUE(values != NULL);
+	for (int i = 0; i < TOTELEM; i++) {
+		EXPECT_EQ(offset + (float)i, values[i]);
+	}
+}
+
+/* Share -> copy -> write -> free, the writer gets its own data and the others keep the original. */
+TEST(customdata, ShareCopyWriteFree)
+{
+	const uintptr_t blocks_in_use = MEM_get_memory_blocks_in_use();
+	CustomData src, copy_a, copy_b;
+
+	customdata_float_init(&src, 0.0f);
+	CustomData_copy(&src, &copy_a, CD_MASK_MESH, CD_SHARE, TOTELEM);
+	CustomData_copy(&copy_a, &copy_b, CD_MASK_MESH, CD_SHARE, TOTELEM);
+
+	/* Reading doesn't copy anything. */
+	const float *src_values = (const float *)CustomData_get_layer(&src, CD_PROP_FLT);
+	EXPECT_EQ(src_values, CustomData_get_layer(&copy_a, CD_PROP_FLT));
+	EXPECT_EQ(src_values, CustomData_get_layer(&copy_b, CD_PROP_FLT));
+	EXPECT_TRUE(CustomData_is_referenced_layer(&copy_a, CD_PROP_FLT));
+
+	float *values_a = (float *)CustomData_duplicate_referenced_layer(&copy_a, CD_PROP_FLT, TOTELEM);
+	EXPECT_NE(src_values, values_a);
+	EXPECT_FALSE(CustomData_is_referenced_layer(&copy_a, CD_PROP_FLT));
+	for (int i = 0; i < TOTELEM; i++) {
+		values_a[i] += 100.0f;
+	}
+
+	customdata_float_expect(&src, 0.0f);
+	customdata_float_expect(&copy_a, 100.0f);
+	customdata_float_expect(&copy_b, 0.0f);
+
+	/* The remaining copy keeps the data alive and becomes its only user. */
+	CustomData_free(&src, TOTELEM);
+	customdata_float_expect(&copy_b, 0.0f);
+
+	float *values_b = (float *)CustomData_duplicate_referenced_layer(&copy_b, CD_PROP_FLT, TOTELEM);
+	EXPECT_EQ(src_values, values_b);
+	values_b[0] = -1.0f;
+
+	CustomData_free(&copy_a, TOTELEM);
+	CustomData_free(&copy_b, TOTELEM);
+
+	EXPECT_EQ(blocks_in_use, MEM_get_memory_blocks_in_use());
+}
+
+/* Element writers make the destination layer unique as well. */
+TEST(customdata, ShareCopyData)
+{
+	const uintptr_t blocks_in_use = MEM_get_memory_blocks_in_use();
+	CustomData src, copy, other;
+
+	customdata_float_init(&src, 0.0f);
+	customdata_float_init(&other, 50.0f);
+	CustomData_copy(&src, &copy, CD_MASK_MESH, CD_SHARE, TOTELEM);
+
+	CustomData_copy_data(&other, &copy, 0, 0, TOTELEM);
+	customdata_float_expect(&src, 0.0f);
+	customdata_float_expect(&copy, 50.0f);
+
+	CustomData_free(&copy, TOTELEM);
+	CustomData_free(&other, TOTELEM);
+	customdata_float_expect(&src, 0.0f);
+	CustomData_free(&src, TOTELEM);
+
+	EXPECT_EQ(blocks_in_use, MEM_get_memory_blocks_in_use());
+}
+
+/* Referenced layers and layers DerivedMesh computes in place are duplicated instead. */
+TEST(customdata, ShareOnlyOwnedMeshLayers)
+{
+	const uintptr_t blocks_in_use = MEM_get_memory_blocks_in_use();
+	CustomData src, ref, copy;
+
+	customdata_float_init(&src, 0.0f);
+	int *origindex = (int *)CustomData_add_layer(&src, CD_ORIGINDEX, CD_CALLOC, NULL, TOTELEM);
+
+	CustomData_copy(&src, &ref, CD_MASK_MESH | CD_MASK_ORIGINDEX, CD_REFERENCE, TOTELEM);
+	CustomData_copy(&ref, &copy, CD_MASK_MESH | CD_MASK_ORIGINDEX, CD_SHARE, TOTELEM);
+
+	EXPECT_NE(CustomData_get_layer(&src, CD_PROP_FLT), CustomData_get_layer(&copy, CD_PROP_FLT));
+	EXPECT_NE(origindex, CustomData_get_layer(&copy, CD_ORIGINDEX));
+	EXPECT_FALSE(CustomData_is_referenced_layer(&copy, CD_PROP_FLT));
+	customdata_float_expect(&copy, 0.0f);
+
+	CustomData_free(&copy, TOTELEM);
+	CustomData_free(&ref, TOTELEM);
+	CustomData_free(&src, TOTELEM);
+
+	EXPECT_EQ(blocks_in_use, MEM_get_memory_blocks_in_use());
+}
+
+/* Replacing the data of a shared layer leaves the shared data to the other users. */
+TEST(customdata, ShareSetLayer)
+{
+	const uintptr_t blocks_in_use = MEM_get_memory_blocks_in_use();
+	CustomData src, copy;
+
+	customdata_float_init(&src, 0.0f);
+	CustomData_copy(&src, &copy, CD_MASK_MESH, CD_SHARE, TOTELEM);
+
+	float *values = (float *)MEM_callocN(sizeof(float) * TOTELEM, __func__);
+	CustomData_set_layer(&copy, CD_PROP_FLT, values);
+	EXPECT_EQ(values, CustomData_get_layer(&copy, CD_PROP_FLT));
+	EXPECT_FALSE(CustomData_is_referenced_layer(&copy, CD_PROP_FLT));
+
+	CustomData_free(&copy, TOTELEM);
+	customdata_float_expect(&src, 0.0f);
+	CustomData_free(&src, TOTELEM);
+
+	EXPECT_EQ(blocks_in_use, MEM_get_memory_blocks_in_use());
+}
@@ -0,0 +1,101 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_utildefines.h"
+#include "BLI_math.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_modifier_types.h"
+#include "BKE_cdderivedmesh.h"
+#include "BKE_DerivedMesh.h"
+#include "BKE_subsurf.h"
+#include "intern/CCGSubSurf.h"
+}
+
+#define LEVELS 2
+
+static DerivedMesh *cube_dm_new(void)
+{
+	const int cube_faces[6][4] = {
+	    {0, 1, 2, 3}, {7, 6, 5, 4}, {0, 4, 5, 1},
+	    {1, 5, 6, 2}, {2, 6, 7, 3}, {3, 7, 4, 0},
+	};
+	DerivedMesh *dm = CDDM_new(8, 0, 0, 24, 6);
+	MVert *mvert = CDDM_get_verts(dm);
+	MLoop *mloop = CDDM_get_loops(dm);
+	MPoly *mpoly = CDDM_get_polys(dm);
+
+	for (int i = 0; i < 8; i++) {
+		mvert[i].co[0] = (i & 1) ? 1.0f : -1.0f;
+		mvert[i].co[1] = (i & 2) ? 1.0f : -1.0f;
+		mvert[i].co[2] = (i & 4) ? 1.0f : -1.0f;
+	}
+	/* make the faces above consistent quads */
+	SWAP(float, mvert[2].co[0], mvert[3].co[0]);
+	SWAP(float, mvert[6].co[0], mvert[7].co[0]);
+
+	for (int i = 0; i < 6; i++) {
+		mpoly[i].loopstart = i * 4;
+		mpoly[i].totloop = 4;
+		for (int j = 0; j < 4; j++) {
+			mloop[i * 4 + j].v = cube_faces[i][j];
+		}
+	}
+
+	CDDM_calc_edges(dm);
+
+	return dm;
+}
+
+static void subsurf_modifier_init(SubsurfModifierData *smd)
+{
+	memset(smd, 0, sizeof(*smd));
+	smd->levels = LEVELS;
+	smd->renderLevels = LEVELS;
+}
+
+/* Playing back a deforming mesh in object mode keeps the cached subsurf,
+ * so its next sync evaluates the stencil tables. */
+TEST(subsurf, ObjectModeStencils)
+{
+	DerivedMesh *dm = cube_dm_new();
+	SubsurfModifierData smd, smd_ref;
+	float vertCos[8][3];
+	DerivedMesh *result, *result_ref;
+	CCGSubSurf *ss;
+
+	subsurf_modifier_init(&smd);
+	subsurf_modifier_init(&smd_ref);
+
+	dm->getVertCos(dm, vertCos);
+	result = subsurf_make_derived_from_derived(dm, &smd, vertCos, SUBSURF_IS_FINAL_CALC);
+	ss = (CCGSubSurf *)smd.mCache;
+	ASSERT_TRUE(ss != NULL);
+	EXPECT_FALSE(ccgSubSurf_hasStencilTable(ss));
+	result->release(result);
+
+	/* Deform all the vertices, the topology stays the same. */
+	for (int i = 0; i < 8; i++) {
+		vertCos[i][0] *= 1.5f;
+		vertCos[i][2] += (float)i * 0.1f;
+	}
+	result = subsurf_make_derived_from_derived(dm, &smd, vertCos, SUBSURF_IS_FINAL_CALC);
+	EXPECT_EQ(ss, (CCGSubSurf *)smd.mCache);
+	EXPECT_TRUE(ccgSubSurf_hasStencilTable(ss));
+
+	/* Same result as a subsurf built from scratch. */
+	result_ref = subsurf_make_derived_from_derived(dm, &smd_ref, vertCos, (SubsurfFlags)0);
+	ASSERT_EQ(result_ref->getNumVerts(result_ref), result->getNumVerts(result));
+	MVert *mvert = result->getVertArray(result);
+	MVert *mvert_ref = result_ref->getVertArray(result_ref);
+	for (int i = 0; i < result->getNumVerts(result); i++) {
+		EXPECT_LT(len_v3v3(mvert[i].co, mvert_ref[i].co), 1e-5f);
+	}
+
+	result_ref->release(result_ref);
+	result->release(result);
+	ccgSubSurf_free((CCGSubSurf *)smd.mCache);
+	dm->release(dm);
+}
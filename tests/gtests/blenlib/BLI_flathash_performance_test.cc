@@ -0,0 +1,327 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+#include "BLI_ressource_strings.h"
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_utildefines.h"
+#include "BLI_ghash.h"
+#include "BLI_flathash.h"
+#include "BLI_rand.h"
+#include "BLI_string.h"
+#include "PIL_time_utildefines.h"
+}
+
+/* Compare the chained GHash with the open addressing FlatHash on the same data,
+ * each test runs both hashes, see BLI_ghash_performance_test.cc for more GHash only cases. */
+
+/* Run the longest tests! */
+//#define FLATHASH_RUN_BIG
+
+/* Size of 'small case' hashes (number of entries). */
+#define TESTCASE_SIZE_SMALL 17
+
+/* Small wrapper so the same test code runs with both hashes. */
+typedef struct HashType {
+	const char *name;
+	void *(*new_fn)(GHashHashFP hashfp, GHashCmpFP cmpfp, const char *info);
+	void (*free_fn)(void *hash);
+	void (*clear_fn)(void *hash);
+	void (*insert_fn)(void *hash, void *key, void *val);
+	void *(*lookup_fn)(void *hash, const void *key);
+	bool (*haskey_fn)(void *hash, const void *key);
+	bool (*remove_fn)(void *hash, const void *key);
+	unsigned int (*size_fn)(void *hash);
+} HashType;
+
+static void *ghash_new_cb(GHashHashFP hashfp, GHashCmpFP cmpfp, const char *info) { return BLI_ghash_new(hashfp, cmpfp, info); }
+static void ghash_free_cb(void *hash) { BLI_ghash_free((GHash *)hash, NULL, NULL); }
+static void ghash_clear_cb(void *hash) { BLI_ghash_clear((GHash *)hash, NULL, NULL); }
+static void ghash_insert_cb(void *hash, void *key, void *val) { BLI_ghash_insert((GHash *)hash, key, val); }
+static void *ghash_lookup_cb(void *hash, const void *key) { return BLI_ghash_lookup((GHash *)hash, key); }
+static bool ghash_haskey_cb(void *hash, const void *key) { return BLI_ghash_haskey((GHash *)hash, key); }
+static bool ghash_remove_cb(void *hash, const void *key) { return BLI_ghash_remove((GHash *)hash, key, NULL, NULL); }
+static unsigned int ghash_size_cb(void *hash) { return BLI_ghash_size((GHash *)hash); }
+
+static void *flathash_new_cb(GHashHashFP hashfp, GHashCmpFP cmpfp, const char *info) { return BLI_flathash_new(hashfp, cmpfp, info); }
+static void flathash_free_cb(void *hash) { BLI_flathash_free((FlatHash *)hash, NULL, NULL); }
+static void flathash_clear_cb(void *hash) { BLI_flathash_clear((FlatHash *)hash, NULL, NULL); }
+static void flathash_insert_cb(void *hash, void *key, void *val) { BLI_flathash_insert((FlatHash *)hash, key, val); }
+static void *flathash_lookup_cb(void *hash, const void *key) { return BLI_flathash_lookup((FlatHash *)hash, key); }
+static bool flathash_haskey_cb(void *hash, const void *key) { return BLI_flathash_haskey((FlatHash *)hash, key); }
+static bool flathash_remove_cb(void *hash, const void *key) { return BLI_flathash_remove((FlatHash *)hash, key, NULL, NULL); }
+static unsigned int flathash_size_cb(void *hash) { return BLI_flathash_size((FlatHash *)hash); }
+
+static const HashType hash_types[] = {
+	{"GHash", ghash_new_cb, ghash_free_cb, ghash_clear_cb, ghash_insert_cb,
+	 ghash_lookup_cb, ghash_haskey_cb, ghash_remove_cb, ghash_size_cb},
+	{"FlatHash", flathash_new_cb, flathash_free_cb, flathash_clear_cb, flathash_insert_cb,
+	 flathash_lookup_cb, flathash_haskey_cb, flathash_remove_cb, flathash_size_cb},
+};
+
+#define HASH_TYPES_ITER(type_) \
+	for (const HashType *type_ = hash_types; type_ != hash_types + ARRAY_SIZE(hash_types); type_++)
+
+/* Str: words of a text. */
+
+static void str_hash_tests(const HashType *type, const char *id)
+{
+	printf("\n========== STARTING %s - %s ==========\n", id, type->name);
+
+	void *hash = type->new_fn(BLI_ghashutil_strhash_p, BLI_ghashutil_strcmp, __func__);
+	char *data = BLI_strdup(words10k);
+	char *data_bis = BLI_strdup(words10k);
+
+	{
+		char *w, *c;
+
+		TIMEIT_START(string_insert);
+
+		for (w = c = data; *c; c++) {
+			if (ELEM(*c, '.', ' ')) {
+				*c = '\0';
+				if (!type->haskey_fn(hash, w)) {
+					type->insert_fn(hash, w, SET_INT_IN_POINTER(w[0]));
+				}
+				w = c + 1;
+			}
+		}
+
+		TIMEIT_END(string_insert);
+	}
+
+	{
+		char *w, *c;
+
+		TIMEIT_START(string_lookup);
+
+		for (w = c = data_bis; *c; c++) {
+			if (ELEM(*c, '.', ' ')) {
+				*c = '\0';
+				void *v = type->lookup_fn(hash, w);
+				EXPECT_EQ(GET_INT_FROM_POINTER(v), w[0]);
+				w = c + 1;
+			}
+		}
+
+		TIMEIT_END(string_lookup);
+	}
+
+	type->free_fn(hash);
+	MEM_freeN(data);
+	MEM_freeN(data_bis);
+
+	printf("========== ENDED %s - %s ==========\n\n", id, type->name);
+}
+
+TEST(flathash, TextCompare)
+{
+	HASH_TYPES_ITER (type) {
+		str_hash_tests(type, "StrHash");
+	}
+}
+
+/* Int: random integers, inserted, looked up (hits and misses) and removed. */
+
+static void randint_hash_tests(const HashType *type, GHashHashFP hashfp, const char *id, const unsigned int nbr)
+{
+	printf("\n========== STARTING %s - %s ==========\n", id, type->name);
+
+	void *hash = type->new_fn(hashfp, BLI_ghashutil_intcmp, __func__);
+	unsigned int *data = (unsigned int *)MEM_mallocN(sizeof(*data) * (size_t)nbr, __func__);
+	unsigned int *dt;
+	unsigned int i;
+
+	{
+		RNG *rng = BLI_rng_new(0);
+		for (i = nbr, dt = data; i--; dt++) {
+			*dt = BLI_rng_get_uint(rng);
+		}
+		BLI_rng_free(rng);
+	}
+
+	{
+		TIMEIT_START(int_insert);
+
+		for (i = nbr, dt = data; i--; dt++) {
+			if (!type->haskey_fn(hash, SET_UINT_IN_POINTER(*dt))) {
+				type->insert_fn(hash, SET_UINT_IN_POINTER(*dt), SET_UINT_IN_POINTER(*dt));
+			}
+		}
+
+		TIMEIT_END(int_insert);
+	}
+
+	{
+		TIMEIT_START(int_lookup);
+
+		for (i = nbr, dt = data; i--; dt++) {
+			void *v = type->lookup_fn(hash, SET_UINT_IN_POINTER(*dt));
+			EXPECT_EQ(GET_UINT_FROM_POINTER(v), *dt);
+		}
+
+		TIMEIT_END(int_lookup);
+	}
+
+	{
+		TIMEIT_START(int_lookup_miss);
+
+		for (i = nbr, dt = data; i--; dt++) {
+			/* Random numbers are unlikely to be in the hash. */
+			type->haskey_fn(hash, SET_UINT_IN_POINTER(*dt ^ 0x5bd1e995));
+		}
+
+		TIMEIT_END(int_lookup_miss);
+	}
+
+	{
+		TIMEIT_START(int_remove);
+
+		for (i = nbr, dt = data; i--; dt++) {
+			type->remove_fn(hash, SET_UINT_IN_POINTER(*dt));
+		}
+
+		TIMEIT_END(int_remove);
+	}
+
+	EXPECT_EQ(type->size_fn(hash), 0);
+
+	type->free_fn(hash);
+	MEM_freeN(data);
+
+	printf("========== ENDED %s - %s ==========\n\n", id, type->name);
+}
+
+TEST(flathash, IntRandCompare12000)
+{
+	HASH_TYPES_ITER (type) {
+		randint_hash_tests(type, BLI_ghashutil_inthash_p, "RandIntHash - 12000", 12000);
+	}
+}
+
+TEST(flathash, IntRandCompare1000000)
+{
+	HASH_TYPES_ITER (type) {
+		randint_hash_tests(type, BLI_ghashutil_inthash_p, "RandIntHash - 1000000", 1000000);
+	}
+}
+
+#ifdef FLATHASH_RUN_BIG
+TEST(flathash, IntRandCompare50000000)
+{
+	HASH_TYPES_ITER (type) {
+		randint_hash_tests(type, BLI_ghashutil_inthash_p, "RandIntHash - 50000000", 50000000);
+	}
+}
+#endif
+
+TEST(flathash, IntRandMurmur2aCompare1000000)
+{
+	HASH_TYPES_ITER (type) {
+		randint_hash_tests(type, BLI_ghashutil_inthash_p_murmur, "RandIntHash - Murmur - 1000000", 1000000);
+	}
+}
+
+/* Int_v4: randomly-generated integer vectors, keys are pointers to the data. */
+
+static void int4_hash_tests(const HashType *type, const char *id, const unsigned int nbr)
+{
+	printf("\n========== STARTING %s - %s ==========\n", id, type->name);
+
+	void *hash = type->new_fn(BLI_ghashutil_uinthash_v4_p, BLI_ghashutil_uinthash_v4_cmp, __func__);
+	void *data_v = MEM_mallocN(sizeof(unsigned int[4]) * (size_t)nbr, __func__);
+	unsigned int (*data)[4] = (unsigned int (*)[4])data_v;
+	unsigned int (*dt)[4];
+	unsigned int i, j;
+
+	{
+		RNG *rng = BLI_rng_new(0);
+		for (i = nbr, dt = data; i--; dt++) {
+			for (j = 4; j--; ) {
+				(*dt)[j] = BLI_rng_get_uint(rng);
+			}
+		}
+		BLI_rng_free(rng);
+	}
+
+	{
+		TIMEIT_START(int_v4_insert);
+
+		for (i = nbr, dt = data; i--; dt++) {
+			type->insert_fn(hash, *dt, SET_UINT_IN_POINTER(i));
+		}
+
+		TIMEIT_END(int_v4_insert);
+	}
+
+	{
+		TIMEIT_START(int_v4_lookup);
+
+		for (i = nbr, dt = data; i--; dt++) {
+			void *v = type->lookup_fn(hash, (void *)(*dt));
+			EXPECT_EQ(GET_UINT_FROM_POINTER(v), i);
+		}
+
+		TIMEIT_END(int_v4_lookup);
+	}
+
+	type->free_fn(hash);
+	MEM_freeN(data);
+
+	printf("========== ENDED %s - %s ==========\n\n", id, type->name);
+}
+
+TEST(flathash, Int4Compare200000)
+{
+	HASH_TYPES_ITER (type) {
+		int4_hash_tests(type, "Int4Hash - 200000", 200000);
+	}
+}
+
+/* MultiSmall: create and manipulate a lot of very small hashes (90% < 10 items, 9% < 100 items, 1% < 1000 items). */
+
+static void multi_small_hash_tests(const HashType *type, const char *id, const unsigned int nbr)
+{
+	printf("\n========== STARTING %s - %s ==========\n", id, type->name);
+
+	void *hash = type->new_fn(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, __func__);
+	RNG *rng = BLI_rng_new(0);
+	unsigned int data[TESTCASE_SIZE_SMALL * 100];
+
+	TIMEIT_START(multi_small_hash);
+
+	unsigned int i = nbr;
+	while (i--) {
+		const unsigned int nbr_small =
+		        1 + (BLI_rng_get_uint(rng) % TESTCASE_SIZE_SMALL) * (!(i % 100) ? 100 : (!(i % 10) ? 10 : 1));
+		unsigned int j;
+
+		for (j = 0; j < nbr_small; j++) {
+			data[j] = BLI_rng_get_uint(rng);
+			if (!type->haskey_fn(hash, SET_UINT_IN_POINTER(data[j]))) {
+				type->insert_fn(hash, SET_UINT_IN_POINTER(data[j]), SET_UINT_IN_POINTER(data[j]));
+			}
+		}
+		for (j = 0; j < nbr_small; j++) {
+			void *v = type->lookup_fn(hash, SET_UINT_IN_POINTER(data[j]));
+			EXPECT_EQ(GET_UINT_FROM_POINTER(v), data[j]);
+		}
+
+		type->clear_fn(hash);
+	}
+
+	TIMEIT_END(multi_small_hash);
+
+	type->free_fn(hash);
+	BLI_rng_free(rng);
+
+	printf("========== ENDED %s - %s ==========\n\n", id, type->name);
+}
+
+TEST(flathash, MultiRandIntCompare200000)
+{
+	HASH_TYPES_ITER (type) {
+		multi_small_hash_tests(type, "MultiSmall RandIntHash - 200000", 200000);
+	}
+}
@@ -0,0 +1,202 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+extern "C" {
+#include "BLI_utildefines.h"
+#include "BLI_flathash.h"
+}
+
+#define TESTCASE_SIZE 10000
+
+/* Unique keys, multiplying by an odd number is a bijection of 32bit integers. */
+static void init_keys(unsigned int keys[TESTCASE_SIZE], const unsigned int seed)
+{
+	unsigned int i;
+
+	for (i = 0; i < TESTCASE_SIZE; i++) {
+		keys[i] = (i + seed * TESTCASE_SIZE) * 2654435761u;
+	}
+}
+
+/* Here we simply insert and then lookup all keys, ensuring we do get back the expected stored 'data'. */
+TEST(flathash, InsertLookup)
+{
+	FlatHash *fh = BLI_flathash_int_new(__func__);
+	unsigned int keys[TESTCASE_SIZE], *k;
+	int i;
+
+	init_keys(keys, 0);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		BLI_flathash_insert(fh, SET_UINT_IN_POINTER(*k), SET_UINT_IN_POINTER(*k));
+	}
+
+	EXPECT_EQ(BLI_flathash_size(fh), TESTCASE_SIZE);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		void *v = BLI_flathash_lookup(fh, SET_UINT_IN_POINTER(*k));
+		EXPECT_EQ(GET_UINT_FROM_POINTER(v), *k);
+	}
+
+	init_keys(keys, 1);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		EXPECT_FALSE(BLI_flathash_haskey(fh, SET_UINT_IN_POINTER(*k)));
+	}
+
+	BLI_flathash_free(fh, NULL, NULL);
+}
+
+/* Insert and then remove all keys, ensuring we do get an empty flathash. */
+TEST(flathash, InsertRemove)
+{
+	FlatHash *fh = BLI_flathash_int_new(__func__);
+	unsigned int keys[TESTCASE_SIZE], *k;
+	int i;
+
+	init_keys(keys, 10);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		BLI_flathash_insert(fh, SET_UINT_IN_POINTER(*k), SET_UINT_IN_POINTER(*k));
+	}
+
+	EXPECT_EQ(BLI_flathash_size(fh), TESTCASE_SIZE);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		void *v = BLI_flathash_popkey(fh, SET_UINT_IN_POINTER(*k), NULL);
+		EXPECT_EQ(GET_UINT_FROM_POINTER(v), *k);
+	}
+
+	EXPECT_EQ(BLI_flathash_size(fh), 0);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		EXPECT_FALSE(BLI_flathash_haskey(fh, SET_UINT_IN_POINTER(*k)));
+	}
+
+	BLI_flathash_free(fh, NULL, NULL);
+}
+
+/* Remove and insert keys many times, deleted slots must be reused or purged. */
+TEST(flathash, Churn)
+{
+	FlatHash *fh = BLI_flathash_int_new(__func__);
+	unsigned int keys[TESTCASE_SIZE];
+	int i, pass;
+
+	init_keys(keys, 20);
+
+	for (i = 0; i < TESTCASE_SIZE / 2; i++) {
+		BLI_flathash_insert(fh, SET_UINT_IN_POINTER(keys[i]), SET_UINT_IN_POINTER(keys[i]));
+	}
+
+	/* Slide a window of half the keys over all the keys. */
+	for (pass = 0; pass < 4; pass++) {
+		for (i = 0; i < TESTCASE_SIZE; i++) {
+			const int i_add = (i + TESTCASE_SIZE / 2) % TESTCASE_SIZE;
+			EXPECT_TRUE(BLI_flathash_remove(fh, SET_UINT_IN_POINTER(keys[i]), NULL, NULL));
+			EXPECT_TRUE(BLI_flathash_reinsert(fh, SET_UINT_IN_POINTER(keys[i_add]), SET_UINT_IN_POINTER(keys[i_add]),
+			                                  NULL, NULL));
+		}
+	}
+
+	EXPECT_EQ(BLI_flathash_size(fh), TESTCASE_SIZE / 2);
+
+	for (i = 0; i < TESTCASE_SIZE; i++) {
+		void *v = BLI_flathash_lookup_default(fh, SET_UINT_IN_POINTER(keys[i]), SET_INT_IN_POINTER(-1));
+		EXPECT_EQ(GET_UINT_FROM_POINTER(v), (i < TESTCASE_SIZE / 2) ? keys[i] : (unsigned int)-1);
+	}
+
+	BLI_flathash_free(fh, NULL, NULL);
+}
+
+/* Iterate over all entries, removing some of them while iterating. */
+TEST(flathash, Iterator)
+{
+	FlatHash *fh = BLI_flathash_int_new(__func__);
+	FlatHashIterator fh_iter;
+	unsigned int keys[TESTCASE_SIZE], *k;
+	int i, tot;
+
+	init_keys(keys, 30);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		BLI_flathash_insert(fh, SET_UINT_IN_POINTER(*k), SET_UINT_IN_POINTER(*k));
+	}
+
+	tot = 0;
+	FLATHASH_ITER (fh_iter, fh) {
+		void *key = BLI_flathashIterator_getKey(&fh_iter);
+		EXPECT_EQ(key, BLI_flathashIterator_getValue(&fh_iter));
+		if (tot % 2) {
+			BLI_flathash_remove(fh, key, NULL, NULL);
+		}
+		tot++;
+	}
+
+	EXPECT_EQ(tot, TESTCASE_SIZE);
+	EXPECT_EQ(BLI_flathash_size(fh), TESTCASE_SIZE - TESTCASE_SIZE / 2);
+
+	BLI_flathash_free(fh, NULL, NULL);
+}
+
+/* String keys and ensure. */
+TEST(flathash, EnsureString)
+{
+	FlatHash *fh = BLI_flathash_str_new(__func__);
+	const char *words[] = {"one", "two", "three", "four", "two", "one"};
+	void **val_p;
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(words); i++) {
+		if (!BLI_flathash_ensure_p(fh, (void *)words[i], &val_p)) {
+			*val_p = SET_UINT_IN_POINTER(0);
+		}
+		*val_p = SET_UINT_IN_POINTER(GET_UINT_FROM_POINTER(*val_p) + 1);
+	}
+
+	EXPECT_EQ(BLI_flathash_size(fh), 4);
+	EXPECT_EQ(GET_UINT_FROM_POINTER(BLI_flathash_lookup(fh, "one")), 2);
+	EXPECT_EQ(GET_UINT_FROM_POINTER(BLI_flathash_lookup(fh, "three")), 1);
+	EXPECT_EQ(BLI_flathash_lookup(fh, "five"), (void *)NULL);
+
+	BLI_flathash_clear(fh, NULL, NULL);
+	EXPECT_EQ(BLI_flathash_size(fh), 0);
+	EXPECT_FALSE(BLI_flathash_haskey(fh, "one"));
+
+	BLI_flathash_free(fh, NULL, NULL);
+}
+
+TEST(flatset, AddRemove)
+{
+	FlatSet *fs = BLI_flatset_ptr_new(__func__);
+	FlatSetIterator fs_iter;
+	unsigned int keys[TESTCASE_SIZE], *k;
+	int i, tot;
+
+	init_keys(keys, 40);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		EXPECT_TRUE(BLI_flatset_add(fs, SET_UINT_IN_POINTER(*k)));
+	}
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		EXPECT_FALSE(BLI_flatset_add(fs, SET_UINT_IN_POINTER(*k)));
+	}
+
+	EXPECT_EQ(BLI_flatset_size(fs), TESTCASE_SIZE);
+
+	tot = 0;
+	FLATSET_ITER (fs_iter, fs) {
+		EXPECT_TRUE(BLI_flatset_haskey(fs, BLI_flatsetIterator_getKey(&fs_iter)));
+		tot++;
+	}
+	EXPECT_EQ(tot, TESTCASE_SIZE);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		EXPECT_TRUE(BLI_flatset_remove(fs, SET_UINT_IN_POINTER(*k), NULL));
+	}
+
+	EXPECT_EQ(BLI_flatset_size(fs), 0);
+
+	BLI_flatset_free(fs, NULL);
+}
@@ -95,3 +95,109 @@ static void find_nearest_points_test(int points_len, float scale, int round, int
 TEST(kdopbvh, FindNearest_1)		{ find_nearest_points_test(1, 1.0, 1000, 1234); }
 TEST(kdopbvh, FindNearest_2)		{ find_nearest_points_test(2, 1.0, 1000, 123); }
 TEST(kdopbvh, FindNearest_500)		{ find_nearest_points_test(500, 1.0, 1000, 12); }
+
+/* Batched queries must give the same results as single queries. */
+static void find_nearest_batch_test(int points_len, float scale, int round, int random_seed)
+{
+	struct RNG *rng = BLI_rng_new(random_seed);
+	BVHTree *tree = BLI_bvhtree_new(points_len, 0.0, 8, 8);
+
+	void *mem = MEM_mallocN(sizeof(float[3]) * points_len, __func__);
+	float (*points)[3] = (float (*)[3])mem;
+	void *mem_co = MEM_mallocN(sizeof(float[3]) * points_len, __func__);
+	float (*co)[3] = (float (*)[3])mem_co;
+	BVHTreeNearest *nearest = (BVHTreeNearest *)MEM_mallocN(sizeof(*nearest) * points_len, __func__);
+
+	for (int i = 0; i < points_len; i++) {
+		rng_v3_round(points[i], 3, rng, round, scale);
+		rng_v3_round(co[i], 3, rng, round, scale);
+		BLI_bvhtree_insert(tree, i, points[i], 1);
+		nearest[i].index = -1;
+		/* Every third query is skipped, every fifth is given a small distance, the others are
+		 * unbounded and start from the previous hit. */
+		nearest[i].dist_sq = (i % 3 == 0) ? 0.0f : ((i % 5 == 0) ? 1e-4f : FLT_MAX);
+	}
+	BLI_bvhtree_balance(tree);
+
+	BLI_bvhtree_find_nearest_batch(tree, co, points_len, nearest, NULL, NULL);
+
+	for (int i = 0; i < points_len; i++) {
+		BVHTreeNearest nearest_single;
+		if (i % 3 == 0) {
+			EXPECT_EQ(-1, nearest[i].index);
+			continue;
+		}
+		nearest_single.index = -1;
+		nearest_single.dist_sq = (i % 5 == 0) ? 1e-4f : FLT_MAX;
+		BLI_bvhtree_find_nearest(tree, co[i], &nearest_single, NULL, NULL);
+		/* Seeded searches may return another node at the same distance. */
+		EXPECT_NEAR(nearest_single.dist_sq, nearest[i].dist_sq, 1e-6f);
+		if (nearest_single.index == -1) {
+			EXPECT_EQ(-1, nearest[i].index);
+		}
+		else {
+			ASSERT_NE(-1, nearest[i].index);
+			EXPECT_NEAR(nearest_single.dist_sq, len_squared_v3v3(co[i], points[nearest[i].index]), 1e-6f);
+		}
+	}
+
+	BLI_bvhtree_free(tree);
+	BLI_rng_free(rng);
+	MEM_freeN(points);
+	MEM_freeN(co);
+	MEM_freeN(nearest);
+}
+
+TEST(kdopbvh, FindNearestBatch_2000)	{ find_nearest_batch_test(2000, 1.0, 1000, 12); }
+
+static void ray_cast_batch_test(int points_len, float scale, int round, int random_seed)
+{
+	struct RNG *rng = BLI_rng_new(random_seed);
+	BVHTree *tree = BLI_bvhtree_new(points_len, 0.0, 8, 8);
+
+	void *mem = MEM_mallocN(sizeof(float[3]) * points_len, __func__);
+	float (*points)[3] = (float (*)[3])mem;
+	void *mem_co = MEM_mallocN(sizeof(float[3]) * points_len, __func__);
+	float (*co)[3] = (float (*)[3])mem_co;
+	void *mem_dir = MEM_mallocN(sizeof(float[3]) * points_len, __func__);
+	float (*dir)[3] = (float (*)[3])mem_dir;
+	BVHTreeRayHit *hit = (BVHTreeRayHit *)MEM_mallocN(sizeof(*hit) * points_len, __func__);
+
+	for (int i = 0; i < points_len; i++) {
+		rng_v3_round(points[i], 3, rng, round, scale);
+		BLI_bvhtree_insert(tree, i, points[i], 1);
+	}
+	BLI_bvhtree_balance(tree);
+
+	/* Rays from outside the points, aimed at them. */
+	for (int i = 0; i < points_len; i++) {
+		rng_v3_round(co[i], 3, rng, round, scale);
+		normalize_v3(co[i]);
+		mul_v3_fl(co[i], 2.0f * scale);
+		sub_v3_v3v3(dir[i], points[i], co[i]);
+		normalize_v3(dir[i]);
+		hit[i].index = -1;
+		hit[i].dist = BVH_RAYCAST_DIST_MAX;
+	}
+
+	BLI_bvhtree_ray_cast_batch(tree, co, dir, points_len, 0.01f, hit, NULL, NULL, BVH_RAYCAST_DEFAULT);
+
+	for (int i = 0; i < points_len; i++) {
+		BVHTreeRayHit hit_single;
+		hit_single.index = -1;
+		hit_single.dist = BVH_RAYCAST_DIST_MAX;
+		BLI_bvhtree_ray_cast(tree, co[i], dir[i], 0.01f, &hit_single, NULL, NULL);
+		EXPECT_GE(hit[i].index, 0);
+		EXPECT_EQ(hit_single.index, hit[i].index);
+		EXPECT_EQ(hit_single.dist, hit[i].dist);
+	}
+
+	BLI_bvhtree_free(tree);
+	BLI_rng_free(rng);
+	MEM_freeN(points);
+	MEM_freeN(co);
+	MEM_freeN(dir);
+	MEM_freeN(hit);
+}
+
+TEST(kdopbvh, RayCastBatch_2000)	{ ray_cast_batch_test(2000, 1.0, 1000, 34); }
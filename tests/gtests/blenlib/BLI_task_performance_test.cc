@@ -0,0 +1,155 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "atomic_ops.h"
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_utildefines.h"
+#include "BLI_task.h"
+#include "PIL_time_utildefines.h"
+}
+
+/* Scheduling overhead of tiny tasks, and how it scales with the number of threads. */
+
+/* Run the longest tests! */
+//#define TASK_RUN_BIG
+
+#ifdef TASK_RUN_BIG
+#  define NUM_TASKS 1000000
+#  define NESTED_DEPTH 20
+#  define RANGE_SIZE 100000000
+#else
+#  define NUM_TASKS 100000
+#  define NESTED_DEPTH 16
+#  define RANGE_SIZE 10000000
+#endif
+
+static const int num_threads_cases[] = {1, 2, 4, 8, 16, 32, 64};
+
+/* Pushing many empty tasks from the main thread, all go through the global queue. */
+
+static void task_empty_func(TaskPool *__restrict pool, void *UNUSED(taskdata), int UNUSED(threadid))
+{
+	uint32_t *count = (uint32_t *)BLI_task_pool_userdata(pool);
+	atomic_add_and_fetch_uint32(count, 1);
+}
+
+TEST(task, PoolEmptyTasks)
+{
+	printf("\n========== STARTING %s ==========\n", "PoolEmptyTasks");
+
+	for (int i = 0; i < (int)ARRAY_SIZE(num_threads_cases); i++) {
+		TaskScheduler *scheduler = BLI_task_scheduler_create(num_threads_cases[i]);
+		uint32_t count = 0;
+
+		printf("%d threads:\n", num_threads_cases[i]);
+
+		TIMEIT_START(pool_empty_tasks);
+
+		TaskPool *pool = BLI_task_pool_create(scheduler, &count);
+		for (int j = 0; j < NUM_TASKS; j++) {
+			BLI_task_pool_push(pool, task_empty_func, NULL, false, TASK_PRIORITY_LOW);
+		}
+		BLI_task_pool_work_and_wait(pool);
+		BLI_task_pool_free(pool);
+
+		TIMEIT_END(pool_empty_tasks);
+
+		EXPECT_EQ(count, NUM_TASKS);
+
+		BLI_task_scheduler_free(scheduler);
+	}
+
+	printf("========== ENDED %s ==========\n\n", "PoolEmptyTasks");
+}
+
+/* Tasks spawning two sub-tasks until a given depth, like recursive algorithms do.
+ * Sub-tasks are pushed from worker threads, so they go to the threads' own queues. */
+
+static void task_nested_func(TaskPool *__restrict pool, void *taskdata, int threadid)
+{
+	const int depth = GET_INT_FROM_POINTER(taskdata);
+	uint32_t *count = (uint32_t *)BLI_task_pool_userdata(pool);
+
+	atomic_add_and_fetch_uint32(count, 1);
+
+	if (depth < NESTED_DEPTH) {
+		BLI_task_pool_push_from_thread(
+		        pool, task_nested_func, SET_INT_IN_POINTER(depth + 1), false, TASK_PRIORITY_HIGH, threadid);
+		BLI_task_pool_push_from_thread(
+		        pool, task_nested_func, SET_INT_IN_POINTER(depth + 1), false, TASK_PRIORITY_HIGH, threadid);
+	}
+}
+
+TEST(task, PoolNestedTasks)
+{
+	printf("\n========== STARTING %s ==========\n", "PoolNestedTasks");
+
+	for (int i = 0; i < (int)ARRAY_SIZE(num_threads_cases); i++) {
+		TaskScheduler *scheduler = BLI_task_scheduler_create(num_threads_cases[i]);
+		uint32_t count = 0;
+
+		printf("%d threads:\n", num_threads_cases[i]);
+
+		TIMEIT_START(pool_nested_tasks);
+
+		TaskPool *pool = BLI_task_pool_create(scheduler, &count);
+		BLI_task_pool_push(pool, task_nested_func, SET_INT_IN_POINTER(0), false, TASK_PRIORITY_HIGH);
+		BLI_task_pool_work_and_wait(pool);
+		BLI_task_pool_free(pool);
+
+		TIMEIT_END(pool_nested_tasks);
+
+		EXPECT_EQ(count, (1u << (NESTED_DEPTH + 1)) - 1);
+
+		BLI_task_scheduler_free(scheduler);
+	}
+
+	printf("========== ENDED %s ==========\n\n", "PoolNestedTasks");
+}
+
+/* Parallel range with very cheap iterations, static and dynamic scheduling
+ * (uses the global scheduler, so all the threads of the system). */
+
+static void task_range_func(void *userdata, void *userdata_chunk, const int iter, const int UNUSED(thread_id))
+{
+	float *data = (float *)userdata;
+	int *count = (int *)userdata_chunk;
+
+	data[iter] = data[iter] * 0.5f + 1.0f;
+	(*count)++;
+}
+
+static void task_range_test(const bool use_dynamic_scheduling)
+{
+	float *data = (float *)MEM_callocN(sizeof(*data) * RANGE_SIZE, __func__);
+	int count = 0;
+
+	TIMEIT_START(parallel_range);
+
+	BLI_task_parallel_range_ex(
+	        0, RANGE_SIZE, data, &count, sizeof(count), task_range_func, true, use_dynamic_scheduling);
+
+	TIMEIT_END(parallel_range);
+
+	EXPECT_EQ(data[0], 1.0f);
+	EXPECT_EQ(data[RANGE_SIZE - 1], 1.0f);
+
+	MEM_freeN(data);
+}
+
+TEST(task, ParallelRangeStatic)
+{
+	printf("\n========== STARTING %s ==========\n", "ParallelRangeStatic");
+	task_range_test(false);
+	printf("========== ENDED %s ==========\n\n", "ParallelRangeStatic");
+}
+
+TEST(task, ParallelRangeDynamic)
+{
+	printf("\n========== STARTING %s ==========\n", "ParallelRangeDynamic");
+	task_range_test(true);
+	printf("========== ENDED %s ==========\n\n", "ParallelRangeDynamic");
+}
@@ -6,6 +6,8 @@
 #include "atomic_ops.h"
 
 extern "C" {
+#include "MEM_guardedalloc.h"
+
 #include "BLI_mempool.h"
 #include "BLI_task.h"
 #include "BLI_utildefines.h"
@@ -74,3 +76,157 @@ TEST(task, MempoolIter)
 
 	BLI_mempool_destroy(mempool);
 }
+
+typedef struct MempoolLocalChunk {
+	BLI_mempool_local *local;
+} MempoolLocalChunk;
+
+static void task_mempool_local_alloc_func(void *userdata, void *userdata_chunk, const int iter, const int UNUSED(thread_id))
+{
+	BLI_mempool *mempool = (BLI_mempool *)userdata;
+	MempoolLocalChunk *chunk = (MempoolLocalChunk *)userdata_chunk;
+
+	if (chunk->local == NULL) {
+		chunk->local = BLI_mempool_local_create(mempool);
+	}
+
+	int *data = (int *)BLI_mempool_local_alloc(chunk->local);
+	*data = iter;
+
+	/* Free some of the items straight away, to reuse them from the local free list. */
+	if (iter % 5 == 0) {
+		BLI_mempool_local_free(chunk->local, data);
+	}
+}
+
+typedef struct MempoolLocalFreeData {
+	BLI_mempool *mempool;
+	int **table;
+} MempoolLocalFreeData;
+
+static void task_mempool_local_free_func(void *userdata, void *userdata_chunk, const int iter, const int UNUSED(thread_id))
+{
+	MempoolLocalFreeData *data = (MempoolLocalFreeData *)userdata;
+	MempoolLocalChunk *chunk = (MempoolLocalChunk *)userdata_chunk;
+
+	if (chunk->local == NULL) {
+		chunk->local = BLI_mempool_local_create(data->mempool);
+	}
+
+	/* Items were allocated by other tasks, they are freed into the cache of this one. */
+	if (*data->table[iter] % 3 == 0) {
+		BLI_mempool_local_free(chunk->local, data->table[iter]);
+	}
+}
+
+static void task_mempool_local_finalize_func(void *UNUSED(userdata), void *userdata_chunk)
+{
+	MempoolLocalChunk *chunk = (MempoolLocalChunk *)userdata_chunk;
+
+	if (chunk->local != NULL) {
+		BLI_mempool_local_destroy(chunk->local);
+	}
+}
+
+TEST(task, MempoolLocalAlloc)
+{
+	/* Only preallocate part of the items, caches share them and then allocate new chunks. */
+	BLI_mempool *mempool = BLI_mempool_create(sizeof(int), NUM_ITEMS / 4, 32, BLI_MEMPOOL_ALLOW_ITER);
+	MempoolLocalChunk chunk = {NULL};
+	BLI_mempool_iter iter;
+	bool found[NUM_ITEMS] = {false};
+	int *data;
+	int i, num_items;
+
+	BLI_task_parallel_range_finalize(
+	        0, NUM_ITEMS, mempool, &chunk, sizeof(chunk),
+	        task_mempool_local_alloc_func, task_mempool_local_finalize_func, true, true);
+
+	EXPECT_EQ(BLI_mempool_count(mempool), NUM_ITEMS - NUM_ITEMS / 5);
+
+	/* All items are there once. */
+	num_items = 0;
+	BLI_mempool_iternew(mempool, &iter);
+	while ((data = (int *)BLI_mempool_iterstep(&iter))) {
+		EXPECT_TRUE(*data >= 0 && *data < NUM_ITEMS);
+		EXPECT_NE(*data % 5, 0);
+		EXPECT_FALSE(found[*data]);
+		found[*data] = true;
+		num_items++;
+	}
+	EXPECT_EQ(num_items, NUM_ITEMS - NUM_ITEMS / 5);
+
+	/* Free some of them from other threads than the ones which allocated them. */
+	MempoolLocalFreeData free_data = {mempool, (int **)BLI_mempool_as_tableN(mempool, __func__)};
+	BLI_task_parallel_range_finalize(
+	        0, num_items, &free_data, &chunk, sizeof(chunk),
+	        task_mempool_local_free_func, task_mempool_local_finalize_func, true, false);
+	MEM_freeN(free_data.table);
+
+	num_items = 0;
+	for (i = 0; i < NUM_ITEMS; i++) {
+		if (i % 5 != 0 && i % 3 != 0) {
+			num_items++;
+		}
+	}
+	EXPECT_EQ(BLI_mempool_count(mempool), num_items);
+
+	/* Freed items are back in the pool, for direct use again. */
+	for (i = 0; i < NUM_ITEMS; i++) {
+		data = (int *)BLI_mempool_alloc(mempool);
+		*data = -1;
+	}
+	EXPECT_EQ(BLI_mempool_count(mempool), num_items + NUM_ITEMS);
+
+	BLI_mempool_destroy(mempool);
+}
+
+static void task_mempool_iter_local_alloc_func(void *userdata, void *userdata_chunk, MempoolIterData *item)
+{
+	BLI_mempool *mempool_dst = (BLI_mempool *)userdata;
+	MempoolLocalChunk *chunk = (MempoolLocalChunk *)userdata_chunk;
+	int *data = (int *)item;
+
+	if (chunk->local == NULL) {
+		chunk->local = BLI_mempool_local_create(mempool_dst);
+	}
+
+	int *data_dst = (int *)BLI_mempool_local_alloc(chunk->local);
+	*data_dst = *data;
+}
+
+/* Same as the toolflags of BMesh elements: allocate an item in another pool for each item of a pool. */
+TEST(task, MempoolIterLocalAlloc)
+{
+	BLI_mempool *mempool_src = BLI_mempool_create(sizeof(int), NUM_ITEMS, 32, BLI_MEMPOOL_ALLOW_ITER);
+	BLI_mempool *mempool_dst = BLI_mempool_create(sizeof(int), NUM_ITEMS, 32, BLI_MEMPOOL_ALLOW_ITER);
+	MempoolLocalChunk chunk = {NULL};
+	BLI_mempool_iter iter;
+	bool found[NUM_ITEMS] = {false};
+	int *data;
+	int i, num_items;
+
+	for (i = 0; i < NUM_ITEMS; i++) {
+		data = (int *)BLI_mempool_alloc(mempool_src);
+		*data = i;
+	}
+
+	BLI_task_parallel_mempool_finalize(
+	        mempool_src, mempool_dst, &chunk, sizeof(chunk),
+	        task_mempool_iter_local_alloc_func, task_mempool_local_finalize_func, true);
+
+	EXPECT_EQ(BLI_mempool_count(mempool_dst), NUM_ITEMS);
+
+	num_items = 0;
+	BLI_mempool_iternew(mempool_dst, &iter);
+	while ((data = (int *)BLI_mempool_iterstep(&iter))) {
+		EXPECT_TRUE(*data >= 0 && *data < NUM_ITEMS);
+		EXPECT_FALSE(found[*data]);
+		found[*data] = true;
+		num_items++;
+	}
+	EXPECT_EQ(num_items, NUM_ITEMS);
+
+	BLI_mempool_destroy(mempool_src);
+	BLI_mempool_destroy(mempool_dst);
+}
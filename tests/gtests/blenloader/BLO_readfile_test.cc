@@ -0,0 +1,75 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_utildefines.h"
+#include "BLI_fileops.h"
+#include "BLI_listbase.h"
+#include "BLI_path_util.h"
+#include "BLI_rand.h"
+#include "DNA_genfile.h"
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "BKE_appdir.h"
+#include "BKE_customdata.h"
+#include "BKE_global.h"
+#include "BKE_library.h"
+#include "BKE_main.h"
+#include "BKE_mesh.h"
+#include "BLO_readfile.h"
+#include "BLO_writefile.h"
+}
+
+/* Several megabytes, compressed files are written in frames of one megabyte. */
+#define TOTVERT 200000
+
+/* Compressed files read from memory, as for LibLoad from bytes, must contain all the frames. */
+TEST(blo_readfile, ReadCompressedFromMemory)
+{
+	char filepath[FILE_MAX];
+	size_t mem_size;
+
+	DNA_sdna_current_init();
+	BKE_tempdir_init(NULL);
+	BLI_join_dirfile(filepath, sizeof(filepath), BKE_tempdir_base(), "blo_readfile_test.blend");
+
+	Main *bmain = BKE_main_new();
+	Mesh *me = BKE_mesh_add(bmain, "Mesh");
+	RNG *rng = BLI_rng_new(0);
+
+	me->totvert = TOTVERT;
+	me->mvert = (MVert *)CustomData_add_layer(&me->vdata, CD_MVERT, CD_CALLOC, NULL, me->totvert);
+	for (int i = 0; i < me->totvert; i++) {
+		BLI_rng_get_float_unit_v3(rng, me->mvert[i].co);
+	}
+
+	ASSERT_TRUE(BLO_write_file(bmain, filepath, G_FILE_COMPRESS, NULL, NULL));
+
+	void *mem = BLI_file_read_binary_as_mem(filepath, 0, &mem_size);
+	ASSERT_TRUE(mem != NULL);
+	/* gzip magic */
+	EXPECT_EQ(0x1f, ((unsigned char *)mem)[0]);
+	EXPECT_EQ(0x8b, ((unsigned char *)mem)[1]);
+
+	BlendFileData *bfd = BLO_read_from_memory(mem, (int)mem_size, NULL, BLO_READ_SKIP_USERDEF);
+	ASSERT_TRUE(bfd != NULL);
+
+	Mesh *me_read = (Mesh *)BLI_findstring(&bfd->main->mesh, "MEMesh", offsetof(ID, name));
+	ASSERT_TRUE(me_read != NULL);
+	ASSERT_EQ(me->totvert, me_read->totvert);
+	ASSERT_TRUE(me_read->mvert != NULL);
+	for (int i = 0; i < me->totvert; i++) {
+		EXPECT_EQ(me->mvert[i].co[0], me_read->mvert[i].co[0]);
+		EXPECT_EQ(me->mvert[i].co[1], me_read->mvert[i].co[1]);
+		EXPECT_EQ(me->mvert[i].co[2], me_read->mvert[i].co[2]);
+	}
+
+	BLO_blendfiledata_free(bfd);
+	MEM_freeN(mem);
+	BLI_delete(filepath, false, false);
+	BLI_rng_free(rng);
+	BKE_main_free(bmain);
+	DNA_sdna_current_free();
+}
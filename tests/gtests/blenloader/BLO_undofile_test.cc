@@ -0,0 +1,68 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_utildefines.h"
+#include "BLI_listbase.h"
+#include "DNA_genfile.h"
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "BKE_customdata.h"
+#include "BKE_library.h"
+#include "BKE_main.h"
+#include "BKE_mesh.h"
+#include "BLO_undofile.h"
+#include "BLO_writefile.h"
+}
+
+/* Enough small data-blocks for the undo file to span many chunks. */
+#define TOTMESH 400
+#define TOTVERT 8
+
+static void mesh_verts_resize(Mesh *me, int totvert)
+{
+	CustomData_free(&me->vdata, me->totvert);
+	me->totvert = totvert;
+	me->mvert = (MVert *)CustomData_add_layer(&me->vdata, CD_MVERT, CD_CALLOC, NULL, me->totvert);
+	for (int i = 0; i < me->totvert; i++) {
+		me->mvert[i].co[0] = (float)i;
+	}
+}
+
+/* Growing one data-block must not make the undo step duplicate the data-blocks written after it. */
+TEST(blo_undofile, GrownIDSharesFollowingChunks)
+{
+	MemFile memfile_a = {{NULL}}, memfile_b = {{NULL}};
+
+	DNA_sdna_current_init();
+
+	Main *bmain = BKE_main_new();
+	for (int i = 0; i < TOTMESH; i++) {
+		mesh_verts_resize(BKE_mesh_add(bmain, "Mesh"), TOTVERT);
+	}
+
+	ASSERT_TRUE(BLO_write_file_mem(bmain, NULL, &memfile_a, 0));
+
+	Mesh *me_first = (Mesh *)bmain->mesh.first;
+	mesh_verts_resize(me_first, TOTVERT + 1);
+
+	ASSERT_TRUE(BLO_write_file_mem(bmain, &memfile_a, &memfile_b, 0));
+
+	/* Only the chunks of the grown mesh are new. */
+	EXPECT_LT(memfile_b.size, memfile_a.size / 20);
+
+	/* Both steps read back the same data where it is shared. */
+	int totchunk_b = 0, totident_b = 0;
+	for (MemFileChunk *chunk = (MemFileChunk *)memfile_b.chunks.first; chunk; chunk = (MemFileChunk *)chunk->next) {
+		totchunk_b++;
+		totident_b += chunk->ident;
+	}
+	EXPECT_GT(totident_b, totchunk_b / 2);
+
+	BLO_memfile_free(&memfile_a);
+	BLO_memfile_free(&memfile_b);
+	BKE_main_free(bmain);
+	DNA_sdna_current_free();
+}
@@ -37,3 +37,77 @@ TEST(bmesh_core, BMVertCreate) {
 	EXPECT_EQ(BM_mesh_elem_count(bm, BM_VERT), 3);
 	BM_mesh_free(bm);
 }
+
+/* Enough elements for the tool flags to be allocated in parallel (see BM_OMP_LIMIT). */
+#define GRID_SIZE 120
+
+TEST(bmesh_core, BMElemToolflagsEnsure) {
+	BMesh *bm;
+	BMVert *grid[GRID_SIZE][GRID_SIZE];
+	BMIter iter;
+	BMVert *v;
+	BMEdge *e;
+	BMFace *f;
+	int i, j;
+
+	BMeshCreateParams bm_params;
+	bm_params.use_toolflags = true;
+	bm = BM_mesh_create(&bm_mesh_allocsize_default, &bm_params);
+
+	for (i = 0; i < GRID_SIZE; i++) {
+		for (j = 0; j < GRID_SIZE; j++) {
+			const float co[3] = {(float)i, (float)j, 0.0f};
+			grid[i][j] = BM_vert_create(bm, co, NULL, BM_CREATE_NOP);
+		}
+	}
+	for (i = 0; i < GRID_SIZE - 1; i++) {
+		for (j = 0; j < GRID_SIZE - 1; j++) {
+			BM_face_create_quad_tri(
+			        bm, grid[i][j], grid[i + 1][j], grid[i + 1][j + 1], grid[i][j + 1], NULL, BM_CREATE_NOP);
+		}
+	}
+
+	BM_mesh_elem_toolflags_ensure(bm);
+
+	/* Every element has its own cleared flags. */
+	i = 0;
+	BM_ITER_MESH (v, &iter, bm, BM_VERTS_OF_MESH) {
+		ASSERT_TRUE(((BMVert_OFlag *)v)->oflags != NULL);
+		EXPECT_FALSE(BMO_vert_flag_test(bm, v, 1));
+		if (i++ % 2) {
+			BMO_vert_flag_enable(bm, v, 1);
+		}
+	}
+	i = 0;
+	BM_ITER_MESH (v, &iter, bm, BM_VERTS_OF_MESH) {
+		EXPECT_EQ(BMO_vert_flag_test(bm, v, 1) != 0, (i++ % 2) != 0);
+	}
+
+	i = 0;
+	BM_ITER_MESH (e, &iter, bm, BM_EDGES_OF_MESH) {
+		ASSERT_TRUE(((BMEdge_OFlag *)e)->oflags != NULL);
+		EXPECT_FALSE(BMO_edge_flag_test(bm, e, 1));
+		if (i++ % 2) {
+			BMO_edge_flag_enable(bm, e, 1);
+		}
+	}
+	i = 0;
+	BM_ITER_MESH (e, &iter, bm, BM_EDGES_OF_MESH) {
+		EXPECT_EQ(BMO_edge_flag_test(bm, e, 1) != 0, (i++ % 2) != 0);
+	}
+
+	i = 0;
+	BM_ITER_MESH (f, &iter, bm, BM_FACES_OF_MESH) {
+		ASSERT_TRUE(((BMFace_OFlag *)f)->oflags != NULL);
+		EXPECT_FALSE(BMO_face_flag_test(bm, f, 1));
+		if (i++ % 2) {
+			BMO_face_flag_enable(bm, f, 1);
+		}
+	}
+	i = 0;
+	BM_ITER_MESH (f, &iter, bm, BM_FACES_OF_MESH) {
+		EXPECT_EQ(BMO_face_flag_test(bm, f, 1) != 0, (i++ % 2) != 0);
+	}
+
+	BM_mesh_free(bm);
+}
@@ -0,0 +1,110 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+#include <math.h>
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_utildefines.h"
+#include "BLI_math_base.h"
+#include "bmesh.h"
+#include "tools/bmesh_decimate.h"
+#include "PIL_time_utildefines.h"
+}
+
+/* Collapse decimation of a big height-field grid, in one go and partitioned. */
+
+/* Run the longest tests! */
+//#define DECIMATE_RUN_BIG
+
+#ifdef DECIMATE_RUN_BIG
+#  define GRID_SIZE 2000
+#else
+#  define GRID_SIZE 500
+#endif
+
+#define DECIMATE_FACTOR 0.1f
+
+static float grid_height(const float x, const float y)
+{
+	return sinf(x * 0.05f) * cosf(y * 0.03f) * 5.0f;
+}
+
+static BMesh *grid_bmesh_create(const int size)
+{
+	const BMAllocTemplate allocsize = {(size + 1) * (size + 1), size * (size + 1) * 2, size * size * 4, size * size};
+	BMeshCreateParams bm_create_params = {0};
+	BMesh *bm = BM_mesh_create(&allocsize, &bm_create_params);
+	BMVert **verts = (BMVert **)MEM_mallocN(sizeof(*verts) * allocsize.totvert, __func__);
+
+	for (int y = 0, i = 0; y <= size; y++) {
+		for (int x = 0; x <= size; x++, i++) {
+			const float co[3] = {(float)x, (float)y, grid_height((float)x, (float)y)};
+			verts[i] = BM_vert_create(bm, co, NULL, BM_CREATE_NOP);
+		}
+	}
+
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			const int v = y * (size + 1) + x;
+			BM_face_create_quad_tri(
+			        bm, verts[v], verts[v + 1], verts[v + size + 2], verts[v + size + 1], NULL, BM_CREATE_NOP);
+		}
+	}
+
+	MEM_freeN(verts);
+
+	BM_mesh_normals_update(bm);
+	BM_mesh_elem_index_ensure(bm, BM_ALL);
+
+	return bm;
+}
+
+/* largest distance of a vertex to the original surface */
+static float grid_bmesh_error(BMesh *bm)
+{
+	BMIter iter;
+	BMVert *v;
+	float error = 0.0f;
+
+	BM_ITER_MESH (v, &iter, bm, BM_VERTS_OF_MESH) {
+		error = max_ff(error, fabsf(v->co[2] - grid_height(v->co[0], v->co[1])));
+	}
+	return error;
+}
+
+TEST(bmesh_decimate, CollapseGrid)
+{
+	printf("\n========== STARTING %s ==========\n", "CollapseGrid");
+
+	BMesh *bm_serial = grid_bmesh_create(GRID_SIZE);
+	BMesh *bm_partition = grid_bmesh_create(GRID_SIZE);
+	/* the decimator triangulates */
+	const int face_tot_target = (int)(bm_serial->totface * 2 * DECIMATE_FACTOR);
+
+	TIMEIT_START(decimate_collapse);
+	BM_mesh_decimate_collapse(bm_serial, DECIMATE_FACTOR, NULL, 0.0f, true, -1, 0.0f, false);
+	TIMEIT_END(decimate_collapse);
+
+	TIMEIT_START(decimate_collapse_partition);
+	BM_mesh_decimate_collapse(bm_partition, DECIMATE_FACTOR, NULL, 0.0f, true, -1, 0.0f, true);
+	TIMEIT_END(decimate_collapse_partition);
+
+	const float error_serial = grid_bmesh_error(bm_serial);
+	const float error_partition = grid_bmesh_error(bm_partition);
+
+	printf("faces: %d (target %d), partitioned: %d\n", bm_serial->totface, face_tot_target, bm_partition->totface);
+	printf("max error: %f, partitioned: %f\n", error_serial, error_partition);
+
+	/* collapsing an edge removes one or two faces */
+	EXPECT_LE(abs(bm_serial->totface - face_tot_target), 1);
+	EXPECT_LE(abs(bm_partition->totface - face_tot_target), 1);
+
+	/* slab boundaries are decimated last, allow some loss */
+	EXPECT_LE(error_partition, error_serial * 1.5f + 0.01f);
+
+	BM_mesh_free(bm_serial);
+	BM_mesh_free(bm_partition);
+
+	printf("========== ENDED %s ==========\n\n", "CollapseGrid");
+}
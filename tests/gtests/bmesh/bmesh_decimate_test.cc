@@ -0,0 +1,98 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+#include <math.h>
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_utildefines.h"
+#include "BLI_threads.h"
+#include "bmesh.h"
+#include "tools/bmesh_decimate.h"
+}
+
+/* Partitioned collapse decimation, run from several threads even on a single core. */
+
+#define GRID_SIZE 120
+#define NUM_THREADS 4
+
+static BMesh *grid_bmesh_create(const int size)
+{
+	const BMAllocTemplate allocsize = {(size + 1) * (size + 1), size * (size + 1) * 2, size * size * 4, size * size};
+	BMeshCreateParams bm_create_params = {0};
+	BMesh *bm = BM_mesh_create(&allocsize, &bm_create_params);
+	BMVert **verts = (BMVert **)MEM_mallocN(sizeof(*verts) * allocsize.totvert, __func__);
+
+	for (int y = 0, i = 0; y <= size; y++) {
+		for (int x = 0; x <= size; x++, i++) {
+			const float co[3] = {(float)x, (float)y, sinf((float)x * 0.2f) * cosf((float)y * 0.15f) * 3.0f};
+			verts[i] = BM_vert_create(bm, co, NULL, BM_CREATE_NOP);
+		}
+	}
+
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			const int v = y * (size + 1) + x;
+			BM_face_create_quad_tri(
+			        bm, verts[v], verts[v + 1], verts[v + size + 2], verts[v + size + 1], NULL, BM_CREATE_NOP);
+		}
+	}
+
+	MEM_freeN(verts);
+
+	/* selection and hidden flags must survive the collapse of neighboring slabs */
+	BMIter iter;
+	BMVert *v;
+	BM_ITER_MESH (v, &iter, bm, BM_VERTS_OF_MESH) {
+		BM_elem_flag_enable(v, BM_ELEM_SELECT);
+	}
+
+	BM_mesh_normals_update(bm);
+	BM_mesh_elem_index_ensure(bm, BM_ALL);
+
+	return bm;
+}
+
+/* every edge uses one or two faces and the grid stays a disk */
+static void grid_bmesh_expect_manifold(BMesh *bm)
+{
+	BMIter iter;
+	BMEdge *e;
+	BMVert *v;
+
+	BM_ITER_MESH (e, &iter, bm, BM_EDGES_OF_MESH) {
+		EXPECT_TRUE(BM_edge_is_manifold(e) || BM_edge_is_boundary(e));
+		EXPECT_TRUE(BM_edge_find_double(e) == NULL);
+	}
+
+	BM_ITER_MESH (v, &iter, bm, BM_VERTS_OF_MESH) {
+		EXPECT_TRUE(BM_vert_is_manifold(v));
+		EXPECT_TRUE(BM_elem_flag_test(v, BM_ELEM_SELECT));
+	}
+
+	EXPECT_EQ(1, bm->totvert - bm->totedge + bm->totface);
+}
+
+TEST(bmesh_decimate, CollapsePartitionThreaded)
+{
+	const float factors[] = {0.5f, 0.2f, 0.05f};
+
+	BLI_threadapi_init();
+	BLI_system_num_threads_override_set(NUM_THREADS);
+
+	for (int i = 0; i < (int)ARRAY_SIZE(factors); i++) {
+		BMesh *bm = grid_bmesh_create(GRID_SIZE);
+		/* the decimator triangulates */
+		const int face_tot_target = (int)(bm->totface * 2 * factors[i]);
+
+		BM_mesh_decimate_collapse(bm, factors[i], NULL, 0.0f, true, -1, 0.0f, true);
+
+		/* collapsing an edge removes one or two faces */
+		EXPECT_LE(abs(bm->totface - face_tot_target), 1);
+		grid_bmesh_expect_manifold(bm);
+
+		BM_mesh_free(bm);
+	}
+
+	BLI_threadapi_exit();
+}
@@ -0,0 +1,129 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+#include <math.h>
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_utildefines.h"
+#include "BLI_math.h"
+#include "bmesh.h"
+#include "tools/bmesh_intersect.h"
+#include "PIL_time_utildefines.h"
+}
+
+/* Boolean union of two dense, overlapping UV-spheres (as done by the boolean modifier). */
+
+/* tag faces from the second operand, #BM_ELEM_TAG is used by the intersection code */
+#define BM_FACE_TAG BM_ELEM_DRAW
+
+/* Run the longest tests! */
+//#define INTERSECT_RUN_BIG
+
+#ifdef INTERSECT_RUN_BIG
+#  define SPHERE_SEGMENTS 768
+#else
+#  define SPHERE_SEGMENTS 512
+#endif
+
+static void sphere_bmesh_add(BMesh *bm, const float center[3], const float radius, const int segments, const bool tag)
+{
+	const int rings = segments / 2;
+	BMVert **verts = (BMVert **)MEM_mallocN(sizeof(*verts) * (size_t)((rings - 1) * segments), __func__);
+	BMVert *v_pole[2];
+	float co[3];
+
+	for (int r = 1, i = 0; r < rings; r++) {
+		const float phi = (float)r / rings * (float)M_PI;
+		for (int s = 0; s < segments; s++, i++) {
+			const float theta = (float)s / segments * 2.0f * (float)M_PI;
+			co[0] = center[0] + radius * sinf(phi) * cosf(theta);
+			co[1] = center[1] + radius * sinf(phi) * sinf(theta);
+			co[2] = center[2] + radius * cosf(phi);
+			verts[i] = BM_vert_create(bm, co, NULL, BM_CREATE_NOP);
+		}
+	}
+	for (int p = 0; p < 2; p++) {
+		co[0] = center[0];
+		co[1] = center[1];
+		co[2] = center[2] + (p ? -radius : radius);
+		v_pole[p] = BM_vert_create(bm, co, NULL, BM_CREATE_NOP);
+	}
+
+	for (int s = 0; s < segments; s++) {
+		const int s_next = (s + 1) % segments;
+		BMFace *f;
+
+		f = BM_face_create_quad_tri(bm, v_pole[0], verts[s], verts[s_next], NULL, NULL, BM_CREATE_NOP);
+		BM_elem_flag_set(f, BM_FACE_TAG, tag);
+
+		for (int r = 1; r < rings - 1; r++) {
+			const int v = (r - 1) * segments;
+			f = BM_face_create_quad_tri(
+			        bm, verts[v + s], verts[v + segments + s], verts[v + segments + s_next], verts[v + s_next],
+			        NULL, BM_CREATE_NOP);
+			BM_elem_flag_set(f, BM_FACE_TAG, tag);
+		}
+
+		const int v = (rings - 2) * segments;
+		f = BM_face_create_quad_tri(bm, verts[v + s_next], verts[v + s], v_pole[1], NULL, NULL, BM_CREATE_NOP);
+		BM_elem_flag_set(f, BM_FACE_TAG, tag);
+	}
+
+	MEM_freeN(verts);
+}
+
+static int bm_face_isect_pair(BMFace *f, void *UNUSED(user_data))
+{
+	return BM_elem_flag_test(f, BM_FACE_TAG) ? 1 : 0;
+}
+
+TEST(bmesh_intersect, BooleanUnionSpheres)
+{
+	printf("\n========== STARTING %s ==========\n", "BooleanUnionSpheres");
+
+	const float center_a[3] = {0.0f, 0.0f, 0.0f};
+	const float center_b[3] = {0.5f, 0.3f, 0.2f};
+	BMeshCreateParams bm_create_params = {0};
+	BMesh *bm = BM_mesh_create(&bm_mesh_allocsize_default, &bm_create_params);
+
+	sphere_bmesh_add(bm, center_a, 1.0f, SPHERE_SEGMENTS, false);
+	sphere_bmesh_add(bm, center_b, 0.8f, SPHERE_SEGMENTS - 100, true);
+	BM_mesh_normals_update(bm);
+
+	printf("%d faces\n", bm->totface);
+
+	const int looptris_tot = poly_to_tri_count(bm->totface, bm->totloop);
+	BMLoop *(*looptris)[3] = (BMLoop *(*)[3])MEM_mallocN(sizeof(*looptris) * (size_t)looptris_tot, __func__);
+	int tottri;
+	bool has_isect;
+
+	BM_mesh_calc_tessellation_beauty(bm, looptris, &tottri);
+
+	TIMEIT_START(boolean_union);
+	has_isect = BM_mesh_intersect(
+	        bm, looptris, tottri, bm_face_isect_pair, NULL,
+	        false, false, true, true, false, BMESH_ISECT_BOOLEAN_UNION, 1e-6f);
+	TIMEIT_END(boolean_union);
+
+	MEM_freeN(looptris);
+
+	printf("%d vertices, %d edges, %d faces\n", bm->totvert, bm->totedge, bm->totface);
+
+	EXPECT_TRUE(has_isect);
+
+	/* the union of two closed surfaces is closed */
+	BMIter iter;
+	BMEdge *e;
+	int totedge_non_manifold = 0;
+	BM_ITER_MESH (e, &iter, bm, BM_EDGES_OF_MESH) {
+		if (!BM_edge_is_manifold(e)) {
+			totedge_non_manifold++;
+		}
+	}
+	EXPECT_EQ(totedge_non_manifold, 0);
+
+	BM_mesh_free(bm);
+
+	printf("========== ENDED %s ==========\n\n", "BooleanUnionSpheres");
+}
@@ -0,0 +1,176 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+#include <string.h>
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_utildefines.h"
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "BKE_customdata.h"
+#include "BKE_mesh.h"
+#include "bmesh.h"
+#include "PIL_time_utildefines.h"
+}
+
+/* Mesh -> BMesh -> Mesh round-trip (as done when entering and leaving edit-mode) on big grids. */
+
+/* Run the longest tests! */
+//#define MESH_CONV_RUN_BIG
+
+#ifdef MESH_CONV_RUN_BIG
+#  define GRID_SIZE 2500
+#else
+#  define GRID_SIZE 1000
+#endif
+
+static void mesh_empty_init(Mesh *me)
+{
+	memset(me, 0, sizeof(*me));
+	CustomData_reset(&me->vdata);
+	CustomData_reset(&me->edata);
+	CustomData_reset(&me->fdata);
+	CustomData_reset(&me->ldata);
+	CustomData_reset(&me->pdata);
+}
+
+/* Fill a mesh with a grid of size * size quads, with a float layer on vertices and an UV layer. */
+static void mesh_grid_init(Mesh *me, const int size)
+{
+	const int totvert = (size + 1) * (size + 1);
+	const int totedge_x = (size + 1) * size;
+	const int totedge = totedge_x * 2;
+	const int totpoly = size * size;
+	const int totloop = totpoly * 4;
+
+	mesh_empty_init(me);
+
+	CustomData_add_layer(&me->vdata, CD_MVERT, CD_CALLOC, NULL, totvert);
+	CustomData_add_layer(&me->edata, CD_MEDGE, CD_CALLOC, NULL, totedge);
+	CustomData_add_layer(&me->ldata, CD_MLOOP, CD_CALLOC, NULL, totloop);
+	CustomData_add_layer(&me->pdata, CD_MPOLY, CD_CALLOC, NULL, totpoly);
+	float *vfloat = (float *)CustomData_add_layer(&me->vdata, CD_PROP_FLT, CD_CALLOC, NULL, totvert);
+	MLoopUV *mloopuv = (MLoopUV *)CustomData_add_layer(&me->ldata, CD_MLOOPUV, CD_CALLOC, NULL, totloop);
+
+	me->totvert = totvert;
+	me->totedge = totedge;
+	me->totloop = totloop;
+	me->totpoly = totpoly;
+	me->act_face = -1;
+	BKE_mesh_update_customdata_pointers(me, false);
+
+	for (int y = 0, i = 0; y <= size; y++) {
+		for (int x = 0; x <= size; x++, i++) {
+			me->mvert[i].co[0] = (float)x;
+			me->mvert[i].co[1] = (float)y;
+			me->mvert[i].no[2] = 32767;
+			vfloat[i] = (float)i;
+		}
+	}
+
+	/* edges along x first, then along y */
+	for (int y = 0, i = 0; y <= size; y++) {
+		for (int x = 0; x < size; x++, i++) {
+			me->medge[i].v1 = y * (size + 1) + x;
+			me->medge[i].v2 = y * (size + 1) + x + 1;
+		}
+	}
+	for (int y = 0, i = totedge_x; y < size; y++) {
+		for (int x = 0; x <= size; x++, i++) {
+			me->medge[i].v1 = y * (size + 1) + x;
+			me->medge[i].v2 = (y + 1) * (size + 1) + x;
+		}
+	}
+
+	for (int y = 0, i = 0; y < size; y++) {
+		for (int x = 0; x < size; x++, i++) {
+			const int v = y * (size + 1) + x;
+			MLoop *ml = &me->mloop[i * 4];
+
+			me->mpoly[i].loopstart = i * 4;
+			me->mpoly[i].totloop = 4;
+
+			ml[0].v = v;
+			ml[0].e = y * size + x;
+			ml[1].v = v + 1;
+			ml[1].e = totedge_x + y * (size + 1) + x + 1;
+			ml[2].v = v + size + 2;
+			ml[2].e = (y + 1) * size + x;
+			ml[3].v = v + size + 1;
+			ml[3].e = totedge_x + y * (size + 1) + x;
+
+			for (int j = 0; j < 4; j++) {
+				mloopuv[i * 4 + j].uv[0] = me->mvert[ml[j].v].co[0] / (float)size;
+				mloopuv[i * 4 + j].uv[1] = me->mvert[ml[j].v].co[1] / (float)size;
+			}
+		}
+	}
+}
+
+TEST(bmesh_mesh_conv, MeshRoundTrip)
+{
+	printf("\n========== STARTING %s ==========\n", "MeshRoundTrip");
+
+	Mesh me_src, me_dst;
+	mesh_grid_init(&me_src, GRID_SIZE);
+	mesh_empty_init(&me_dst);
+
+	const BMAllocTemplate allocsize = BMALLOC_TEMPLATE_FROM_ME(&me_src);
+	BMeshCreateParams bm_create_params = {0};
+	BMesh *bm = BM_mesh_create(&allocsize, &bm_create_params);
+
+	BMeshFromMeshParams bm_from_me_params = {0};
+	bm_from_me_params.calc_face_normal = true;
+
+	TIMEIT_START(mesh_to_bmesh);
+	BM_mesh_bm_from_me(bm, &me_src, &bm_from_me_params);
+	TIMEIT_END(mesh_to_bmesh);
+
+	EXPECT_EQ(bm->totvert, me_src.totvert);
+	EXPECT_EQ(bm->totedge, me_src.totedge);
+	EXPECT_EQ(bm->totloop, me_src.totloop);
+	EXPECT_EQ(bm->totface, me_src.totpoly);
+
+	BMeshToMeshParams bm_to_me_params = {0};
+
+	TIMEIT_START(bmesh_to_mesh);
+	BM_mesh_bm_to_me(bm, &me_dst, &bm_to_me_params);
+	TIMEIT_END(bmesh_to_mesh);
+
+	ASSERT_EQ(me_dst.totvert, me_src.totvert);
+	ASSERT_EQ(me_dst.totedge, me_src.totedge);
+	ASSERT_EQ(me_dst.totloop, me_src.totloop);
+	ASSERT_EQ(me_dst.totpoly, me_src.totpoly);
+
+	/* elements are written back in the same order, with the same custom-data */
+	const float *vfloat_src = (const float *)CustomData_get_layer(&me_src.vdata, CD_PROP_FLT);
+	const float *vfloat_dst = (const float *)CustomData_get_layer(&me_dst.vdata, CD_PROP_FLT);
+	for (int i = 0; i < me_src.totvert; i++) {
+		EXPECT_EQ(me_dst.mvert[i].co[0], me_src.mvert[i].co[0]);
+		EXPECT_EQ(me_dst.mvert[i].co[1], me_src.mvert[i].co[1]);
+		EXPECT_EQ(vfloat_dst[i], vfloat_src[i]);
+	}
+	for (int i = 0; i < me_src.totedge; i++) {
+		EXPECT_EQ(me_dst.medge[i].v1, me_src.medge[i].v1);
+		EXPECT_EQ(me_dst.medge[i].v2, me_src.medge[i].v2);
+	}
+	const MLoopUV *mloopuv_src = (const MLoopUV *)CustomData_get_layer(&me_src.ldata, CD_MLOOPUV);
+	const MLoopUV *mloopuv_dst = (const MLoopUV *)CustomData_get_layer(&me_dst.ldata, CD_MLOOPUV);
+	for (int i = 0; i < me_src.totpoly; i++) {
+		EXPECT_EQ(me_dst.mpoly[i].loopstart, me_src.mpoly[i].loopstart);
+		EXPECT_EQ(me_dst.mpoly[i].totloop, me_src.mpoly[i].totloop);
+	}
+	for (int i = 0; i < me_src.totloop; i++) {
+		EXPECT_EQ(me_dst.mloop[i].v, me_src.mloop[i].v);
+		EXPECT_EQ(me_dst.mloop[i].e, me_src.mloop[i].e);
+		EXPECT_EQ(mloopuv_dst[i].uv[0], mloopuv_src[i].uv[0]);
+		EXPECT_EQ(mloopuv_dst[i].uv[1], mloopuv_src[i].uv[1]);
+	}
+
+	BM_mesh_free(bm);
+	BKE_mesh_free(&me_src);
+	BKE_mesh_free(&me_dst);
+
+	printf("========== ENDED %s ==========\n\n", "MeshRoundTrip");
+}
@@ -0,0 +1,200 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+#include <math.h>
+#include <string.h>
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_utildefines.h"
+#include "BLI_task.h"
+#include "PIL_time_utildefines.h"
+}
+
+#include "dualcon.h"
+
+/* Remeshing a torus at several octree depths, single-threaded and multi-threaded. */
+
+/* Run the longest tests! */
+//#define DUALCON_RUN_BIG
+
+#ifdef DUALCON_RUN_BIG
+#  define MAX_DEPTH 10
+#else
+#  define MAX_DEPTH 8
+#endif
+
+#define TORUS_SEGMENTS 256
+#define TORUS_RINGS 64
+
+typedef struct TestInput {
+	float (*co)[3];
+	unsigned int *loops;
+	unsigned int (*tris)[3];
+	DualConInput input;
+} TestInput;
+
+typedef struct TestOutput {
+	float (*co)[3];
+	int (*quads)[4];
+	int totvert, totquad;
+	int curvert, curquad;
+} TestOutput;
+
+static void torus_init(TestInput *tin)
+{
+	const int totvert = TORUS_SEGMENTS * TORUS_RINGS;
+	const int tottri = totvert * 2;
+
+	tin->co = (float (*)[3])MEM_mallocN(sizeof(*tin->co) * totvert, __func__);
+	tin->loops = (unsigned int *)MEM_mallocN(sizeof(*tin->loops) * tottri * 3, __func__);
+	tin->tris = (unsigned int (*)[3])MEM_mallocN(sizeof(*tin->tris) * tottri, __func__);
+
+	for (int i = 0, v = 0; i < TORUS_SEGMENTS; i++) {
+		const float u = (float)i / TORUS_SEGMENTS * 2.0f * (float)M_PI;
+		for (int j = 0; j < TORUS_RINGS; j++, v++) {
+			const float w = (float)j / TORUS_RINGS * 2.0f * (float)M_PI;
+			const float r = 1.0f + 0.3f * cosf(w);
+			tin->co[v][0] = r * cosf(u);
+			tin->co[v][1] = r * sinf(u);
+			tin->co[v][2] = 0.3f * sinf(w);
+		}
+	}
+
+	for (int i = 0, t = 0; i < TORUS_SEGMENTS; i++) {
+		const int i_next = (i + 1) % TORUS_SEGMENTS;
+		for (int j = 0; j < TORUS_RINGS; j++, t += 2) {
+			const int j_next = (j + 1) % TORUS_RINGS;
+			const unsigned int quad[4] = {
+			    (unsigned int)(i * TORUS_RINGS + j), (unsigned int)(i_next * TORUS_RINGS + j),
+			    (unsigned int)(i_next * TORUS_RINGS + j_next), (unsigned int)(i * TORUS_RINGS + j_next)};
+			const int tri_verts[2][3] = {{0, 1, 2}, {0, 2, 3}};
+
+			for (int k = 0; k < 2; k++) {
+				for (int l = 0; l < 3; l++) {
+					tin->loops[(t + k) * 3 + l] = quad[tri_verts[k][l]];
+					tin->tris[t + k][l] = (t + k) * 3 + l;
+				}
+			}
+		}
+	}
+
+	memset(&tin->input, 0, sizeof(tin->input));
+	tin->input.co = tin->co;
+	tin->input.co_stride = sizeof(*tin->co);
+	tin->input.totco = totvert;
+	tin->input.mloop = tin->loops;
+	tin->input.loop_stride = sizeof(*tin->loops);
+	tin->input.looptri = tin->tris;
+	tin->input.tri_stride = sizeof(*tin->tris);
+	tin->input.tottri = tottri;
+	tin->input.min[0] = tin->input.min[1] = -1.3f;
+	tin->input.max[0] = tin->input.max[1] = 1.3f;
+	tin->input.min[2] = -0.3f;
+	tin->input.max[2] = 0.3f;
+}
+
+static void torus_free(TestInput *tin)
+{
+	MEM_freeN(tin->co);
+	MEM_freeN(tin->loops);
+	MEM_freeN(tin->tris);
+}
+
+static void *test_alloc_output(int totvert, int totquad)
+{
+	TestOutput *out = (TestOutput *)MEM_callocN(sizeof(*out), __func__);
+
+	out->co = (float (*)[3])MEM_mallocN(sizeof(*out->co) * MAX2(totvert, 1), __func__);
+	out->quads = (int (*)[4])MEM_mallocN(sizeof(*out->quads) * MAX2(totquad, 1), __func__);
+	out->totvert = totvert;
+	out->totquad = totquad;
+	return out;
+}
+
+static void test_add_vert(void *output, const float co[3])
+{
+	TestOutput *out = (TestOutput *)output;
+
+	memcpy(out->co[out->curvert++], co, sizeof(*out->co));
+}
+
+static void test_add_quad(void *output, const int vert_indices[4])
+{
+	TestOutput *out = (TestOutput *)output;
+
+	memcpy(out->quads[out->curquad++], vert_indices, sizeof(*out->quads));
+}
+
+static void test_output_free(TestOutput *out)
+{
+	MEM_freeN(out->co);
+	MEM_freeN(out->quads);
+	MEM_freeN(out);
+}
+
+typedef struct TestParallelData {
+	DualConParallelFunc func;
+	void *userdata;
+} TestParallelData;
+
+static void test_parallel_range_cb(void *userdata, const int iter)
+{
+	TestParallelData *data = (TestParallelData *)userdata;
+
+	data->func(data->userdata, iter);
+}
+
+static void test_parallel_range(int tot, void *userdata, DualConParallelFunc func)
+{
+	TestParallelData data = {func, userdata};
+
+	BLI_task_parallel_range(0, tot, &data, test_parallel_range_cb, true);
+}
+
+static TestOutput *test_remesh(TestInput *tin, DualConParallelRange parallel_range, int depth)
+{
+	return (TestOutput *)dualcon(
+	        &tin->input, test_alloc_output, test_add_vert, test_add_quad, parallel_range,
+	        DUALCON_FLOOD_FILL, DUALCON_SHARP_FEATURES, 1.0f, 1.0f, 0.9f, depth);
+}
+
+TEST(dualcon, RemeshTorus)
+{
+	printf("\n========== STARTING %s ==========\n", "RemeshTorus");
+
+	TestInput tin;
+	torus_init(&tin);
+
+	for (int depth = 4; depth <= MAX_DEPTH; depth += 2) {
+		TestOutput *out_serial, *out_parallel;
+
+		printf("depth %d:\n", depth);
+
+		TIMEIT_START(remesh_serial);
+		out_serial = test_remesh(&tin, NULL, depth);
+		TIMEIT_END(remesh_serial);
+
+		TIMEIT_START(remesh_parallel);
+		out_parallel = test_remesh(&tin, test_parallel_range, depth);
+		TIMEIT_END(remesh_parallel);
+
+		printf("%d vertices, %d quads\n", out_serial->totvert, out_serial->totquad);
+
+		/* threading must not change the result, nor its order */
+		EXPECT_GT(out_serial->totquad, 0);
+		ASSERT_EQ(out_parallel->totvert, out_serial->totvert);
+		ASSERT_EQ(out_parallel->totquad, out_serial->totquad);
+		EXPECT_EQ(out_parallel->curvert, out_serial->curvert);
+		EXPECT_EQ(out_parallel->curquad, out_serial->curquad);
+		EXPECT_EQ(memcmp(out_parallel->co, out_serial->co, sizeof(*out_serial->co) * out_serial->curvert), 0);
+		EXPECT_EQ(memcmp(out_parallel->quads, out_serial->quads, sizeof(*out_serial->quads) * out_serial->curquad), 0);
+
+		test_output_free(out_serial);
+		test_output_free(out_parallel);
+	}
+
+	torus_free(&tin);
+
+	printf("========== ENDED %s ==========\n\n", "RemeshTorus");
+}
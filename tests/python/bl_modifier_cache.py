@@ -0,0 +1,79 @@
+# Apache License, Version 2.0
+
+# ./blender.bin --background -noaudio --python tests/python/bl_modifier_cache.py -- --verbose
+import bpy
+import unittest
+
+
+def evaluated_coords(ob):
+    me = ob.to_mesh(bpy.context.scene, True, 'PREVIEW')
+    coords = [v.co.copy() for v in me.vertices]
+    bpy.data.meshes.remove(me)
+    return coords
+
+
+class TestModifierCache(unittest.TestCase):
+
+    def setUp(self):
+        bpy.ops.mesh.primitive_uv_sphere_add(segments=16, ring_count=8)
+        self.ob = bpy.context.active_object
+
+        # Array gives a plain mesh result, which is what gets cached.
+        self.array = self.ob.modifiers.new("Array", 'ARRAY')
+        self.array.count = 3
+        self.array.use_cache_result = True
+
+        self.displace = self.ob.modifiers.new("Displace", 'DISPLACE')
+        self.displace.strength = 0.25
+
+    def tearDown(self):
+        me = self.ob.data
+        bpy.data.objects.remove(self.ob)
+        bpy.data.meshes.remove(me)
+
+    def assertCoordsEqual(self, coords_a, coords_b):
+        self.assertEqual(len(coords_a), len(coords_b))
+        for co_a, co_b in zip(coords_a, coords_b):
+            self.assertAlmostEqual((co_a - co_b).length, 0.0, places=5)
+
+    def uncached_coords(self):
+        self.array.use_cache_result = False
+        coords = evaluated_coords(self.ob)
+        self.array.use_cache_result = True
+        return coords
+
+    def test_resume_after_cached(self):
+        evaluated_coords(self.ob)
+
+        # Only the displace modifier changed, the array result is reused.
+        self.displace.strength = 0.75
+        self.assertCoordsEqual(evaluated_coords(self.ob), self.uncached_coords())
+
+    def test_cached_modifier_changed(self):
+        evaluated_coords(self.ob)
+
+        self.array.count = 4
+        coords = evaluated_coords(self.ob)
+        self.assertEqual(len(coords), len(self.ob.data.vertices) * 4)
+        self.assertCoordsEqual(coords, self.uncached_coords())
+
+    def test_input_mesh_changed(self):
+        evaluated_coords(self.ob)
+
+        self.ob.data.vertices[0].co.z += 1.0
+        self.assertCoordsEqual(evaluated_coords(self.ob), self.uncached_coords())
+
+    def test_vertex_group_changed(self):
+        group = self.ob.vertex_groups.new("Group")
+        group.add([0, 1, 2], 1.0, 'REPLACE')
+        self.displace.vertex_group = group.name
+        evaluated_coords(self.ob)
+
+        group.add([0, 1, 2], 0.5, 'REPLACE')
+        self.assertCoordsEqual(evaluated_coords(self.ob), self.uncached_coords())
+
+
+if __name__ == '__main__':
+    import sys
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    unittest.main()